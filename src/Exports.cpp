@@ -452,6 +452,13 @@ API void CCONV _RA_InstallMemoryBankBlockReader(int nBankID, void* pReader)
     }
 }
 
+API void CCONV _RA_InstallMemoryBankPointer(int nBankID, const void* pMemory)
+{
+    auto* pEmulatorMemoryContext = dynamic_cast<ra::context::impl::EmulatorMemoryContext*>(&ra::services::ServiceLocator::GetMutable<ra::context::IEmulatorMemoryContext>());
+    if (pEmulatorMemoryContext)
+        pEmulatorMemoryContext->AddMemoryBlockPointer(nBankID, static_cast<const uint8_t*>(pMemory));
+}
+
 API void CCONV _RA_ClearMemoryBanks()
 {
     auto* pEmulatorMemoryContext = dynamic_cast<ra::context::impl::EmulatorMemoryContext*>(&ra::services::ServiceLocator::GetMutable<ra::context::IEmulatorMemoryContext>());
@@ -574,6 +581,12 @@ API void CCONV _RA_DoAchievementsFrame()
     ra::ui::win32::bindings::ControlBinding::RepaintGuard guard;
 #endif
 
+    // the emulator doesn't modify memory while we're processing the frame, so memory read by the
+    // runtime can be reused by the UI instead of calling back into the emulator again.
+    auto* pEmulatorMemoryContext = dynamic_cast<ra::context::impl::EmulatorMemoryContext*>(&ra::services::ServiceLocator::GetMutable<ra::context::IEmulatorMemoryContext>());
+    if (pEmulatorMemoryContext)
+        pEmulatorMemoryContext->BeginCachingReads();
+
     // make sure we process the achievements _before_ updating the UI.
     // the frozen bookmarks may modify the memory
     TALLY_PERFORMANCE(PerformanceCheckpoint::RuntimeProcess);
@@ -584,6 +597,9 @@ API void CCONV _RA_DoAchievementsFrame()
     UpdateUIForFrameChange();
 #endif
 
+    if (pEmulatorMemoryContext)
+        pEmulatorMemoryContext->EndCachingReads();
+
     CHECK_PERFORMANCE();
 }
 
@@ -68,8 +68,10 @@ extern "C" {
     //  pReader is typedef unsigned char (_RAMByteReadFn)( unsigned nOffset );
     //  pBlockReader is typedef unsigned (_RAMBlockReadFn)( unsigned nOffset, unsigned char* pBuffer, unsigned nCount );
     //  pWriter is typedef void (_RAMByteWriteFn)( unsigned int nOffs, unsigned char nVal );
+    //  pMemory is the host memory backing the bank, if the bank is stored contiguously and pReader has no side effects
     API void CCONV _RA_InstallMemoryBank(int nBankID, void* pReader, void* pWriter, int nBankSize);
     API void CCONV _RA_InstallMemoryBankBlockReader(int nBankID, void* pBlockReader);
+    API void CCONV _RA_InstallMemoryBankPointer(int nBankID, const void* pMemory);
 
     // Call before installing any memory banks
     API void CCONV _RA_ClearMemoryBanks();
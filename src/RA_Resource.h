@@ -155,6 +155,8 @@
 #define IDC_RA_REMOVE_REGION            1250
 #define IDC_RA_VIEW_DETAIL              1251
 #define IDC_RA_LBL_VALUE                1252
+#define IDC_RA_MAX_OFFSET               1253
+#define IDC_RA_POINTER_DEPTH            1254
 
 
 #define IDD_RA_MEMORY                   1501
@@ -219,6 +221,7 @@
 #define IDM_RA_FILES_OPENALL            1719
 #define IDM_RA_FILES_POINTERFINDER      1720
 #define IDM_RA_FILES_POINTERINSPECTOR   1721
+#define IDM_RA_TOGGLEPROFILER           1722
 #define IDM_RA_MENUEND                  1739
 
 // Next default values for new objects
@@ -227,7 +230,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        122
 #define _APS_NEXT_COMMAND_VALUE         40001
-#define _APS_NEXT_CONTROL_VALUE         1253
+#define _APS_NEXT_CONTROL_VALUE         1255
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -25,6 +25,85 @@ namespace context {
 
 constexpr int SERVER_PING_FREQUENCY = 2 * 60; // seconds between server pings
 
+// The session history is a header followed by fixed-size records. Each completed session adds one record.
+// Records are only ever appended (or rewritten in place while the session is in progress), and each record
+// has its own checksum, so a record that was only partially written when the process was killed is ignored
+// without affecting the other records.
+//
+// header:  [4 bytes] signature  [4 bytes] version  [4 bytes] record count  [4 bytes] checksum
+// record:  [4 bytes] game id  [4 bytes] duration (seconds)  [8 bytes] session start (time_t)
+//          [4 bytes] reserved  [4 bytes] checksum
+//
+// The record count in the header is the number of records the file was created with. Sessions appended
+// afterwards are not reflected in it. All values are little-endian.
+constexpr uint32_t SESSION_HISTORY_SIGNATURE = 0x48534152; // "RASH"
+constexpr uint32_t SESSION_HISTORY_VERSION = 1;
+constexpr size_t SESSION_HISTORY_HEADER_SIZE = 16;
+constexpr size_t SESSION_HISTORY_RECORD_SIZE = 24;
+
+// the history is compacted when it has this many more records than games
+constexpr size_t SESSION_HISTORY_COMPACT_THRESHOLD = 256;
+
+static void AppendUInt32(std::string& sBuffer, uint32_t nValue)
+{
+    sBuffer.push_back(gsl::narrow_cast<char>(nValue & 0xFF));
+    sBuffer.push_back(gsl::narrow_cast<char>((nValue >> 8) & 0xFF));
+    sBuffer.push_back(gsl::narrow_cast<char>((nValue >> 16) & 0xFF));
+    sBuffer.push_back(gsl::narrow_cast<char>((nValue >> 24) & 0xFF));
+}
+
+GSL_SUPPRESS_BOUNDS4
+static uint32_t ReadUInt32(const uint8_t* pBuffer) noexcept
+{
+    return static_cast<uint32_t>(pBuffer[0]) | (static_cast<uint32_t>(pBuffer[1]) << 8) |
+           (static_cast<uint32_t>(pBuffer[2]) << 16) | (static_cast<uint32_t>(pBuffer[3]) << 24);
+}
+
+// FNV-1a
+GSL_SUPPRESS_BOUNDS4
+static uint32_t CalculateChecksum(const uint8_t* pBuffer, size_t nBytes) noexcept
+{
+    uint32_t nChecksum = 0x811C9DC5;
+    for (size_t i = 0; i < nBytes; ++i)
+    {
+        nChecksum ^= pBuffer[i];
+        nChecksum *= 0x01000193;
+    }
+
+    return nChecksum;
+}
+
+static void AppendChecksum(std::string& sBuffer, size_t nStart)
+{
+    const uint8_t* pBuffer;
+    GSL_SUPPRESS_TYPE1 pBuffer = reinterpret_cast<const uint8_t*>(&sBuffer.at(nStart));
+    AppendUInt32(sBuffer, CalculateChecksum(pBuffer, sBuffer.length() - nStart));
+}
+
+static std::string EncodeSessionHistoryHeader(size_t nRecords)
+{
+    std::string sHeader;
+    sHeader.reserve(SESSION_HISTORY_HEADER_SIZE);
+    AppendUInt32(sHeader, SESSION_HISTORY_SIGNATURE);
+    AppendUInt32(sHeader, SESSION_HISTORY_VERSION);
+    AppendUInt32(sHeader, gsl::narrow_cast<uint32_t>(nRecords));
+    AppendChecksum(sHeader, 0);
+    return sHeader;
+}
+
+static void AppendSessionHistoryRecord(std::string& sBuffer, unsigned int nGameId, time_t tSessionStart,
+                                       std::chrono::seconds tSessionDuration)
+{
+    const auto nStart = sBuffer.length();
+    const auto nSessionStart = static_cast<uint64_t>(tSessionStart);
+    AppendUInt32(sBuffer, nGameId);
+    AppendUInt32(sBuffer, gsl::narrow_cast<uint32_t>(tSessionDuration.count()));
+    AppendUInt32(sBuffer, gsl::narrow_cast<uint32_t>(nSessionStart & 0xFFFFFFFF));
+    AppendUInt32(sBuffer, gsl::narrow_cast<uint32_t>(nSessionStart >> 32));
+    AppendUInt32(sBuffer, 0);
+    AppendChecksum(sBuffer, nStart);
+}
+
 void SessionTracker::Initialize(const std::string& sUsername)
 {
     m_sUsername = ra::util::String::Widen(sUsername);
@@ -36,57 +115,196 @@ void SessionTracker::Initialize(const std::string& sUsername)
 void SessionTracker::LoadSessions()
 {
     m_vGameStats.clear();
+    m_mGameIndex.clear();
+    m_nFileWritePosition = 0;
 
     auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
-    auto pStatsFile = pLocalStorage.ReadText(ra::services::StorageItemType::SessionStats, m_sUsername);
+    size_t nRecords = 0;
 
-    if (pStatsFile != nullptr)
+    // the backup only exists if compaction was interrupted. if it was completely written, the history file
+    // may not have been, so finish the compaction from the backup. otherwise, the history file wasn't touched.
+    auto pBackupFile = pLocalStorage.ReadText(ra::services::StorageItemType::SessionHistoryBackup, m_sUsername);
+    if (pBackupFile != nullptr)
     {
-        // line format: <gameid>:<sessionstart>:<sessionlength>:<checksum>
-        std::string sLine;
-        while (pStatsFile->GetLine(sLine))
+        const bool bComplete = ReadSessionHistory(*pBackupFile, true, nRecords);
+        pBackupFile.reset();
+
+        if (bComplete)
         {
-            ra::util::Tokenizer pTokenizer(sLine);
+            RA_LOG_WARN("Recovering session history from backup");
+            CompactSessions();
+            return;
+        }
 
-            const auto nGameId = pTokenizer.ReadNumber();
-            if (!pTokenizer.Consume(':'))
-                continue;
+        pLocalStorage.Delete(ra::services::StorageItemType::SessionHistoryBackup, m_sUsername);
+    }
 
-            const auto nSessionStart = pTokenizer.ReadNumber();
-            if (!pTokenizer.Consume(':'))
-                continue;
+    auto pHistoryFile = pLocalStorage.ReadText(ra::services::StorageItemType::SessionHistory, m_sUsername);
+    if (pHistoryFile != nullptr && ReadSessionHistory(*pHistoryFile, false, nRecords))
+    {
+        pHistoryFile.reset();
 
-            const auto nSessionLength = pTokenizer.ReadNumber();
-            if (!pTokenizer.Consume(':'))
-                continue;
+        if (nRecords > m_vGameStats.size() + SESSION_HISTORY_COMPACT_THRESHOLD)
+            CompactSessions();
+
+        return;
+    }
+    pHistoryFile.reset();
 
+    // convert the text history from older versions
+    if (LoadLegacySessions())
+    {
+        RA_LOG_INFO("Converting %zu game session histories", m_vGameStats.size());
+        CompactSessions();
+
+        if (m_nFileWritePosition != 0)
+            pLocalStorage.Delete(ra::services::StorageItemType::SessionStats, m_sUsername);
+    }
+}
+
+bool SessionTracker::ReadSessionHistory(ra::services::TextReader& pHistoryFile, bool bRequireComplete, size_t& nRecords)
+{
+    uint8_t pHeader[SESSION_HISTORY_HEADER_SIZE]{};
+    if (pHistoryFile.GetBytes(pHeader, sizeof(pHeader)) != sizeof(pHeader))
+        return false;
 
-            const BYTE* pLine;
-            GSL_SUPPRESS_TYPE1{ pLine = reinterpret_cast<const BYTE*>(sLine.c_str()); }
-            const auto md5 = RAGenerateMD5(pLine, pTokenizer.CurrentPosition());
-            if (pTokenizer.Consume(md5.front()) && pTokenizer.Consume(md5.back()))
-                AddSession(nGameId, nSessionStart, std::chrono::seconds(nSessionLength));
+    uint32_t nExpectedRecords = 0;
+    GSL_SUPPRESS_BOUNDS4
+    {
+        if (ReadUInt32(&pHeader[0]) != SESSION_HISTORY_SIGNATURE ||
+            ReadUInt32(&pHeader[4]) != SESSION_HISTORY_VERSION ||
+            ReadUInt32(&pHeader[12]) != CalculateChecksum(pHeader, 12))
+        {
+            return false;
+        }
+
+        nExpectedRecords = ReadUInt32(&pHeader[8]);
+    }
+
+    // read in chunks. a partial record at the end of the file is discarded, and will be overwritten by the
+    // next session.
+    std::vector<uint8_t> vBuffer(SESSION_HISTORY_RECORD_SIZE * 1024);
+    nRecords = 0;
+    for (;;)
+    {
+        const auto nRead = pHistoryFile.GetBytes(vBuffer.data(), vBuffer.size());
+        const auto nReadRecords = nRead / SESSION_HISTORY_RECORD_SIZE;
+
+        for (size_t nOffset = 0; nOffset < nReadRecords * SESSION_HISTORY_RECORD_SIZE;
+             nOffset += SESSION_HISTORY_RECORD_SIZE)
+        {
+            if (ReadUInt32(&vBuffer.at(nOffset + 20)) != CalculateChecksum(&vBuffer.at(nOffset), 20))
+                continue;
+
+            const auto nSessionStart = static_cast<uint64_t>(ReadUInt32(&vBuffer.at(nOffset + 8))) |
+                                       (static_cast<uint64_t>(ReadUInt32(&vBuffer.at(nOffset + 12))) << 32);
+            AddSession(ReadUInt32(&vBuffer.at(nOffset)), static_cast<time_t>(nSessionStart),
+                       std::chrono::seconds(ReadUInt32(&vBuffer.at(nOffset + 4))));
         }
 
-        m_nFileWritePosition = pStatsFile->GetPosition();
+        nRecords += nReadRecords;
+        if (nRead < vBuffer.size())
+            break;
     }
+
+    if (bRequireComplete && nRecords < nExpectedRecords)
+    {
+        m_vGameStats.clear();
+        m_mGameIndex.clear();
+        return false;
+    }
+
+    m_nFileWritePosition = SESSION_HISTORY_HEADER_SIZE + nRecords * SESSION_HISTORY_RECORD_SIZE;
+    return true;
+}
+
+bool SessionTracker::LoadLegacySessions()
+{
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    auto pStatsFile = pLocalStorage.ReadText(ra::services::StorageItemType::SessionStats, m_sUsername);
+    if (pStatsFile == nullptr)
+        return false;
+
+    // line format: <gameid>:<sessionstart>:<sessionlength>:<checksum>
+    std::string sLine;
+    while (pStatsFile->GetLine(sLine))
+    {
+        ra::util::Tokenizer pTokenizer(sLine);
+
+        const auto nGameId = pTokenizer.ReadNumber();
+        if (!pTokenizer.Consume(':'))
+            continue;
+
+        const auto nSessionStart = pTokenizer.ReadNumber();
+        if (!pTokenizer.Consume(':'))
+            continue;
+
+        const auto nSessionLength = pTokenizer.ReadNumber();
+        if (!pTokenizer.Consume(':'))
+            continue;
+
+
+        const BYTE* pLine;
+        GSL_SUPPRESS_TYPE1{ pLine = reinterpret_cast<const BYTE*>(sLine.c_str()); }
+        const auto md5 = RAGenerateMD5(pLine, pTokenizer.CurrentPosition());
+        if (pTokenizer.Consume(md5.front()) && pTokenizer.Consume(md5.back()))
+            AddSession(nGameId, nSessionStart, std::chrono::seconds(nSessionLength));
+    }
+
+    return true;
+}
+
+void SessionTracker::CompactSessions()
+{
+    std::string sContents = EncodeSessionHistoryHeader(m_vGameStats.size());
+    sContents.reserve(SESSION_HISTORY_HEADER_SIZE + m_vGameStats.size() * SESSION_HISTORY_RECORD_SIZE);
+    for (const auto& pGameStats : m_vGameStats)
+    {
+        AppendSessionHistoryRecord(sContents, pGameStats.GameId,
+            std::chrono::system_clock::to_time_t(pGameStats.LastSessionStart), pGameStats.TotalPlayTime);
+    }
+
+    // write the backup first. if the history file is only partially rewritten, it will be restored from the
+    // backup the next time the history is loaded.
+    auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
+    {
+        auto pBackupFile = pLocalStorage.WriteText(ra::services::StorageItemType::SessionHistoryBackup, m_sUsername);
+        if (pBackupFile == nullptr)
+            return;
+
+        pBackupFile->Write(sContents);
+    }
+
+    {
+        auto pHistoryFile = pLocalStorage.WriteText(ra::services::StorageItemType::SessionHistory, m_sUsername);
+        if (pHistoryFile == nullptr)
+            return;
+
+        pHistoryFile->Write(sContents);
+    }
+
+    pLocalStorage.Delete(ra::services::StorageItemType::SessionHistoryBackup, m_sUsername);
+    m_nFileWritePosition = sContents.length();
 }
 
 void SessionTracker::AddSession(unsigned int nGameId, time_t tSessionStart, std::chrono::seconds tSessionDuration)
 {
-    auto pIter = m_vGameStats.begin();
-    while (pIter != m_vGameStats.end() && pIter->GameId != nGameId)
-        ++pIter;
+    GameStats* pGameStats = nullptr;
 
-    if (pIter == m_vGameStats.end())
+    const auto pIter = m_mGameIndex.find(nGameId);
+    if (pIter == m_mGameIndex.end())
     {
-        m_vGameStats.emplace_back();
-        pIter = m_vGameStats.end() - 1;
-        pIter->GameId = nGameId;
+        m_mGameIndex.emplace(nGameId, m_vGameStats.size());
+        pGameStats = &m_vGameStats.emplace_back();
+        pGameStats->GameId = nGameId;
+    }
+    else
+    {
+        pGameStats = &m_vGameStats.at(pIter->second);
     }
 
-    pIter->LastSessionStart = std::chrono::system_clock::from_time_t(tSessionStart);
-    pIter->TotalPlayTime += tSessionDuration;
+    pGameStats->LastSessionStart = std::chrono::system_clock::from_time_t(tSessionStart);
+    pGameStats->TotalPlayTime += tSessionDuration;
 }
 
 void SessionTracker::SortSessions()
@@ -96,6 +314,9 @@ void SessionTracker::SortSessions()
     {
         return (right.LastSessionStart < left.LastSessionStart);
     });
+
+    for (size_t nIndex = 0; nIndex < m_vGameStats.size(); ++nIndex)
+        m_mGameIndex.insert_or_assign(m_vGameStats.at(nIndex).GameId, nIndex);
 }
 
 void SessionTracker::BeginSession(unsigned int nGameId)
@@ -173,18 +394,32 @@ void SessionTracker::UpdateSession(time_t tSessionStart)
 std::streampos SessionTracker::WriteSessionStats(std::chrono::seconds tSessionDuration) const
 {
     auto& pLocalStorage = ra::services::ServiceLocator::GetMutable<ra::services::ILocalStorage>();
-    auto pStatsFile = pLocalStorage.AppendText(ra::services::StorageItemType::SessionStats, m_sUsername);
+    std::unique_ptr<ra::services::TextWriter> pHistoryFile;
+    std::string sRecord;
 
-    auto nSessionDuration = tSessionDuration.count();
-    auto sLine = ra::util::String::Printf("%u:%ll:%ll:", m_nCurrentGameId, m_tSessionStart, nSessionDuration);
-    const auto sMD5 = RAGenerateMD5(sLine);
-    sLine.push_back(sMD5.front());
-    sLine.push_back(sMD5.back());
+    if (m_nFileWritePosition == 0)
+    {
+        // no valid history, start a new file
+        pHistoryFile = pLocalStorage.WriteText(ra::services::StorageItemType::SessionHistory, m_sUsername);
+        if (pHistoryFile == nullptr)
+            return m_nFileWritePosition;
+
+        sRecord = EncodeSessionHistoryHeader(0);
+    }
+    else
+    {
+        pHistoryFile = pLocalStorage.AppendText(ra::services::StorageItemType::SessionHistory, m_sUsername);
+        if (pHistoryFile == nullptr)
+            return m_nFileWritePosition;
+
+        // the record for the current session is rewritten each time the session is updated
+        pHistoryFile->SetPosition(m_nFileWritePosition);
+    }
 
-    pStatsFile->SetPosition(m_nFileWritePosition);
-    pStatsFile->WriteLine(sLine);
+    AppendSessionHistoryRecord(sRecord, m_nCurrentGameId, m_tSessionStart, tSessionDuration);
+    pHistoryFile->Write(sRecord);
 
-    return pStatsFile->GetPosition();
+    return pHistoryFile->GetPosition();
 }
 
 std::chrono::seconds SessionTracker::GetTotalPlaytime(unsigned int nGameId) const
@@ -201,14 +436,9 @@ std::chrono::seconds SessionTracker::GetTotalPlaytime(unsigned int nGameId) cons
     }
 
     // add any prior session durations
-    for (const auto& pGameStats : m_vGameStats)
-    {
-        if (pGameStats.GameId == nGameId)
-        {
-            tPlaytime += pGameStats.TotalPlayTime;
-            break;
-        }
-    }
+    const auto pIter = m_mGameIndex.find(nGameId);
+    if (pIter != m_mGameIndex.end())
+        tPlaytime += m_vGameStats.at(pIter->second).TotalPlayTime;
 
     return tPlaytime;
 }
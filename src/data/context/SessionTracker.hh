@@ -2,6 +2,8 @@
 #define RA_DATA_SESSIONTRACKER_HH
 #pragma once
 
+#include "services\TextReader.hh"
+
 #include <string>
 
 namespace ra {
@@ -59,6 +61,17 @@ protected:
     virtual void LoadSessions();
     void AddSession(unsigned int nGameId, time_t tSessionStart, std::chrono::seconds tSessionDuration);
 
+    /// <summary>
+    /// Reads the session history from the text format used by older versions.
+    /// </summary>
+    /// <returns><c>true</c> if a text session history was found.</returns>
+    bool LoadLegacySessions();
+
+    /// <summary>
+    /// Replaces the session history with a single record for each game.
+    /// </summary>
+    void CompactSessions();
+
     void UpdateSession(time_t tSessionStart);
     std::streampos WriteSessionStats(std::chrono::seconds tSessionDuration) const;
 
@@ -67,11 +80,13 @@ protected:
 
 private:
     void SortSessions();
+    bool ReadSessionHistory(ra::services::TextReader& pHistoryFile, bool bRequireComplete, size_t& nRecords);
 
     std::chrono::steady_clock::time_point m_tpSessionStart{};
     time_t m_tSessionStart{};
 
     std::vector<GameStats> m_vGameStats;
+    std::unordered_map<unsigned int, size_t> m_mGameIndex; // GameId => index in m_vGameStats
 
     std::streamoff m_nFileWritePosition{};
 };
@@ -91,6 +91,29 @@ public:
     /// </summary>
     virtual bool IsMemoryInsecure() const = 0;
 
+    /// <summary>
+    /// Starts monitoring the pages of memory containing the specified ranges for modifications. Pages that are
+    /// already being monitored retain their state. Pages that don't contain any of the ranges stop being monitored.
+    /// </summary>
+    /// <param name="vRanges">Start address and number of bytes for each range to monitor.</param>
+    virtual void TrackDirtyPages(const std::vector<std::pair<ra::data::ByteAddress, uint32_t>>& vRanges) = 0;
+
+    /// <summary>
+    /// Stops monitoring memory for modifications.
+    /// </summary>
+    virtual void StopTrackingDirtyPages() noexcept = 0;
+
+    /// <summary>
+    /// Reads the monitored pages and determines which have been modified since the previous call.
+    /// </summary>
+    virtual void UpdateDirtyPages() = 0;
+
+    /// <summary>
+    /// Determines if any memory in the specified range was modified prior to the most recent call to
+    /// <see cref="UpdateDirtyPages" />. Memory that is not being monitored is always considered modified.
+    /// </summary>
+    virtual bool IsMemoryModified(ra::data::ByteAddress nAddress, uint32_t nBytes) const = 0;
+
     class NotifyTarget
     {
     public:
@@ -4,10 +4,46 @@
 
 #include <rc_consoles.h>
 
+#include <array>
+
 namespace ra {
 namespace context {
 namespace impl {
 
+// additional mirror/shadow ram mappings not directly exposed by rc_console_memory_regions.
+// each maps a range of real addresses onto another range of real addresses that is directly mapped.
+struct MirrorRange
+{
+    ConsoleID nConsoleId;
+    ra::data::ByteAddress nRealStartAddress;
+    ra::data::ByteAddress nRealEndAddress;
+    ra::data::ByteAddress nTargetRealStartAddress;
+};
+
+static constexpr std::array<MirrorRange, 10> MIRROR_RANGES = {{
+    // http://archiv.sega-dc.de/munkeechuff/hardware/Memory.html
+    { ConsoleID::Dreamcast, 0x8C000000, 0x8CFFFFFF, 0x0C000000 }, // System Memory (MMU enabled)
+    { ConsoleID::Dreamcast, 0xAC000000, 0xACFFFFFF, 0x0C000000 }, // System Memory (cache enabled)
+
+    // https://wiibrew.org/wiki/Memory_map
+    { ConsoleID::GameCube, 0xC0000000, 0xC17FFFFF, 0x80000000 }, // System Memory (uncached)
+
+    // https://problemkaputt.de/gbatek.htm#dsiiomap
+    { ConsoleID::DSi, 0x0C000000, 0x0CFFFFFF, 0x02000000 }, // Mirror of Main RAM
+
+    // https://www.raphnet.net/electronique/psx_adaptor/Playstation.txt
+    { ConsoleID::PlayStation, 0x80000000, 0x801FFFFF, 0x00000000 }, // Kernel and User Memory Mirror (cached)
+    { ConsoleID::PlayStation, 0xA0000000, 0xA01FFFFF, 0x00000000 }, // Kernel and User Memory Mirror (uncached)
+
+    // https://psi-rockin.github.io/ps2tek/
+    { ConsoleID::PlayStation2, 0x20000000, 0x21FFFFFF, 0x00000000 }, // Main RAM Mirror (uncached)
+    { ConsoleID::PlayStation2, 0x30100000, 0x31FFFFFF, 0x00100000 }, // Main RAM Mirror (uncached and accelerated)
+
+    // https://wiibrew.org/wiki/Memory_map
+    { ConsoleID::WII, 0xC0000000, 0xC17FFFFF, 0x80000000 }, // System Memory (uncached)
+    { ConsoleID::WII, 0xD0000000, 0xD3FFFFFF, 0x90000000 }, // System Memory (uncached)
+}};
+
 ConsoleContext::ConsoleContext(ConsoleID nId) noexcept
 {
     m_nId = nId;
@@ -55,104 +91,160 @@ ConsoleContext::ConsoleContext(ConsoleID nId) noexcept
             m_nMaxAddress = std::max(m_nMaxAddress, pRegion.end_address);
         }
     }
-}
 
-const ra::data::MemoryRegion* ConsoleContext::GetMemoryRegion(ra::data::ByteAddress nAddress) const
-{
-    const auto& vRegions = MemoryRegions();
-    gsl::index nStart = 0;
-    gsl::index nEnd = vRegions.size() - 1;
-    while (nStart <= nEnd)
-    {
-        const gsl::index nMid = (nStart + nEnd) / 2;
-        const auto& pRegion = vRegions.at(nMid);
-        if (pRegion.GetStartAddress() > nAddress)
-            nEnd = nMid - 1;
-        else if (pRegion.GetEndAddress() < nAddress)
-            nStart = nMid + 1;
-        else
-            return &pRegion;
-    }
-
-    return nullptr;
+    UpdateAddressTranslation();
 }
 
-ra::data::ByteAddress ConsoleContext::ByteAddressFromRealAddress(ra::data::ByteAddress nRealAddress) const noexcept
+static bool DirectByteAddressFromRealAddress(const std::vector<ra::data::MemoryRegion>& vRegions,
+                                             ra::data::ByteAddress nRealAddress, ra::data::ByteAddress& nByteAddress) noexcept
 {
-    for (const auto& pRegion : m_vRegions)
+    for (const auto& pRegion : vRegions)
     {
         if (pRegion.ContainsRealAddress(nRealAddress))
         {
             if (pRegion.GetType() == ra::data::MemoryRegion::Type::Unused)
-                break;
+                return false;
 
-            return (nRealAddress - pRegion.GetRealStartAddress()) + pRegion.GetStartAddress();
+            nByteAddress = (nRealAddress - pRegion.GetRealStartAddress()) + pRegion.GetStartAddress();
+            return true;
         }
     }
 
-    // additional mirror/shadow ram mappings not directly exposed by rc_console_memory_regions
-    switch (m_nId)
+    return false;
+}
+
+template<typename TTranslate>
+void ConsoleContext::BuildAddressRanges(std::vector<uint64_t>& vBoundaries, TTranslate fTranslate,
+                                        std::vector<AddressRange>& vRanges)
+{
+    // the translation is a constant offset between any two adjacent boundaries. evaluate it once at the
+    // start of each span, and merge neighboring spans that share the same offset.
+    vBoundaries.push_back(0);
+    std::sort(vBoundaries.begin(), vBoundaries.end());
+    vBoundaries.erase(std::unique(vBoundaries.begin(), vBoundaries.end()), vBoundaries.end());
+
+    vRanges.clear();
+    for (const auto nBoundary : vBoundaries)
     {
-        case ConsoleID::Dreamcast:
-            // http://archiv.sega-dc.de/munkeechuff/hardware/Memory.html
-            if (nRealAddress >= 0x8C000000 && nRealAddress <= 0x8CFFFFFF) // System Memory (MMU enabled)
-                return ByteAddressFromRealAddress(nRealAddress & 0x0FFFFFFF);
-            if (nRealAddress >= 0xAC000000 && nRealAddress <= 0xACFFFFFF) // System Memory (cache enabled)
-                return ByteAddressFromRealAddress(nRealAddress & 0x0FFFFFFF);
+        if (nBoundary > 0xFFFFFFFF)
             break;
 
-        case ConsoleID::GameCube:
-            // https://wiibrew.org/wiki/Memory_map
-            if (nRealAddress >= 0xC0000000 && nRealAddress <= 0xC17FFFFF) // System Memory (uncached)
-                return ByteAddressFromRealAddress(nRealAddress - (0xC0000000-0x80000000));
-            break;
+        const auto nAddress = gsl::narrow_cast<ra::data::ByteAddress>(nBoundary);
+        ra::data::ByteAddress nTranslatedAddress = 0;
+        const bool bValid = fTranslate(nAddress, nTranslatedAddress);
+        const ra::data::ByteAddress nOffset = bValid ? nTranslatedAddress - nAddress : 0;
 
-        case ConsoleID::DSi:
-            // https://problemkaputt.de/gbatek.htm#dsiiomap
-            if (nRealAddress >= 0x0C000000 && nRealAddress <= 0x0CFFFFFF) // Mirror of Main RAM
-                return ByteAddressFromRealAddress(nRealAddress - (0x0C000000-0x02000000));
-            break;
+        if (!vRanges.empty() && vRanges.back().bValid == bValid && vRanges.back().nOffset == nOffset)
+            continue;
 
-        case ConsoleID::PlayStation:
-            // https://www.raphnet.net/electronique/psx_adaptor/Playstation.txt
-            if (nRealAddress >= 0x80000000 && nRealAddress <= 0x801FFFFF) // Kernel and User Memory Mirror (cached)
-                return ByteAddressFromRealAddress(nRealAddress & 0x001FFFFF);
-            if (nRealAddress >= 0xA0000000 && nRealAddress <= 0xA01FFFFF) // Kernel and User Memory Mirror (uncached)
-                return ByteAddressFromRealAddress(nRealAddress & 0x001FFFFF);
-            break;
+        vRanges.push_back({nAddress, nOffset, bValid});
+    }
+}
 
-        case ConsoleID::PlayStation2:
-            // https://psi-rockin.github.io/ps2tek/
-            if (nRealAddress >= 0x20000000 && nRealAddress <= 0x21FFFFFF) // Main RAM Mirror (uncached)
-                return ByteAddressFromRealAddress(nRealAddress & 0x01FFFFFF);
-            if (nRealAddress >= 0x30100000 && nRealAddress <= 0x31FFFFFF) // Main RAM Mirror (uncached and accelerated)
-                return ByteAddressFromRealAddress(nRealAddress & 0x01FFFFFF);
-            break;
+void ConsoleContext::UpdateAddressTranslation()
+{
+    std::vector<uint64_t> vRealBoundaries;
+    std::vector<uint64_t> vByteBoundaries;
+    for (const auto& pRegion : m_vRegions)
+    {
+        vRealBoundaries.push_back(pRegion.GetRealStartAddress());
+        vRealBoundaries.push_back(uint64_t{pRegion.GetRealStartAddress()} + pRegion.GetSize());
+        vByteBoundaries.push_back(pRegion.GetStartAddress());
+        vByteBoundaries.push_back(uint64_t{pRegion.GetEndAddress()} + 1);
+    }
 
-        case ConsoleID::WII:
-            // https://wiibrew.org/wiki/Memory_map
-            if (nRealAddress >= 0xC0000000 && nRealAddress <= 0xC17FFFFF) // System Memory (uncached)
-                return ByteAddressFromRealAddress(nRealAddress - (0xC0000000 - 0x80000000));
-            if (nRealAddress >= 0xD0000000 && nRealAddress <= 0xD3FFFFFF) // System Memory (uncached)
-                return ByteAddressFromRealAddress(nRealAddress - (0xD0000000 - 0x90000000));
-            break;
+    // a mirror has to be split wherever the memory it mirrors crosses into another region
+    const size_t nDirectBoundaries = vRealBoundaries.size();
+    for (const auto& pMirror : MIRROR_RANGES)
+    {
+        if (pMirror.nConsoleId != m_nId)
+            continue;
 
-        default:
-            break;
+        vRealBoundaries.push_back(pMirror.nRealStartAddress);
+        vRealBoundaries.push_back(uint64_t{pMirror.nRealEndAddress} + 1);
+
+        const uint64_t nTargetEnd = uint64_t{pMirror.nTargetRealStartAddress} +
+            (pMirror.nRealEndAddress - pMirror.nRealStartAddress);
+        for (size_t i = 0; i < nDirectBoundaries; ++i)
+        {
+            const auto nBoundary = vRealBoundaries.at(i);
+            if (nBoundary > pMirror.nTargetRealStartAddress && nBoundary <= nTargetEnd)
+                vRealBoundaries.push_back(nBoundary - pMirror.nTargetRealStartAddress + pMirror.nRealStartAddress);
+        }
     }
 
-    return 0xFFFFFFFF;
+    BuildAddressRanges(vRealBoundaries, [this](ra::data::ByteAddress nRealAddress, ra::data::ByteAddress& nByteAddress) {
+        if (DirectByteAddressFromRealAddress(m_vRegions, nRealAddress, nByteAddress))
+            return true;
+
+        for (const auto& pMirror : MIRROR_RANGES)
+        {
+            if (pMirror.nConsoleId == m_nId &&
+                nRealAddress >= pMirror.nRealStartAddress && nRealAddress <= pMirror.nRealEndAddress)
+            {
+                const auto nMirroredAddress = nRealAddress - pMirror.nRealStartAddress + pMirror.nTargetRealStartAddress;
+                return DirectByteAddressFromRealAddress(m_vRegions, nMirroredAddress, nByteAddress);
+            }
+        }
+
+        return false;
+    }, m_vRealToByteAddressRanges);
+
+    BuildAddressRanges(vByteBoundaries, [this](ra::data::ByteAddress nByteAddress, ra::data::ByteAddress& nRealAddress) noexcept {
+        for (const auto& pRegion : m_vRegions)
+        {
+            if (pRegion.ContainsAddress(nByteAddress))
+            {
+                nRealAddress = pRegion.GetRealStartAddress() + (nByteAddress - pRegion.GetStartAddress());
+                return true;
+            }
+        }
+
+        return false;
+    }, m_vByteToRealAddressRanges);
 }
 
-ra::data::ByteAddress ConsoleContext::RealAddressFromByteAddress(ra::data::ByteAddress nByteAddress) const noexcept
+ra::data::ByteAddress ConsoleContext::TranslateAddress(const std::vector<AddressRange>& vRanges,
+                                                       ra::data::ByteAddress nAddress) noexcept
 {
-    for (const auto& pRegion : m_vRegions)
+    // the first range always starts at 0, so the range before the first one starting after the address contains it
+    const auto pIter = std::upper_bound(vRanges.begin(), vRanges.end(), nAddress,
+        [](ra::data::ByteAddress nValue, const AddressRange& pRange) noexcept { return nValue < pRange.nStart; });
+    if (pIter == vRanges.begin())
+        return 0xFFFFFFFF;
+
+    const auto& pRange = *(pIter - 1);
+    return pRange.bValid ? nAddress + pRange.nOffset : 0xFFFFFFFF;
+}
+
+const ra::data::MemoryRegion* ConsoleContext::GetMemoryRegion(ra::data::ByteAddress nAddress) const
+{
+    const auto& vRegions = MemoryRegions();
+    gsl::index nStart = 0;
+    gsl::index nEnd = vRegions.size() - 1;
+    while (nStart <= nEnd)
     {
-        if (pRegion.ContainsAddress(nByteAddress))
-            return pRegion.GetRealStartAddress() + nByteAddress;
+        const gsl::index nMid = (nStart + nEnd) / 2;
+        const auto& pRegion = vRegions.at(nMid);
+        if (pRegion.GetStartAddress() > nAddress)
+            nEnd = nMid - 1;
+        else if (pRegion.GetEndAddress() < nAddress)
+            nStart = nMid + 1;
+        else
+            return &pRegion;
     }
 
-    return 0xFFFFFFFF;
+    return nullptr;
+}
+
+ra::data::ByteAddress ConsoleContext::ByteAddressFromRealAddress(ra::data::ByteAddress nRealAddress) const noexcept
+{
+    return TranslateAddress(m_vRealToByteAddressRanges, nRealAddress);
+}
+
+ra::data::ByteAddress ConsoleContext::RealAddressFromByteAddress(ra::data::ByteAddress nByteAddress) const noexcept
+{
+    return TranslateAddress(m_vByteToRealAddressRanges, nByteAddress);
 }
 
 bool ConsoleContext::GetRealAddressConversion(ra::data::Memory::Size* nReadSize, uint32_t* nMask, uint32_t* nOffset) const
@@ -23,6 +23,29 @@ public:
     ra::data::ByteAddress ByteAddressFromRealAddress(ra::data::ByteAddress nRealAddress) const noexcept override;
     ra::data::ByteAddress RealAddressFromByteAddress(ra::data::ByteAddress nRealAddress) const noexcept override;
     bool GetRealAddressConversion(ra::data::Memory::Size* nReadSize, uint32_t* nMask, uint32_t* nOffset) const override;
+
+protected:
+    /// <summary>
+    /// Rebuilds the address translation tables from the current console and memory regions.
+    /// </summary>
+    void UpdateAddressTranslation();
+
+private:
+    struct AddressRange
+    {
+        ra::data::ByteAddress nStart;  // first address in the range. the range ends where the next one starts.
+        ra::data::ByteAddress nOffset; // added to an address in the range to translate it (may wrap)
+        bool bValid;                   // false if addresses in the range can't be translated
+    };
+
+    template<typename TTranslate>
+    static void BuildAddressRanges(std::vector<uint64_t>& vBoundaries, TTranslate fTranslate,
+                                   std::vector<AddressRange>& vRanges);
+    static ra::data::ByteAddress TranslateAddress(const std::vector<AddressRange>& vRanges,
+                                                  ra::data::ByteAddress nAddress) noexcept;
+
+    std::vector<AddressRange> m_vRealToByteAddressRanges;
+    std::vector<AddressRange> m_vByteToRealAddressRanges;
 };
 
 } // namespace impl
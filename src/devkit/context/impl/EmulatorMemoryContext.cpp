@@ -41,6 +41,18 @@ static std::wstring FormatAddressSmall(ra::data::ByteAddress nAddress)
     return sAddress;
 }
 
+// reads are cached in small pages to minimize the cost of populating a page when the emulator only
+// provides a byte reader
+_CONSTANT_VAR READ_CACHE_PAGE_SIZE = 64U;
+_CONSTANT_VAR READ_CACHE_BYPASS_SIZE = 4096U;
+_CONSTANT_VAR READ_CACHE_UNCACHEABLE = 0xFFFFFFFFU;
+static_assert(READ_CACHE_PAGE_SIZE == 64, "m_vReadCacheValid has one bit for each byte of a page");
+
+static constexpr uint64_t GetReadCacheMask(uint32_t nOffset, size_t nCount) noexcept
+{
+    return ((nCount >= READ_CACHE_PAGE_SIZE) ? ~0ULL : ((1ULL << nCount) - 1)) << nOffset;
+}
+
 GSL_SUPPRESS_F6
 EmulatorMemoryContext::EmulatorMemoryContext() noexcept
 {
@@ -50,6 +62,7 @@ EmulatorMemoryContext::EmulatorMemoryContext() noexcept
 void EmulatorMemoryContext::ClearMemoryBlocks()
 {
     m_vMemoryBlocks.clear();
+    m_vMemoryPages.clear();
 
     if (m_nTotalMemorySize != 0U)
     {
@@ -71,8 +84,10 @@ void EmulatorMemoryContext::AddMemoryBlock(gsl::index nIndex, size_t nBytes,
         pBlock.read = pReader;
         pBlock.write = pWriter;
         pBlock.readBlock = nullptr;
+        pBlock.data = nullptr;
 
         m_nTotalMemorySize += nBytes;
+        BuildMemoryPages();
 
         OnTotalMemorySizeChanged();
     }
@@ -85,8 +100,108 @@ void EmulatorMemoryContext::AddMemoryBlockReader(gsl::index nIndex,
         m_vMemoryBlocks.at(nIndex).readBlock = pReader;
 }
 
+void EmulatorMemoryContext::AddMemoryBlockPointer(gsl::index nIndex, const uint8_t* pMemory)
+{
+    if (nIndex < gsl::narrow_cast<gsl::index>(m_vMemoryBlocks.size()))
+    {
+        m_vMemoryBlocks.at(nIndex).data = pMemory;
+        BuildMemoryPages();
+    }
+}
+
+void EmulatorMemoryContext::BuildMemoryPages()
+{
+    m_vMemoryPages.clear();
+
+    const auto nPages = (m_nTotalMemorySize + MEMORY_PAGE_SIZE - 1) / MEMORY_PAGE_SIZE;
+    m_vMemoryPages.reserve(nPages);
+
+    size_t nBlockIndex = 0;
+    size_t nBlockStart = 0;
+    for (size_t nPage = 0; nPage < nPages; ++nPage)
+    {
+        const size_t nPageStart = nPage * MEMORY_PAGE_SIZE;
+        while (nBlockIndex < m_vMemoryBlocks.size() && nPageStart >= nBlockStart + m_vMemoryBlocks.at(nBlockIndex).size)
+            nBlockStart += m_vMemoryBlocks.at(nBlockIndex++).size;
+
+        if (nBlockIndex == m_vMemoryBlocks.size())
+            break;
+
+        const auto& pBlock = m_vMemoryBlocks.at(nBlockIndex);
+        const auto nBlockAddress = nPageStart - nBlockStart;
+
+        auto& pPage = m_vMemoryPages.emplace_back();
+        pPage.nBlockIndex = gsl::narrow_cast<uint32_t>(nBlockIndex);
+        pPage.nBlockAddress = gsl::narrow_cast<uint32_t>(nBlockAddress);
+
+        // pages that span multiple blocks are resolved by walking the blocks
+        pPage.pData = (pBlock.data && nBlockAddress + MEMORY_PAGE_SIZE <= pBlock.size) ? pBlock.data + nBlockAddress : nullptr;
+    }
+}
+
+gsl::index EmulatorMemoryContext::FindMemoryBlock(ra::data::ByteAddress nAddress,
+                                                  ra::data::ByteAddress& nBlockAddress) const noexcept
+{
+    const auto nPage = nAddress / MEMORY_PAGE_SIZE;
+    if (nPage >= m_vMemoryPages.size())
+        return -1;
+
+    GSL_SUPPRESS_BOUNDS4 const auto& pPage = m_vMemoryPages[nPage];
+    size_t nIndex = pPage.nBlockIndex;
+    size_t nOffset = pPage.nBlockAddress + (nAddress % MEMORY_PAGE_SIZE);
+
+    // the address may be in a later block if the page spans multiple blocks
+    for (; nIndex < m_vMemoryBlocks.size(); ++nIndex)
+    {
+        GSL_SUPPRESS_BOUNDS4 const auto nBlockSize = m_vMemoryBlocks[nIndex].size;
+        if (nOffset < nBlockSize)
+        {
+            nBlockAddress = gsl::narrow_cast<ra::data::ByteAddress>(nOffset);
+            return gsl::narrow_cast<gsl::index>(nIndex);
+        }
+
+        nOffset -= nBlockSize;
+    }
+
+    return -1;
+}
+
+const uint8_t* EmulatorMemoryContext::GetDirectMemory(ra::data::ByteAddress nAddress, size_t nCount) const noexcept
+{
+    const auto nPage = nAddress / MEMORY_PAGE_SIZE;
+    if (nPage >= m_vMemoryPages.size())
+        return nullptr;
+
+    GSL_SUPPRESS_BOUNDS4 const auto* pData = m_vMemoryPages[nPage].pData;
+    const auto nOffset = nAddress % MEMORY_PAGE_SIZE;
+    if (pData == nullptr || nOffset + nCount > MEMORY_PAGE_SIZE)
+        return nullptr;
+
+    return pData + nOffset;
+}
+
+uint32_t EmulatorMemoryContext::PeekMemoryIndirect(ra::data::ByteAddress nAddress, uint32_t nBytes) const
+{
+    switch (nBytes)
+    {
+        case 1:
+            return ReadMemoryByte(nAddress);
+        case 2:
+            return ReadMemory(nAddress, ra::data::Memory::Size::SixteenBit);
+        case 4:
+            return ReadMemory(nAddress, ra::data::Memory::Size::ThirtyTwoBit);
+        default:
+            return 0U;
+    }
+}
+
 void EmulatorMemoryContext::OnTotalMemorySizeChanged()
 {
+    // the page snapshots no longer correspond to the memory layout
+    StopTrackingDirtyPages();
+    if (m_bCachingReads)
+        BeginCachingReads();
+
     if (m_nTotalMemorySize <= 0x10000)
         m_fFormatAddress = FormatAddressSmall;
     else if (m_nTotalMemorySize <= 0x1000000)
@@ -116,20 +231,12 @@ bool EmulatorMemoryContext::HasInvalidRegions() const noexcept
 
 bool EmulatorMemoryContext::IsValidAddress(ra::data::ByteAddress nAddress) const noexcept
 {
-    for (const auto& pBlock : m_vMemoryBlocks)
-    {
-        if (nAddress < pBlock.size)
-        {
-            if (pBlock.read)
-                return true;
+    ra::data::ByteAddress nBlockAddress = 0;
+    const auto nBlockIndex = FindMemoryBlock(nAddress, nBlockAddress);
+    if (nBlockIndex < 0)
+        return false;
 
-            break;
-        }
-
-        nAddress -= gsl::narrow_cast<ra::data::ByteAddress>(pBlock.size);
-    }
-
-    return false;
+    GSL_SUPPRESS_BOUNDS4 return (m_vMemoryBlocks[nBlockIndex].read != nullptr);
 }
 
 void EmulatorMemoryContext::AssertIsOnDoFrameThread() const
@@ -155,21 +262,127 @@ void EmulatorMemoryContext::AssertIsOnDoFrameThread() const
 #endif
 }
 
-uint8_t EmulatorMemoryContext::ReadMemoryByte(ra::data::ByteAddress nAddress) const
+void EmulatorMemoryContext::BeginCachingReads()
 {
-    AssertIsOnDoFrameThread();
+    InvalidateReadCache();
+    m_vReadCacheIndex.resize((m_nTotalMemorySize + READ_CACHE_PAGE_SIZE - 1) / READ_CACHE_PAGE_SIZE);
+    m_bCachingReads = true;
+}
 
-    for (const auto& pBlock : m_vMemoryBlocks)
+void EmulatorMemoryContext::EndCachingReads()
+{
+    m_bCachingReads = false;
+    InvalidateReadCache();
+}
+
+void EmulatorMemoryContext::InvalidateReadCache() const
+{
+    for (const auto nPage : m_vReadCachePages)
+        m_vReadCacheIndex.at(nPage) = 0;
+
+    m_vReadCachePages.clear();
+    m_vReadCacheMemory.clear();
+    m_vReadCacheValid.clear();
+}
+
+const uint8_t* EmulatorMemoryContext::GetCachedPage(ra::data::ByteAddress nAddress, size_t nCount) const
+{
+    const auto nPage = nAddress / READ_CACHE_PAGE_SIZE;
+    if (nPage >= m_vReadCacheIndex.size())
+        return nullptr;
+
+    auto& nSlot = m_vReadCacheIndex.at(nPage);
+    if (nSlot == READ_CACHE_UNCACHEABLE)
+        return nullptr;
+
+    if (nSlot == 0)
+    {
+        m_vReadCachePages.push_back(nPage);
+        m_vReadCacheMemory.resize(m_vReadCacheMemory.size() + READ_CACHE_PAGE_SIZE);
+        m_vReadCacheValid.push_back(0);
+        nSlot = gsl::narrow_cast<uint32_t>(m_vReadCacheValid.size());
+    }
+
+    const auto nSlotIndex = gsl::narrow_cast<size_t>(nSlot) - 1;
+    auto* pPage = &m_vReadCacheMemory.at(nSlotIndex * READ_CACHE_PAGE_SIZE);
+    auto& nValid = m_vReadCacheValid.at(nSlotIndex);
+
+    const auto nPageAddress = nPage * READ_CACHE_PAGE_SIZE;
+    auto nOffset = nAddress - nPageAddress;
+    if ((nValid & GetReadCacheMask(nOffset, nCount)) == GetReadCacheMask(nOffset, nCount))
+        return pPage;
+
+    if (nValid == 0)
     {
-        if (nAddress < pBlock.size)
+        // if the emulator can provide a block of memory, populate the whole page with a single call. otherwise,
+        // only read the requested bytes so sparse reads don't have to read the rest of the page a byte at a time.
+        ra::data::ByteAddress nBlockAddress = 0;
+        const auto nBlockIndex = FindMemoryBlock(nPageAddress, nBlockAddress);
+        if (nBlockIndex >= 0)
         {
-            if (pBlock.read)
-                return pBlock.read(nAddress);
+            const auto& pBlock = m_vMemoryBlocks.at(nBlockIndex);
+            if ((pBlock.readBlock || pBlock.data) && nBlockAddress + READ_CACHE_PAGE_SIZE <= pBlock.size)
+            {
+                nOffset = 0;
+                nCount = READ_CACHE_PAGE_SIZE;
+            }
+        }
+    }
 
-            break;
+    // read each run of missing bytes
+    const auto nEnd = nOffset + nCount;
+    while (nOffset < nEnd)
+    {
+        if (nValid & (1ULL << nOffset))
+        {
+            ++nOffset;
+            continue;
+        }
+
+        auto nRunEnd = nOffset + 1;
+        while (nRunEnd < nEnd && !(nValid & (1ULL << nRunEnd)))
+            ++nRunEnd;
+
+        const auto nRunSize = nRunEnd - nOffset;
+        if (ReadMemoryUncached(nPageAddress + nOffset, pPage + nOffset, nRunSize) < nRunSize)
+        {
+            // page contains invalid memory. always read it directly so the caller knows which bytes are invalid.
+            nSlot = READ_CACHE_UNCACHEABLE;
+            return nullptr;
         }
 
-        nAddress -= gsl::narrow_cast<ra::data::ByteAddress>(pBlock.size);
+        nValid |= GetReadCacheMask(nOffset, nRunSize);
+        nOffset = nRunEnd;
+    }
+
+    return pPage;
+}
+
+uint8_t EmulatorMemoryContext::ReadMemoryByte(ra::data::ByteAddress nAddress) const
+{
+    AssertIsOnDoFrameThread();
+
+    const auto* pData = GetDirectMemory(nAddress, 1);
+    if (pData)
+        return *pData;
+
+    if (m_bCachingReads)
+    {
+        const auto* pPage = GetCachedPage(nAddress, 1);
+        if (pPage)
+            return pPage[nAddress % READ_CACHE_PAGE_SIZE];
+    }
+
+    ra::data::ByteAddress nBlockAddress = 0;
+    const auto nBlockIndex = FindMemoryBlock(nAddress, nBlockAddress);
+    if (nBlockIndex >= 0)
+    {
+        const auto& pBlock = m_vMemoryBlocks.at(nBlockIndex);
+        if (pBlock.data)
+            return pBlock.data[nBlockAddress];
+
+        if (pBlock.read)
+            return pBlock.read(nBlockAddress);
     }
 
     return 0;
@@ -180,6 +393,13 @@ uint32_t EmulatorMemoryContext::ReadMemory(ra::data::ByteAddress nAddress, uint8
 {
     Expects(pBuffer != nullptr);
 
+    if (pBlock.data)
+    {
+        // memory is directly accessible, just copy it
+        memcpy(pBuffer, pBlock.data + nAddress, nCount);
+        return gsl::narrow_cast<uint32_t>(nCount);
+    }
+
     if (pBlock.readBlock)
     {
         const size_t nRead = pBlock.readBlock(nAddress, pBuffer, gsl::narrow_cast<uint32_t>(nCount));
@@ -244,29 +464,74 @@ uint32_t EmulatorMemoryContext::ReadMemory(ra::data::ByteAddress nAddress, uint8
 {
     AssertIsOnDoFrameThread();
 
+    const auto* pData = GetDirectMemory(nAddress, nCount);
+    if (pData)
+    {
+        Expects(pBuffer != nullptr);
+        memcpy(pBuffer, pData, nCount);
+        return gsl::narrow_cast<uint32_t>(nCount);
+    }
+
+    // large reads are usually snapshots. reading them through the cache would just create a second copy.
+    if (!m_bCachingReads || nCount >= READ_CACHE_BYPASS_SIZE)
+        return ReadMemoryUncached(nAddress, pBuffer, nCount);
+
     uint32_t nBytesRead = 0;
     Expects(pBuffer != nullptr);
 
-    for (const auto& pBlock : m_vMemoryBlocks)
+    while (nCount > 0)
     {
-        if (nAddress >= pBlock.size)
+        const auto nPageOffset = nAddress % READ_CACHE_PAGE_SIZE;
+        const auto nToRead = std::min(nCount, gsl::narrow_cast<size_t>(READ_CACHE_PAGE_SIZE - nPageOffset));
+
+        const auto* pPage = GetCachedPage(nAddress, nToRead);
+        if (pPage)
         {
-            nAddress -= gsl::narrow_cast<ra::data::ByteAddress>(pBlock.size);
-            continue;
+            memcpy(pBuffer, pPage + nPageOffset, nToRead);
+            nBytesRead += gsl::narrow_cast<uint32_t>(nToRead);
+        }
+        else
+        {
+            nBytesRead += ReadMemoryUncached(nAddress, pBuffer, nToRead);
         }
-
-        const size_t nBlockRemaining = pBlock.size - nAddress;
-        size_t nToRead = std::min(nCount, nBlockRemaining);
-
-        nBytesRead += ReadMemory(nAddress, pBuffer, nToRead, pBlock);
 
         pBuffer += nToRead;
+        nAddress += gsl::narrow_cast<ra::data::ByteAddress>(nToRead);
         nCount -= nToRead;
+    }
 
-        if (nCount == 0)
-            return nBytesRead;
+    return nBytesRead;
+}
+
+uint32_t EmulatorMemoryContext::ReadMemoryUncached(ra::data::ByteAddress nAddress, uint8_t pBuffer[], size_t nCount) const
+{
+    uint32_t nBytesRead = 0;
+    Expects(pBuffer != nullptr);
+
+    ra::data::ByteAddress nBlockAddress = 0;
+    auto nBlockIndex = FindMemoryBlock(nAddress, nBlockAddress);
+    if (nBlockIndex >= 0)
+    {
+        const auto nBlockCount = gsl::narrow_cast<gsl::index>(m_vMemoryBlocks.size());
+        for (; nBlockIndex < nBlockCount; ++nBlockIndex)
+        {
+            const auto& pBlock = m_vMemoryBlocks.at(nBlockIndex);
+            if (pBlock.size == 0)
+                continue;
 
-        nAddress = 0;
+            const size_t nBlockRemaining = pBlock.size - nBlockAddress;
+            size_t nToRead = std::min(nCount, nBlockRemaining);
+
+            nBytesRead += ReadMemory(nBlockAddress, pBuffer, nToRead, pBlock);
+
+            pBuffer += nToRead;
+            nCount -= nToRead;
+
+            if (nCount == 0)
+                return nBytesRead;
+
+            nBlockAddress = 0;
+        }
     }
 
     if (nCount > 0)
@@ -357,40 +622,58 @@ void EmulatorMemoryContext::WriteMemory(ra::data::ByteAddress nAddress, const ui
 {
     Expects(pBytes != nullptr);
     size_t nBytesWritten = 0;
-    auto nBlockAddress = nAddress;
-
-    for (const auto& pBlock : m_vMemoryBlocks)
+    ra::data::ByteAddress nBlockAddress = 0;
+    auto nBlockIndex = FindMemoryBlock(nAddress, nBlockAddress);
+    if (nBlockIndex >= 0)
     {
-        if (nBlockAddress < pBlock.size)
+        const auto nBlockCount = gsl::narrow_cast<gsl::index>(m_vMemoryBlocks.size());
+        for (; nBlockIndex < nBlockCount; ++nBlockIndex)
         {
-            if (!pBlock.write)
-                break;
+            const auto& pBlock = m_vMemoryBlocks.at(nBlockIndex);
+            if (nBlockAddress < pBlock.size)
+            {
+                if (!pBlock.write)
+                    break;
 
-            m_bMemoryModified = true;
+                m_bMemoryModified = true;
 
-            if (nBytes == 1)
-            {
-                pBlock.write(nBlockAddress, pBytes[0]);
-                nBytesWritten = 1;
-                break;
-            }
-            else
-            {
-                do
+                if (nBytes == 1)
                 {
-                    pBlock.write(nBlockAddress++, pBytes[nBytesWritten++]);
-                } while (nBytesWritten < nBytes && nBlockAddress < pBlock.size);
-
-                if (nBytesWritten == nBytes)
+                    pBlock.write(nBlockAddress, pBytes[0]);
+                    nBytesWritten = 1;
                     break;
+                }
+                else
+                {
+                    do
+                    {
+                        pBlock.write(nBlockAddress++, pBytes[nBytesWritten++]);
+                    } while (nBytesWritten < nBytes && nBlockAddress < pBlock.size);
+
+                    if (nBytesWritten == nBytes)
+                        break;
+                }
             }
-        }
 
-        nBlockAddress -= gsl::narrow_cast<ra::data::ByteAddress>(pBlock.size);
+            nBlockAddress -= gsl::narrow_cast<ra::data::ByteAddress>(pBlock.size);
+        }
     }
 
     if (nBytesWritten > 0)
     {
+        if (m_bCachingReads)
+        {
+            // the emulator may not store the value exactly as written. discard the contents of the cached pages so
+            // they get re-read. the slots are kept so the pages aren't tracked more than once.
+            const auto nLastPage = (nAddress + nBytesWritten - 1) / READ_CACHE_PAGE_SIZE;
+            for (auto nPage = nAddress / READ_CACHE_PAGE_SIZE; nPage <= nLastPage && nPage < m_vReadCacheIndex.size(); ++nPage)
+            {
+                const auto nSlot = m_vReadCacheIndex.at(nPage);
+                if (nSlot != 0 && nSlot != READ_CACHE_UNCACHEABLE)
+                    m_vReadCacheValid.at(gsl::narrow_cast<size_t>(nSlot) - 1) = 0;
+            }
+        }
+
         if (m_vNotifyTargets.LockIfNotEmpty())
         {
             for (auto& target : m_vNotifyTargets.Targets())
@@ -546,10 +829,116 @@ bool EmulatorMemoryContext::IsMemoryInsecure() const
     return m_bMemoryInsecure;
 }
 
+void EmulatorMemoryContext::TrackDirtyPages(const std::vector<std::pair<ra::data::ByteAddress, uint32_t>>& vRanges)
+{
+    std::vector<uint32_t> vPages;
+    for (const auto& pRange : vRanges)
+    {
+        if (pRange.second == 0)
+            continue;
+
+        const auto nLastPage = (pRange.first + pRange.second - 1) / DIRTY_PAGE_SIZE;
+        for (auto nPage = pRange.first / DIRTY_PAGE_SIZE; nPage <= nLastPage; ++nPage)
+        {
+            if (vPages.empty() || vPages.back() != nPage)
+                vPages.push_back(nPage);
+        }
+    }
+
+    std::sort(vPages.begin(), vPages.end());
+    vPages.erase(std::unique(vPages.begin(), vPages.end()), vPages.end());
+
+    if (vPages.size() == m_vDirtyPages.size() &&
+        std::equal(vPages.begin(), vPages.end(), m_vDirtyPages.begin(),
+                   [](uint32_t nPage, const DirtyPage& pPage) noexcept { return nPage == pPage.nPage; }))
+    {
+        // already monitoring exactly these pages
+        return;
+    }
+
+    std::vector<DirtyPage> vDirtyPages;
+    vDirtyPages.reserve(vPages.size());
+    std::vector<uint8_t> vDirtyPageMemory(vPages.size() * DIRTY_PAGE_SIZE);
+    auto* pMemory = vDirtyPageMemory.data();
+
+    gsl::index nOldIndex = 0;
+    const auto nOldCount = gsl::narrow_cast<gsl::index>(m_vDirtyPages.size());
+    for (const auto nPage : vPages)
+    {
+        while (nOldIndex < nOldCount && m_vDirtyPages.at(nOldIndex).nPage < nPage)
+            ++nOldIndex;
+
+        if (nOldIndex < nOldCount && m_vDirtyPages.at(nOldIndex).nPage == nPage)
+        {
+            // already monitoring the page, keep the existing snapshot
+            vDirtyPages.push_back(m_vDirtyPages.at(nOldIndex));
+            memcpy(pMemory, &m_vDirtyPageMemory.at(nOldIndex * DIRTY_PAGE_SIZE), DIRTY_PAGE_SIZE);
+        }
+        else
+        {
+            // we don't know what the page looked like before now, so report it as modified until the
+            // next call to UpdateDirtyPages
+            vDirtyPages.push_back({ nPage, true });
+            ReadMemory(nPage * DIRTY_PAGE_SIZE, pMemory, DIRTY_PAGE_SIZE);
+        }
+
+        pMemory += DIRTY_PAGE_SIZE;
+    }
+
+    m_vDirtyPages.swap(vDirtyPages);
+    m_vDirtyPageMemory.swap(vDirtyPageMemory);
+}
+
+void EmulatorMemoryContext::StopTrackingDirtyPages() noexcept
+{
+    m_vDirtyPages.clear();
+    m_vDirtyPageMemory.clear();
+    m_vDirtyPageMemory.shrink_to_fit();
+}
+
+void EmulatorMemoryContext::UpdateDirtyPages()
+{
+    std::array<uint8_t, DIRTY_PAGE_SIZE> pBuffer{};
+    auto* pMemory = m_vDirtyPageMemory.data();
+
+    for (auto& pPage : m_vDirtyPages)
+    {
+        ReadMemory(pPage.nPage * DIRTY_PAGE_SIZE, pBuffer.data(), pBuffer.size());
+
+        pPage.bModified = (memcmp(pMemory, pBuffer.data(), DIRTY_PAGE_SIZE) != 0);
+        if (pPage.bModified)
+            memcpy(pMemory, pBuffer.data(), DIRTY_PAGE_SIZE);
+
+        pMemory += DIRTY_PAGE_SIZE;
+    }
+}
+
+bool EmulatorMemoryContext::IsMemoryModified(ra::data::ByteAddress nAddress, uint32_t nBytes) const
+{
+    if (nBytes == 0)
+        return false;
+
+    const auto nFirstPage = nAddress / DIRTY_PAGE_SIZE;
+    const auto nLastPage = (nAddress + nBytes - 1) / DIRTY_PAGE_SIZE;
+
+    auto pIter = std::lower_bound(m_vDirtyPages.begin(), m_vDirtyPages.end(), nFirstPage,
+                                  [](const DirtyPage& pPage, uint32_t nPage) noexcept { return pPage.nPage < nPage; });
+
+    for (auto nPage = nFirstPage; nPage <= nLastPage; ++nPage, ++pIter)
+    {
+        // pages that aren't being monitored may have been modified
+        if (pIter == m_vDirtyPages.end() || pIter->nPage != nPage || pIter->bModified)
+            return true;
+    }
+
+    return false;
+}
+
 _CONSTANT_VAR MAX_BLOCK_SIZE = 256U * 1024; // 256K
 
 void EmulatorMemoryContext::CaptureMemory(std::vector<ra::data::CapturedMemoryBlock>& vBlocks, ra::data::ByteAddress nAddress, uint32_t nCount, uint32_t nPadding) const
 {
+    const auto nFirstNewBlock = vBlocks.size();
     ra::data::ByteAddress nAdjustedAddress = nAddress;
     for (const auto& pMemoryBlock : m_vMemoryBlocks)
     {
@@ -559,7 +948,7 @@ void EmulatorMemoryContext::CaptureMemory(std::vector<ra::data::CapturedMemoryBl
             continue;
         }
 
-        if (!pMemoryBlock.read && !pMemoryBlock.readBlock)
+        if (!pMemoryBlock.read && !pMemoryBlock.readBlock && !pMemoryBlock.data)
         {
             nCount -= gsl::narrow_cast<uint32_t>(pMemoryBlock.size);
             nAddress += gsl::narrow_cast<ra::data::ByteAddress>(pMemoryBlock.size);
@@ -589,11 +978,18 @@ void EmulatorMemoryContext::CaptureMemory(std::vector<ra::data::CapturedMemoryBl
             }
 
             Expects(pBlock != nullptr);
-            const auto nRead = ReadMemory(nAdjustedAddress, pBlock->GetBytes(), nBlockSize, pMemoryBlock, false);
-            if (nRead == 0)
-                vBlocks.pop_back();
+            if (pMemoryBlock.data && nAdjustedAddress + pBlock->GetBytesSize() <= pMemoryBlock.size)
+            {
+                // memory is directly accessible (including the padding). only copy it if an identical
+                // block hasn't already been captured.
+                pBlock->CopyBytes(pMemoryBlock.data + nAdjustedAddress);
+            }
             else
-                pBlock->OptimizeMemory(vBlocks);
+            {
+                const auto nRead = ReadMemory(nAdjustedAddress, pBlock->GetBytes(), nBlockSize, pMemoryBlock, false);
+                if (nRead == 0)
+                    vBlocks.pop_back();
+            }
 
             nAddress += nBlockSize;
             nAdjustedAddress += nBlockSize;
@@ -608,18 +1004,27 @@ void EmulatorMemoryContext::CaptureMemory(std::vector<ra::data::CapturedMemoryBl
 
     if (nPadding)
     {
-        // copy the first four bytes of each block to the last four bytes of the previous
-        // block to cover the overlap
+        // copy the first nPadding bytes of each block to the last nPadding bytes of the
+        // previous block to cover the overlap
         for (size_t i = 1; i < vBlocks.size(); ++i)
         {
             auto& pDstBlock = vBlocks.at(i - 1);
-            // ASSERT: pDstBlock->GetBytes() is a size that's a multiple of 4 even if
-            //         pDstBlock->GetBytesSize() is not.
-            auto* pDstBytes = pDstBlock.GetBytes() + (pDstBlock.GetBytesSize() & ~3);
-            const auto* pSrcBytes = vBlocks.at(i).GetBytes();
-            memcpy(pDstBytes, pSrcBytes, 4);
+            const auto& pSrcBlock = vBlocks.at(i);
+            const auto nOverlap = std::min(nPadding, pSrcBlock.GetBytesSize());
+            const auto nOverlapOffset = pDstBlock.GetBytesSize() - nOverlap;
+
+            // blocks copied directly from host memory already have their padding. don't unshare them.
+            if (memcmp(std::as_const(pDstBlock).GetBytes().Data() + nOverlapOffset, pSrcBlock.GetBytes().Data(), nOverlap) == 0)
+                continue;
+
+            memcpy(pDstBlock.GetBytes() + nOverlapOffset, pSrcBlock.GetBytes().Data(), nOverlap);
         }
     }
+
+    // share the captured memory with any identical blocks from this or previous captures. has to be
+    // done after the padding is populated as shared memory can't be modified.
+    for (auto nIndex = nFirstNewBlock; nIndex < vBlocks.size(); ++nIndex)
+        vBlocks.at(nIndex).OptimizeMemory();
 }
 
 } // namespace impl
@@ -32,6 +32,16 @@ public:
     /// </summary>
     void AddMemoryBlockReader(gsl::index nIndex, MemoryReadBlockFunction pReader);
 
+    /// <summary>
+    /// Specifies the host memory backing a memory block. Reads from the memory block will copy directly
+    /// from the host memory instead of calling the read functions.
+    /// </summary>
+    /// <remarks>
+    /// Only valid if the emulator's read function for the memory block returns bytes from the host memory
+    /// without side effects. Writes still go through the write function.
+    /// </remarks>
+    void AddMemoryBlockPointer(gsl::index nIndex, const uint8_t* pMemory);
+
     /// <summary>
     /// Clears all registered memory blocks so they can be rebuilt.
     /// </summary>
@@ -107,8 +117,119 @@ public:
     /// </summary>
     bool IsMemoryInsecure() const override;
 
+    /// <summary>
+    /// Starts monitoring the pages of memory containing the specified ranges for modifications. Pages that are
+    /// already being monitored retain their state. Pages that don't contain any of the ranges stop being monitored.
+    /// </summary>
+    void TrackDirtyPages(const std::vector<std::pair<ra::data::ByteAddress, uint32_t>>& vRanges) override;
+
+    /// <summary>
+    /// Stops monitoring memory for modifications.
+    /// </summary>
+    void StopTrackingDirtyPages() noexcept override;
+
+    /// <summary>
+    /// Reads the monitored pages and determines which have been modified since the previous call.
+    /// </summary>
+    void UpdateDirtyPages() override;
+
+    /// <summary>
+    /// Determines if any memory in the specified range was modified prior to the most recent call to
+    /// <see cref="UpdateDirtyPages" />. Memory that is not being monitored is always considered modified.
+    /// </summary>
+    bool IsMemoryModified(ra::data::ByteAddress nAddress, uint32_t nBytes) const override;
+
+    static constexpr uint32_t DIRTY_PAGE_SIZE = 4096;
+
+    /// <summary>
+    /// Starts caching memory reads. Memory is assumed to only change through <see cref="WriteMemory" /> until
+    /// <see cref="EndCachingReads" /> is called.
+    /// </summary>
+    /// <remarks>
+    /// Used while processing a frame so each consumer doesn't have to call back into the emulator for the same memory.
+    /// </remarks>
+    void BeginCachingReads();
+
+    /// <summary>
+    /// Stops caching memory reads and discards any cached memory.
+    /// </summary>
+    void EndCachingReads();
+
+    // small enough that most memory blocks start and end on a page boundary, large enough to keep the table small
+    static constexpr uint32_t MEMORY_PAGE_SIZE = 0x400;
+
+    /// <summary>
+    /// Reads a 1, 2, or 4 byte little-endian value from memory.
+    /// </summary>
+    /// <remarks>
+    /// Used by rc_peek_callback for every memory reference it's asked to read. Memory that is directly accessible
+    /// is read from the page table without any virtual calls.
+    /// </remarks>
+    uint32_t PeekMemory(ra::data::ByteAddress nAddress, uint32_t nBytes) const
+    {
+        const auto nPage = nAddress / MEMORY_PAGE_SIZE;
+        const auto nOffset = nAddress % MEMORY_PAGE_SIZE;
+        if (nPage < m_vMemoryPages.size() && nOffset + nBytes <= MEMORY_PAGE_SIZE)
+        {
+            GSL_SUPPRESS_BOUNDS4 const auto* pData = m_vMemoryPages[nPage].pData;
+            if (pData)
+            {
+                AssertIsOnDoFrameThread();
+
+                pData += nOffset;
+                switch (nBytes)
+                {
+                    case 1:
+                        return pData[0];
+                    case 2:
+                        return pData[0] | (pData[1] << 8);
+                    case 4:
+                        return pData[0] | (pData[1] << 8) | (pData[2] << 16) | (pData[3] << 24);
+                    default:
+                        return 0U;
+                }
+            }
+        }
+
+        return PeekMemoryIndirect(nAddress, nBytes);
+    }
+
+    /// <summary>
+    /// Reads memory into a buffer.
+    /// </summary>
+    /// <returns>Number of bytes read.</returns>
+    /// <remarks>
+    /// Used by the rc_client read memory callback. Reads that stay within a directly accessible page are copied
+    /// from the page table without any virtual calls.
+    /// </remarks>
+    uint32_t PeekMemory(ra::data::ByteAddress nAddress, uint8_t pBuffer[], uint32_t nCount) const
+    {
+        const auto nPage = nAddress / MEMORY_PAGE_SIZE;
+        const auto nOffset = nAddress % MEMORY_PAGE_SIZE;
+        if (nPage < m_vMemoryPages.size() && nOffset + nCount <= MEMORY_PAGE_SIZE)
+        {
+            GSL_SUPPRESS_BOUNDS4 const auto* pData = m_vMemoryPages[nPage].pData;
+            if (pData)
+            {
+                AssertIsOnDoFrameThread();
+
+                memcpy(pBuffer, pData + nOffset, nCount);
+                return nCount;
+            }
+        }
+
+        return ReadMemory(nAddress, pBuffer, nCount);
+    }
+
 private:
     void WriteMemory(ra::data::ByteAddress nAddress, const uint8_t* pBytes, size_t nByteCount) const;
+    void BuildMemoryPages();
+    gsl::index FindMemoryBlock(ra::data::ByteAddress nAddress, ra::data::ByteAddress& nBlockAddress) const noexcept;
+    const uint8_t* GetDirectMemory(ra::data::ByteAddress nAddress, size_t nCount) const noexcept;
+    uint32_t PeekMemoryIndirect(ra::data::ByteAddress nAddress, uint32_t nBytes) const;
+    uint32_t ReadMemoryUncached(ra::data::ByteAddress nAddress, uint8_t pBuffer[], size_t nCount) const;
+    const uint8_t* GetCachedPage(ra::data::ByteAddress nAddress, size_t nCount) const;
+    void InvalidateReadCache() const;
 
 protected:
     void OnTotalMemorySizeChanged();
@@ -122,14 +243,39 @@ protected:
         MemoryReadFunction* read;
         MemoryWriteFunction* write;
         MemoryReadBlockFunction* readBlock;
+        const uint8_t* data;
     };
     static uint32_t ReadMemory(ra::data::ByteAddress nAddress, uint8_t pBuffer[], size_t nCount, const MemoryBlock& pBlock, bool bFill = true);
 
     std::vector<MemoryBlock> m_vMemoryBlocks;
     size_t m_nTotalMemorySize = 0U;
+
+    // maps each MEMORY_PAGE_SIZE page of memory to the block containing it so reads don't have to walk
+    // m_vMemoryBlocks. rebuilt whenever the blocks change.
+    struct MemoryPage
+    {
+        const uint8_t* pData;   // host memory for the page, nullptr if the page isn't entirely in host memory
+        uint32_t nBlockIndex;   // index of the block containing the first byte of the page
+        uint32_t nBlockAddress; // address of the first byte of the page relative to the block
+    };
+    std::vector<MemoryPage> m_vMemoryPages;
     mutable bool m_bMemoryModified = false;
     mutable bool m_bMemoryInsecure = false;
     mutable std::chrono::steady_clock::time_point m_tLastInsecureCheck{};
+
+    struct DirtyPage
+    {
+        uint32_t nPage;
+        bool bModified;
+    };
+    std::vector<DirtyPage> m_vDirtyPages; // sorted by nPage
+    std::vector<uint8_t> m_vDirtyPageMemory; // DIRTY_PAGE_SIZE bytes for each item in m_vDirtyPages
+
+    bool m_bCachingReads = false;
+    mutable std::vector<uint32_t> m_vReadCacheIndex; // for each page of memory, 0 if not cached, otherwise slot+1
+    mutable std::vector<uint32_t> m_vReadCachePages; // pages with non-zero entries in m_vReadCacheIndex
+    mutable std::vector<uint8_t> m_vReadCacheMemory;
+    mutable std::vector<uint64_t> m_vReadCacheValid; // for each slot, a bit for each byte that has been read
 };
 
 } // namespace impl
@@ -1,8 +1,44 @@
 #include "CapturedMemoryBlock.hh"
 
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
 namespace ra {
 namespace data {
 
+// content-addressed table of every uncompressed AllocatedMemory that can be shared, keyed by size and hash.
+struct CapturedMemoryBlock::SharedMemoryStore
+{
+    std::mutex mtxMemory;
+    std::unordered_multimap<uint64_t, AllocatedMemory*> mMemory;
+
+    static SharedMemoryStore& Get()
+    {
+        // intentionally leaked so blocks destroyed during shutdown can still unregister themselves
+        static SharedMemoryStore* pStore = new SharedMemoryStore();
+        return *pStore;
+    }
+
+    static uint64_t GetKey(uint32_t nSize, uint32_t nHash) noexcept
+    {
+        return (gsl::narrow_cast<uint64_t>(nSize) << 32) | nHash;
+    }
+
+    void Remove(const AllocatedMemory* pAllocatedMemory, uint32_t nSize) noexcept
+    {
+        const auto pRange = mMemory.equal_range(GetKey(nSize, pAllocatedMemory->nHash));
+        for (auto pIter = pRange.first; pIter != pRange.second; ++pIter)
+        {
+            if (pIter->second == pAllocatedMemory)
+            {
+                mMemory.erase(pIter);
+                break;
+            }
+        }
+    }
+};
+
 CapturedMemoryBlock::CapturedMemoryBlock(const CapturedMemoryBlock& other) noexcept :
     m_nFirstAddress(other.m_nFirstAddress),
     m_nBytesSize(other.m_nBytesSize),
@@ -11,7 +47,8 @@ CapturedMemoryBlock::CapturedMemoryBlock(const CapturedMemoryBlock& other) noexc
 {
     if (IsBytesAllocated())
     {
-        other.m_pAllocatedMemory->nReferenceCount++;
+        // the caller holds a reference, so the memory can't be freed before this one is added
+        other.m_pAllocatedMemory->nReferenceCount.fetch_add(1, std::memory_order_relaxed);
         m_pAllocatedMemory = other.m_pAllocatedMemory;
     }
     else
@@ -19,14 +56,13 @@ CapturedMemoryBlock::CapturedMemoryBlock(const CapturedMemoryBlock& other) noexc
         std::memcpy(m_vBytes, other.m_vBytes, sizeof(m_vBytes));
     }
 
-    m_nMatchingAddressCount = other.m_nMatchingAddressCount;
     if (!AreAllAddressesMatching())
     {
-        if ((m_nMatchingAddressCount + 7) / 8 > sizeof(m_vAddresses))
+        if (IsMatchingAddressesAllocated())
         {
             auto* pAddresses = AllocateMatchingAddresses();
             if (pAddresses != nullptr)
-                std::memcpy(pAddresses, other.m_pAddresses, (m_nMatchingAddressCount + 7) / 8);
+                std::memcpy(pAddresses, other.m_pAddresses, (m_nAddressCount + 7) / 8);
         }
         else
         {
@@ -52,18 +88,14 @@ CapturedMemoryBlock::CapturedMemoryBlock(CapturedMemoryBlock&& other) noexcept :
         std::memcpy(m_vBytes, other.m_vBytes, sizeof(m_vBytes));
     }
 
-    if (!AreAllAddressesMatching())
+    if (IsMatchingAddressesAllocated())
     {
-        if ((m_nMatchingAddressCount + 7) / 8 > sizeof(m_vAddresses))
-        {
-            m_pAddresses = other.m_pAddresses;
-            other.m_pAddresses = nullptr;
-            other.m_nMatchingAddressCount = 0;
-        }
-        else
-        {
-            std::memcpy(m_vAddresses, other.m_vAddresses, sizeof(m_vAddresses));
-        }
+        m_pAddresses = other.m_pAddresses;
+        other.m_pAddresses = nullptr;
+    }
+    else
+    {
+        std::memcpy(m_vAddresses, other.m_vAddresses, sizeof(m_vAddresses));
     }
 }
 
@@ -71,41 +103,134 @@ CapturedMemoryBlock::~CapturedMemoryBlock() noexcept
 {
     if (IsBytesAllocated())
     {
+        ReleaseMemory(m_pAllocatedMemory, m_nBytesSize);
         m_nBytesSize = 0;
-        if (--m_pAllocatedMemory->nReferenceCount == 0)
-            free(m_pAllocatedMemory);
     }
 
-    if (!AreAllAddressesMatching() && (m_nMatchingAddressCount + 7) / 8 > sizeof(m_vAddresses))
-        delete[] m_pAddresses;
+    ReleaseMatchingAddresses();
 }
 
-void CapturedMemoryBlock::ShareMemory(const std::vector<CapturedMemoryBlock>& vBlocks, uint32_t nHash) noexcept
+CapturedMemoryBlock::AllocatedMemory* CapturedMemoryBlock::AllocateMemory(uint32_t nSize) noexcept
 {
-    if (IsBytesAllocated())
+    const auto nAllocSize = sizeof(AllocatedMemory) - sizeof(AllocatedMemory::pBytes) +
+                            ((gsl::narrow_cast<size_t>(nSize) + 3) & ~3);
+    auto* pMemory = malloc(nAllocSize);
+    if (pMemory == nullptr)
+        return nullptr;
+
+    auto* pAllocatedMemory = new (pMemory) AllocatedMemory;
+    pAllocatedMemory->nReferenceCount.store(1, std::memory_order_relaxed);
+    pAllocatedMemory->nHash = 0;
+    pAllocatedMemory->nCompressedSize = 0;
+    pAllocatedMemory->bShared.store(false, std::memory_order_relaxed);
+    return pAllocatedMemory;
+}
+
+bool CapturedMemoryBlock::TryAddReference(AllocatedMemory* pAllocatedMemory) noexcept
+{
+    // memory with no references is about to be freed. it's still in the store until the thread
+    // releasing it can acquire the lock, but it can't be claimed.
+    auto nReferenceCount = pAllocatedMemory->nReferenceCount.load(std::memory_order_relaxed);
+    do
     {
-        for (const auto& pBlock : vBlocks)
-        {
-            if (pBlock.m_nBytesSize == m_nBytesSize &&
-                &pBlock != this &&
-                pBlock.m_pAllocatedMemory->nHash == nHash)
-            {
-                if (memcmp(pBlock.m_pAllocatedMemory->pBytes, m_pAllocatedMemory->pBytes, m_nBytesSize) == 0)
-                {
-                    pBlock.m_pAllocatedMemory->nReferenceCount++;
-                    auto* pAllocatedMemory = m_pAllocatedMemory;
-                    m_pAllocatedMemory = pBlock.m_pAllocatedMemory;
+        if (nReferenceCount == 0)
+            return false;
+    } while (!pAllocatedMemory->nReferenceCount.compare_exchange_weak(nReferenceCount, nReferenceCount + 1,
+                                                                     std::memory_order_relaxed));
 
-                    if (--pAllocatedMemory->nReferenceCount == 0)
-                        free(pAllocatedMemory);
+    return true;
+}
 
-                    return;
-                }
-            }
+void CapturedMemoryBlock::ReleaseMemory(AllocatedMemory* pAllocatedMemory, uint32_t nSize) noexcept
+{
+    // acq_rel so everything done with the memory by other references happens before it's freed
+    if (pAllocatedMemory->nReferenceCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    // bShared can only change while a reference is held, so it's stable now
+    if (pAllocatedMemory->bShared.load(std::memory_order_relaxed))
+    {
+        auto& pStore = SharedMemoryStore::Get();
+        std::lock_guard<std::mutex> pLock(pStore.mtxMemory);
+        pStore.Remove(pAllocatedMemory, nSize);
+    }
+
+    free(pAllocatedMemory);
+}
+
+bool CapturedMemoryBlock::AdoptSharedMemory(SharedMemoryStore& pStore, const uint8_t* pBytes, uint32_t nHash) noexcept
+{
+    const auto pRange = pStore.mMemory.equal_range(SharedMemoryStore::GetKey(m_nBytesSize, nHash));
+    for (auto pIter = pRange.first; pIter != pRange.second; ++pIter)
+    {
+        auto* pSharedMemory = pIter->second;
+        if (memcmp(pSharedMemory->pBytes, pBytes, m_nBytesSize) == 0 && TryAddReference(pSharedMemory))
+        {
+            auto* pAllocatedMemory = m_pAllocatedMemory;
+            m_pAllocatedMemory = pSharedMemory;
+
+            // not shared, and can't become shared while the lock is held, so ReleaseMemory won't try to
+            // reacquire the lock
+            ReleaseMemory(pAllocatedMemory, m_nBytesSize);
+            return true;
         }
+    }
 
-        m_pAllocatedMemory->nHash = nHash;
+    return false;
+}
+
+void CapturedMemoryBlock::ShareMemory(uint32_t nHash) noexcept
+{
+    if (!IsBytesAllocated() || m_pAllocatedMemory->nCompressedSize != 0 || m_pAllocatedMemory->bShared)
+        return;
+
+    auto& pStore = SharedMemoryStore::Get();
+    const auto nKey = SharedMemoryStore::GetKey(m_nBytesSize, nHash);
+
+    std::lock_guard<std::mutex> pLock(pStore.mtxMemory);
+
+    // a copy of this block may have registered the memory since it was checked above
+    if (m_pAllocatedMemory->bShared)
+        return;
+
+    if (AdoptSharedMemory(pStore, m_pAllocatedMemory->pBytes, nHash))
+        return;
+
+    m_pAllocatedMemory->nHash = nHash;
+    m_pAllocatedMemory->bShared = true;
+    pStore.mMemory.emplace(nKey, m_pAllocatedMemory);
+}
+
+void CapturedMemoryBlock::UnshareMemory() noexcept
+{
+    auto* pSharedMemory = m_pAllocatedMemory;
+
+    if (pSharedMemory->bShared)
+    {
+        // lookups only add references while holding the lock, so the count can't change from 1 while it's held
+        auto& pStore = SharedMemoryStore::Get();
+        std::lock_guard<std::mutex> pLock(pStore.mtxMemory);
+        if (pSharedMemory->nReferenceCount == 1)
+        {
+            // nothing else is using the memory. just remove it from the store so it can be modified
+            pStore.Remove(pSharedMemory, m_nBytesSize);
+            pSharedMemory->bShared = false;
+            return;
+        }
     }
+    else if (pSharedMemory->nReferenceCount.load(std::memory_order_acquire) == 1)
+    {
+        // only this block has a reference, and a reference is needed to share the memory
+        return;
+    }
+
+    // the memory is being used by other blocks. modify a private copy.
+    auto* pAllocatedMemory = AllocateMemory(m_nBytesSize);
+    Expects(pAllocatedMemory != nullptr);
+    memcpy(&pAllocatedMemory->pBytes[0], &pSharedMemory->pBytes[0], m_nBytesSize);
+
+    m_pAllocatedMemory = pAllocatedMemory;
+    ReleaseMemory(pSharedMemory, m_nBytesSize);
 }
 
 //void CapturedMemoryBlock::SetRepeat(uint32_t nCount, uint32_t nValue) noexcept
@@ -115,15 +240,71 @@ void CapturedMemoryBlock::ShareMemory(const std::vector<CapturedMemoryBlock>& vB
 //    memcpy(&m_vBytes[4], &nValue, 4);
 //}
 
-void CapturedMemoryBlock::OptimizeMemory(const std::vector<CapturedMemoryBlock>& vBlocks) noexcept
+// FNV-1a over 32-bit words. the hash is used to find matches across every captured block, so
+// it has to distinguish blocks better than a simple XOR (which cancels out repeated values).
+static uint32_t HashBytes(const uint8_t* pBytes, uint32_t nSize) noexcept
+{
+    uint32_t nHash = 2166136261U;
+
+    // the source may not be aligned, so copy each word rather than casting the pointer
+    const auto nWordsSize = nSize & ~3;
+    for (uint32_t nIndex = 0; nIndex < nWordsSize; nIndex += 4)
+    {
+        uint32_t nWord;
+        memcpy(&nWord, pBytes + nIndex, sizeof(nWord));
+        nHash = (nHash ^ nWord) * 16777619U;
+    }
+
+    // an allocation is padded to a multiple of four bytes, but the padding isn't initialized
+    for (auto nIndex = nWordsSize; nIndex < nSize; ++nIndex)
+        nHash = (nHash ^ pBytes[nIndex]) * 16777619U;
+
+    return nHash;
+}
+
+void CapturedMemoryBlock::CopyBytes(const uint8_t* pBytes) noexcept
 {
     if (!IsBytesAllocated())
+    {
+        memcpy(m_vBytes, pBytes, m_nBytesSize);
         return;
+    }
+
+    if (m_pAllocatedMemory->bShared || m_pAllocatedMemory->nCompressedSize != 0 ||
+        m_pAllocatedMemory->nReferenceCount.load(std::memory_order_acquire) != 1)
+    {
+        // the current bytes are being replaced, so don't make a private copy of them
+        ReleaseMemory(m_pAllocatedMemory, m_nBytesSize);
+        m_pAllocatedMemory = AllocateMemory(m_nBytesSize);
+        Expects(m_pAllocatedMemory != nullptr);
+    }
 
-    const auto* pBytes = GetBytes();
+    // hash the source before copying it. if identical memory was already captured, just share that.
+    const auto nHash = HashBytes(pBytes, m_nBytesSize);
+    {
+        auto& pStore = SharedMemoryStore::Get();
+        std::lock_guard<std::mutex> pLock(pStore.mtxMemory);
+        if (AdoptSharedMemory(pStore, pBytes, nHash))
+            return;
+    }
+
+    // copy outside the lock. ShareMemory will check again in case another thread registered a match.
+    memcpy(&m_pAllocatedMemory->pBytes[0], pBytes, m_nBytesSize);
+    ShareMemory(nHash);
+}
+
+void CapturedMemoryBlock::OptimizeMemory() noexcept
+{
+    if (!IsBytesAllocated() || m_pAllocatedMemory->bShared || m_pAllocatedMemory->nCompressedSize != 0)
+        return;
+
+    // the bytes are only read. don't make a private copy if they're shared with a copy of this block.
+    const auto pBytesView = std::as_const(*this).GetBytes();
+    const auto* pBytes = pBytesView.Data();
     if (!pBytes)
         return;
 
+#ifdef COLLAPSE_FILLED
     GSL_SUPPRESS_TYPE1
     const auto* pStart = reinterpret_cast<const uint32_t*>(pBytes);
     const auto* pScan = pStart;
@@ -131,9 +312,8 @@ void CapturedMemoryBlock::OptimizeMemory(const std::vector<CapturedMemoryBlock>&
         return;
 
     GSL_SUPPRESS_TYPE1
-    const auto* pStop = reinterpret_cast<const uint32_t*>(pBytes + GetBytesSize());
+    const auto* pStop = reinterpret_cast<const uint32_t*>(pBytes + (GetBytesSize() & ~3));
 
-#ifdef COLLAPSE_FILLED
     // TODO: this attempts to identify large chunks of repeated data to avoid
     //       allocating AllocatedMemory for them. However, that breaks anything
     //       trying to read from the GetBytes() pointer, so its unfeasible at this time.
@@ -217,21 +397,209 @@ void CapturedMemoryBlock::OptimizeMemory(const std::vector<CapturedMemoryBlock>&
         return;
     }
 #else
-    uint32_t nHash = *pScan++;
-    while (pScan < pStop)
-        nHash ^= *pScan++;
+    const auto nHash = HashBytes(pBytes, GetBytesSize());
 #endif
 
-    ShareMemory(vBlocks, nHash);
+    ShareMemory(nHash);
+}
+
+// run-length encoding: a control byte of 0x00-0x7F is followed by (control + 1) literal bytes. a control byte of
+// 0x80-0xFF is followed by a single byte that is repeated (control - 0x80 + MIN_REPEAT) times.
+_CONSTANT_VAR MIN_REPEAT = 3U;
+_CONSTANT_VAR MAX_REPEAT = 0x7FU + MIN_REPEAT;
+_CONSTANT_VAR MAX_LITERAL = 0x80U;
+
+// returns the number of bytes written to pOutput, or 0 if the encoded data would not fit in nMaxOutputSize bytes.
+static uint32_t EncodeRunLength(const uint8_t* pInput, uint32_t nInputSize, uint8_t* pOutput,
+                                uint32_t nMaxOutputSize) noexcept
+{
+    uint32_t nOutputSize = 0;
+    uint32_t nLiteralStart = 0;
+    uint32_t nIndex = 0;
+
+    const auto FlushLiterals = [pInput, pOutput, nMaxOutputSize, &nOutputSize](uint32_t nStart, uint32_t nStop) noexcept {
+        while (nStart < nStop)
+        {
+            const auto nCount = std::min(nStop - nStart, MAX_LITERAL);
+            if (nOutputSize + nCount + 1 > nMaxOutputSize)
+                return false;
+
+            pOutput[nOutputSize++] = gsl::narrow_cast<uint8_t>(nCount - 1);
+            memcpy(&pOutput[nOutputSize], &pInput[nStart], nCount);
+            nOutputSize += nCount;
+            nStart += nCount;
+        }
+
+        return true;
+    };
+
+    while (nIndex < nInputSize)
+    {
+        const auto nValue = pInput[nIndex];
+        uint32_t nRepeat = 1;
+        while (nIndex + nRepeat < nInputSize && pInput[nIndex + nRepeat] == nValue && nRepeat < MAX_REPEAT)
+            ++nRepeat;
+
+        if (nRepeat < MIN_REPEAT)
+        {
+            nIndex += nRepeat;
+            continue;
+        }
+
+        if (!FlushLiterals(nLiteralStart, nIndex))
+            return 0;
+
+        if (nOutputSize + 2 > nMaxOutputSize)
+            return 0;
+
+        pOutput[nOutputSize++] = gsl::narrow_cast<uint8_t>(0x80 + nRepeat - MIN_REPEAT);
+        pOutput[nOutputSize++] = nValue;
+
+        nIndex += nRepeat;
+        nLiteralStart = nIndex;
+    }
+
+    if (!FlushLiterals(nLiteralStart, nInputSize))
+        return 0;
+
+    return nOutputSize;
+}
+
+static void DecodeRunLength(const uint8_t* pInput, uint32_t nInputSize, uint8_t* pOutput, uint32_t nOutputSize) noexcept
+{
+    uint32_t nInputIndex = 0;
+    uint32_t nOutputIndex = 0;
+    while (nInputIndex < nInputSize)
+    {
+        const auto nControl = pInput[nInputIndex++];
+        if (nControl < 0x80)
+        {
+            const auto nCount = std::min(gsl::narrow_cast<uint32_t>(nControl) + 1, nOutputSize - nOutputIndex);
+            memcpy(&pOutput[nOutputIndex], &pInput[nInputIndex], nCount);
+            nInputIndex += nControl + 1;
+            nOutputIndex += nCount;
+        }
+        else
+        {
+            const auto nCount = std::min(nControl - 0x80 + MIN_REPEAT, nOutputSize - nOutputIndex);
+            memset(&pOutput[nOutputIndex], pInput[nInputIndex++], nCount);
+            nOutputIndex += nCount;
+        }
+    }
+}
+
+void CapturedMemoryBlock::CompressBytes() noexcept
+{
+    if (!IsBytesAllocated() || m_pAllocatedMemory->nCompressedSize != 0)
+        return;
+
+    // only worth doing if it saves at least a quarter of the memory
+    const auto nMaxCompressedSize = m_nBytesSize - (m_nBytesSize / 4);
+    auto pBuffer = std::unique_ptr<uint8_t[]>(new (std::nothrow) uint8_t[nMaxCompressedSize]);
+    if (pBuffer == nullptr)
+        return;
+
+    const auto nCompressedSize = EncodeRunLength(&m_pAllocatedMemory->pBytes[0], m_nBytesSize, pBuffer.get(),
+                                                 nMaxCompressedSize);
+    if (nCompressedSize == 0)
+        return;
+
+    auto* pCompressedMemory = AllocateMemory(nCompressedSize);
+    if (pCompressedMemory == nullptr)
+        return;
+
+    pCompressedMemory->nCompressedSize = nCompressedSize;
+    memcpy(&pCompressedMemory->pBytes[0], pBuffer.get(), nCompressedSize);
+
+    ReleaseMemory(m_pAllocatedMemory, m_nBytesSize);
+
+    m_pAllocatedMemory = pCompressedMemory;
+}
+
+void CapturedMemoryBlock::DecompressBytes() noexcept
+{
+    if (!IsBytesAllocated() || m_pAllocatedMemory->nCompressedSize == 0)
+        return;
+
+    auto* pAllocatedMemory = AllocateMemory(m_nBytesSize);
+    Expects(pAllocatedMemory != nullptr);
+
+    DecodeRunLength(&m_pAllocatedMemory->pBytes[0], m_pAllocatedMemory->nCompressedSize,
+                    &pAllocatedMemory->pBytes[0], m_nBytesSize);
+
+    ReleaseMemory(m_pAllocatedMemory, m_nBytesSize);
+
+    m_pAllocatedMemory = pAllocatedMemory;
+}
+
+// the most recently decoded compressed memory for a thread. compressed memory is never modified, and the cache holds
+// a reference to it so it can't be freed and reallocated for something else while the decoded bytes are cached.
+// the decoded memory is only reused for another block if no BytesView still references it.
+struct CapturedMemoryBlock::DecompressedMemoryCache
+{
+    AllocatedMemory* pCompressedMemory = nullptr;
+    AllocatedMemory* pDecompressedMemory = nullptr;
+    uint32_t nSize = 0;
+
+    DecompressedMemoryCache() noexcept = default;
+    ~DecompressedMemoryCache() noexcept
+    {
+        if (pCompressedMemory != nullptr)
+            ReleaseMemory(pCompressedMemory, nSize);
+        if (pDecompressedMemory != nullptr)
+            ReleaseMemory(pDecompressedMemory, nSize);
+    }
+
+    DecompressedMemoryCache(const DecompressedMemoryCache&) noexcept = delete;
+    DecompressedMemoryCache& operator=(const DecompressedMemoryCache&) noexcept = delete;
+    DecompressedMemoryCache(DecompressedMemoryCache&&) noexcept = delete;
+    DecompressedMemoryCache& operator=(DecompressedMemoryCache&&) noexcept = delete;
+};
+
+CapturedMemoryBlock::BytesView CapturedMemoryBlock::GetDecompressedBytes() const noexcept
+{
+    static thread_local DecompressedMemoryCache pCache;
+    if (pCache.pCompressedMemory != m_pAllocatedMemory)
+    {
+        if (pCache.pCompressedMemory != nullptr)
+        {
+            ReleaseMemory(pCache.pCompressedMemory, pCache.nSize);
+            pCache.pCompressedMemory = nullptr;
+        }
+
+        // acquire so a view released on another thread has finished reading before the memory is overwritten
+        if (pCache.pDecompressedMemory != nullptr && (pCache.nSize != m_nBytesSize ||
+            pCache.pDecompressedMemory->nReferenceCount.load(std::memory_order_acquire) != 1))
+        {
+            ReleaseMemory(pCache.pDecompressedMemory, pCache.nSize);
+            pCache.pDecompressedMemory = nullptr;
+        }
+
+        if (pCache.pDecompressedMemory == nullptr)
+        {
+            pCache.pDecompressedMemory = AllocateMemory(m_nBytesSize);
+            Expects(pCache.pDecompressedMemory != nullptr);
+        }
+
+        DecodeRunLength(&m_pAllocatedMemory->pBytes[0], m_pAllocatedMemory->nCompressedSize,
+                        &pCache.pDecompressedMemory->pBytes[0], m_nBytesSize);
+
+        // the caller holds a reference, so the memory can't be freed before this one is added
+        m_pAllocatedMemory->nReferenceCount.fetch_add(1, std::memory_order_relaxed);
+        pCache.pCompressedMemory = m_pAllocatedMemory;
+        pCache.nSize = m_nBytesSize;
+    }
+
+    pCache.pDecompressedMemory->nReferenceCount.fetch_add(1, std::memory_order_relaxed);
+    return BytesView(pCache.pDecompressedMemory, m_nBytesSize);
 }
 
 uint8_t* CapturedMemoryBlock::AllocateMatchingAddresses() noexcept
 {
-    const auto nAddressesSize = (m_nAddressCount + 7) / 8;
-    if (nAddressesSize > sizeof(m_vAddresses))
+    if (IsMatchingAddressesAllocated())
     {
         if (m_pAddresses == nullptr)
-            m_pAddresses = new (std::nothrow) uint8_t[nAddressesSize];
+            m_pAddresses = new (std::nothrow) uint8_t[(m_nAddressCount + 7) / 8];
 
         return m_pAddresses;
     }
@@ -239,9 +607,64 @@ uint8_t* CapturedMemoryBlock::AllocateMatchingAddresses() noexcept
     return &m_vAddresses[0];
 }
 
-void CapturedMemoryBlock::SetMatchingAddresses(std::vector<ra::data::ByteAddress>& vAddresses, gsl::index nFirstIndex, gsl::index nLastIndex)
+void CapturedMemoryBlock::ReleaseMatchingAddresses() noexcept
 {
-    m_nMatchingAddressCount = gsl::narrow_cast<unsigned int>(nLastIndex - nFirstIndex) + 1;
+    // the allocation is kept when all addresses match again, so it has to be released regardless
+    if (IsMatchingAddressesAllocated())
+        delete[] m_pAddresses;
+
+    memset(m_vAddresses, 0, sizeof(m_vAddresses));
+}
+
+static uint32_t CountBits(uint32_t nBits) noexcept
+{
+    nBits = nBits - ((nBits >> 1) & 0x55555555);
+    nBits = (nBits & 0x33333333) + ((nBits >> 2) & 0x33333333);
+    return (((nBits + (nBits >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+// reads up to eight bits from a bitmap starting at an arbitrary bit
+static uint8_t ReadBits(const uint8_t* pBits, uint32_t nIndex, uint32_t nCount) noexcept
+{
+    const uint8_t* pByte = pBits + (nIndex >> 3);
+    const auto nShift = nIndex & 7;
+
+    uint32_t nValue = pByte[0] >> nShift;
+    if (nShift != 0 && nCount > 8 - nShift)
+        nValue |= gsl::narrow_cast<uint32_t>(pByte[1]) << (8 - nShift);
+
+    if (nCount < 8)
+        nValue &= (1U << nCount) - 1;
+
+    return gsl::narrow_cast<uint8_t>(nValue);
+}
+
+void CapturedMemoryBlock::SetMatchingAddresses(const uint8_t* pMatches, ra::data::ByteAddress nMatchesFirstAddress,
+    ra::data::ByteAddress nFirstMatchingAddress, ra::data::ByteAddress nLastMatchingAddress)
+{
+    Expects(pMatches != nullptr);
+    Expects(nMatchesFirstAddress <= m_nFirstAddress && m_nFirstAddress <= nFirstMatchingAddress);
+
+    const auto nFirstIndex = m_nFirstAddress - nMatchesFirstAddress;
+    const auto nStartOffset = nFirstMatchingAddress - m_nFirstAddress;
+    const auto nStopOffset = std::min(nLastMatchingAddress - m_nFirstAddress + 1, m_nAddressCount);
+    const auto nMatchesSize = (nStopOffset + 7) / 8;
+
+    // the block may start before the first matching address (i.e. upper nibble). ignore anything before it.
+    const auto GetMatchingBits = [pMatches, nFirstIndex, nStartOffset, nStopOffset](uint32_t nIndex) noexcept {
+        const auto nOffset = nIndex * 8;
+        auto nBits = ReadBits(pMatches, nFirstIndex + nOffset, nStopOffset - nOffset);
+        if (nOffset < nStartOffset)
+            nBits &= (nStartOffset - nOffset < 8) ? gsl::narrow_cast<uint8_t>(0xFF << (nStartOffset - nOffset)) : 0;
+
+        return nBits;
+    };
+
+    uint32_t nMatchingAddressCount = 0;
+    for (uint32_t nIndex = 0; nIndex < nMatchesSize; ++nIndex)
+        nMatchingAddressCount += CountBits(GetMatchingBits(nIndex));
+
+    m_nMatchingAddressCount = nMatchingAddressCount;
 
     if (m_nMatchingAddressCount != m_nAddressCount)
     {
@@ -250,15 +673,8 @@ void CapturedMemoryBlock::SetMatchingAddresses(std::vector<ra::data::ByteAddress
         Expects(pAddresses != nullptr);
 
         memset(pAddresses, 0, nAddressesSize);
-        for (gsl::index nIndex = nFirstIndex; nIndex <= nLastIndex; ++nIndex)
-        {
-            const auto nOffset = vAddresses.at(nIndex) - m_nFirstAddress;
-            if (nOffset < m_nAddressCount)
-            {
-                const auto nBit = 1 << (nOffset & 7);
-                pAddresses[nOffset >> 3] |= nBit;
-            }
-        }
+        for (uint32_t nIndex = 0; nIndex < nMatchesSize; ++nIndex)
+            pAddresses[nIndex] = GetMatchingBits(nIndex);
     }
 }
 
@@ -293,7 +709,7 @@ void CapturedMemoryBlock::ExcludeMatchingAddress(ra::data::ByteAddress nAddress)
     }
     else
     {
-        pAddresses = (nAddressesSize > sizeof(m_vAddresses)) ? m_pAddresses : &m_vAddresses[0];
+        pAddresses = IsMatchingAddressesAllocated() ? m_pAddresses : &m_vAddresses[0];
         Expects(pAddresses != nullptr);
         if (!(pAddresses[nIndex >> 3] & nBit))
             return;
@@ -335,8 +751,7 @@ ra::data::ByteAddress CapturedMemoryBlock::GetMatchingAddress(gsl::index nIndex)
     if (AreAllAddressesMatching())
         return m_nFirstAddress + gsl::narrow_cast<ra::data::ByteAddress>(nIndex);
 
-    const auto nAddressesSize = (m_nAddressCount + 7) / 8;
-    const uint8_t* pAddresses = (nAddressesSize > sizeof(m_vAddresses)) ? m_pAddresses : &m_vAddresses[0];
+    const uint8_t* pAddresses = GetMatchingAddressPointer();
     ra::data::ByteAddress nAddress = m_nFirstAddress;
     const ra::data::ByteAddress nStop = m_nFirstAddress + m_nAddressCount;
     uint8_t nMask = 0x01;
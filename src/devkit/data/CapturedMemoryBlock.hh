@@ -6,16 +6,29 @@
 
 #include "util/GSL.hh"
 
+#include <atomic>
+
 namespace ra {
 namespace data {
 
+/// <summary>
+/// A copy of a range of memory, and the addresses within it that match the current search.
+/// </summary>
+/// <remarks>
+/// Captured bytes are shared by copies of a block and by blocks with identical contents (see
+/// <see cref="OptimizeMemory" />). Shared bytes are never modified - the non-const <see cref="GetBytes" /> makes a
+/// private copy first. So blocks that share bytes may be read, copied, and destroyed on different threads. The const
+/// accessors never modify the block, so a single block may also be read by multiple threads at the same time.
+/// </remarks>
 class CapturedMemoryBlock
 {
 private:
     struct AllocatedMemory
     {
-        uint32_t nReferenceCount;
+        std::atomic<uint32_t> nReferenceCount;
         uint32_t nHash;
+        uint32_t nCompressedSize; // non-zero if pBytes contains run-length encoded data
+        std::atomic<bool> bShared; // true if registered in the SharedMemoryStore
         uint8_t pBytes[16]; // this will actually be sized by the allocation code.
     };
 
@@ -28,12 +41,8 @@ public:
     {
         if (IsBytesAllocated()) // not actually allocated yet, but about to be.
         {
-            const auto nAllocSize = sizeof(AllocatedMemory) - sizeof(m_pAllocatedMemory->pBytes) +
-                                    ((gsl::narrow_cast<size_t>(nSize) + 3) & ~3);
-            m_pAllocatedMemory = static_cast<AllocatedMemory*>(malloc(nAllocSize));
+            m_pAllocatedMemory = AllocateMemory(nSize);
             Expects(m_pAllocatedMemory != nullptr);
-            m_pAllocatedMemory->nReferenceCount = 1;
-            m_pAllocatedMemory->nHash = 0;
         }
     }
 
@@ -47,19 +56,119 @@ public:
     /// <summary>
     /// Gets the raw bytes that were captured.
     /// </summary>
+    /// <remarks>
+    /// Decompresses the bytes if <see cref="CompressBytes" /> was called. If the bytes are being shared
+    /// with a copy of this block or by <see cref="OptimizeMemory" />, a private copy is made so they can
+    /// be modified.
+    /// </remarks>
     uint8_t* GetBytes() noexcept
     {
-        return IsBytesAllocated() ? &m_pAllocatedMemory->pBytes[0] : &m_vBytes[0];
+        if (!IsBytesAllocated())
+            return &m_vBytes[0];
+
+        if (m_pAllocatedMemory->nCompressedSize != 0)
+            DecompressBytes();
+        else if (m_pAllocatedMemory->bShared || m_pAllocatedMemory->nReferenceCount != 1)
+            UnshareMemory();
+
+        return &m_pAllocatedMemory->pBytes[0];
     }
 
+    /// <summary>
+    /// Read-only access to the captured bytes, as returned by the const <see cref="GetBytes" />.
+    /// </summary>
+    /// <remarks>
+    /// If the block is compressed, the view holds a reference to the decoded bytes, so they remain valid for as long
+    /// as the view exists, even if other compressed blocks are read in the meantime. Otherwise, the view points at
+    /// the bytes of the block, and is only valid until the block is modified.
+    /// </remarks>
+    class BytesView
+    {
+    public:
+        BytesView() noexcept = default;
+
+        BytesView(BytesView&& other) noexcept :
+            m_pBytes(other.m_pBytes),
+            m_pDecompressedMemory(other.m_pDecompressedMemory),
+            m_nSize(other.m_nSize)
+        {
+            other.m_pDecompressedMemory = nullptr;
+        }
+
+        ~BytesView() noexcept
+        {
+            if (m_pDecompressedMemory != nullptr)
+                ReleaseMemory(m_pDecompressedMemory, m_nSize);
+        }
+
+        BytesView(const BytesView&) noexcept = delete;
+        BytesView& operator=(const BytesView&) noexcept = delete;
+        BytesView& operator=(BytesView&&) noexcept = delete;
+
+        /// <summary>
+        /// Gets a pointer to the first captured byte.
+        /// </summary>
+        const uint8_t* Data() const noexcept { return m_pBytes; }
+
+    private:
+        friend class CapturedMemoryBlock;
+
+        explicit BytesView(const uint8_t* pBytes) noexcept : m_pBytes(pBytes) {}
+
+        BytesView(AllocatedMemory* pDecompressedMemory, uint32_t nSize) noexcept :
+            m_pBytes(&pDecompressedMemory->pBytes[0]),
+            m_pDecompressedMemory(pDecompressedMemory),
+            m_nSize(nSize)
+        {
+        }
+
+        const uint8_t* m_pBytes = nullptr;
+        AllocatedMemory* m_pDecompressedMemory = nullptr; // holds a reference if not null
+        uint32_t m_nSize = 0;
+    };
+
     /// <summary>
     /// Gets the raw bytes that were captured.
     /// </summary>
-    const uint8_t* GetBytes() const noexcept
+    /// <remarks>
+    /// If <see cref="CompressBytes" /> was called, the bytes are decoded and the block is left compressed. Each
+    /// thread keeps the most recently decoded block, so reading the same block repeatedly only decodes it once.
+    /// Call <see cref="DecompressBytes" /> first if the block will be read frequently.
+    /// </remarks>
+    BytesView GetBytes() const noexcept
     {
-        return IsBytesAllocated() ? &m_pAllocatedMemory->pBytes[0] : &m_vBytes[0];
+        if (!IsBytesAllocated())
+            return BytesView(&m_vBytes[0]);
+
+        if (m_pAllocatedMemory->nCompressedSize != 0)
+            return GetDecompressedBytes();
+
+        return BytesView(&m_pAllocatedMemory->pBytes[0]);
     }
 
+    /// <summary>
+    /// Run-length encodes the captured bytes if doing so would save a meaningful amount of memory.
+    /// </summary>
+    /// <remarks>
+    /// Intended for blocks that aren't expected to be accessed frequently. The bytes will be decompressed
+    /// the next time the non-const <see cref="GetBytes" /> or <see cref="DecompressBytes" /> is called.
+    /// </remarks>
+    void CompressBytes() noexcept;
+
+    /// <summary>
+    /// Restores the captured bytes if they were compressed by <see cref="CompressBytes" />.
+    /// </summary>
+    /// <remarks>
+    /// Called implicitly by the non-const <see cref="GetBytes" />. Copies of the block still share the compressed
+    /// bytes, and will each decompress their own copy unless <see cref="OptimizeMemory" /> is called afterwards.
+    /// </remarks>
+    void DecompressBytes() noexcept;
+
+    /// <summary>
+    /// Determines whether the captured bytes are currently compressed.
+    /// </summary>
+    bool IsCompressed() const noexcept { return IsBytesAllocated() && m_pAllocatedMemory->nCompressedSize != 0; }
+
     /// <summary>
     /// Gets the number of captured bytes.
     /// </summary>
@@ -93,6 +202,9 @@ public:
     /// </summary>
     void SetAddressCount(uint32_t nAddressCount) noexcept
     { 
+        // where the matching addresses are stored depends on the address count
+        ReleaseMatchingAddresses();
+
         m_nAddressCount = nAddressCount; 
         m_nMatchingAddressCount = nAddressCount;
     }
@@ -118,9 +230,14 @@ public:
     bool ContainsMatchingAddress(ByteAddress nAddress) const;
 
     /// <summary>
-    /// Specifies which addresses are matching from a slice of an address list.
+    /// Specifies which addresses are matching from a slice of a bitmap.
     /// </summary>
-    void SetMatchingAddresses(std::vector<ByteAddress>& vAddresses, gsl::index nFirstIndex, gsl::index nLastIndex);
+    /// <param name="pMatches">A bitmap where bit N indicates address nMatchesFirstAddress + N is matching.</param>
+    /// <param name="nMatchesFirstAddress">The address represented by the first bit of the bitmap.</param>
+    /// <param name="nFirstMatchingAddress">The first address to copy from the bitmap.</param>
+    /// <param name="nLastMatchingAddress">The last address to copy from the bitmap.</param>
+    void SetMatchingAddresses(const uint8_t* pMatches, ByteAddress nMatchesFirstAddress,
+                              ByteAddress nFirstMatchingAddress, ByteAddress nLastMatchingAddress);
 
     /// <summary>
     /// Marks an address as no longer matching.
@@ -143,8 +260,7 @@ public:
         if (AreAllAddressesMatching())
             return nullptr;
 
-        const auto nAddressesSize = (m_nAddressCount + 7) / 8;
-        return (nAddressesSize > sizeof(m_vAddresses)) ? m_pAddresses : &m_vAddresses[0];
+        return IsMatchingAddressesAllocated() ? m_pAddresses : &m_vAddresses[0];
     }
 
     /// <summary>
@@ -167,18 +283,44 @@ public:
     }
 
     /// <summary>
-    /// Attempts to minimize memory allocations by detecting and sharing large blocks of repeated data.
+    /// Attempts to minimize memory allocations by sharing the captured bytes with any other
+    /// <see cref="CapturedMemoryBlock" /> (from this or any other capture) that has identical contents.
     /// </summary>
-    /// <param name="vBlocks">A collection of previously captured memory blocks that could be shared.</param>
-    void OptimizeMemory(const std::vector<CapturedMemoryBlock>& vBlocks) noexcept;
+    /// <remarks>
+    /// Should be called after the captured bytes have been populated. Costs one hash of the bytes and
+    /// one lookup in a shared table.
+    /// </remarks>
+    void OptimizeMemory() noexcept;
+
+    /// <summary>
+    /// Populates the captured bytes from <paramref name="pBytes" />.
+    /// </summary>
+    /// <remarks>
+    /// The source is hashed before it's copied. If any <see cref="CapturedMemoryBlock" /> already has identical
+    /// contents, its bytes are shared and nothing is copied. Otherwise, the bytes are copied and made available for
+    /// sharing as if <see cref="OptimizeMemory" /> had been called.
+    /// </remarks>
+    void CopyBytes(const uint8_t* pBytes) noexcept;
 
 private:
+    struct SharedMemoryStore;
+    struct DecompressedMemoryCache;
+
     bool IsBytesAllocated() const noexcept { return GetBytesSize() > sizeof(m_vBytes); }
 
-    void ShareMemory(const std::vector<CapturedMemoryBlock>& vBlocks, uint32_t nHash) noexcept;
+    static AllocatedMemory* AllocateMemory(uint32_t nSize) noexcept;
+    BytesView GetDecompressedBytes() const noexcept;
+    void ShareMemory(uint32_t nHash) noexcept;
+    bool AdoptSharedMemory(SharedMemoryStore& pStore, const uint8_t* pBytes, uint32_t nHash) noexcept;
+    void UnshareMemory() noexcept;
+    static bool TryAddReference(AllocatedMemory* pAllocatedMemory) noexcept;
+    static void ReleaseMemory(AllocatedMemory* pAllocatedMemory, uint32_t nSize) noexcept;
     //void SetRepeat(uint32_t nCount, uint32_t nValue) noexcept;
 
+    // the matching addresses are stored in m_vAddresses unless they won't fit
+    bool IsMatchingAddressesAllocated() const noexcept { return (m_nAddressCount + 7) / 8 > sizeof(m_vAddresses); }
     uint8_t* AllocateMatchingAddresses() noexcept;
+    void ReleaseMatchingAddresses() noexcept;
     bool AreAllAddressesMatching() const noexcept { return m_nMatchingAddressCount == m_nAddressCount; }
 
     ByteAddress m_nFirstAddress;     // 4 bytes
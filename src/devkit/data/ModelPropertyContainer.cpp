@@ -5,20 +5,105 @@ namespace data {
 
 std::wstring ModelPropertyContainer::s_sEmpty;
 
-int ModelPropertyContainer::CompareModelPropertyKey(const ModelPropertyContainer::ModelPropertyValue& left, int nKey) noexcept
+const ModelPropertyContainer::ModelPropertyPage* ModelPropertyContainer::FindPage(int nKey) const noexcept
 {
-    return left.nKey < nKey;
+    const auto* pDirectory = m_pDirectory.load(std::memory_order_acquire);
+    if (pDirectory == nullptr)
+        return nullptr;
+
+    const auto nPage = gsl::narrow_cast<size_t>(nKey / PageSize);
+    const auto nCount = pDirectory->nCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        const auto& pEntry = pDirectory->vEntries[i];
+        if (pEntry.nPage == nPage)
+            return pEntry.pPage;
+    }
+
+    return nullptr;
 }
 
-const int* ModelPropertyContainer::FindValue(int nKey) const
+ModelPropertyContainer::ModelPropertyPage& ModelPropertyContainer::GetPage(int nKey)
 {
-    std::lock_guard<std::mutex> pLock(m_mtxData);
+    // caller must hold m_mtxData
+    const auto nPage = gsl::narrow_cast<size_t>(nKey / PageSize);
 
-    const auto iter = std::lower_bound(m_vValues.begin(), m_vValues.end(), nKey, CompareModelPropertyKey);
-    if (iter == m_vValues.end() || iter->nKey != nKey)
-        return nullptr;
+    auto* pDirectory = m_pDirectory.load(std::memory_order_relaxed);
+    const auto nCount = (pDirectory != nullptr) ? pDirectory->nCount.load(std::memory_order_relaxed) : 0U;
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        const auto& pEntry = pDirectory->vEntries[i];
+        if (pEntry.nPage == nPage)
+            return *pEntry.pPage;
+    }
+
+    auto* pPage = m_vPages.emplace_back(std::make_unique<ModelPropertyPage>()).get();
+
+    if (pDirectory == nullptr || nCount == pDirectory->vEntries.size())
+    {
+        auto pNewDirectory = std::make_unique<ModelPropertyDirectory>(std::max<size_t>(nCount * 2, 4U));
+        if (pDirectory != nullptr)
+            std::copy_n(pDirectory->vEntries.begin(), nCount, pNewDirectory->vEntries.begin());
+
+        pNewDirectory->vEntries[nCount] = { nPage, pPage };
+        pNewDirectory->nCount.store(nCount + 1, std::memory_order_relaxed);
+
+        pDirectory = pNewDirectory.get();
+        m_vDirectories.push_back(std::move(pNewDirectory));
+        m_pDirectory.store(pDirectory, std::memory_order_release);
+    }
+    else
+    {
+        // readers don't look past nCount, so the entry can be populated before it's published
+        pDirectory->vEntries[nCount] = { nPage, pPage };
+        pDirectory->nCount.store(nCount + 1, std::memory_order_release);
+    }
+
+    return *pPage;
+}
+
+bool ModelPropertyContainer::FindValue(int nKey, int& nValue) const noexcept
+{
+    const auto* pPage = FindPage(nKey);
+    if (pPage == nullptr)
+        return false;
+
+    const auto nSlot = nKey % PageSize;
+    if ((pPage->nAssigned.load(std::memory_order_acquire) & (1U << nSlot)) == 0)
+        return false;
+
+    nValue = gsl::at(pPage->nValues, nSlot).load(std::memory_order_relaxed);
+    return true;
+}
+
+bool ModelPropertyContainer::UpdateValue(int nKey, int nValue, int nDefaultValue, int& nOldValue)
+{
+    // caller must hold m_mtxData
+    if (!FindValue(nKey, nOldValue))
+    {
+        nOldValue = nDefaultValue;
+        if (nValue == nOldValue)
+            return false;
+    }
+    else if (nValue == nOldValue)
+    {
+        return false;
+    }
+
+    auto& pPage = GetPage(nKey);
+    const auto nSlot = nKey % PageSize;
+    if (nValue == nDefaultValue)
+    {
+        pPage.nAssigned.fetch_and(~(1U << nSlot), std::memory_order_release);
+    }
+    else
+    {
+        // store the value before flagging it as assigned so readers don't see a stale value
+        gsl::at(pPage.nValues, nSlot).store(nValue, std::memory_order_relaxed);
+        pPage.nAssigned.fetch_or(1U << nSlot, std::memory_order_release);
+    }
 
-    return &iter->nValue;
+    return true;
 }
 
 void ModelPropertyContainer::SetValue(const BoolModelProperty& pProperty, bool bValue)
@@ -27,24 +112,9 @@ void ModelPropertyContainer::SetValue(const BoolModelProperty& pProperty, bool b
     {
         std::lock_guard<std::mutex> pLock(m_mtxData);
 
-        auto iter = std::lower_bound(m_vValues.begin(), m_vValues.end(), pProperty.GetKey(), CompareModelPropertyKey);
-        if (iter == m_vValues.end() || iter->nKey != pProperty.GetKey())
-        {
-            if (bValue == pProperty.GetDefaultValue())
-                return;
-
-            m_vValues.emplace(iter, pProperty.GetKey(), nValue);
-        }
-        else
-        {
-            if (nValue == iter->nValue)
-                return;
-
-            if (bValue == pProperty.GetDefaultValue())
-                m_vValues.erase(iter);
-            else
-                iter->nValue = nValue;
-        }
+        int nOldValue = 0;
+        if (!UpdateValue(pProperty.GetKey(), nValue, pProperty.GetDefaultValue() ? 1 : 0, nOldValue))
+            return;
 
 #ifdef _DEBUG
         m_mDebugValues.insert_or_assign(pProperty.GetPropertyName(), bValue ? L"true" : L"false");
@@ -112,8 +182,10 @@ void ModelPropertyContainer::SetValue(const StringModelProperty& pProperty, cons
     {
         std::lock_guard<std::mutex> pLock(m_mtxData);
 
-        auto iter = std::lower_bound(m_vValues.begin(), m_vValues.end(), pProperty.GetKey(), CompareModelPropertyKey);
-        if (iter == m_vValues.end() || iter->nKey != pProperty.GetKey())
+        const auto nKey = pProperty.GetKey();
+        const auto nSlot = nKey % PageSize;
+        int nIndex = 0;
+        if (!FindValue(nKey, nIndex))
         {
             // no entry for property. if setting to default, do nothing
             if (sValue == pProperty.GetDefaultValue())
@@ -132,27 +204,28 @@ void ModelPropertyContainer::SetValue(const StringModelProperty& pProperty, cons
                 nValue = LoadIntoEmptyStringSlot(sValue);
             }
 
-            m_vValues.emplace(iter, pProperty.GetKey(), nValue);
+            auto& pPage = GetPage(nKey);
+            gsl::at(pPage.nValues, nSlot).store(nValue, std::memory_order_relaxed);
+            pPage.nAssigned.fetch_or(1U << nSlot, std::memory_order_release);
             pOldValue = &pProperty.GetDefaultValue();
         }
         else
         {
             pOldValue = &sOldValue;
-            gsl::not_null<std::wstring*> sString = gsl::make_not_null(&sOldValue);
+            auto& pPage = GetPage(nKey);
 
-            if (iter->nValue == -1)
+            if (nIndex == -1)
             {
                 // negative nValue is empty string. if new value is also empty, do nothing
                 if (sValue.empty())
                     return;
 
-                iter->nValue = LoadIntoEmptyStringSlot(sValue);
+                gsl::at(pPage.nValues, nSlot).store(LoadIntoEmptyStringSlot(sValue), std::memory_order_release);
             }
             else
             {
                 // find the current value. if the new value is the same, do nothing
                 ModelPropertyStrings* pStrings = m_pStrings.get();
-                int nIndex = iter->nValue;
                 while (nIndex >= ModelPropertyStrings::ChunkCount && pStrings)
                 {
                     pStrings = pStrings->pNext.get();
@@ -162,7 +235,7 @@ void ModelPropertyContainer::SetValue(const StringModelProperty& pProperty, cons
                 if (pStrings == nullptr)
                     return;
 
-                sString = gsl::make_not_null(&gsl::at(pStrings->sStrings, nIndex));
+                gsl::not_null<std::wstring*> sString = gsl::make_not_null(&gsl::at(pStrings->sStrings, nIndex));
                 if (sValue == *sString)
                     return;
 
@@ -171,8 +244,8 @@ void ModelPropertyContainer::SetValue(const StringModelProperty& pProperty, cons
 
                 if (sValue == pProperty.GetDefaultValue())
                 {
-                    // setting value back to default. eliminate the value pair.
-                    m_vValues.erase(iter);
+                    // setting value back to default. eliminate the value.
+                    pPage.nAssigned.fetch_and(~(1U << nSlot), std::memory_order_release);
                 }
                 else
                 {
@@ -201,26 +274,8 @@ void ModelPropertyContainer::SetValue(const IntModelProperty& pProperty, int nVa
     {
         std::lock_guard<std::mutex> pLock(m_mtxData);
 
-        auto iter = std::lower_bound(m_vValues.begin(), m_vValues.end(), pProperty.GetKey(), CompareModelPropertyKey);
-        if (iter == m_vValues.end() || iter->nKey != pProperty.GetKey())
-        {
-            nOldValue = pProperty.GetDefaultValue();
-            if (nValue == nOldValue)
-                return;
-
-            m_vValues.emplace(iter, pProperty.GetKey(), nValue);
-        }
-        else
-        {
-            nOldValue = iter->nValue;
-            if (nValue == nOldValue)
-                return;
-
-            if (nValue == pProperty.GetDefaultValue())
-                m_vValues.erase(iter);
-            else
-                iter->nValue = nValue;
-        }
+        if (!UpdateValue(pProperty.GetKey(), nValue, pProperty.GetDefaultValue(), nOldValue))
+            return;
 
 #ifdef _DEBUG
         m_mDebugValues.insert_or_assign(pProperty.GetPropertyName(), std::to_wstring(nValue));
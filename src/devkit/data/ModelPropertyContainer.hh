@@ -4,6 +4,8 @@
 
 #include "data/ModelProperty.hh"
 
+#include <array>
+#include <atomic>
 #include <mutex>
 
 namespace ra {
@@ -36,8 +38,8 @@ public:
     /// <returns>The current value of the property for this object.</returns>
     bool GetValue(const BoolModelProperty& pProperty) const
     {
-        const int* pValue = FindValue(pProperty.GetKey());
-        return pValue ? (*pValue != 0) : pProperty.GetDefaultValue();
+        int nValue = 0;
+        return FindValue(pProperty.GetKey(), nValue) ? (nValue != 0) : pProperty.GetDefaultValue();
     }
 
     /// <summary>
@@ -60,11 +62,11 @@ public:
     /// <returns>The current value of the property for this object.</returns>
     const std::wstring& GetValue(const StringModelProperty& pProperty) const
     {
-        const int* pValue = FindValue(pProperty.GetKey());
-        if (pValue == nullptr)
+        int nValue = 0;
+        if (!FindValue(pProperty.GetKey(), nValue))
             return pProperty.GetDefaultValue();
 
-        return GetString(*pValue);
+        return GetString(nValue);
     }
 
     /// <summary>
@@ -87,8 +89,8 @@ public:
     /// <returns>The current value of the property for this object.</returns>
     int GetValue(const IntModelProperty& pProperty) const
     {
-        const int* pValue = FindValue(pProperty.GetKey());
-        return pValue ? *pValue : pProperty.GetDefaultValue();
+        int nValue = 0;
+        return FindValue(pProperty.GetKey(), nValue) ? nValue : pProperty.GetDefaultValue();
     }
 
     /// <summary>
@@ -105,17 +107,36 @@ public:
     virtual void OnValueChanged(const IntModelProperty::ChangeArgs& args) noexcept(false);
 
 private:
-    typedef struct ModelPropertyValue
+    // values are stored in pages of consecutive property keys. the properties of a class are declared together,
+    // so they have consecutive keys and the values for an object are usually spread across only a few pages.
+    // pages are never moved or freed while the container exists, so they can be read without locking.
+    static constexpr int PageSize = 32;
+
+    typedef struct ModelPropertyPage
     {
-        ModelPropertyValue(int nKey, int nValue) noexcept
-            : nKey(nKey), nValue(nValue)
-        {
-        }
+        std::atomic<uint32_t> nAssigned{ 0U }; // one bit for each value that is not the default value
+        std::array<std::atomic<int>, PageSize> nValues{};
+    } ModelPropertyPage;
+    std::vector<std::unique_ptr<ModelPropertyPage>> m_vPages;
+
+    // lists the pages that have been allocated. an object only uses a few pages, so the directory only holds
+    // entries for those rather than a slot for every possible page. entries are only appended, so readers can
+    // scan the first nCount entries without locking. a full directory is replaced by one twice its size, but
+    // the old one is kept until the container is destroyed in case something is still reading it.
+    typedef struct ModelPropertyDirectory
+    {
+        explicit ModelPropertyDirectory(size_t nCapacity) : vEntries(nCapacity) {}
 
-        int nKey;
-        int nValue;
-    } ModelPropertyValue;
-    std::vector<ModelPropertyValue> m_vValues;
+        typedef struct Entry
+        {
+            size_t nPage = 0U;
+            ModelPropertyPage* pPage = nullptr;
+        } Entry;
+        std::vector<Entry> vEntries;
+        std::atomic<size_t> nCount{ 0U }; // number of entries in vEntries that have been populated
+    } ModelPropertyDirectory;
+    std::vector<std::unique_ptr<ModelPropertyDirectory>> m_vDirectories;
+    std::atomic<ModelPropertyDirectory*> m_pDirectory{ nullptr };
 
     typedef struct ModelPropertyStrings
     {
@@ -135,8 +156,10 @@ private:
 
     static std::wstring s_sEmpty;
 
-    static int CompareModelPropertyKey(const ModelPropertyValue& left, int nKey) noexcept;
-    const int* FindValue(int nKey) const;
+    const ModelPropertyPage* FindPage(int nKey) const noexcept;
+    ModelPropertyPage& GetPage(int nKey);
+    bool FindValue(int nKey, int& nValue) const noexcept;
+    bool UpdateValue(int nKey, int nValue, int nDefaultValue, int& nOldValue);
     const std::wstring& GetString(int nIndex) const noexcept;
     int LoadIntoEmptyStringSlot(const std::wstring& sValue);
 
@@ -56,6 +56,10 @@ void AchievementModel::Deactivate()
 
 void AchievementModel::OnValueChanged(const IntModelProperty::ChangeArgs& args)
 {
+    // the state may no longer match the runtime. resync it on the next frame.
+    if (args.Property == StateProperty)
+        m_pSyncedRuntimeTrigger = nullptr;
+
     // if we're still loading the asset, ignore the event. we'll get recalled once loading finishes
     if (!IsUpdating())
     {
@@ -176,7 +180,18 @@ bool AchievementModel::ValidateAsset(std::wstring& sError)
 void AchievementModel::DoFrame()
 {
     if (m_pAchievementInfo && m_pAchievementInfo->trigger)
-        SyncStateFromRuntime(m_pAchievementInfo->trigger->state);
+    {
+        // SetState goes through the property container. only call it if the runtime state has changed.
+        const auto* pTrigger = m_pAchievementInfo->trigger;
+        const auto nState = pTrigger->state;
+        if (pTrigger != m_pSyncedRuntimeTrigger || nState != m_nSyncedRuntimeState)
+        {
+            SyncStateFromRuntime(nState);
+
+            m_pSyncedRuntimeTrigger = pTrigger;
+            m_nSyncedRuntimeState = nState;
+        }
+    }
 }
 
 void AchievementModel::SyncStateFromRuntime(uint8_t nState)
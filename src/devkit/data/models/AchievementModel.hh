@@ -229,6 +229,10 @@ private:
     // the current achievement information
     struct rc_client_achievement_info_t* m_pAchievementInfo = nullptr;
 
+    // the runtime state that was last synced to the model. see DoFrame
+    const struct rc_trigger_t* m_pSyncedRuntimeTrigger = nullptr;
+    uint8_t m_nSyncedRuntimeState = 0;
+
     // the original achievement information received from the server
     const struct rc_client_achievement_info_t* m_pPublishedAchievementInfo = nullptr;
 
@@ -26,17 +26,21 @@ GameAssets::~GameAssets() noexcept
 
 ra::data::models::AssetModelBase* GameAssets::FindAsset(ra::data::models::AssetType nType, uint32_t nId)
 {
-    for (auto& pAsset : *this)
-    {
-        if (pAsset.GetID() == nId && pAsset.GetType() == nType)
-            return &pAsset;
-    }
-
-    return nullptr;
+    GSL_SUPPRESS_TYPE3 return const_cast<ra::data::models::AssetModelBase*>(std::as_const(*this).FindAsset(nType, nId));
 }
 
 const ra::data::models::AssetModelBase* GameAssets::FindAsset(ra::data::models::AssetType nType, uint32_t nId) const
 {
+    if (!IsUpdating())
+    {
+        const auto pIter = m_mAssetIndex.find(GetAssetKey(nType, nId));
+        if (pIter == m_mAssetIndex.end())
+            return nullptr;
+
+        return pIter->second;
+    }
+
+    // the index isn't maintained while updating. it's rebuilt when the update completes.
     for (const auto& pAsset : *this)
     {
         if (pAsset.GetID() == nId && pAsset.GetType() == nType)
@@ -46,6 +50,31 @@ const ra::data::models::AssetModelBase* GameAssets::FindAsset(ra::data::models::
     return nullptr;
 }
 
+void GameAssets::IndexAsset(ra::data::models::AssetModelBase& pAsset, uint32_t nId)
+{
+    // if multiple assets share a type and ID, the first one in the collection is the one that's found.
+    // new items are always added after existing items, so don't replace an existing entry.
+    const auto pResult = m_mAssetIndex.emplace(GetAssetKey(pAsset.GetType(), nId), &pAsset);
+    if (!pResult.second && pResult.first->second != &pAsset)
+        m_bAssetIndexHasDuplicates = true;
+}
+
+void GameAssets::UnindexAsset(const ra::data::models::AssetModelBase& pAsset, uint32_t nId)
+{
+    const auto pIter = m_mAssetIndex.find(GetAssetKey(pAsset.GetType(), nId));
+    if (pIter != m_mAssetIndex.end() && pIter->second == &pAsset)
+        m_mAssetIndex.erase(pIter);
+}
+
+void GameAssets::RebuildAssetIndex()
+{
+    m_mAssetIndex.clear();
+    m_bAssetIndexHasDuplicates = false;
+
+    for (auto& pAsset : *this)
+        IndexAsset(pAsset, pAsset.GetID());
+}
+
 ra::data::models::AssetCategory GameAssets::MostPublishedAssetCategory() const
 {
     bool bHasLocalAssets = false;
@@ -101,6 +130,8 @@ void GameAssets::OnModelValueChanged(gsl::index nIndex, const BoolModelProperty:
             m_vPauseOnResetAchievementIds.erase(nId);
         else
             m_vPauseOnResetAchievementIds.insert(nId);
+
+        m_bPauseOnXAssetsStale = true;
     }
 
     ra::data::DataModelCollection<ra::data::models::AssetModelBase>::OnModelValueChanged(nIndex, args);
@@ -108,7 +139,21 @@ void GameAssets::OnModelValueChanged(gsl::index nIndex, const BoolModelProperty:
 
 void GameAssets::OnModelValueChanged(gsl::index nIndex, const IntModelProperty::ChangeArgs& args)
 {
-    if (args.Property == ra::data::models::LeaderboardModel::PauseOnResetProperty)
+    if (args.Property == ra::data::models::AssetModelBase::IDProperty)
+    {
+        auto* pAsset = GetItemAt(nIndex);
+        if (pAsset != nullptr && !IsUpdating())
+        {
+            UnindexAsset(*pAsset, ra::to_unsigned(args.tOldValue));
+            if (m_bAssetIndexHasDuplicates)
+                RebuildAssetIndex();
+            else
+                IndexAsset(*pAsset, ra::to_unsigned(args.tNewValue));
+        }
+
+        m_bPauseOnXAssetsStale = true;
+    }
+    else if (args.Property == ra::data::models::LeaderboardModel::PauseOnResetProperty)
     {
         const auto nId = GetItemValue(nIndex, ra::data::models::AssetModelBase::IDProperty);
 
@@ -116,6 +161,8 @@ void GameAssets::OnModelValueChanged(gsl::index nIndex, const IntModelProperty::
             m_vPauseOnResetLeaderboardIds.erase(nId);
         else
             m_vPauseOnResetLeaderboardIds.insert(nId);
+
+        m_bPauseOnXAssetsStale = true;
     }
     else if (args.Property == ra::data::models::LeaderboardModel::PauseOnTriggerProperty)
     {
@@ -125,6 +172,8 @@ void GameAssets::OnModelValueChanged(gsl::index nIndex, const IntModelProperty::
             m_vPauseOnTriggerLeaderboardIds.erase(nId);
         else
             m_vPauseOnTriggerLeaderboardIds.insert(nId);
+
+        m_bPauseOnXAssetsStale = true;
     }
     else if (args.Property == ra::data::models::AssetModelBase::SubsetIDProperty ||
              args.Property == ra::data::models::AssetModelBase::CategoryProperty)
@@ -143,34 +192,58 @@ bool GameAssets::HasPauseOnXAssets() const noexcept
         !m_vPauseOnTriggerLeaderboardIds.empty();
 }
 
-void GameAssets::GetPauseOnResetAchievements(std::vector<const ra::data::models::AchievementModel*>& vAchievements) const
+void GameAssets::UpdatePauseOnXAssets() const
 {
+    m_vPauseOnResetAchievements.clear();
     for (const auto nId : m_vPauseOnResetAchievementIds)
     {
         const auto* vmAchievement = FindAchievement(nId);
         if (vmAchievement != nullptr)
-            vAchievements.push_back(vmAchievement);
+            m_vPauseOnResetAchievements.push_back(vmAchievement);
     }
-}
 
-void GameAssets::GetPauseOnResetLeaderboards(std::vector<const ra::data::models::LeaderboardModel*>& vLeaderboards) const
-{
+    m_vPauseOnResetLeaderboards.clear();
     for (const auto nId : m_vPauseOnResetLeaderboardIds)
     {
         const auto* vmLeaderboard = FindLeaderboard(nId);
         if (vmLeaderboard != nullptr)
-            vLeaderboards.push_back(vmLeaderboard);
+            m_vPauseOnResetLeaderboards.push_back(vmLeaderboard);
     }
-}
 
-void GameAssets::GetPauseOnTriggerLeaderboards(std::vector<const ra::data::models::LeaderboardModel*>& vLeaderboards) const
-{
+    m_vPauseOnTriggerLeaderboards.clear();
     for (const auto nId : m_vPauseOnTriggerLeaderboardIds)
     {
         const auto* vmLeaderboard = FindLeaderboard(nId);
         if (vmLeaderboard != nullptr)
-            vLeaderboards.push_back(vmLeaderboard);
+            m_vPauseOnTriggerLeaderboards.push_back(vmLeaderboard);
     }
+
+    // items added while updating can't be tracked until the update completes. keep resolving them until then.
+    m_bPauseOnXAssetsStale = IsUpdating();
+}
+
+const std::vector<const ra::data::models::AchievementModel*>& GameAssets::GetPauseOnResetAchievements() const
+{
+    if (m_bPauseOnXAssetsStale)
+        UpdatePauseOnXAssets();
+
+    return m_vPauseOnResetAchievements;
+}
+
+const std::vector<const ra::data::models::LeaderboardModel*>& GameAssets::GetPauseOnResetLeaderboards() const
+{
+    if (m_bPauseOnXAssetsStale)
+        UpdatePauseOnXAssets();
+
+    return m_vPauseOnResetLeaderboards;
+}
+
+const std::vector<const ra::data::models::LeaderboardModel*>& GameAssets::GetPauseOnTriggerLeaderboards() const
+{
+    if (m_bPauseOnXAssetsStale)
+        UpdatePauseOnXAssets();
+
+    return m_vPauseOnTriggerLeaderboards;
 }
 
 void GameAssets::OnBeforeItemRemoved(ModelBase& pModel)
@@ -200,11 +273,24 @@ void GameAssets::OnBeforeItemRemoved(ModelBase& pModel)
         }
     }
 
+    if (!IsUpdating())
+    {
+        const auto* pAsset = dynamic_cast<const ra::data::models::AssetModelBase*>(&pModel);
+        if (pAsset)
+            UnindexAsset(*pAsset, pAsset->GetID());
+    }
+
+    m_bPauseOnXAssetsStale = true;
+
     ra::data::DataModelCollection<ra::data::models::AssetModelBase>::OnBeforeItemRemoved(pModel);
 }
 
 void GameAssets::OnItemsRemoved(const std::vector<gsl::index>& vDeletedIndices)
 {
+    // another asset with the same type and ID as a removed asset may need to take its place in the index
+    if (m_bAssetIndexHasDuplicates && !IsUpdating())
+        RebuildAssetIndex();
+
     if (m_pPublishedSubsets != nullptr) // assets previously sync'd, resync them
         SyncAssetsToRuntime();
 
@@ -213,12 +299,41 @@ void GameAssets::OnItemsRemoved(const std::vector<gsl::index>& vDeletedIndices)
 
 void GameAssets::OnItemsAdded(const std::vector<gsl::index>& vNewIndices)
 {
+    if (!IsUpdating())
+    {
+        for (const auto nIndex : vNewIndices)
+        {
+            auto* pAsset = GetItemAt(nIndex);
+            if (pAsset != nullptr)
+                IndexAsset(*pAsset, pAsset->GetID());
+        }
+    }
+
+    m_bPauseOnXAssetsStale = true;
+
     if (m_pPublishedSubsets != nullptr) // assets previously sync'd, resync them
         SyncAssetsToRuntime();
 
     ra::data::DataModelCollection<ra::data::models::AssetModelBase>::OnItemsAdded(vNewIndices);
 }
 
+void GameAssets::OnEndUpdate()
+{
+    // changes to items that were moved while updating aren't reported, so an item may have been moved, given a
+    // new ID, and even removed without the index knowing. rebuild it before anything else can use it.
+    RebuildAssetIndex();
+    m_bPauseOnXAssetsStale = true;
+
+    ra::data::DataModelCollection<ra::data::models::AssetModelBase>::OnEndUpdate();
+}
+
+void GameAssets::OnItemsChanged(const std::vector<gsl::index>& vChangedIndices)
+{
+    m_bPauseOnXAssetsStale = true;
+
+    ra::data::DataModelCollection<ra::data::models::AssetModelBase>::OnItemsChanged(vChangedIndices);
+}
+
 void GameAssets::ReloadAssets(const std::vector<ra::data::models::AssetModelBase*>& vAssetsToReload)
 {
     if (AchievementSets().Count() == 0) // server assets haven't been loaded yet
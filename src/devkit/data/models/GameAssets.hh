@@ -12,6 +12,7 @@
 #include "data/models/RichPresenceModel.hh"
 
 #include <set>
+#include <unordered_map>
 
 struct rc_api_fetch_game_sets_response_t;
 struct rc_client_subset_info_t;
@@ -185,17 +186,17 @@ public:
     /// <summary>
     /// Gets the achievements where PauseOnReset is set.
     /// </summary>
-    void GetPauseOnResetAchievements(std::vector<const ra::data::models::AchievementModel*>& vAchievements) const;
+    const std::vector<const ra::data::models::AchievementModel*>& GetPauseOnResetAchievements() const;
 
     /// <summary>
     /// Gets the leaderboards where PauseOnReset is set.
     /// </summary>
-    void GetPauseOnResetLeaderboards(std::vector<const ra::data::models::LeaderboardModel*>& vLeaderboards) const;
+    const std::vector<const ra::data::models::LeaderboardModel*>& GetPauseOnResetLeaderboards() const;
 
     /// <summary>
     /// Gets the leaderboards where PauseOnTrigger is set.
     /// </summary>
-    void GetPauseOnTriggerLeaderboards(std::vector<const ra::data::models::LeaderboardModel*>& vLeaderboards) const;
+    const std::vector<const ra::data::models::LeaderboardModel*>& GetPauseOnTriggerLeaderboards() const;
 
     /// <summary>
     /// Syncs the collection into the runtime.
@@ -224,6 +225,8 @@ protected:
     void OnBeforeItemRemoved(ModelBase& pModel) override;
     void OnItemsRemoved(const std::vector<gsl::index>& vDeletedIndices) override;
     void OnItemsAdded(const std::vector<gsl::index>& vNewIndices) override;
+    void OnItemsChanged(const std::vector<gsl::index>& vChangedIndices) override;
+    void OnEndUpdate() override;
 
     uint32_t m_nNextLocalId = FirstLocalId;
 
@@ -233,6 +236,28 @@ protected:
     std::set<uint32_t> m_vPauseOnResetAchievementIds;
     std::set<uint32_t> m_vPauseOnResetLeaderboardIds;
     std::set<uint32_t> m_vPauseOnTriggerLeaderboardIds;
+
+private:
+    static constexpr uint64_t GetAssetKey(ra::data::models::AssetType nType, uint32_t nId) noexcept
+    {
+        return (gsl::narrow_cast<uint64_t>(ra::etoi(nType)) << 32) | nId;
+    }
+
+    void IndexAsset(ra::data::models::AssetModelBase& pAsset, uint32_t nId);
+    void UnindexAsset(const ra::data::models::AssetModelBase& pAsset, uint32_t nId);
+    void RebuildAssetIndex();
+    void UpdatePauseOnXAssets() const;
+
+    // maps GetAssetKey(type, id) to the first asset in the collection with that type and id.
+    // not maintained while the collection is being updated. rebuilt when the update completes.
+    std::unordered_map<uint64_t, ra::data::models::AssetModelBase*> m_mAssetIndex;
+    bool m_bAssetIndexHasDuplicates = false;
+
+    // resolved from the m_vPauseOnXIds sets by UpdatePauseOnXAssets
+    mutable std::vector<const ra::data::models::AchievementModel*> m_vPauseOnResetAchievements;
+    mutable std::vector<const ra::data::models::LeaderboardModel*> m_vPauseOnResetLeaderboards;
+    mutable std::vector<const ra::data::models::LeaderboardModel*> m_vPauseOnTriggerLeaderboards;
+    mutable bool m_bPauseOnXAssetsStale = false;
 };
 
 } // namespace models
@@ -51,6 +51,10 @@ void LeaderboardModel::Deactivate()
 
 void LeaderboardModel::OnValueChanged(const IntModelProperty::ChangeArgs& args)
 {
+    // the state may no longer match the runtime. resync it on the next frame.
+    if (args.Property == StateProperty)
+        m_pSyncedRuntimeLeaderboard = nullptr;
+
     // if we're still loading the asset, ignore the event. we'll get recalled once loading finishes
     if (!IsUpdating())
     {
@@ -157,7 +161,18 @@ bool LeaderboardModel::ValidateAsset(std::wstring& sError)
 void LeaderboardModel::DoFrame()
 {
     if (m_pLeaderboardInfo && m_pLeaderboardInfo->lboard)
-        SyncStateFromRuntime(m_pLeaderboardInfo->lboard->state);
+    {
+        // SetState goes through the property container. only call it if the runtime state has changed.
+        const auto* pLeaderboard = m_pLeaderboardInfo->lboard;
+        const auto nState = pLeaderboard->state;
+        if (pLeaderboard != m_pSyncedRuntimeLeaderboard || nState != m_nSyncedRuntimeState)
+        {
+            SyncStateFromRuntime(nState);
+
+            m_pSyncedRuntimeLeaderboard = pLeaderboard;
+            m_nSyncedRuntimeState = nState;
+        }
+    }
 }
 
 void LeaderboardModel::SyncStateFromRuntime(uint8_t nState)
@@ -246,6 +246,10 @@ private:
     // the current leaderboard information
     struct rc_client_leaderboard_info_t* m_pLeaderboardInfo = nullptr;
 
+    // the runtime state that was last synced to the model. see DoFrame
+    const struct rc_lboard_t* m_pSyncedRuntimeLeaderboard = nullptr;
+    uint8_t m_nSyncedRuntimeState = 0;
+
     // the original leaderboard information received from the server
     const struct rc_client_leaderboard_info_t* m_pPublishedLeaderboardInfo = nullptr;
 
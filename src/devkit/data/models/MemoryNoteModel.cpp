@@ -90,14 +90,15 @@ static ra::data::ByteAddress ConvertPointer(ra::data::ByteAddress nAddress)
     return nAddress;
 }
 
-void MemoryNoteModel::UpdateRawPointerValue(ra::data::ByteAddress nAddress, const ra::context::IEmulatorMemoryContext& pMemoryContext,
+bool MemoryNoteModel::UpdateRawPointerValue(ra::data::ByteAddress nAddress, const ra::context::IEmulatorMemoryContext& pMemoryContext,
                                           NoteMovedFunction fNoteMovedCallback)
 {
     if (m_pPointerData == nullptr)
-        return;
+        return false;
 
     m_pPointerData->PointerRead = true;
 
+    bool bMoved = false;
     const uint32_t nValue = pMemoryContext.ReadMemory(nAddress, GetMemSize());
     if (nValue != m_pPointerData->RawPointerValue)
     {
@@ -110,6 +111,8 @@ void MemoryNoteModel::UpdateRawPointerValue(ra::data::ByteAddress nAddress, cons
         if (nNewAddress != nOldAddress)
         {
             m_pPointerData->PointerAddress = nNewAddress;
+            bMoved = true;
+
             if (fNoteMovedCallback)
             {
                 for (const auto& pNote : m_pPointerData->OffsetNotes)
@@ -127,11 +130,16 @@ void MemoryNoteModel::UpdateRawPointerValue(ra::data::ByteAddress nAddress, cons
         {
             if (pNote.IsPointer())
             {
-                pNote.UpdateRawPointerValue(m_pPointerData->PointerAddress + pNote.GetAddress(),
-                                            pMemoryContext, fNoteMovedCallback);
+                if (pNote.UpdateRawPointerValue(m_pPointerData->PointerAddress + pNote.GetAddress(),
+                                                pMemoryContext, fNoteMovedCallback))
+                {
+                    bMoved = true;
+                }
             }
         }
     }
+
+    return bMoved;
 }
 
 const MemoryNoteModel* MemoryNoteModel::GetPointerNoteAtOffset(int nOffset) const
@@ -115,7 +115,8 @@ public:
     /// <param name="nAddress">The address of the pointer data. For root pointers, this will be the note's address. For nested pointers, it will be the note's offset + the parent pointer's value.</param>
     /// <param name="pMemoryContext">Where to read the new value from.</param>
     /// <param name="fNoteMovedCallback">Function to call if the PointerAddress changes.</param>
-    void UpdateRawPointerValue(ra::data::ByteAddress nAddress, const ra::context::IEmulatorMemoryContext& pMemoryContext, NoteMovedFunction fNoteMovedCallback);
+    /// <returns><c>true</c> if the PointerAddress of the note, or of any nested pointer, changed.</returns>
+    bool UpdateRawPointerValue(ra::data::ByteAddress nAddress, const ra::context::IEmulatorMemoryContext& pMemoryContext, NoteMovedFunction fNoteMovedCallback);
 
     /// <summary>
     /// Gets the last known value of the pointer.
@@ -5,6 +5,7 @@
 
 #include "services/ServiceLocator.hh"
 #include "services/IMessageDispatcher.hh"
+#include "services/ParallelPartitions.hh"
 
 #include "util/Strings.hh"
 
@@ -27,6 +28,15 @@ void MemoryNotesModel::Refresh(unsigned int nGameId,
     m_vMemoryNotes.clear();
     m_bHasPointers = false;
 
+    {
+        std::unique_lock<std::mutex> lock(m_oPointerIndexMutex);
+        m_vPointerNoteRanges.clear();
+        m_vLargePointerNoteRanges.clear();
+        m_vPointerNoteFields.clear();
+        m_mPointerNoteIndexEntries.clear();
+        m_nMaxPointerNoteRangeSize = 0;
+    }
+
     if (nGameId == 0)
     {
         m_fMemoryNoteChanged = nullptr;
@@ -66,26 +76,15 @@ void MemoryNotesModel::Refresh(unsigned int nGameId,
         }
         else
         {
+            std::vector<ServerMemoryNote> vNotes;
+            vNotes.reserve(response.num_notes);
+
             const auto* pNote = response.notes;
             const auto* pStop = pNote + response.num_notes;
             for (; pNote < pStop; ++pNote)
-            {
-                auto sNote = ra::util::String::Widen(pNote->note);
-                ra::util::String::NormalizeLineEndings(sNote);
-
-                {
-                    std::unique_lock<std::mutex> lock(m_oMutex);
-                    const auto pIter = m_mOriginalNotes.find(pNote->address);
-                    if (pIter != m_mOriginalNotes.end())
-                    {
-                        pIter->second.first = pNote->author;
-                        pIter->second.second = sNote;
-                        continue;
-                    }
-                }
-
-                AddMemoryNote(pNote->address, pNote->author, sNote);
-            }
+                vNotes.push_back({ pNote->address, pNote->author, pNote->note });
+
+            AddServerMemoryNotes(vNotes);
         }
 
         rc_api_destroy_fetch_code_notes_response(&response);
@@ -132,17 +131,122 @@ void MemoryNotesModel::AddMemoryNote(ra::data::ByteAddress nAddress, const std::
     if (bIsPointer && !m_bRefreshing)
         m_bHasPointers = true;
 
+    bool bWasPointer = false;
     {
         std::unique_lock<std::mutex> lock(m_oMutex);
         auto iter = std::lower_bound(m_vMemoryNotes.begin(), m_vMemoryNotes.end(), nAddress, CompareNoteAddresses);
         if (iter != m_vMemoryNotes.end() && (*iter)->GetAddress() == note->GetAddress())
+        {
+            bWasPointer = (*iter)->IsPointer();
             iter->swap(note);
+        }
         else
+        {
             m_vMemoryNotes.insert(iter, std::move(note));
+        }
     }
 
     OnMemoryNoteChanged(nAddress, sNote);
 
+    // the pointer may be read while the change is being handled, so don't index it until afterward
+    if (bIsPointer || bWasPointer)
+        IndexPointerNote(nAddress, FindMemoryNoteModel(nAddress, false));
+
+    // MemoryNoteChanged events for indirect child notes will be raised by first call to DoFrame
+}
+
+// parsing is the expensive part of loading the notes. only split the work if there's enough of it.
+_CONSTANT_VAR PARALLEL_PARSE_THRESHOLD = 1024U;
+_CONSTANT_VAR PARALLEL_PARSE_PARTITION_SIZE = 256U;
+
+void MemoryNotesModel::AddServerMemoryNotes(const std::vector<ServerMemoryNote>& vNotes)
+{
+    std::vector<std::unique_ptr<MemoryNoteModel>> vNewNotes(vNotes.size());
+    auto fParseNotes = [&vNotes, &vNewNotes](size_t nFirstNote, size_t nStopNote) {
+        for (auto nIndex = nFirstNote; nIndex < nStopNote; ++nIndex)
+        {
+            const auto& pServerNote = vNotes.at(nIndex);
+            auto sNote = ra::util::String::Widen(pServerNote.sNote);
+            ra::util::String::NormalizeLineEndings(sNote);
+
+            auto pNote = std::make_unique<MemoryNoteModel>();
+            pNote->SetAuthor(pServerNote.sAuthor);
+            pNote->SetNote(sNote);
+            pNote->SetAddress(pServerNote.nAddress);
+            vNewNotes.at(nIndex) = std::move(pNote);
+        }
+    };
+
+    if (vNotes.size() < PARALLEL_PARSE_THRESHOLD)
+    {
+        fParseNotes(0U, vNotes.size());
+    }
+    else
+    {
+        const auto nNotes = vNotes.size();
+        const auto nPartitions = (nNotes + PARALLEL_PARSE_PARTITION_SIZE - 1) / PARALLEL_PARSE_PARTITION_SIZE;
+        ra::services::ProcessPartitions(nPartitions, [&fParseNotes, nNotes](size_t nPartition)
+        {
+            const auto nFirstNote = nPartition * PARALLEL_PARSE_PARTITION_SIZE;
+            fParseNotes(nFirstNote, std::min(nFirstNote + PARALLEL_PARSE_PARTITION_SIZE, nNotes));
+        });
+    }
+
+    // if the server returns multiple notes for an address, the last one wins
+    std::stable_sort(vNewNotes.begin(), vNewNotes.end(),
+        [](const std::unique_ptr<MemoryNoteModel>& pLeft, const std::unique_ptr<MemoryNoteModel>& pRight) noexcept {
+            return pLeft->GetAddress() < pRight->GetAddress();
+        });
+
+    bool bHasPointers = false;
+    {
+        std::unique_lock<std::mutex> lock(m_oMutex);
+
+        std::vector<std::unique_ptr<MemoryNoteModel>> vMemoryNotes;
+        vMemoryNotes.reserve(vNewNotes.size() + m_vMemoryNotes.size());
+
+        auto pExisting = m_vMemoryNotes.begin();
+        for (auto& pNote : vNewNotes)
+        {
+            const auto nAddress = pNote->GetAddress();
+
+            // locally modified notes only need their server state updated
+            const auto pOriginal = m_mOriginalNotes.find(nAddress);
+            if (pOriginal != m_mOriginalNotes.end())
+            {
+                pOriginal->second.first = pNote->GetAuthor();
+                pOriginal->second.second = pNote->GetNote();
+                continue;
+            }
+
+            while (pExisting != m_vMemoryNotes.end() && (*pExisting)->GetAddress() < nAddress)
+                vMemoryNotes.push_back(std::move(*pExisting++));
+            if (pExisting != m_vMemoryNotes.end() && (*pExisting)->GetAddress() == nAddress)
+                ++pExisting;
+
+            bHasPointers |= pNote->IsPointer();
+            if (!vMemoryNotes.empty() && vMemoryNotes.back()->GetAddress() == nAddress)
+                vMemoryNotes.back() = std::move(pNote);
+            else
+                vMemoryNotes.push_back(std::move(pNote));
+        }
+
+        while (pExisting != m_vMemoryNotes.end())
+            vMemoryNotes.push_back(std::move(*pExisting++));
+
+        m_vMemoryNotes.swap(vMemoryNotes);
+    }
+
+    if (bHasPointers && !m_bRefreshing)
+        m_bHasPointers = true;
+
+    RebuildPointerNoteIndex();
+
+    SetValue(ra::data::models::AssetModelBase::ChangesProperty,
+             m_mOriginalNotes.empty() ?
+                 ra::etoi(ra::data::models::AssetChanges::None) :
+                 ra::etoi(ra::data::models::AssetChanges::Unpublished));
+
     // MemoryNoteChanged events for indirect child notes will be raised by first call to DoFrame
 }
 
@@ -184,7 +288,7 @@ ra::data::ByteAddress MemoryNotesModel::FindNoteStart(ra::data::ByteAddress nAdd
     // also check for derived memory notes
     if (m_bHasPointers)
     {
-        for (const auto& pNote : m_vMemoryNotes)
+        for (const auto* pNote : FindPointerNotesContaining(nAddress))
         {
             const auto pair = pNote->GetPointerNoteAtAddress(nAddress);
             if (pair.second != nullptr)
@@ -266,7 +370,7 @@ std::wstring MemoryNotesModel::FindNote(ra::data::ByteAddress nAddress, Memory::
     // no memory note on the address, check for pointers
     if (m_bHasPointers)
     {
-        for (const auto& pMemoryNote2 : m_vMemoryNotes)
+        for (const auto* pMemoryNote2 : FindPointerNotesContaining(nAddress))
         {
             const auto pair = pMemoryNote2->GetPointerNoteAtAddress(nAddress);
             if (pair.second != nullptr)
@@ -274,7 +378,7 @@ std::wstring MemoryNotesModel::FindNote(ra::data::ByteAddress nAddress, Memory::
         }
 
         const auto nLastAddress = nAddress + nCheckBytes - 1;
-        for (const auto& pMemoryNote2 : m_vMemoryNotes)
+        for (const auto* pMemoryNote2 : FindPointerNotesContaining(nLastAddress))
         {
             const auto pair = pMemoryNote2->GetPointerNoteAtAddress(nLastAddress);
             if (pair.second != nullptr)
@@ -343,6 +447,9 @@ void MemoryNotesModel::SetNote(ra::data::ByteAddress nAddress, const std::wstrin
             {
                 // note didn't originally exist, don't keep a modification record if the
                 // changes were discarded.
+                if ((*pIter)->IsPointer())
+                    IndexPointerNote(nAddress, nullptr);
+
                 m_vMemoryNotes.erase(pIter);
                 OnMemoryNoteChanged(nAddress, sNote);
                 return;
@@ -376,7 +483,7 @@ const MemoryNoteModel* MemoryNotesModel::FindMemoryNoteModel(ra::data::ByteAddre
 std::pair<ra::data::ByteAddress, const MemoryNoteModel*>
     MemoryNotesModel::FindIndirectMemoryNoteInternal(ra::data::ByteAddress nAddress) const
 {
-    for (const auto& pMemoryNote : m_vMemoryNotes)
+    for (const auto* pMemoryNote : FindPointerNotesContaining(nAddress))
     {
         auto pair = pMemoryNote->GetPointerNoteAtAddress(nAddress);
         if (pair.second != nullptr && pair.first == nAddress) // only match start of note
@@ -409,10 +516,23 @@ ra::data::ByteAddress MemoryNotesModel::GetNextNoteAddress(ra::data::ByteAddress
 
     if (m_bHasPointers && bIncludeDerived)
     {
+        // only the pointer notes with a field between the address and the best address found so far
+        // have to be checked. each pointer note only has to be checked once.
         ra::data::ByteAddress nNextAddress = 0U;
-        for (const auto& pNote : m_vMemoryNotes)
+        std::vector<ra::data::ByteAddress> vCheckedNotes;
+
+        std::unique_lock<std::mutex> lock(m_oPointerIndexMutex);
+        auto pFieldIter = std::upper_bound(m_vPointerNoteFields.begin(), m_vPointerNoteFields.end(),
+                                           std::make_pair(nAfterAddress, 0xFFFFFFFFU));
+        for (; pFieldIter != m_vPointerNoteFields.end() && pFieldIter->first < nBestAddress; ++pFieldIter)
         {
-            if (pNote->GetNextAddress(nAfterAddress, nNextAddress))
+            if (std::find(vCheckedNotes.begin(), vCheckedNotes.end(), pFieldIter->second) != vCheckedNotes.end())
+                continue;
+
+            vCheckedNotes.push_back(pFieldIter->second);
+
+            const auto* pNote = FindMemoryNoteModel(pFieldIter->second, false);
+            if (pNote != nullptr && pNote->GetNextAddress(nAfterAddress, nNextAddress))
                 nBestAddress = std::min(nBestAddress, nNextAddress);
         }
     }
@@ -439,14 +559,28 @@ ra::data::ByteAddress MemoryNotesModel::GetPreviousNoteAddress(ra::data::ByteAdd
         nBestAddress = (*pIter)->GetAddress();
     }
 
-    if (m_bHasPointers && bIncludeDerived)
+    if (m_bHasPointers && bIncludeDerived && nBestAddress != 0xFFFFFFFF)
     {
         ra::data::ByteAddress nPreviousAddress = 0U;
+        std::vector<ra::data::ByteAddress> vCheckedNotes;
 
         // scan pointed-at addresses to see if there's anything between the next lower item and nBeforeAddress
-        for (const auto& pNote : m_vMemoryNotes)
+        std::unique_lock<std::mutex> lock(m_oPointerIndexMutex);
+        auto pFieldIter = std::lower_bound(m_vPointerNoteFields.begin(), m_vPointerNoteFields.end(),
+                                           std::make_pair(nBeforeAddress, 0U));
+        while (pFieldIter != m_vPointerNoteFields.begin())
         {
-            if (pNote->GetPreviousAddress(nBeforeAddress, nPreviousAddress))
+            --pFieldIter;
+            if (pFieldIter->first <= nBestAddress)
+                break;
+
+            if (std::find(vCheckedNotes.begin(), vCheckedNotes.end(), pFieldIter->second) != vCheckedNotes.end())
+                continue;
+
+            vCheckedNotes.push_back(pFieldIter->second);
+
+            const auto* pNote = FindMemoryNoteModel(pFieldIter->second, false);
+            if (pNote != nullptr && pNote->GetPreviousAddress(nBeforeAddress, nPreviousAddress))
                 nBestAddress = std::max(nBestAddress, nPreviousAddress);
         }
     }
@@ -510,31 +644,260 @@ void MemoryNotesModel::DoFrame()
 
     const auto& pMemoryContext = ra::services::ServiceLocator::Get<ra::context::IEmulatorMemoryContext>();
 
+    // the callbacks may look up notes by address, so they aren't raised until the moved notes have been reindexed
+    struct MovedNote
+    {
+        ra::data::ByteAddress nOldAddress;
+        ra::data::ByteAddress nNewAddress;
+        std::wstring sNote;
+    };
+    std::vector<MovedNote> vMovedNotes;
+
     for (auto& pMemoryNote : m_vMemoryNotes)
     {
         if (pMemoryNote->IsPointer())
         {
+            bool bMoved = false;
             if (!m_fMemoryNoteMoved)
             {
-                pMemoryNote->UpdateRawPointerValue(pMemoryNote->GetAddress(), pMemoryContext, nullptr);
+                bMoved = pMemoryNote->UpdateRawPointerValue(pMemoryNote->GetAddress(), pMemoryContext, nullptr);
             }
             else if (pMemoryNote->HasRawPointerValue())
             {
-                pMemoryNote->UpdateRawPointerValue(pMemoryNote->GetAddress(), pMemoryContext,
-                    [this](ra::data::ByteAddress nOldAddress, ra::data::ByteAddress nNewAddress, const MemoryNoteModel& pOffsetNote) {
-                        m_fMemoryNoteMoved(nOldAddress, nNewAddress, pOffsetNote.GetNote());
+                bMoved = pMemoryNote->UpdateRawPointerValue(pMemoryNote->GetAddress(), pMemoryContext,
+                    [&vMovedNotes](ra::data::ByteAddress nOldAddress, ra::data::ByteAddress nNewAddress, const MemoryNoteModel& pOffsetNote) {
+                        vMovedNotes.push_back({ nOldAddress, nNewAddress, pOffsetNote.GetNote() });
                     });
             }
             else
             {
                 // pointer hasn't been read before, provide dummy previous address
-                pMemoryNote->UpdateRawPointerValue(pMemoryNote->GetAddress(), pMemoryContext,
-                    [this](ra::data::ByteAddress, ra::data::ByteAddress nNewAddress, const MemoryNoteModel& pOffsetNote) {
-                        m_fMemoryNoteMoved(0xFFFFFFFF, nNewAddress, pOffsetNote.GetNote());
+                bMoved = pMemoryNote->UpdateRawPointerValue(pMemoryNote->GetAddress(), pMemoryContext,
+                    [&vMovedNotes](ra::data::ByteAddress, ra::data::ByteAddress nNewAddress, const MemoryNoteModel& pOffsetNote) {
+                        vMovedNotes.push_back({ 0xFFFFFFFF, nNewAddress, pOffsetNote.GetNote() });
                     });
             }
+
+            if (bMoved)
+                IndexPointerNote(pMemoryNote->GetAddress(), pMemoryNote.get());
+        }
+    }
+
+    for (const auto& pMovedNote : vMovedNotes)
+        m_fMemoryNoteMoved(pMovedNote.nOldAddress, pMovedNote.nNewAddress, pMovedNote.sNote);
+}
+
+// ranges larger than this are checked on every lookup instead of being found through the sorted index
+_CONSTANT_VAR MAX_INDEXED_POINTER_NOTE_RANGE_SIZE = 0x100U;
+
+void MemoryNotesModel::IndexPointerNote(ra::data::ByteAddress nAddress, const MemoryNoteModel* pNote)
+{
+    std::unique_lock<std::mutex> lock(m_oPointerIndexMutex);
+
+    RemovePointerNoteFromIndex(nAddress);
+
+    if (pNote == nullptr || !pNote->IsPointer())
+        return;
+
+    auto& pEntries = m_mPointerNoteIndexEntries[nAddress];
+    GetPointerNoteIndexEntries(nAddress, *pNote, pEntries);
+
+    for (const auto nFieldAddress : pEntries.vFieldAddresses)
+    {
+        const auto pField = std::make_pair(nFieldAddress, nAddress);
+        m_vPointerNoteFields.insert(
+            std::upper_bound(m_vPointerNoteFields.begin(), m_vPointerNoteFields.end(), pField), pField);
+    }
+
+    for (const auto& pRange : pEntries.vRanges)
+    {
+        const auto nSize = pRange.nLastAddress - pRange.nFirstAddress;
+        if (nSize > MAX_INDEXED_POINTER_NOTE_RANGE_SIZE)
+        {
+            m_vLargePointerNoteRanges.push_back(pRange);
+            continue;
+        }
+
+        m_nMaxPointerNoteRangeSize = std::max(m_nMaxPointerNoteRangeSize, nSize);
+        m_vPointerNoteRanges.insert(std::upper_bound(m_vPointerNoteRanges.begin(), m_vPointerNoteRanges.end(),
+            pRange.nFirstAddress, [](ra::data::ByteAddress nAddress, const PointerNoteRange& pOther) noexcept {
+                return nAddress < pOther.nFirstAddress;
+            }), pRange);
+    }
+}
+
+void MemoryNotesModel::RemovePointerNoteFromIndex(ra::data::ByteAddress nAddress)
+{
+    const auto pEntriesIter = m_mPointerNoteIndexEntries.find(nAddress);
+    if (pEntriesIter == m_mPointerNoteIndexEntries.end())
+        return;
+
+    for (const auto nFieldAddress : pEntriesIter->second.vFieldAddresses)
+    {
+        const auto pField = std::make_pair(nFieldAddress, nAddress);
+        const auto pIter = std::lower_bound(m_vPointerNoteFields.begin(), m_vPointerNoteFields.end(), pField);
+        if (pIter != m_vPointerNoteFields.end() && *pIter == pField)
+            m_vPointerNoteFields.erase(pIter);
+    }
+
+    for (const auto& pRange : pEntriesIter->second.vRanges)
+    {
+        const auto bMatch = [&pRange](const PointerNoteRange& pOther) noexcept {
+            return pOther.nFirstAddress == pRange.nFirstAddress && pOther.nLastAddress == pRange.nLastAddress &&
+                   pOther.nPointerNoteAddress == pRange.nPointerNoteAddress;
+        };
+
+        if (pRange.nLastAddress - pRange.nFirstAddress > MAX_INDEXED_POINTER_NOTE_RANGE_SIZE)
+        {
+            const auto pIter = std::find_if(m_vLargePointerNoteRanges.begin(), m_vLargePointerNoteRanges.end(), bMatch);
+            if (pIter != m_vLargePointerNoteRanges.end())
+                m_vLargePointerNoteRanges.erase(pIter);
+            continue;
+        }
+
+        auto pIter = std::lower_bound(m_vPointerNoteRanges.begin(), m_vPointerNoteRanges.end(), pRange.nFirstAddress,
+            [](const PointerNoteRange& pOther, ra::data::ByteAddress nAddress) noexcept {
+                return pOther.nFirstAddress < nAddress;
+            });
+        for (; pIter != m_vPointerNoteRanges.end() && pIter->nFirstAddress == pRange.nFirstAddress; ++pIter)
+        {
+            if (bMatch(*pIter))
+            {
+                m_vPointerNoteRanges.erase(pIter);
+                break;
+            }
+        }
+    }
+
+    m_mPointerNoteIndexEntries.erase(pEntriesIter);
+}
+
+void MemoryNotesModel::RebuildPointerNoteIndex()
+{
+    std::unique_lock<std::mutex> lock(m_oPointerIndexMutex);
+
+    m_vPointerNoteRanges.clear();
+    m_vLargePointerNoteRanges.clear();
+    m_vPointerNoteFields.clear();
+    m_mPointerNoteIndexEntries.clear();
+    m_nMaxPointerNoteRangeSize = 0;
+
+    for (const auto& pNote : m_vMemoryNotes)
+    {
+        if (!pNote->IsPointer())
+            continue;
+
+        const auto nAddress = pNote->GetAddress();
+        auto& pEntries = m_mPointerNoteIndexEntries[nAddress];
+        GetPointerNoteIndexEntries(nAddress, *pNote, pEntries);
+
+        for (const auto nFieldAddress : pEntries.vFieldAddresses)
+            m_vPointerNoteFields.emplace_back(nFieldAddress, nAddress);
+
+        for (const auto& pRange : pEntries.vRanges)
+        {
+            const auto nSize = pRange.nLastAddress - pRange.nFirstAddress;
+            if (nSize > MAX_INDEXED_POINTER_NOTE_RANGE_SIZE)
+            {
+                m_vLargePointerNoteRanges.push_back(pRange);
+            }
+            else
+            {
+                m_nMaxPointerNoteRangeSize = std::max(m_nMaxPointerNoteRangeSize, nSize);
+                m_vPointerNoteRanges.push_back(pRange);
+            }
+        }
+    }
+
+    std::sort(m_vPointerNoteFields.begin(), m_vPointerNoteFields.end());
+
+    std::sort(m_vPointerNoteRanges.begin(), m_vPointerNoteRanges.end(),
+        [](const PointerNoteRange& pLeft, const PointerNoteRange& pRight) noexcept {
+            return pLeft.nFirstAddress < pRight.nFirstAddress;
+        });
+}
+
+void MemoryNotesModel::GetPointerNoteIndexEntries(ra::data::ByteAddress nAddress, const MemoryNoteModel& pNote,
+                                                  PointerNoteIndexEntries& pEntries)
+{
+    // GetNextAddress/GetPreviousAddress only look at the fields of the outermost pointer
+    const auto nPointerAddress = pNote.GetPointerAddress();
+    pNote.EnumeratePointerNotes([&pEntries, nPointerAddress](ra::data::ByteAddress, const MemoryNoteModel& pField) {
+        pEntries.vFieldAddresses.push_back(nPointerAddress + pField.GetAddress());
+        return true;
+    });
+
+    // GetPointerNoteAtAddress looks at every byte of every field, including the fields of nested pointers
+    std::function<void(const MemoryNoteModel&)> fAddRanges = [&pEntries, nAddress, &fAddRanges](const MemoryNoteModel& pPointerNote) {
+        const auto nPointerAddress = pPointerNote.GetPointerAddress();
+        if (nPointerAddress == 0) // null pointers don't resolve to anything
+            return;
+
+        pPointerNote.EnumeratePointerNotes([&pEntries, nAddress, nPointerAddress, &fAddRanges](ra::data::ByteAddress, const MemoryNoteModel& pField) {
+            const auto nFirstAddress = nPointerAddress + pField.GetAddress();
+            const auto nLastAddress = nFirstAddress + std::max(pField.GetBytes(), 1U) - 1;
+            if (nLastAddress < nFirstAddress)
+            {
+                // field wraps around the end of the address space
+                pEntries.vRanges.push_back({ nFirstAddress, 0xFFFFFFFF, nAddress });
+                pEntries.vRanges.push_back({ 0, nLastAddress, nAddress });
+            }
+            else
+            {
+                pEntries.vRanges.push_back({ nFirstAddress, nLastAddress, nAddress });
+            }
+
+            if (pField.IsPointer())
+                fAddRanges(pField);
+
+            return true;
+        });
+    };
+    fAddRanges(pNote);
+}
+
+std::vector<const MemoryNoteModel*> MemoryNotesModel::FindPointerNotesContaining(ra::data::ByteAddress nAddress) const
+{
+    std::vector<ra::data::ByteAddress> vPointerNoteAddresses;
+
+    {
+        std::unique_lock<std::mutex> lock(m_oPointerIndexMutex);
+
+        // a range can't contain the address if it starts further before the address than the largest range
+        const auto nFirstAddress = (nAddress > m_nMaxPointerNoteRangeSize) ? nAddress - m_nMaxPointerNoteRangeSize : 0;
+        auto pIter = std::lower_bound(m_vPointerNoteRanges.begin(), m_vPointerNoteRanges.end(), nFirstAddress,
+            [](const PointerNoteRange& pRange, ra::data::ByteAddress nAddress) noexcept {
+                return pRange.nFirstAddress < nAddress;
+            });
+
+        for (; pIter != m_vPointerNoteRanges.end() && pIter->nFirstAddress <= nAddress; ++pIter)
+        {
+            if (pIter->nLastAddress >= nAddress)
+                vPointerNoteAddresses.push_back(pIter->nPointerNoteAddress);
+        }
+
+        for (const auto& pRange : m_vLargePointerNoteRanges)
+        {
+            if (pRange.nFirstAddress <= nAddress && pRange.nLastAddress >= nAddress)
+                vPointerNoteAddresses.push_back(pRange.nPointerNoteAddress);
         }
     }
+
+    // callers expect the pointer notes to be processed in the same order as the notes
+    std::sort(vPointerNoteAddresses.begin(), vPointerNoteAddresses.end());
+    vPointerNoteAddresses.erase(std::unique(vPointerNoteAddresses.begin(), vPointerNoteAddresses.end()),
+                                vPointerNoteAddresses.end());
+
+    std::vector<const MemoryNoteModel*> vPointerNotes;
+    vPointerNotes.reserve(vPointerNoteAddresses.size());
+    for (const auto nPointerNoteAddress : vPointerNoteAddresses)
+    {
+        const auto* pNote = FindMemoryNoteModel(nPointerNoteAddress, false);
+        if (pNote != nullptr)
+            vPointerNotes.push_back(pNote);
+    }
+
+    return vPointerNotes;
 }
 
 void MemoryNotesModel::SetServerNote(ra::data::ByteAddress nAddress, const std::wstring& sNote)
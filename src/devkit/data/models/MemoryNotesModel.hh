@@ -6,6 +6,8 @@
 
 #include "data/models/MemoryNoteModel.hh"
 
+#include <unordered_map>
+
 namespace ra {
 namespace data {
 namespace models {
@@ -154,6 +156,21 @@ public:
 
 protected:
     void AddMemoryNote(ra::data::ByteAddress nAddress, const std::string& sAuthor, const std::wstring& sNote);
+
+    struct ServerMemoryNote
+    {
+        ra::data::ByteAddress nAddress;
+        const char* sAuthor;
+        const char* sNote;
+    };
+
+    /// <summary>
+    /// Adds a batch of notes downloaded from the server. The notes are parsed on the thread pool and
+    /// inserted in a single step. Unlike <see cref="AddMemoryNote" />, no change notification is raised
+    /// for the individual notes - the caller is expected to report the load as a whole.
+    /// </summary>
+    void AddServerMemoryNotes(const std::vector<ServerMemoryNote>& vNotes);
+
     void OnMemoryNoteChanged(ra::data::ByteAddress nAddress, const std::wstring& sNewNote);
 
     std::vector<std::unique_ptr<MemoryNoteModel>> m_vMemoryNotes;
@@ -172,7 +189,58 @@ protected:
 private:
     static std::wstring BuildNoteForAddress(ra::data::ByteAddress nAddress, unsigned nCheckBytes, ra::data::ByteAddress nNoteAddress, const MemoryNoteModel& pNote);
 
+    /// <summary>
+    /// Updates the pointer index for the note at the specified address. If <paramref name="pNote" /> is
+    /// <c>nullptr</c>, the note is removed from the index.
+    /// </summary>
+    void IndexPointerNote(ra::data::ByteAddress nAddress, const MemoryNoteModel* pNote);
+
+    /// <summary>
+    /// Rebuilds the pointer index for all of the notes.
+    /// </summary>
+    void RebuildPointerNoteIndex();
+
+    struct PointerNoteIndexEntries;
+    static void GetPointerNoteIndexEntries(ra::data::ByteAddress nAddress, const MemoryNoteModel& pNote,
+                                           PointerNoteIndexEntries& pEntries);
+    void RemovePointerNoteFromIndex(ra::data::ByteAddress nAddress);
+
+    /// <summary>
+    /// Gets the pointer notes (in address order) that may have an indirect note at the specified address.
+    /// </summary>
+    std::vector<const MemoryNoteModel*> FindPointerNotesContaining(ra::data::ByteAddress nAddress) const;
+
     mutable std::mutex m_oMutex;
+
+    // the ranges of addresses that the pointer notes currently resolve to, so finding an indirect note
+    // doesn't have to ask every pointer note. rebuilt for a pointer note when it's added or moves.
+    struct PointerNoteRange
+    {
+        ra::data::ByteAddress nFirstAddress;
+        ra::data::ByteAddress nLastAddress;
+        ra::data::ByteAddress nPointerNoteAddress;
+    };
+    std::vector<PointerNoteRange> m_vPointerNoteRanges; // sorted by nFirstAddress
+    ra::data::ByteAddress m_nMaxPointerNoteRangeSize = 0; // largest range ever added to m_vPointerNoteRanges
+
+    // ranges larger than MAX_INDEXED_POINTER_NOTE_RANGE_SIZE. kept separate so they don't inflate
+    // m_nMaxPointerNoteRangeSize, which determines how much of m_vPointerNoteRanges each lookup has to scan.
+    std::vector<PointerNoteRange> m_vLargePointerNoteRanges;
+
+    // the current addresses of the fields of each pointer note (not including nested pointers) and the
+    // address of the pointer note. sorted by field address.
+    std::vector<std::pair<ra::data::ByteAddress, ra::data::ByteAddress>> m_vPointerNoteFields;
+
+    // the entries each pointer note added to the index, so they can be found by binary search when the
+    // pointer moves or the note is removed.
+    struct PointerNoteIndexEntries
+    {
+        std::vector<ra::data::ByteAddress> vFieldAddresses;
+        std::vector<PointerNoteRange> vRanges;
+    };
+    std::unordered_map<ra::data::ByteAddress, PointerNoteIndexEntries> m_mPointerNoteIndexEntries;
+
+    mutable std::mutex m_oPointerIndexMutex;
 };
 
 } // namespace models
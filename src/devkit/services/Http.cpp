@@ -24,7 +24,9 @@ Http::Response Http::Request::Call() const
 void Http::Request::CallAsync(Callback&& fCallback) const
 {
     auto& pThreadPool = ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>();
-    pThreadPool.RunAsync([request = *this, f = std::move(fCallback)]() {
+    // server calls are usually made on behalf of the player (unlocks, leaderboard submissions, etc). don't make them
+    // wait behind downloads.
+    pThreadPool.RunAsync(ra::services::TaskPriority::High, [request = *this, f = std::move(fCallback)]() {
         auto response = request.Call();
         f(response);
     });
@@ -45,7 +47,8 @@ Http::Response Http::Request::Download(const std::wstring& sFilename) const
 void Http::Request::DownloadAsync(const std::wstring& sFilename, Callback&& fCallback) const
 {
     auto& pThreadPool = ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>();
-    pThreadPool.RunAsync([request = *this, sFilename, f = std::move(fCallback)]() {
+    // downloads are usually images, which may be requested in bulk. let other work go first.
+    pThreadPool.RunAsync(ra::services::TaskPriority::Low, [request = *this, sFilename, f = std::move(fCallback)]() {
         auto response = request.Download(sFilename);
         f(response);
     });
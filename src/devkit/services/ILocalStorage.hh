@@ -23,6 +23,8 @@ enum class StorageItemType
     SessionStats,
     Bookmarks,
     HashMapping,
+    SessionHistory,
+    SessionHistoryBackup,
 };
 
 class ILocalStorage
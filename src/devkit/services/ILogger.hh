@@ -2,6 +2,7 @@
 #define RA_SERVICES_ILOGGER_HH
 #pragma once
 
+#include <functional>
 #include <string>
 
 namespace ra {
@@ -33,6 +34,21 @@ public:
     /// </summary>
     virtual void LogMessage(LogLevel level, const std::string& sMessage) const = 0;
 
+    using MessageFormatter = std::function<std::string()>;
+
+    /// <summary>
+    /// Logs a message that isn't built until <paramref name="fFormatMessage" /> is called. Loggers that write
+    /// on a background thread can defer the cost of building the message to that thread.
+    /// </summary>
+    /// <remarks>
+    /// <paramref name="fFormatMessage" /> may be called after this returns, so it must not reference anything
+    /// owned by the caller.
+    /// </remarks>
+    virtual void LogDeferredMessage(LogLevel level, MessageFormatter&& fFormatMessage) const
+    {
+        LogMessage(level, fFormatMessage());
+    }
+
 protected:
     ILogger() noexcept = default;
 };
@@ -7,6 +7,16 @@
 namespace ra {
 namespace services {
 
+/// <summary>
+/// Determines the order in which queued work is started.
+/// </summary>
+enum class TaskPriority
+{
+    Low,    // bulk work that can wait, like downloading images
+    Normal,
+    High,   // work the player is waiting on, like submitting an unlock
+};
+
 class IThreadPool
 {
 public:
@@ -21,6 +31,14 @@ public:
     /// </summary>
     virtual void RunAsync(std::function<void()>&& f) = 0;
 
+    /// <summary>
+    /// Queues work for a background thread. Higher priority work is started before lower priority work.
+    /// </summary>
+    virtual void RunAsync([[maybe_unused]] TaskPriority nPriority, std::function<void()>&& f)
+    {
+        RunAsync(std::move(f));
+    }
+
     /// <summary>
     /// Queues work for a background thread to be run after a period of time
     /// </summary>
@@ -0,0 +1,105 @@
+#include "ParallelPartitions.hh"
+
+#include "services/IThreadPool.hh"
+#include "services/ServiceLocator.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ra {
+namespace services {
+
+namespace {
+
+struct ParallelPartitionsState
+{
+    explicit ParallelPartitionsState(size_t nPartitions, const std::function<void(size_t)>& fProcessPartition) noexcept
+        : nPartitions(nPartitions), pProcessPartition(&fProcessPartition)
+    {
+    }
+
+    const size_t nPartitions;
+
+    // only dereferenced while processing a claimed partition, and the caller waits for every claimed partition
+    // to complete, so it will still be valid.
+    const std::function<void(size_t)>* pProcessPartition;
+
+    std::atomic<size_t> nNextPartition{ 0U };
+
+    std::mutex oMutex;
+    std::condition_variable oCondition;
+    size_t nCompletedPartitions = 0U;
+    std::exception_ptr pException;
+};
+
+} // anonymous namespace
+
+void ProcessPartitions(size_t nPartitions, const std::function<void(size_t)>& fProcessPartition)
+{
+    const size_t nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    if (nPartitions < 2 || nThreads < 2 || !ServiceLocator::Exists<IThreadPool>())
+    {
+        for (size_t nPartition = 0; nPartition < nPartitions; ++nPartition)
+            fProcessPartition(nPartition);
+
+        return;
+    }
+
+    // each worker claims partitions until there are none left. a worker that starts after all partitions have been
+    // claimed only touches the shared state, which it keeps alive.
+    auto pState = std::make_shared<ParallelPartitionsState>(nPartitions, fProcessPartition);
+    auto fProcessPartitions = [pState]()
+    {
+        for (;;)
+        {
+            const auto nPartition = pState->nNextPartition.fetch_add(1);
+            if (nPartition >= pState->nPartitions)
+                break;
+
+            std::exception_ptr pException;
+            try
+            {
+                (*pState->pProcessPartition)(nPartition);
+            }
+            catch (...)
+            {
+                pException = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> pLock(pState->oMutex);
+                if (pException && !pState->pException)
+                    pState->pException = pException;
+
+                ++pState->nCompletedPartitions;
+            }
+
+            pState->oCondition.notify_all();
+        }
+    };
+
+    auto& pThreadPool = ServiceLocator::GetMutable<IThreadPool>();
+    const auto nHelpers = std::min(nPartitions, nThreads) - 1;
+    for (size_t i = 0; i < nHelpers; ++i)
+        pThreadPool.RunAsync(fProcessPartitions);
+
+    fProcessPartitions();
+
+    {
+        std::unique_lock<std::mutex> pLock(pState->oMutex);
+        pState->oCondition.wait(pLock, [&pState]() noexcept {
+            return pState->nCompletedPartitions == pState->nPartitions;
+        });
+    }
+
+    if (pState->pException)
+        std::rethrow_exception(pState->pException);
+}
+
+} // namespace services
+} // namespace ra
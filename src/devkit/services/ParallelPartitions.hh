@@ -0,0 +1,24 @@
+#ifndef RA_SERVICES_PARALLEL_PARTITIONS_HH
+#define RA_SERVICES_PARALLEL_PARTITIONS_HH
+#pragma once
+
+#include <functional>
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// Calls <paramref name="fProcessPartition" /> once for each partition index in [0, nPartitions), distributing the
+/// partitions across the <see cref="IThreadPool" />.
+/// </summary>
+/// <remarks>
+/// The calling thread processes partitions too, so all of the work gets done even if the thread pool is busy. Does
+/// not return until every partition has been processed. If any partition throws, the first exception is rethrown
+/// on the calling thread. Runs serially if there's only one partition or no thread pool has been registered.
+/// </remarks>
+void ProcessPartitions(size_t nPartitions, const std::function<void(size_t)>& fProcessPartition);
+
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_PARALLEL_PARTITIONS_HH
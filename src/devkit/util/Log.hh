@@ -4,6 +4,85 @@
 
 #include "services/ILogger.hh"
 
+#include "util/Strings.hh"
+
+#include <tuple>
+
+namespace ra {
+namespace util {
+
+// copy of a C-style string argument that has to outlive the call that provided it
+template<typename CharT>
+struct DeferredLogString
+{
+    std::basic_string<CharT> sValue;
+};
+
+/// <summary>
+/// Copies a log message argument so the message can be formatted after the argument goes out of scope.
+/// </summary>
+/// <remarks>
+/// Strings referenced by pointer or view are copied. Everything else is copied by value, so pointers to other
+/// types are only useful for printing the address.
+/// </remarks>
+template<typename T>
+auto CaptureLogArgument(T&& value)
+{
+    using TValue = std::decay_t<T>;
+    if constexpr (std::is_same_v<TValue, const char*> || std::is_same_v<TValue, char*>)
+        return DeferredLogString<char>{ value ? value : "" };
+    else if constexpr (std::is_same_v<TValue, const wchar_t*> || std::is_same_v<TValue, wchar_t*>)
+        return DeferredLogString<wchar_t>{ value ? value : L"" };
+    else if constexpr (std::is_same_v<TValue, std::string_view>)
+        return std::string(value);
+    else if constexpr (std::is_same_v<TValue, std::wstring_view>)
+        return std::wstring(value);
+    else
+        return TValue(std::forward<T>(value));
+}
+
+template<typename T>
+const T& UnwrapLogArgument(const T& value) noexcept
+{
+    return value;
+}
+
+template<typename CharT>
+const CharT* UnwrapLogArgument(const DeferredLogString<CharT>& value) noexcept
+{
+    return value.sValue.c_str();
+}
+
+/// <summary>
+/// Captures the arguments for a log message so it can be formatted later.
+/// </summary>
+/// <param name="sFormat">The printf-style format. Must be a string literal.</param>
+template<typename... Ts>
+ra::services::ILogger::MessageFormatter DeferLogMessage(_In_z_ _Printf_format_string_ const char* const sFormat,
+                                                        Ts&&... args)
+{
+    return [sFormat, tArgs = std::make_tuple(CaptureLogArgument(std::forward<Ts>(args))...)]()
+    {
+        return std::apply([sFormat](const auto&... vArgs) {
+            return ra::util::String::Printf(sFormat, UnwrapLogArgument(vArgs)...);
+        }, tArgs);
+    };
+}
+
+/// <summary>
+/// Captures a log message without arguments so it can be formatted later.
+/// </summary>
+/// <remarks>
+/// The message is copied as it may not be a string literal.
+/// </remarks>
+inline ra::services::ILogger::MessageFormatter DeferLogMessage(const char* const sMessage)
+{
+    return [sMessage = std::string(sMessage)]() { return ra::util::String::Printf(sMessage.c_str()); };
+}
+
+} // namespace util
+} // namespace ra
+
 #ifdef RA_UTEST
 
 #define RA_LOG_LEVEL(lvl, ...)
@@ -11,13 +90,13 @@
 #else
 
 #include "services/ServiceLocator.hh"
-#include "util/Strings.hh"
 
+// the arguments are captured rather than formatted so loggers can format the message on a background thread
 #define RA_LOG_LEVEL(lvl, ...) \
 { \
     const auto& __pLogger = ra::services::ServiceLocator::Get<ra::services::ILogger>(); \
     if (__pLogger.IsEnabled(lvl)) \
-        __pLogger.LogMessage(lvl, ra::util::String::Printf(__VA_ARGS__)); \
+        __pLogger.LogDeferredMessage(lvl, ra::util::DeferLogMessage(__VA_ARGS__)); \
 }
 
 #endif
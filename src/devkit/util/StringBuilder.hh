@@ -285,7 +285,10 @@ public:
                 AppendSubString(pScan - 1, 1);
                 AppendPrintf(++pScan, value, std::forward<Ts>(args)...);
                 break;
-            case 'l': // assume ll, or li
+            case 'l': // assume li, lu, lld, or llu
+                if (pScan[1] == 'l')
+                    ++pScan;
+                _FALLTHROUGH;
             case 'z': // assume zu
                 ++pScan;
                 _FALLTHROUGH;
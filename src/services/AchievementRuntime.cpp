@@ -17,6 +17,7 @@
 #include "context\IEmulatorMemoryContext.hh"
 #include "context\IRcClient.hh"
 #include "context\UserContext.hh"
+#include "context\impl\EmulatorMemoryContext.hh"
 
 #include "data\context\EmulatorContext.hh"
 #include "data\context\GameContext.hh"
@@ -32,6 +33,7 @@
 #include "services\ILocalStorage.hh"
 #include "services\ILoginService.hh"
 #include "services\IThreadPool.hh"
+#include "services\PerformanceCounter.hh"
 #include "services\ServiceLocator.hh"
 #include "services\impl\JsonFileConfiguration.hh"
 #include "services\impl\LoginService.hh"
@@ -238,8 +240,30 @@ AchievementRuntime::~AchievementRuntime()
     }
 }
 
+// memory is read through the memory context several times for every memref. the context only changes when a
+// different one is provided, so the cast is only redone then. the runtime and the UI read memory on different
+// threads, so each thread has its own cache.
+static ra::context::impl::EmulatorMemoryContext* GetEmulatorMemoryContext()
+{
+    thread_local const ra::context::IEmulatorMemoryContext* s_pCachedMemoryContext = nullptr;
+    thread_local ra::context::impl::EmulatorMemoryContext* s_pCachedEmulatorMemoryContext = nullptr;
+
+    auto& pMemoryContext = ra::services::ServiceLocator::GetMutable<ra::context::IEmulatorMemoryContext>();
+    if (&pMemoryContext != s_pCachedMemoryContext)
+    {
+        s_pCachedEmulatorMemoryContext = dynamic_cast<ra::context::impl::EmulatorMemoryContext*>(&pMemoryContext);
+        s_pCachedMemoryContext = &pMemoryContext;
+    }
+
+    return s_pCachedEmulatorMemoryContext;
+}
+
 uint32_t AchievementRuntime::ReadMemory(uint32_t nAddress, uint8_t* pBuffer, uint32_t nBytes, rc_client_t*)
 {
+    const auto* pEmulatorMemoryContext = GetEmulatorMemoryContext();
+    if (pEmulatorMemoryContext != nullptr)
+        return pEmulatorMemoryContext->PeekMemory(nAddress, pBuffer, nBytes);
+
     const auto& pMemoryContext = ra::services::ServiceLocator::Get<ra::context::IEmulatorMemoryContext>();
     return pMemoryContext.ReadMemory(nAddress, pBuffer, nBytes);
 }
@@ -725,10 +749,7 @@ void AchievementRuntime::UnloadGame()
 static void PrepareForPauseOnReset(const ra::data::models::GameAssets& pAssets,
     std::vector<const rc_client_achievement_info_t*>& vAchievementsWithHits)
 {
-    std::vector<const ra::data::models::AchievementModel*> vAchievements;
-    pAssets.GetPauseOnResetAchievements(vAchievements);
-
-    for (const auto* vmAchievement : vAchievements)
+    for (const auto* vmAchievement : pAssets.GetPauseOnResetAchievements())
     {
         if (vmAchievement && vmAchievement->IsActive())
         {
@@ -742,10 +763,7 @@ static void PrepareForPauseOnReset(const ra::data::models::GameAssets& pAssets,
 static void PrepareForPauseOnReset(const ra::data::models::GameAssets& pAssets,
     std::map<const rc_client_leaderboard_info_t*, ra::data::models::LeaderboardModel::LeaderboardParts>& mLeaderboardsWithHits)
 {
-    std::vector<const ra::data::models::LeaderboardModel*> vLeaderboards;
-    pAssets.GetPauseOnResetLeaderboards(vLeaderboards);
-
-    for (const auto* vmLeaderboard : vLeaderboards)
+    for (const auto* vmLeaderboard : pAssets.GetPauseOnResetLeaderboards())
     {
         if (vmLeaderboard && vmLeaderboard->IsActive())
         {
@@ -777,10 +795,7 @@ static void PrepareForPauseOnReset(const ra::data::models::GameAssets& pAssets,
 static void PrepareForPauseOnTrigger(const ra::data::models::GameAssets& pAssets,
     std::map<const rc_client_leaderboard_info_t*, ra::data::models::LeaderboardModel::LeaderboardParts>& mActiveLeaderboards)
 {
-    std::vector<const ra::data::models::LeaderboardModel*> vLeaderboards;
-    pAssets.GetPauseOnTriggerLeaderboards(vLeaderboards);
-
-    for (const auto* vmLeaderboard : vLeaderboards)
+    for (const auto* vmLeaderboard : pAssets.GetPauseOnTriggerLeaderboards())
     {
         if (vmLeaderboard && vmLeaderboard->IsActive())
         {
@@ -930,6 +945,7 @@ void AchievementRuntime::DoFrame()
     const auto& pAssets = ra::services::ServiceLocator::GetMutable<ra::data::context::GameContext>().Assets();
     if (!pAssets.HasPauseOnXAssets())
     {
+        PERFORMANCE_SCOPE(PerformanceCheckpoint::RuntimeDoFrame);
         rc_client_do_frame(pClient);
         return;
     }
@@ -943,7 +959,10 @@ void AchievementRuntime::DoFrame()
     std::map<const rc_client_leaderboard_info_t*, ra::data::models::LeaderboardModel::LeaderboardParts> mActiveLeaderboards;
     PrepareForPauseOnTrigger(pAssets, mActiveLeaderboards);
 
-    rc_client_do_frame(pClient);
+    {
+        PERFORMANCE_SCOPE(PerformanceCheckpoint::RuntimeDoFrame);
+        rc_client_do_frame(pClient);
+    }
 
     if (!vAchievementsWithHits.empty())
         RaisePauseOnChangeEvents(vAchievementsWithHits);
@@ -1605,6 +1624,7 @@ void AchievementRuntime::EventHandler(const rc_client_event_t* pEvent, rc_client
 {
     Expects(pClient != nullptr);
     Expects(pEvent != nullptr);
+    PERFORMANCE_SCOPE(PerformanceCheckpoint::RuntimeEvents);
     switch (pEvent->type)
     {
         case RC_CLIENT_EVENT_LEADERBOARD_TRACKER_UPDATE:
@@ -2119,11 +2139,23 @@ int AchievementRuntime::SaveProgressToBuffer(uint8_t* pBuffer, int nBufferSize)
     return nSize;
 }
 
+void* AchievementRuntime::GetPeekCallbackData()
+{
+    return GetEmulatorMemoryContext();
+}
+
 } // namespace services
 } // namespace ra
 
-extern "C" unsigned int rc_peek_callback(unsigned int nAddress, unsigned int nBytes, _UNUSED void* pData)
+extern "C" unsigned int rc_peek_callback(unsigned int nAddress, unsigned int nBytes, void* pData)
 {
+    if (pData != nullptr)
+    {
+        // directly accessible memory is read from the page table without any virtual calls
+        const auto* pEmulatorMemoryContext = static_cast<const ra::context::impl::EmulatorMemoryContext*>(pData);
+        return pEmulatorMemoryContext->PeekMemory(nAddress, nBytes);
+    }
+
     const auto& pMemoryContext = ra::services::ServiceLocator::Get<ra::context::IEmulatorMemoryContext>();
     switch (nBytes)
     {
@@ -42,6 +42,12 @@ public:
 
     static std::string GetAchievementBadge(const rc_client_achievement_t& pAchievement);
 
+    /// <summary>
+    /// Gets the value to pass as the pData parameter of rc_peek_callback so it doesn't have to look up the
+    /// memory context for every read.
+    /// </summary>
+    static void* GetPeekCallbackData();
+
     void InitializeRcClient();
     void RaiseClientEvent(rc_client_achievement_info_t& pAchievement, uint32_t nEventType) const;
 
@@ -229,6 +235,6 @@ private:
 } // namespace services
 } // namespace ra
 
-extern "C" unsigned int rc_peek_callback(unsigned int nAddress, unsigned int nBytes, _UNUSED void* pData);
+extern "C" unsigned int rc_peek_callback(unsigned int nAddress, unsigned int nBytes, void* pData);
 
 #endif // !RA_SERVICES_ACHIEVEMENT_RUNTIME_HH
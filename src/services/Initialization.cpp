@@ -148,13 +148,18 @@ void Initialization::RegisterServices(EmulatorID nEmulatorId, const char* sClien
     pThreadPool->Initialize(pConfiguration->GetNumBackgroundThreads());
     ra::services::ServiceLocator::Provide<ra::services::IThreadPool>(std::move(pThreadPool));
 
+    // now that we're not in DllMain, messages can be written by a background thread
+    auto* pLogger = dynamic_cast<ra::services::impl::FileLogger*>(
+        &ra::services::ServiceLocator::GetMutable<ra::services::ILogger>());
+    if (pLogger != nullptr)
+        pLogger->StartWriterThread();
+
     auto pHttpRequester = std::make_unique<ra::services::impl::WindowsHttpRequester>();
     ra::services::ServiceLocator::Provide<ra::services::IHttpRequester>(std::move(pHttpRequester));
 
-#ifdef PERFORMANCE_COUNTERS
     auto pPerformanceCounter = std::make_unique<ra::services::PerformanceCounter>();
+    pPerformanceCounter->SetEnabled(pConfiguration->IsFeatureEnabled(ra::services::Feature::PerformanceProfiler));
     ra::services::ServiceLocator::Provide<ra::services::PerformanceCounter>(std::move(pPerformanceCounter));
-#endif
 
     auto pUserContext = std::make_unique<ra::context::UserContext>();
     ra::services::ServiceLocator::Provide<ra::context::UserContext>(std::move(pUserContext));
@@ -247,6 +252,20 @@ void Initialization::Shutdown()
 
     ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().Shutdown(true);
 
+    // write any pending log messages. anything logged after this is written immediately.
+    auto* pLogger = dynamic_cast<ra::services::impl::FileLogger*>(
+        &ra::services::ServiceLocator::GetMutable<ra::services::ILogger>());
+    if (pLogger != nullptr)
+        pLogger->StopWriterThread();
+
+    // write out the recorded timings so they can be examined in a trace viewer
+    const auto& pPerformanceCounter = ra::services::ServiceLocator::Get<ra::services::PerformanceCounter>();
+    if (pPerformanceCounter.IsEnabled())
+    {
+        const auto& pFileSystem = ra::services::ServiceLocator::Get<ra::services::IFileSystem>();
+        pPerformanceCounter.ExportChromeTrace(pFileSystem.BaseDirectory() + L"RACache\\Profile.json");
+    }
+
     // ImageReference destructors will try to use the IImageRepository if they think it still exists.
     // explicitly deregister it to prevent exceptions when closing down the application.
     ra::services::ServiceLocator::Provide<ra::ui::IImageRepository>(nullptr);
@@ -1,118 +1,286 @@
 #include "PerformanceCounter.hh"
 
-#ifdef PERFORMANCE_COUNTERS
-
 #include "util\Log.hh"
+#include "util\Strings.hh"
 
-#include "IClock.hh"
+#include "services\IClock.hh"
+#include "services\IFileSystem.hh"
+#include "services\ServiceLocator.hh"
 
 namespace ra {
 namespace services {
 
-static std::string GetLabel(PerformanceCheckpoint nCheckpoint)
-{
-    std::string sCheckpoint;
+// to achieve 60 fps, emulator has to render every 16ms, we don't want to use more than 2ms of that.
+_CONSTANT_VAR OUTSTANDING_FRAME_MICROSECONDS = 2000;
+
+// once per minute, log the distribution of the timings
+_CONSTANT_VAR STATISTICS_INTERVAL = 3600U;
 
+// enough to capture every event of an outstanding frame
+_CONSTANT_VAR FRAME_EVENT_LOOKBEHIND = 256U;
+
+const char* PerformanceCounter::GetLabel(PerformanceCheckpoint nCheckpoint) noexcept
+{
     switch (nCheckpoint)
     {
-        case PerformanceCheckpoint::RuntimeProcess: sCheckpoint = "Runtime"; break;
-        case PerformanceCheckpoint::RuntimeEvents: sCheckpoint = "Events"; break;
-        case PerformanceCheckpoint::OverlayManagerAdvanceFrame: sCheckpoint = "Overlay"; break;
-        case PerformanceCheckpoint::MemoryBookmarksDoFrame: sCheckpoint = "Bookmarks"; break;
-        case PerformanceCheckpoint::MemoryInspectorDoFrame: sCheckpoint = "Inspector"; break;
-        case PerformanceCheckpoint::AssetListDoFrame: sCheckpoint = "AssetList"; break;
-        case PerformanceCheckpoint::AssetEditorDoFrame: sCheckpoint = "AssetEditor"; break;
-        case PerformanceCheckpoint::PointerFinderDoFrame: sCheckpoint = "PointerFinder"; break;
-        case PerformanceCheckpoint::PointerInspectorDoFrame: sCheckpoint = "PointerInspector"; break;
-        case PerformanceCheckpoint::FrameEvents: sCheckpoint = "FrameEvents"; break;
-        default: sCheckpoint = std::to_string(ra::etoi(nCheckpoint)); break;
+        case PerformanceCheckpoint::RuntimeProcess: return "Runtime";
+        case PerformanceCheckpoint::RuntimeDoFrame: return "rc_client_do_frame";
+        case PerformanceCheckpoint::RuntimeEvents: return "Events";
+        case PerformanceCheckpoint::OverlayManagerAdvanceFrame: return "Overlay";
+        case PerformanceCheckpoint::OverlayRender: return "OverlayRender";
+        case PerformanceCheckpoint::MemoryBookmarksDoFrame: return "Bookmarks";
+        case PerformanceCheckpoint::MemoryInspectorDoFrame: return "Inspector";
+        case PerformanceCheckpoint::AssetListDoFrame: return "AssetList";
+        case PerformanceCheckpoint::AssetEditorDoFrame: return "AssetEditor";
+        case PerformanceCheckpoint::PointerFinderDoFrame: return "PointerFinder";
+        case PerformanceCheckpoint::PointerInspectorDoFrame: return "PointerInspector";
+        case PerformanceCheckpoint::FrameEvents: return "FrameEvents";
+        case PerformanceCheckpoint::Frame: return "Frame";
+        default: return "Unknown";
     }
+}
 
-    return sCheckpoint;
+static int ToMicroseconds(std::chrono::steady_clock::duration nDuration) noexcept
+{
+    return gsl::narrow_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(nDuration).count());
+}
+
+void PerformanceCounter::SetEnabled(bool bEnabled)
+{
+    if (bEnabled == IsEnabled())
+        return;
+
+    if (bEnabled && !m_pEvents)
+    {
+        // the buffer is never released, so recorders on other threads don't have to synchronize with this
+        m_pEvents.reset(new Event[EVENT_BUFFER_SIZE]);
+        m_tEpoch = ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime();
+    }
+
+    m_nCurrentCheckpoint = PerformanceCheckpoint::NUM_CHECKPOINTS;
+    m_bEnabled.store(bEnabled, std::memory_order_release);
+
+    RA_LOG_INFO("Performance profiler %s", bEnabled ? "enabled" : "disabled");
 }
 
 void PerformanceCounter::Tally(PerformanceCheckpoint nCheckpoint)
 {
-    const auto& pClock = ra::services::ServiceLocator::Get<ra::services::IClock>();
-    m_vMeasurements.emplace_back(nCheckpoint, pClock.UpTime());
+    if (!IsEnabled())
+        return;
+
+    const auto tNow = ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime();
+    if (m_nCurrentCheckpoint == PerformanceCheckpoint::NUM_CHECKPOINTS)
+        m_tFrameStart = tNow;
+    else
+        Record(m_nCurrentCheckpoint, m_tCheckpointStart, tNow);
+
+    m_nCurrentCheckpoint = nCheckpoint;
+    m_tCheckpointStart = tNow;
 }
 
 void PerformanceCounter::Stop()
 {
-    Tally(PerformanceCheckpoint::NUM_CHECKPOINTS);
+    if (m_nCurrentCheckpoint == PerformanceCheckpoint::NUM_CHECKPOINTS)
+        return;
+
+    const auto nCheckpoint = m_nCurrentCheckpoint;
+    m_nCurrentCheckpoint = PerformanceCheckpoint::NUM_CHECKPOINTS;
+    if (!IsEnabled())
+        return;
+
+    const auto tNow = ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime();
+    Record(nCheckpoint, m_tCheckpointStart, tNow);
+    Record(PerformanceCheckpoint::Frame, m_tFrameStart, tNow);
+
+    const auto nFrame = m_nFrame.fetch_add(1, std::memory_order_relaxed);
+
+    const auto nFrameTime = ToMicroseconds(tNow - m_tFrameStart);
+    if (nFrameTime > OUTSTANDING_FRAME_MICROSECONDS)
+        LogFrame(nFrame, nFrameTime);
+
+    if ((nFrame + 1) % STATISTICS_INTERVAL == 0)
+        LogStatistics();
+}
+
+void PerformanceCounter::Record(PerformanceCheckpoint nCheckpoint, std::chrono::steady_clock::time_point tStart,
+                                std::chrono::steady_clock::time_point tEnd) noexcept
+{
+    if (!IsEnabled())
+        return;
+
+    // claim a slot. if the buffer has wrapped, the oldest event is overwritten.
+    const auto nIndex = m_nNextEvent.fetch_add(1, std::memory_order_relaxed);
+    auto& pEvent = m_pEvents[nIndex & (EVENT_BUFFER_SIZE - 1)];
+
+    // clear the sequence before modifying the event so readers know it's being written
+    pEvent.nSequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    pEvent.nStart.store(std::chrono::duration_cast<std::chrono::microseconds>(tStart - m_tEpoch).count(),
+                        std::memory_order_relaxed);
+    pEvent.nDuration.store(ToMicroseconds(tEnd - tStart), std::memory_order_relaxed);
+    pEvent.nFrame.store(m_nFrame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    pEvent.nThreadId.store(GetCurrentThreadId(), std::memory_order_relaxed);
+    pEvent.nCheckpoint.store(nCheckpoint, std::memory_order_relaxed);
+
+    pEvent.nSequence.store(nIndex + 1, std::memory_order_release);
+}
+
+std::vector<PerformanceCounter::EventData> PerformanceCounter::ReadEvents(uint64_t nMaxEvents) const
+{
+    std::vector<EventData> vEvents;
+    if (!m_pEvents)
+        return vEvents;
+
+    const auto nNextEvent = m_nNextEvent.load(std::memory_order_acquire);
+    const auto nAvailableEvents = std::min<uint64_t>(std::min<uint64_t>(nNextEvent, EVENT_BUFFER_SIZE), nMaxEvents);
+    vEvents.reserve(gsl::narrow_cast<size_t>(nAvailableEvents));
+
+    for (auto nIndex = nNextEvent - nAvailableEvents; nIndex < nNextEvent; ++nIndex)
+    {
+        // a slot may still be being written, or may have been reclaimed by a recorder that wrapped around
+        // the buffer. only keep the event if the slot held it both before and after it was copied.
+        const auto& pEvent = m_pEvents[nIndex & (EVENT_BUFFER_SIZE - 1)];
+        if (pEvent.nSequence.load(std::memory_order_acquire) != nIndex + 1)
+            continue;
+
+        const EventData pData{
+            pEvent.nStart.load(std::memory_order_relaxed),
+            pEvent.nDuration.load(std::memory_order_relaxed),
+            pEvent.nFrame.load(std::memory_order_relaxed),
+            pEvent.nThreadId.load(std::memory_order_relaxed),
+            pEvent.nCheckpoint.load(std::memory_order_relaxed),
+        };
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (pEvent.nSequence.load(std::memory_order_relaxed) != nIndex + 1)
+            continue;
+
+        vEvents.push_back(pData);
+    }
+
+    return vEvents;
+}
+
+static PerformanceCounter::Statistics CalculateStatistics(std::vector<int>& vDurations)
+{
+    PerformanceCounter::Statistics pStatistics;
+    pStatistics.nSamples = vDurations.size();
+    if (vDurations.empty())
+        return pStatistics;
+
+    // nearest-rank percentiles
+    std::sort(vDurations.begin(), vDurations.end());
+    pStatistics.nP50 = vDurations.at((vDurations.size() * 50 + 99) / 100 - 1);
+    pStatistics.nP99 = vDurations.at((vDurations.size() * 99 + 99) / 100 - 1);
+    pStatistics.nMax = vDurations.back();
+    return pStatistics;
+}
 
-    int nLapTime = 0;
-    Lap& pLap = m_vLaps.at(m_nNextLap);
-    for (gsl::index nIndex = 1; nIndex < gsl::narrow_cast<gsl::index>(m_vMeasurements.size()); ++nIndex)
+PerformanceCounter::Statistics PerformanceCounter::GetStatistics(PerformanceCheckpoint nCheckpoint) const
+{
+    std::vector<int> vDurations;
+    for (const auto& pEvent : ReadEvents(EVENT_BUFFER_SIZE))
     {
-        const auto& pMeasurement = m_vMeasurements.at(nIndex - 1);
-        const auto nElapsed = m_vMeasurements.at(nIndex).tWhen - pMeasurement.tWhen;
-        const auto nElapsedMicroseconds = gsl::narrow_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(nElapsed).count());
+        if (pEvent.nCheckpoint == nCheckpoint)
+            vDurations.push_back(pEvent.nDuration);
+    }
 
-        const auto nCheckpointIndex = ra::etoi(pMeasurement.nCheckpoint);
-        const auto nPreviousMicroseconds = pLap.at(nCheckpointIndex);
-        m_nRollingTotals.at(nCheckpointIndex) += nElapsedMicroseconds - nPreviousMicroseconds;
-        pLap.at(nCheckpointIndex) = nElapsedMicroseconds;
+    return CalculateStatistics(vDurations);
+}
 
-        m_nLapTotal += nElapsedMicroseconds - nPreviousMicroseconds;
-        nLapTime += nElapsedMicroseconds;
+void PerformanceCounter::LogStatistics() const
+{
+    std::array<std::vector<int>, ra::etoi(PerformanceCheckpoint::NUM_CHECKPOINTS)> vDurations;
+    for (const auto& pEvent : ReadEvents(EVENT_BUFFER_SIZE))
+    {
+        if (pEvent.nCheckpoint < PerformanceCheckpoint::NUM_CHECKPOINTS)
+            vDurations.at(ra::etoi(pEvent.nCheckpoint)).push_back(pEvent.nDuration);
     }
 
-    m_vMeasurements.clear();
+    RA_LOG_INFO("Frame timings (p50/p99/max):");
+    for (gsl::index i = 0; i < ra::etoi(PerformanceCheckpoint::NUM_CHECKPOINTS); ++i)
+    {
+        const auto pStatistics = CalculateStatistics(vDurations.at(i));
+        if (pStatistics.nSamples == 0)
+            continue;
+
+        RA_LOG_INFO(" %s: %d.%03d/%d.%03d/%d.%03dms (%zu samples)", GetLabel(ra::itoe<PerformanceCheckpoint>(i)),
+                    pStatistics.nP50 / 1000, pStatistics.nP50 % 1000, pStatistics.nP99 / 1000, pStatistics.nP99 % 1000,
+                    pStatistics.nMax / 1000, pStatistics.nMax % 1000, pStatistics.nSamples);
+    }
+}
+
+void PerformanceCounter::LogFrame(uint32_t nFrame, int nFrameTime) const
+{
+    auto vEvents = ReadEvents(FRAME_EVENT_LOOKBEHIND);
+    vEvents.erase(std::remove_if(vEvents.begin(), vEvents.end(), [nFrame](const EventData& pEvent) {
+        return pEvent.nFrame != nFrame || pEvent.nCheckpoint == PerformanceCheckpoint::Frame;
+    }), vEvents.end());
 
-    if (++m_nNextLap == NUM_LAPS)
-        m_nNextLap = 0;
+    // nested scopes complete before the scopes containing them. put them back in the order they started.
+    std::stable_sort(vEvents.begin(), vEvents.end(), [](const EventData& pLeft, const EventData& pRight) {
+        return pLeft.nStart < pRight.nStart;
+    });
 
-    if (++m_nTotalLaps > NUM_LAPS)
+    RA_LOG_INFO("Outstanding frame: %d.%03dms", nFrameTime / 1000, nFrameTime % 1000);
+    for (const auto& pEvent : vEvents)
+        RA_LOG_INFO(" %s: %d.%03dms", GetLabel(pEvent.nCheckpoint), pEvent.nDuration / 1000, pEvent.nDuration % 1000);
+}
+
+void PerformanceCounter::ExportChromeTrace(ra::services::TextWriter& pWriter) const
+{
+    pWriter.WriteLine("{\"traceEvents\":[");
+
+    bool bFirst = true;
+    for (const auto& pEvent : ReadEvents(EVENT_BUFFER_SIZE))
+    {
+        if (!bFirst)
+            pWriter.WriteLine(",");
+        bFirst = false;
+
+        // "X" events are complete events. the viewer nests them based on their start and duration.
+        pWriter.Write(ra::util::String::Printf(
+            "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"dur\":%d,\"args\":{\"frame\":%u}}",
+            GetLabel(pEvent.nCheckpoint), pEvent.nThreadId, static_cast<long long>(pEvent.nStart), pEvent.nDuration, pEvent.nFrame));
+    }
+
+    pWriter.WriteLine();
+    pWriter.WriteLine("],\"displayTimeUnit\":\"ms\"}");
+}
+
+bool PerformanceCounter::ExportChromeTrace(const std::wstring& sFilePath) const
+{
+    const auto& pFileSystem = ra::services::ServiceLocator::Get<ra::services::IFileSystem>();
+    auto pWriter = pFileSystem.CreateTextFile(sFilePath);
+    if (pWriter == nullptr)
     {
-        const auto nLapAverage = m_nLapTotal / NUM_LAPS;
-
-        if (m_nTotalLaps % NUM_LAPS == 0) 
-        {
-            RA_LOG_INFO("Lap averages: total: %d.%03dms", nLapAverage / 1000, nLapAverage % 1000);
-            for (gsl::index i = 0; i < ra::etoi(PerformanceCheckpoint::NUM_CHECKPOINTS); ++i)
-            {
-                const auto nCheckpointTime = pLap.at(i);
-                if (nCheckpointTime != 0)
-                {
-                    const auto nCheckpointAverage = m_nRollingTotals.at(i) / NUM_LAPS;
-                    RA_LOG_INFO(" %s: %d.%03dms", GetLabel(ra::itoe<PerformanceCheckpoint>(i)), nCheckpointAverage / 1000, nCheckpointAverage % 1000);
-                }
-            }
-        }
-        else if (nLapTime > 100) // ignore everything under 100us
-        {
-            if (nLapTime > 2000) // to achieve 60 fps, emulator has to render every 16ms, we don't want to use more than 2ms of that.
-            {
-                RA_LOG_INFO("Outstanding lap: %d.%03dms (avg: %d.%03dms)", nLapTime / 1000, nLapTime % 1000, nLapAverage / 1000, nLapAverage % 1000);
-
-                for (gsl::index i = 0; i < ra::etoi(PerformanceCheckpoint::NUM_CHECKPOINTS); ++i)
-                {
-                    const auto nCheckpointTime = pLap.at(i);
-                    if (nCheckpointTime != 0)
-                        DumpCheckpoint(ra::itoe<PerformanceCheckpoint>(i), nCheckpointTime);
-                }
-            }
-            else
-            {
-                for (gsl::index i = 1; i < ra::etoi(PerformanceCheckpoint::NUM_CHECKPOINTS); ++i)
-                {
-                    const auto nCheckpointTime = pLap.at(i);
-                    if (nCheckpointTime > 75 && nCheckpointTime > m_nRollingTotals.at(i) * 2)
-                        DumpCheckpoint(ra::itoe<PerformanceCheckpoint>(i), nCheckpointTime);
-                }
-            }
-        }
+        RA_LOG_ERR("Could not create %s", sFilePath);
+        return false;
     }
+
+    ExportChromeTrace(*pWriter);
+    RA_LOG_INFO("Wrote performance trace to %s", sFilePath);
+    return true;
 }
 
-void PerformanceCounter::DumpCheckpoint(PerformanceCheckpoint nCheckpoint, int nCheckpointTime)
+PerformanceScope::PerformanceScope(PerformanceCheckpoint nCheckpoint)
+    : m_nCheckpoint(nCheckpoint)
 {
-    const auto nCheckpointAverage = m_nRollingTotals.at(ra::etoi(nCheckpoint)) / NUM_LAPS;
-    RA_LOG_INFO(" %s: %d.%03dms (avg: %d.%03dms)", GetLabel(nCheckpoint), nCheckpointTime / 1000, nCheckpointTime % 1000, nCheckpointAverage / 1000, nCheckpointAverage % 1000);
+    auto& pCounter = ra::services::ServiceLocator::GetMutable<ra::services::PerformanceCounter>();
+    if (pCounter.IsEnabled())
+    {
+        m_pCounter = &pCounter;
+        m_tStart = ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime();
+    }
+}
+
+GSL_SUPPRESS_F6
+PerformanceScope::~PerformanceScope() noexcept
+{
+    if (m_pCounter)
+        m_pCounter->Record(m_nCheckpoint, m_tStart, ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime());
 }
 
 } // namespace services
 } // namespace ra
-
-#endif // PERFORMANCE_COUNTERS
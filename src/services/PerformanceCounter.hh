@@ -2,15 +2,15 @@
 #define RA_SERVICES_PERFORMANCECOUNTER_H
 #pragma once
 
-#ifndef RA_UTEST
-//#define PERFORMANCE_COUNTERS
-#endif
+#include "services\TextWriter.hh"
 
 enum class PerformanceCheckpoint
 {
     RuntimeProcess = 0,
+    RuntimeDoFrame,
     RuntimeEvents,
     OverlayManagerAdvanceFrame,
+    OverlayRender,
     MemoryBookmarksDoFrame,
     MemoryInspectorDoFrame,
     AssetListDoFrame,
@@ -18,63 +18,165 @@ enum class PerformanceCheckpoint
     PointerFinderDoFrame,
     PointerInspectorDoFrame,
     FrameEvents,
+    Frame,
 
     NUM_CHECKPOINTS
 };
 
-#ifdef PERFORMANCE_COUNTERS
-
-#include "services/ServiceLocator.hh"
-
 namespace ra {
 namespace services {
 
 class PerformanceCounter
 {
 public:
+    PerformanceCounter() noexcept = default;
+    ~PerformanceCounter() noexcept = default;
+    PerformanceCounter(const PerformanceCounter&) noexcept = delete;
+    PerformanceCounter& operator=(const PerformanceCounter&) noexcept = delete;
+    PerformanceCounter(PerformanceCounter&&) noexcept = delete;
+    PerformanceCounter& operator=(PerformanceCounter&&) noexcept = delete;
+
+    /// <summary>
+    /// Determines if timings are being recorded.
+    /// </summary>
+    bool IsEnabled() const noexcept { return m_bEnabled.load(std::memory_order_acquire); }
+
+    /// <summary>
+    /// Starts or stops recording timings.
+    /// </summary>
+    void SetEnabled(bool bEnabled);
+
+    /// <summary>
+    /// Starts timing a checkpoint of the current frame. The checkpoint ends when the next checkpoint is
+    /// tallied or the frame is stopped.
+    /// </summary>
     void Tally(PerformanceCheckpoint nCheckpoint);
 
+    /// <summary>
+    /// Ends the current frame.
+    /// </summary>
     void Stop();
 
-private:
-    void DumpCheckpoint(PerformanceCheckpoint nCheckpoint, int nCheckpointTime);
+    /// <summary>
+    /// Records a timing that was captured outside of <see cref="Tally" />. May be called from any thread.
+    /// </summary>
+    void Record(PerformanceCheckpoint nCheckpoint, std::chrono::steady_clock::time_point tStart,
+                std::chrono::steady_clock::time_point tEnd) noexcept;
+
+    struct Statistics
+    {
+        size_t nSamples = 0;
+        int nP50 = 0; // microseconds
+        int nP99 = 0; // microseconds
+        int nMax = 0; // microseconds
+    };
+
+    /// <summary>
+    /// Gets the distribution of the timings still in the buffer for a checkpoint.
+    /// </summary>
+    Statistics GetStatistics(PerformanceCheckpoint nCheckpoint) const;
+
+    /// <summary>
+    /// Writes the timings still in the buffer as a Chrome trace (chrome://tracing, Perfetto).
+    /// </summary>
+    void ExportChromeTrace(ra::services::TextWriter& pWriter) const;
+
+    /// <summary>
+    /// Writes the timings still in the buffer to a Chrome trace file. Recording does not have to be stopped.
+    /// </summary>
+    /// <returns><c>true</c> if the file was written, <c>false</c> if it could not be created.</returns>
+    bool ExportChromeTrace(const std::wstring& sFilePath) const;
+
+    /// <summary>
+    /// Gets the label used to identify a checkpoint in the log and trace files.
+    /// </summary>
+    static const char* GetLabel(PerformanceCheckpoint nCheckpoint) noexcept;
+
+    // number of events retained. about a minute of frames at 60fps.
+    static constexpr size_t EVENT_BUFFER_SIZE = 128 * 1024;
 
-    struct Measurement
+private:
+    struct Event
     {
-        Measurement(PerformanceCheckpoint nCheckpoint, std::chrono::steady_clock::time_point tWhen) noexcept
-        {
-            this->nCheckpoint = nCheckpoint;
-            this->tWhen = tWhen;
-        }
+        // index of the event + 1. zero while the slot is being written. see ReadEvents.
+        std::atomic<uint64_t> nSequence{ 0 };
+
+        // a reader may copy the fields while a recorder is writing them. they're atomic so that isn't a data
+        // race, but only accessed with relaxed ordering. nSequence determines whether the copy is usable.
+        std::atomic<int64_t> nStart{ 0 }; // microseconds since m_tEpoch
+        std::atomic<int> nDuration{ 0 }; // microseconds
+        std::atomic<uint32_t> nFrame{ 0 };
+        std::atomic<uint32_t> nThreadId{ 0 };
+        std::atomic<PerformanceCheckpoint> nCheckpoint{ PerformanceCheckpoint::NUM_CHECKPOINTS };
+    };
 
+    struct EventData
+    {
+        int64_t nStart;
+        int nDuration;
+        uint32_t nFrame;
+        uint32_t nThreadId;
         PerformanceCheckpoint nCheckpoint;
-        std::chrono::steady_clock::time_point tWhen;
     };
 
-    std::vector<Measurement> m_vMeasurements;
+    std::vector<EventData> ReadEvents(uint64_t nMaxEvents) const;
+    void LogStatistics() const;
+    void LogFrame(uint32_t nFrame, int nFrameTime) const;
+
+    std::atomic_bool m_bEnabled{ false };
+    std::unique_ptr<Event[]> m_pEvents;
+    std::atomic<uint64_t> m_nNextEvent{ 0 };
+    std::atomic<uint32_t> m_nFrame{ 0 };
+    std::chrono::steady_clock::time_point m_tEpoch;
+
+    // the frame is only ever tallied by the emulator thread
+    PerformanceCheckpoint m_nCurrentCheckpoint = PerformanceCheckpoint::NUM_CHECKPOINTS;
+    std::chrono::steady_clock::time_point m_tCheckpointStart;
+    std::chrono::steady_clock::time_point m_tFrameStart;
+};
 
-    size_t m_nTotalLaps = 0;
-    
-    using Lap = std::array<int, static_cast<size_t>(PerformanceCheckpoint::NUM_CHECKPOINTS)>;
-    Lap m_nRollingTotals;
-    int m_nLapTotal = 0;
+/// <summary>
+/// Records the time until the object goes out of scope. Scopes may be nested within each other and within tallied
+/// checkpoints.
+/// </summary>
+class PerformanceScope
+{
+public:
+    explicit PerformanceScope(PerformanceCheckpoint nCheckpoint);
+    ~PerformanceScope() noexcept;
+    PerformanceScope(const PerformanceScope&) noexcept = delete;
+    PerformanceScope& operator=(const PerformanceScope&) noexcept = delete;
+    PerformanceScope(PerformanceScope&&) noexcept = delete;
+    PerformanceScope& operator=(PerformanceScope&&) noexcept = delete;
 
-    static constexpr size_t NUM_LAPS = 3600; // once per minute, log overall averages
-    std::array<Lap, NUM_LAPS> m_vLaps;
-    gsl::index m_nNextLap = 0;
+private:
+    PerformanceCounter* m_pCounter = nullptr;
+    PerformanceCheckpoint m_nCheckpoint;
+    std::chrono::steady_clock::time_point m_tStart;
 };
 
 } // namespace services
 } // namespace ra
 
-#define TALLY_PERFORMANCE(checkpoint) ra::services::ServiceLocator::GetMutable<ra::services::PerformanceCounter>().Tally(checkpoint)
+#ifndef RA_UTEST
+
+#include "services\ServiceLocator.hh"
+
+#define TALLY_PERFORMANCE(checkpoint) \
+{ \
+    auto& __pPerformanceCounter = ra::services::ServiceLocator::GetMutable<ra::services::PerformanceCounter>(); \
+    if (__pPerformanceCounter.IsEnabled()) \
+        __pPerformanceCounter.Tally(checkpoint); \
+}
 #define CHECK_PERFORMANCE() ra::services::ServiceLocator::GetMutable<ra::services::PerformanceCounter>().Stop()
+#define PERFORMANCE_SCOPE(checkpoint) ra::services::PerformanceScope __pPerformanceScope(checkpoint)
 
-#else // PERFORMANCE_COUNTERS
+#else // RA_UTEST
 
-#define TALLY_PERFORMANCE(checkpoint) 
+#define TALLY_PERFORMANCE(checkpoint)
 #define CHECK_PERFORMANCE()
+#define PERFORMANCE_SCOPE(checkpoint)
 
-#endif // PERFORMANCE_COUNTERS
+#endif // RA_UTEST
 
-#endif !RA_SERVICES_PERFORMANCECOUNTER_H
+#endif // !RA_SERVICES_PERFORMANCECOUNTER_H
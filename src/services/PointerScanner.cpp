@@ -0,0 +1,425 @@
+#include "PointerScanner.hh"
+
+#include "services\ParallelPartitions.hh"
+
+#include "search\SearchImpl_vectorized.hh"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+namespace ra {
+namespace services {
+
+// scans covering less memory than this aren't worth distributing across threads
+_CONSTANT_VAR PARALLEL_SCAN_THRESHOLD = 256U * 1024U; // 256K
+
+// work is split into partitions of at least this many addresses so threads aren't constantly synchronizing
+_CONSTANT_VAR PARALLEL_SCAN_MIN_PARTITION_SIZE = 64U * 1024U; // 64K
+
+// limits the number of addresses per state that can be the second pointer in a chain. if the window is large
+// enough that more addresses than this qualify, the chain search would be too slow and too noisy to be useful.
+_CONSTANT_VAR MAX_CHAIN_CANDIDATES = 1024U * 1024U; // 1M
+
+struct PointerScanner::ScanContext
+{
+    // copy of the memory for each state, padded so a full value can be read at any address
+    std::vector<std::vector<uint8_t>> vMemory;
+
+    // target address for each state
+    std::vector<uint32_t> vTargetAddresses;
+
+    // number of addresses that can hold a complete value
+    uint32_t nAddressCount = 0U;
+};
+
+void PointerScanner::SetSearchType(SearchType nSearchType) noexcept
+{
+    switch (nSearchType)
+    {
+        case SearchType::SixteenBit:
+            m_nValueSize = 2U;
+            m_nAlignment = 1U;
+            m_bBigEndian = false;
+            break;
+        case SearchType::SixteenBitAligned:
+            m_nValueSize = 2U;
+            m_nAlignment = 2U;
+            m_bBigEndian = false;
+            break;
+        case SearchType::SixteenBitBigEndian:
+            m_nValueSize = 2U;
+            m_nAlignment = 1U;
+            m_bBigEndian = true;
+            break;
+        case SearchType::SixteenBitBigEndianAligned:
+            m_nValueSize = 2U;
+            m_nAlignment = 2U;
+            m_bBigEndian = true;
+            break;
+        case SearchType::TwentyFourBit:
+            m_nValueSize = 3U;
+            m_nAlignment = 1U;
+            m_bBigEndian = false;
+            break;
+        case SearchType::ThirtyTwoBit:
+            m_nValueSize = 4U;
+            m_nAlignment = 1U;
+            m_bBigEndian = false;
+            break;
+        case SearchType::ThirtyTwoBitBigEndian:
+            m_nValueSize = 4U;
+            m_nAlignment = 1U;
+            m_bBigEndian = true;
+            break;
+        case SearchType::ThirtyTwoBitBigEndianAligned:
+            m_nValueSize = 4U;
+            m_nAlignment = 4U;
+            m_bBigEndian = true;
+            break;
+        default:
+            m_nValueSize = 4U;
+            m_nAlignment = 4U;
+            m_bBigEndian = false;
+            break;
+    }
+}
+
+void PointerScanner::AddPointerBias(uint32_t nBias)
+{
+    if (std::find(m_vPointerBiases.begin(), m_vPointerBiases.end(), nBias) == m_vPointerBiases.end())
+        m_vPointerBiases.push_back(nBias);
+}
+
+bool PointerScanner::IsOffsetInRange(uint32_t nOffset) const noexcept
+{
+    if (m_nMaxOffset == 0U)
+        return true;
+
+    // unsigned math: (offset - bias) is in [-max, +max] if shifting it by max puts it in [0, 2 * max]
+    const auto nWindow = std::min(m_nMaxOffset, 0x7FFFFFFFU);
+    for (const auto nBias : m_vPointerBiases)
+    {
+        if (nOffset - nBias + nWindow <= nWindow * 2)
+            return true;
+    }
+
+    return false;
+}
+
+GSL_SUPPRESS_BOUNDS4
+static uint32_t ReadValue(const uint8_t* pBytes, uint32_t nSize, bool bBigEndian) noexcept
+{
+    switch (nSize)
+    {
+        case 2:
+            return bBigEndian ? ((pBytes[0] << 8) | pBytes[1]) : (pBytes[0] | (pBytes[1] << 8));
+        case 3:
+            return bBigEndian ? ((pBytes[0] << 16) | (pBytes[1] << 8) | pBytes[2])
+                              : (pBytes[0] | (pBytes[1] << 8) | (pBytes[2] << 16));
+        default:
+            return bBigEndian ? ((static_cast<uint32_t>(pBytes[0]) << 24) | (pBytes[1] << 16) | (pBytes[2] << 8) | pBytes[3])
+                              : (pBytes[0] | (pBytes[1] << 8) | (pBytes[2] << 16) | (static_cast<uint32_t>(pBytes[3]) << 24));
+    }
+}
+
+#ifdef RA_SEARCH_VECTORIZED
+
+// returns a bit for each 32-bit value in the chunk where every state is offset from the first state by the
+// same amount as the target addresses are.
+template<typename TKernel>
+static uint32_t MatchPointerChunk(const std::vector<std::vector<uint8_t>>& vMemory,
+                                  const std::vector<uint32_t>& vTargetAddresses, uint32_t nAddress) noexcept
+{
+    const uint8_t* pFirst = vMemory.front().data() + nAddress;
+    uint32_t nMask = 0xFF;
+    for (size_t nState = 1; nState < vMemory.size() && nMask; ++nState)
+    {
+        nMask &= TKernel::EqualPlus(vMemory.at(nState).data() + nAddress, pFirst,
+                                    vTargetAddresses.at(nState) - vTargetAddresses.front());
+    }
+
+    return nMask;
+}
+
+#endif
+
+void PointerScanner::FindPointers(const ScanContext& pContext, uint32_t nFirstAddress, uint32_t nStopAddress,
+                                  std::vector<Result>& vResults) const
+{
+    const auto nStates = pContext.vMemory.size();
+
+    auto fCheckAddress = [this, &pContext, nStates, &vResults](uint32_t nAddress)
+    {
+        const auto nValue = ReadValue(pContext.vMemory.front().data() + nAddress, m_nValueSize, m_bBigEndian);
+        const auto nOffset = pContext.vTargetAddresses.front() - nValue;
+
+        for (size_t nState = 1; nState < nStates; ++nState)
+        {
+            const auto nStateValue = ReadValue(pContext.vMemory.at(nState).data() + nAddress, m_nValueSize, m_bBigEndian);
+            if (pContext.vTargetAddresses.at(nState) - nStateValue != nOffset)
+                return;
+        }
+
+        if (!IsOffsetInRange(nOffset))
+            return;
+
+        auto& pResult = vResults.emplace_back();
+        pResult.nAddress = nAddress;
+        pResult.vOffsets.push_back(nOffset);
+        pResult.vValues.reserve(nStates);
+        for (size_t nState = 0; nState < nStates; ++nState)
+            pResult.vValues.push_back(pContext.vTargetAddresses.at(nState) - nOffset);
+    };
+
+    auto nAddress = nFirstAddress;
+
+#ifdef RA_SEARCH_VECTORIZED
+    // aligned little endian 32-bit values map directly onto the vector lanes. the partitions are aligned to the
+    // chunk size, so the chunks are too. the kernel eliminates most addresses, the scalar code verifies the rest.
+    if (m_nValueSize == 4 && m_nAlignment == 4 && !m_bBigEndian)
+    {
+        using namespace ra::services::search;
+        const auto nInstructionSet = vectorized::GetInstructionSet();
+        if (nInstructionSet != vectorized::InstructionSet::None)
+        {
+            for (; nAddress + vectorized::CHUNK_SIZE <= nStopAddress; nAddress += vectorized::CHUNK_SIZE)
+            {
+                auto nMask = (nInstructionSet == vectorized::InstructionSet::AVX2)
+                    ? MatchPointerChunk<vectorized::AVX2Kernel>(pContext.vMemory, pContext.vTargetAddresses, nAddress)
+                    : MatchPointerChunk<vectorized::SSE2Kernel>(pContext.vMemory, pContext.vTargetAddresses, nAddress);
+
+                for (uint32_t nLane = 0; nMask; ++nLane, nMask >>= 1)
+                {
+                    if (nMask & 1)
+                        fCheckAddress(nAddress + nLane * 4);
+                }
+            }
+        }
+    }
+#endif
+
+    for (; nAddress < nStopAddress; nAddress += m_nAlignment)
+        fCheckAddress(nAddress);
+}
+
+void PointerScanner::FindCandidates(const ScanContext& pContext, uint32_t nFirstAddress, uint32_t nStopAddress,
+                                    std::vector<std::vector<Candidate>>& vCandidates) const
+{
+    const auto nStates = pContext.vMemory.size();
+    vCandidates.resize(nStates);
+
+    for (size_t nState = 0; nState < nStates; ++nState)
+    {
+        const auto* pMemory = pContext.vMemory.at(nState).data();
+        const auto nTargetAddress = pContext.vTargetAddresses.at(nState);
+        auto& vStateCandidates = vCandidates.at(nState);
+
+        for (auto nAddress = nFirstAddress; nAddress < nStopAddress; nAddress += m_nAlignment)
+        {
+            const auto nOffset = nTargetAddress - ReadValue(pMemory + nAddress, m_nValueSize, m_bBigEndian);
+            if (IsOffsetInRange(nOffset))
+                vStateCandidates.push_back({ nAddress, nOffset });
+        }
+    }
+}
+
+void PointerScanner::FindChains(const ScanContext& pContext, const std::vector<std::vector<Candidate>>& vCandidates,
+                                uint32_t nFirstAddress, uint32_t nStopAddress, std::vector<Result>& vResults) const
+{
+    const auto nStates = pContext.vMemory.size();
+    const auto& vFirstCandidates = vCandidates.front();
+    const auto nWindow = std::min(m_nMaxOffset, 0x7FFFFFFFU);
+    std::vector<uint32_t> vValues(nStates);
+
+    auto fFindCandidate = [](const std::vector<Candidate>& vStateCandidates, uint32_t nAddress)
+    {
+        return std::lower_bound(vStateCandidates.begin(), vStateCandidates.end(), nAddress,
+            [](const Candidate& pCandidate, uint32_t nValue) noexcept { return pCandidate.nAddress < nValue; });
+    };
+
+    for (auto nAddress = nFirstAddress; nAddress < nStopAddress; nAddress += m_nAlignment)
+    {
+        bool bChanged = false;
+        for (size_t nState = 0; nState < nStates; ++nState)
+        {
+            vValues.at(nState) = ReadValue(pContext.vMemory.at(nState).data() + nAddress, m_nValueSize, m_bBigEndian);
+            bChanged |= (vValues.at(nState) != vValues.front());
+        }
+
+        // a pointer to a pointer that doesn't move is just a pointer that doesn't move. the direct scan will
+        // find the second pointer if it's interesting.
+        if (!bChanged)
+            continue;
+
+        const auto nFirstResult = vResults.size();
+        for (const auto nBias : m_vPointerBiases)
+        {
+            // the addresses the pointer could be pointing at in the first state. split the range if it wraps.
+            const auto nStart = vValues.front() + nBias - nWindow;
+            const auto nEnd = nStart + nWindow * 2;
+            std::array<std::pair<uint32_t, uint32_t>, 2> vRanges{};
+            size_t nRanges = 0;
+            if (nEnd >= nStart)
+            {
+                vRanges.at(nRanges++) = { nStart, nEnd };
+            }
+            else
+            {
+                vRanges.at(nRanges++) = { 0U, nEnd };
+                vRanges.at(nRanges++) = { nStart, 0xFFFFFFFFU };
+            }
+
+            for (size_t nRange = 0; nRange < nRanges; ++nRange)
+            {
+                const auto& pRange = vRanges.at(nRange);
+                for (auto pIter = fFindCandidate(vFirstCandidates, pRange.first);
+                     pIter != vFirstCandidates.end() && pIter->nAddress <= pRange.second; ++pIter)
+                {
+                    const auto nChainOffset = pIter->nAddress - vValues.front();
+
+                    bool bMatch = true;
+                    for (size_t nState = 1; nState < nStates; ++nState)
+                    {
+                        const auto& vStateCandidates = vCandidates.at(nState);
+                        const auto nStateAddress = vValues.at(nState) + nChainOffset;
+                        const auto pStateIter = fFindCandidate(vStateCandidates, nStateAddress);
+                        if (pStateIter == vStateCandidates.end() || pStateIter->nAddress != nStateAddress ||
+                            pStateIter->nOffset != pIter->nOffset)
+                        {
+                            bMatch = false;
+                            break;
+                        }
+                    }
+
+                    if (bMatch)
+                    {
+                        auto& pResult = vResults.emplace_back();
+                        pResult.nAddress = nAddress;
+                        pResult.vOffsets = { nChainOffset, pIter->nOffset };
+                        pResult.vValues = vValues;
+                    }
+                }
+            }
+        }
+
+        // overlapping bias windows can find the same chain more than once
+        if (m_vPointerBiases.size() > 1 && vResults.size() - nFirstResult > 1)
+        {
+            const auto pFirst = vResults.begin() + nFirstResult;
+            std::sort(pFirst, vResults.end(), [](const Result& pLeft, const Result& pRight) {
+                return pLeft.vOffsets < pRight.vOffsets;
+            });
+            vResults.erase(std::unique(pFirst, vResults.end(), [](const Result& pLeft, const Result& pRight) {
+                return pLeft.vOffsets == pRight.vOffsets;
+            }), vResults.end());
+        }
+    }
+}
+
+std::vector<PointerScanner::Result> PointerScanner::Find(const std::vector<State>& vStates) const
+{
+    std::vector<Result> vResults;
+    if (vStates.empty())
+        return vResults;
+
+    // copy each state into a flat buffer so the workers don't have to locate blocks (or decompress them).
+    // uncaptured memory is treated as zeros.
+    ScanContext pContext;
+    uint32_t nMemorySize = 0U;
+    for (const auto& pState : vStates)
+    {
+        Expects(pState.pMemory != nullptr);
+        for (const auto& pRange : pState.pMemory->GetCapturedMemoryRanges())
+            nMemorySize = std::max(nMemorySize, pRange.first + pRange.second);
+    }
+
+    if (nMemorySize < m_nValueSize)
+        return vResults;
+
+    pContext.nAddressCount = nMemorySize - m_nValueSize + 1;
+    pContext.vMemory.reserve(vStates.size());
+    pContext.vTargetAddresses.reserve(vStates.size());
+    for (const auto& pState : vStates)
+    {
+        auto& vMemory = pContext.vMemory.emplace_back(nMemorySize + sizeof(uint32_t), gsl::narrow_cast<uint8_t>(0));
+        for (const auto& pRange : pState.pMemory->GetCapturedMemoryRanges())
+            pState.pMemory->GetBytes(pRange.first, vMemory.data() + pRange.first, pRange.second);
+
+        pContext.vTargetAddresses.push_back(pState.nTargetAddress);
+    }
+
+    // split the address space into partitions aligned to the vector chunk size
+    const auto nAddressCount = pContext.nAddressCount;
+    size_t nPartitionSize = nAddressCount;
+    if (nAddressCount >= PARALLEL_SCAN_THRESHOLD)
+    {
+        const size_t nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+        nPartitionSize = std::max(nAddressCount / (nThreads * 4), size_t{ PARALLEL_SCAN_MIN_PARTITION_SIZE });
+        nPartitionSize = (nPartitionSize + search::vectorized::CHUNK_SIZE - 1) & ~size_t{ search::vectorized::CHUNK_SIZE - 1 };
+    }
+    const size_t nPartitions = (nAddressCount + nPartitionSize - 1) / nPartitionSize;
+
+    auto fGetPartitionRange = [nAddressCount, nPartitionSize](size_t nPartition) noexcept
+    {
+        const auto nFirst = gsl::narrow_cast<uint32_t>(nPartition * nPartitionSize);
+        const auto nStop = gsl::narrow_cast<uint32_t>(std::min(nFirst + nPartitionSize, size_t{ nAddressCount }));
+        return std::make_pair(nFirst, nStop);
+    };
+
+    // direct pointers
+    std::vector<std::vector<Result>> vPartitionResults(nPartitions);
+    ProcessPartitions(nPartitions, [this, &pContext, &vPartitionResults, &fGetPartitionRange](size_t nPartition) {
+        const auto pRange = fGetPartitionRange(nPartition);
+        FindPointers(pContext, pRange.first, pRange.second, vPartitionResults.at(nPartition));
+    });
+
+    for (auto& vPartition : vPartitionResults)
+        std::move(vPartition.begin(), vPartition.end(), std::back_inserter(vResults));
+
+    // pointers to pointers. without a window, every address would be a candidate for the second pointer.
+    if (m_nMaxDepth < 2 || m_nMaxOffset == 0U)
+        return vResults;
+
+    std::vector<std::vector<std::vector<Candidate>>> vPartitionCandidates(nPartitions);
+    ProcessPartitions(nPartitions, [this, &pContext, &vPartitionCandidates, &fGetPartitionRange](size_t nPartition) {
+        const auto pRange = fGetPartitionRange(nPartition);
+        FindCandidates(pContext, pRange.first, pRange.second, vPartitionCandidates.at(nPartition));
+    });
+
+    std::vector<std::vector<Candidate>> vCandidates(vStates.size());
+    for (size_t nState = 0; nState < vStates.size(); ++nState)
+    {
+        auto& vStateCandidates = vCandidates.at(nState);
+        for (auto& vPartition : vPartitionCandidates)
+        {
+            const auto& vPartitionStateCandidates = vPartition.at(nState);
+            vStateCandidates.insert(vStateCandidates.end(), vPartitionStateCandidates.begin(), vPartitionStateCandidates.end());
+        }
+
+        if (vStateCandidates.empty() || vStateCandidates.size() > MAX_CHAIN_CANDIDATES)
+            return vResults;
+    }
+    vPartitionCandidates.clear();
+
+    for (auto& vPartition : vPartitionResults)
+        vPartition.clear();
+
+    ProcessPartitions(nPartitions, [this, &pContext, &vCandidates, &vPartitionResults, &fGetPartitionRange](size_t nPartition) {
+        const auto pRange = fGetPartitionRange(nPartition);
+        FindChains(pContext, vCandidates, pRange.first, pRange.second, vPartitionResults.at(nPartition));
+    });
+
+    for (auto& vPartition : vPartitionResults)
+        std::move(vPartition.begin(), vPartition.end(), std::back_inserter(vResults));
+
+    // direct pointers were added first, so a stable sort keeps them ahead of chains starting at the same address
+    std::stable_sort(vResults.begin(), vResults.end(), [](const Result& pLeft, const Result& pRight) noexcept {
+        return pLeft.nAddress < pRight.nAddress;
+    });
+
+    return vResults;
+}
+
+} // namespace services
+} // namespace ra
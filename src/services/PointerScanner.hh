@@ -0,0 +1,111 @@
+#ifndef RA_SERVICES_POINTERSCANNER_HH
+#define RA_SERVICES_POINTERSCANNER_HH
+#pragma once
+
+#include "services\SearchResults.h"
+
+namespace ra {
+namespace services {
+
+/// <summary>
+/// Locates addresses that consistently point at a target address across several captured memory states.
+/// </summary>
+class PointerScanner
+{
+public:
+    /// <summary>
+    /// A captured memory state and the address of the data being pointed at in that state.
+    /// </summary>
+    struct State
+    {
+        const SearchResults* pMemory = nullptr;
+        ra::data::ByteAddress nTargetAddress = 0U;
+    };
+
+    /// <summary>
+    /// A pointer (or chain of pointers) that resolves to the target address in every state.
+    /// </summary>
+    struct Result
+    {
+        // address of the pointer. it's at the same address in every state.
+        ra::data::ByteAddress nAddress = 0U;
+
+        // offsets to add to each pointer in the chain, starting with the value at nAddress. adding the last
+        // offset to the last pointer in the chain yields the target address.
+        std::vector<uint32_t> vOffsets;
+
+        // value of the pointer at nAddress in each state.
+        std::vector<uint32_t> vValues;
+    };
+
+    /// <summary>
+    /// Sets the type of value that holds a pointer.
+    /// </summary>
+    /// <remarks>
+    /// Only the 16-bit, 24-bit, and 32-bit integer search types (including aligned and big endian variants) are
+    /// supported. Aligned types only consider addresses that are a multiple of the value size.
+    /// </remarks>
+    void SetSearchType(SearchType nSearchType) noexcept;
+
+    /// <summary>
+    /// Sets the maximum distance between where a pointer points and the address being looked for.
+    /// </summary>
+    /// <remarks>
+    /// 0 allows any offset. Multi-level chains are only searched when there's a maximum offset.
+    /// </remarks>
+    void SetMaxOffset(uint32_t nMaxOffset) noexcept { m_nMaxOffset = nMaxOffset; }
+
+    /// <summary>
+    /// Sets the maximum number of pointers in a chain. 1 only finds pointers directly to the target address,
+    /// 2 also finds pointers to pointers to the target address.
+    /// </summary>
+    void SetMaxDepth(uint32_t nMaxDepth) noexcept { m_nMaxDepth = std::max(std::min(nMaxDepth, 2U), 1U); }
+
+    /// <summary>
+    /// Registers a value that converts a pointer value into an address, allowing offsets to be measured
+    /// relative to it. Used for systems where the pointers hold real addresses.
+    /// </summary>
+    /// <remarks>
+    /// For a memory region, this is the difference between the first address of the region and the first
+    /// real address of the region. The reported offsets still include the bias so they can be directly
+    /// added to the pointer values.
+    /// </remarks>
+    void AddPointerBias(uint32_t nBias);
+
+    /// <summary>
+    /// Finds all pointers that resolve to the target address in every provided state.
+    /// </summary>
+    /// <returns>The pointers found, ordered by address and then by chain length.</returns>
+    std::vector<Result> Find(const std::vector<State>& vStates) const;
+
+private:
+    struct Candidate
+    {
+        ra::data::ByteAddress nAddress;
+        uint32_t nOffset;
+    };
+
+    struct ScanContext;
+
+    bool IsOffsetInRange(uint32_t nOffset) const noexcept;
+
+    void FindPointers(const ScanContext& pContext, uint32_t nFirstAddress, uint32_t nStopAddress,
+                      std::vector<Result>& vResults) const;
+    void FindCandidates(const ScanContext& pContext, uint32_t nFirstAddress, uint32_t nStopAddress,
+                        std::vector<std::vector<Candidate>>& vCandidates) const;
+    void FindChains(const ScanContext& pContext, const std::vector<std::vector<Candidate>>& vCandidates,
+                    uint32_t nFirstAddress, uint32_t nStopAddress, std::vector<Result>& vResults) const;
+
+    uint32_t m_nValueSize = 4U;
+    uint32_t m_nAlignment = 4U;
+    bool m_bBigEndian = false;
+
+    uint32_t m_nMaxOffset = 0U;
+    uint32_t m_nMaxDepth = 1U;
+    std::vector<uint32_t> m_vPointerBiases{ 0U };
+};
+
+} // namespace services
+} // namespace ra
+
+#endif /* !RA_SERVICES_POINTERSCANNER_HH */
@@ -1,13 +1,69 @@
 #include "SearchImpl.hh"
 
+#include "services\IThreadPool.hh"
+#include "services\ParallelPartitions.hh"
+#include "services\ServiceLocator.hh"
+
 #include "util\TypeCasts.hh"
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 namespace ra {
 namespace services {
 namespace search {
 
+namespace vectorized {
+
+static InstructionSet DetectInstructionSet() noexcept
+{
+#ifdef RA_SEARCH_VECTORIZED
+    std::array<int, 4> vRegisters{};
+    __cpuid(vRegisters.data(), 0);
+    const int nMaxLeaf = vRegisters.at(0);
+
+    __cpuid(vRegisters.data(), 1);
+    const bool bHasSSE2 = (vRegisters.at(3) & (1 << 26)) != 0;
+    const bool bHasOSXSAVE = (vRegisters.at(2) & (1 << 27)) != 0;
+
+    // AVX2 requires the OS to preserve the YMM registers across context switches
+    if (nMaxLeaf >= 7 && bHasOSXSAVE && (_xgetbv(0) & 0x06) == 0x06)
+    {
+        __cpuidex(vRegisters.data(), 7, 0);
+        if (vRegisters.at(1) & (1 << 5))
+            return InstructionSet::AVX2;
+    }
+
+    if (bHasSSE2)
+        return InstructionSet::SSE2;
+#endif
+
+    return InstructionSet::None;
+}
+
+static const InstructionSet s_nSupportedInstructionSet = DetectInstructionSet();
+
+// may be changed while searches are running on other threads. searches only need to see the change eventually.
+static std::atomic<InstructionSet> s_nInstructionSet{ s_nSupportedInstructionSet };
+
+InstructionSet GetSupportedInstructionSet() noexcept
+{
+    return s_nSupportedInstructionSet;
+}
+
+InstructionSet GetInstructionSet() noexcept
+{
+    return s_nInstructionSet.load(std::memory_order_relaxed);
+}
+
+void SetInstructionSet(InstructionSet nInstructionSet) noexcept
+{
+    s_nInstructionSet.store(std::min(nInstructionSet, s_nSupportedInstructionSet), std::memory_order_relaxed);
+}
+
+} // namespace vectorized
+
 bool SearchImpl::ContainsAddress(const SearchResults& srResults, ra::data::ByteAddress nAddress) const
 {
     if (nAddress & (GetStride() - 1))
@@ -59,18 +115,27 @@ bool SearchImpl::ValidateFilterValue(SearchResults& srNew) const
     return true;
 }
 
+// filters covering less memory than this aren't worth distributing across threads
+_CONSTANT_VAR PARALLEL_FILTER_THRESHOLD = 256U * 1024U; // 256K
+
+// work is split into partitions of at least this many bytes so threads aren't constantly synchronizing
+_CONSTANT_VAR PARALLEL_FILTER_MIN_PARTITION_SIZE = 64U * 1024U; // 64K
+
+// and at most this many bytes (unless a single block is larger) so the memory captured for the partitions
+// being processed at any one time stays small
+_CONSTANT_VAR PARALLEL_FILTER_MAX_PARTITION_SIZE = 1024U * 1024U; // 1M
+
 void SearchImpl::ApplyFilter(SearchResults& srNew, const SearchResults& srPrevious, std::function<void(ra::data::ByteAddress,uint8_t*,size_t)> pReadMemory) const
 {
+    size_t nTotalBytes = 0U;
     uint32_t nLargestBlock = 0U;
     for (auto& block : srPrevious.m_vBlocks)
     {
+        nTotalBytes += block.GetBytesSize();
         if (block.GetBytesSize() > nLargestBlock)
             nLargestBlock = block.GetBytesSize();
     }
 
-    std::vector<uint8_t> vMemory(nLargestBlock);
-    std::vector<ra::data::ByteAddress> vMatches;
-
     uint32_t nAdjustment = 0;
     switch (srNew.GetFilterType())
     {
@@ -84,85 +149,220 @@ void SearchImpl::ApplyFilter(SearchResults& srNew, const SearchResults& srPrevio
             break;
     }
 
+    if (nTotalBytes >= PARALLEL_FILTER_THRESHOLD && srPrevious.m_vBlocks.size() > 1 &&
+        ra::services::ServiceLocator::Exists<ra::services::IThreadPool>())
+    {
+        ApplyFilterParallel(srNew, srPrevious, pReadMemory, nAdjustment, nTotalBytes);
+        return;
+    }
+
+    std::vector<uint8_t> vMemory(nLargestBlock);
+    MatchingAddressBitmap vMatches;
+
     for (auto& block : srPrevious.m_vBlocks)
     {
         const auto nRealAddress = ConvertToRealAddress(block.GetFirstAddress());
         pReadMemory(nRealAddress, vMemory.data(), block.GetBytesSize());
 
-        const auto nStop = block.GetBytesSize() - GetPadding();
+        if (ApplyFilterToBlock(srNew.m_vBlocks, block, vMemory.data(), srNew, nAdjustment, vMatches))
+            srNew.m_vBlocks.emplace_back(block);
+    }
+}
 
-        switch (srNew.GetFilterType())
-        {
-            case SearchFilterType::Constant:
-                ApplyConstantFilter(vMemory.data(), vMemory.data() + nStop, block,
-                    srNew.GetFilterComparison(), srNew.GetFilterValue(), vMatches);
-                break;
+bool SearchImpl::ApplyFilterToBlock(std::vector<CapturedMemoryBlock>& vBlocks, const CapturedMemoryBlock& pPreviousBlock,
+    const uint8_t* pMemory, const SearchResults& srNew, uint32_t nAdjustment, MatchingAddressBitmap& vMatches) const
+{
+    vMatches.Reset(pPreviousBlock.GetFirstAddress(), pPreviousBlock.GetAddressCount());
 
-            default:
-                // if an entire block is unchanged, everything in it is equal to the LastKnownValue
-                // or InitialValue and we don't have to check every address.
-                if (memcmp(vMemory.data(), block.GetBytes(), block.GetBytesSize()) == 0)
+    const auto nStop = pPreviousBlock.GetBytesSize() - GetPadding();
+
+    switch (srNew.GetFilterType())
+    {
+        case SearchFilterType::Constant:
+            ApplyConstantFilter(pMemory, pMemory + nStop, pPreviousBlock,
+                srNew.GetFilterComparison(), srNew.GetFilterValue(), vMatches);
+            break;
+
+        default:
+            // if an entire block is unchanged, everything in it is equal to the LastKnownValue
+            // or InitialValue and we don't have to check every address.
+            if (memcmp(pMemory, pPreviousBlock.GetBytes().Data(), pPreviousBlock.GetBytesSize()) == 0)
+            {
+                switch (srNew.GetFilterComparison())
                 {
-                    switch (srNew.GetFilterComparison())
-                    {
-                        case ComparisonType::Equals:
-                        case ComparisonType::GreaterThanOrEqual:
-                        case ComparisonType::LessThanOrEqual:
-                            if (nAdjustment == 0)
-                            {
-                                // entire block matches, copy the old block
-                                srNew.m_vBlocks.emplace_back(block);
-                                continue;
-                            }
-                            else if (srNew.GetFilterComparison() == ComparisonType::Equals)
-                            {
-                                // entire block matches, so adjustment won't match. discard the block
-                                continue;
-                            }
-                            break;
-
-                        default:
-                            if (nAdjustment == 0)
-                            {
-                                // entire block matches, discard it
-                                continue;
-                            }
-                            break;
-                    }
-
-                    // have to check individual addresses to see if adjustment matches
+                    case ComparisonType::Equals:
+                    case ComparisonType::GreaterThanOrEqual:
+                    case ComparisonType::LessThanOrEqual:
+                        if (nAdjustment == 0)
+                        {
+                            // entire block matches, copy the old block
+                            return true;
+                        }
+                        else if (srNew.GetFilterComparison() == ComparisonType::Equals)
+                        {
+                            // entire block matches, so adjustment won't match. discard the block
+                            return false;
+                        }
+                        break;
+
+                    default:
+                        if (nAdjustment == 0)
+                        {
+                            // entire block matches, discard it
+                            return false;
+                        }
+                        break;
                 }
 
-                // per-address comparison
-                ApplyCompareFilter(vMemory.data(), vMemory.data() + nStop, block,
-                    srNew.GetFilterComparison(), nAdjustment, vMatches);
-                break;
+                // have to check individual addresses to see if adjustment matches
+            }
+
+            // per-address comparison
+            ApplyCompareFilter(pMemory, pMemory + nStop, pPreviousBlock,
+                srNew.GetFilterComparison(), nAdjustment, vMatches);
+            break;
+    }
+
+    if (!vMatches.IsEmpty())
+        AddBlocks(vBlocks, vMatches, pMemory, GetPadding());
+
+    return false;
+}
+
+namespace {
+
+struct ParallelFilterPartition
+{
+    size_t nFirstBlock = 0U;
+    size_t nStopBlock = 0U;
+
+    // the memory for the partition's blocks, captured by the calling thread. only held while the partition
+    // is being processed.
+    std::vector<uint8_t> vMemory;
+
+    // blocks generated for the partition, in address order
+    std::vector<CapturedMemoryBlock> vBlocks;
+
+    // previous blocks that should be reused as-is. first is the index in vBlocks the previous block should be
+    // inserted before, second is the index of the block in the previous results. the previous blocks are copied
+    // on the calling thread while merging as copying them modifies their shared reference count.
+    std::vector<std::pair<size_t, size_t>> vReusedBlocks;
+};
+
+} // anonymous namespace
+
+void SearchImpl::ApplyFilterParallel(SearchResults& srNew, const SearchResults& srPrevious,
+    const std::function<void(ra::data::ByteAddress, uint8_t*, size_t)>& pReadMemory,
+    uint32_t nAdjustment, size_t nTotalBytes) const
+{
+    const auto& vPreviousBlocks = srPrevious.m_vBlocks;
+
+    // split the blocks into contiguous partitions of roughly the same number of bytes
+    const size_t nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    size_t nPartitionSize = std::max(nTotalBytes / (nThreads * 4), size_t{ PARALLEL_FILTER_MIN_PARTITION_SIZE });
+    nPartitionSize = std::min(nPartitionSize, size_t{ PARALLEL_FILTER_MAX_PARTITION_SIZE });
+
+    std::vector<ParallelFilterPartition> vPartitions;
+    {
+        size_t nPartitionBytes = 0U;
+        for (size_t nIndex = 0; nIndex < vPreviousBlocks.size(); ++nIndex)
+        {
+            if (nPartitionBytes == 0U)
+                vPartitions.emplace_back().nFirstBlock = nIndex;
+
+            nPartitionBytes += vPreviousBlocks.at(nIndex).GetBytesSize();
+            if (nPartitionBytes >= nPartitionSize)
+            {
+                vPartitions.back().nStopBlock = nIndex + 1;
+                nPartitionBytes = 0U;
+            }
         }
 
-        if (!vMatches.empty())
+        if (nPartitionBytes != 0U)
+            vPartitions.back().nStopBlock = vPreviousBlocks.size();
+    }
+
+    // the memory has to be read on the calling thread. capture one partition per thread at a time, process them
+    // in parallel, and release the captured memory before moving on to the next set of partitions.
+    // compressed blocks are decoded by the workers without modifying them.
+    for (size_t nFirstPartition = 0; nFirstPartition < vPartitions.size(); nFirstPartition += nThreads)
+    {
+        const size_t nPartitions = std::min(vPartitions.size() - nFirstPartition, nThreads);
+        for (size_t nPartition = nFirstPartition; nPartition < nFirstPartition + nPartitions; ++nPartition)
         {
-            AddBlocks(srNew, vMatches, vMemory, block.GetFirstAddress(), GetPadding());
-            vMatches.clear();
+            auto& pPartition = vPartitions.at(nPartition);
+
+            size_t nPartitionBytes = 0U;
+            for (auto nIndex = pPartition.nFirstBlock; nIndex < pPartition.nStopBlock; ++nIndex)
+                nPartitionBytes += vPreviousBlocks.at(nIndex).GetBytesSize();
+
+            pPartition.vMemory.resize(nPartitionBytes);
+            size_t nOffset = 0U;
+            for (auto nIndex = pPartition.nFirstBlock; nIndex < pPartition.nStopBlock; ++nIndex)
+            {
+                const auto& block = vPreviousBlocks.at(nIndex);
+                pReadMemory(ConvertToRealAddress(block.GetFirstAddress()), &pPartition.vMemory.at(nOffset),
+                            block.GetBytesSize());
+                nOffset += block.GetBytesSize();
+            }
         }
+
+        ra::services::ProcessPartitions(nPartitions,
+            [this, &vPartitions, &vPreviousBlocks, nFirstPartition, &srNew, nAdjustment](size_t nPartition)
+        {
+            auto& pPartition = vPartitions.at(nFirstPartition + nPartition);
+            MatchingAddressBitmap vMatches;
+
+            const uint8_t* pMemory = pPartition.vMemory.data();
+            for (auto nIndex = pPartition.nFirstBlock; nIndex < pPartition.nStopBlock; ++nIndex)
+            {
+                const auto& pPreviousBlock = vPreviousBlocks.at(nIndex);
+                if (ApplyFilterToBlock(pPartition.vBlocks, pPreviousBlock, pMemory, srNew, nAdjustment, vMatches))
+                    pPartition.vReusedBlocks.emplace_back(pPartition.vBlocks.size(), nIndex);
+
+                pMemory += pPreviousBlock.GetBytesSize();
+            }
+
+            // release the captured memory now. AddBlocks copied anything that was kept.
+            std::vector<uint8_t>().swap(pPartition.vMemory);
+        });
     }
-}
 
-bool SearchImpl::GetMatchingAddress(const SearchResults& srResults, gsl::index nIndex, _Out_ SearchResult& result) const noexcept
-{
-    result.nSize = GetMemSize();
+    // merge the partitions in order so the results are identical to filtering the blocks serially
+    size_t nBlocks = 0U;
+    for (const auto& pPartition : vPartitions)
+        nBlocks += pPartition.vBlocks.size() + pPartition.vReusedBlocks.size();
+    srNew.m_vBlocks.reserve(nBlocks);
 
-    for (const auto& pBlock : srResults.m_vBlocks)
+    for (auto& pPartition : vPartitions)
     {
-        if (nIndex < gsl::narrow_cast<gsl::index>(pBlock.GetMatchingAddressCount()))
+        auto pReused = pPartition.vReusedBlocks.begin();
+        for (size_t nIndex = 0; nIndex <= pPartition.vBlocks.size(); ++nIndex)
         {
-            result.nAddress = pBlock.GetMatchingAddress(nIndex);
-            return GetValueFromCapturedMemoryBlock(pBlock, result);
+            while (pReused != pPartition.vReusedBlocks.end() && pReused->first == nIndex)
+            {
+                srNew.m_vBlocks.emplace_back(vPreviousBlocks.at(pReused->second));
+                ++pReused;
+            }
+
+            if (nIndex < pPartition.vBlocks.size())
+                srNew.m_vBlocks.emplace_back(std::move(pPartition.vBlocks.at(nIndex)));
         }
 
-        nIndex -= pBlock.GetMatchingAddressCount();
+        pPartition.vBlocks.clear();
     }
+}
 
-    return false;
+GSL_SUPPRESS_F6
+bool SearchImpl::GetMatchingAddress(const SearchResults& srResults, gsl::index nIndex, _Out_ SearchResult& result) const noexcept
+{
+    result.nSize = GetMemSize();
+
+    const auto* pBlock = srResults.FindMatchingAddress(nIndex, result.nAddress);
+    if (pBlock == nullptr)
+        return false;
+
+    return GetValueFromCapturedMemoryBlock(*pBlock, result);
 }
 
 size_t SearchImpl::GetIndexOfBlockForVirtualAddress(const SearchResults& srResults, uint32_t nAddress)
@@ -273,7 +473,7 @@ bool SearchImpl::MatchesFilter(const SearchResults& pResults, const SearchResult
 
 void SearchImpl::ApplyConstantFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
     const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nConstantValue,
-    std::vector<ra::data::ByteAddress>& vMatches) const
+    MatchingAddressBitmap& vMatches) const
 {
     const auto nBlockAddress = pPreviousBlock.GetFirstAddress();
     const auto nStride = GetStride();
@@ -287,16 +487,17 @@ void SearchImpl::ApplyConstantFilter(const uint8_t* pBytes, const uint8_t* pByte
             const ra::data::ByteAddress nAddress = nBlockAddress +
                 ConvertFromRealAddress(gsl::narrow_cast<uint32_t>(pScan - pBytes));
             if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                vMatches.push_back(nAddress);
+                vMatches.Add(nAddress);
         }
     }
 }
 
 void SearchImpl::ApplyCompareFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
     const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nAdjustment,
-    std::vector<ra::data::ByteAddress>& vMatches) const
+    MatchingAddressBitmap& vMatches) const
 {
-    const auto* pBlockBytes = pPreviousBlock.GetBytes();
+    const auto pPreviousBytes = pPreviousBlock.GetBytes();
+    const auto* pBlockBytes = pPreviousBytes.Data();
     const auto nBlockAddress = pPreviousBlock.GetFirstAddress();
     const auto nStride = GetStride();
     const auto* pMatchingAddresses = pPreviousBlock.GetMatchingAddressPointer();
@@ -310,7 +511,7 @@ void SearchImpl::ApplyCompareFilter(const uint8_t* pBytes, const uint8_t* pBytes
             const ra::data::ByteAddress nAddress = nBlockAddress +
                 ConvertFromRealAddress(gsl::narrow_cast<uint32_t>(pScan - pBytes));
             if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                vMatches.push_back(nAddress);
+                vMatches.Add(nAddress);
         }
     }
 }
@@ -324,7 +525,7 @@ bool SearchImpl::GetValueFromCapturedMemoryBlock(const CapturedMemoryBlock& bloc
     if (nOffset >= block.GetBytesSize() - GetPadding())
         return false;
 
-    result.nValue = BuildValue(block.GetBytes() + nOffset);
+    result.nValue = BuildValue(block.GetBytes().Data() + nOffset);
     return true;
 }
 
@@ -333,21 +534,26 @@ uint32_t SearchImpl::BuildValue(const uint8_t* ptr) const noexcept
     return ptr ? ptr[0] : 0;
 }
 
-void SearchImpl::AddBlocks(SearchResults& srNew, std::vector<ra::data::ByteAddress>& vMatches,
-    std::vector<uint8_t>& vMemory, ra::data::ByteAddress nPreviousBlockFirstAddress, uint32_t nPadding) const
+void SearchImpl::AddBlocks(std::vector<CapturedMemoryBlock>& vBlocks, const MatchingAddressBitmap& vMatches,
+    const uint8_t* pMemory, uint32_t nPadding) const
 {
-    const gsl::index nStopIndex = gsl::narrow_cast<gsl::index>(vMatches.size()) - 1;
-    gsl::index nFirstIndex = 0;
-    gsl::index nLastIndex = 0;
-    do
+    const auto nStopAddress = vMatches.GetFirstAddress() + vMatches.GetAddressCount();
+    const auto nMemoryRealAddress = ConvertToRealAddress(vMatches.GetFirstAddress());
+
+    auto nFirstMatchingAddress = vMatches.FindNextMatch(vMatches.GetFirstAddress());
+    while (nFirstMatchingAddress < nStopAddress)
     {
-        const auto nFirstMatchingAddress = vMatches.at(nFirstIndex);
-        while (nLastIndex < nStopIndex && vMatches.at(nLastIndex + 1) - nFirstMatchingAddress < 64)
-            nLastIndex++;
+        auto nLastMatchingAddress = nFirstMatchingAddress;
+        auto nNextMatchingAddress = vMatches.FindNextMatch(nLastMatchingAddress + 1);
+        while (nNextMatchingAddress < nStopAddress && nNextMatchingAddress - nFirstMatchingAddress < 64)
+        {
+            nLastMatchingAddress = nNextMatchingAddress;
+            nNextMatchingAddress = vMatches.FindNextMatch(nLastMatchingAddress + 1);
+        }
 
         // determine how many bytes we need to capture
         const auto nFirstRealAddress = ConvertToRealAddress(nFirstMatchingAddress);
-        const auto nLastRealAddress = ConvertToRealAddress(vMatches.at(nLastIndex));
+        const auto nLastRealAddress = ConvertToRealAddress(nLastMatchingAddress);
         const uint32_t nBlockSize = nLastRealAddress - nFirstRealAddress + 1 + nPadding;
 
         // determine the maximum number of addresses that can be associated to the captured bytes
@@ -357,17 +563,18 @@ void SearchImpl::AddBlocks(SearchResults& srNew, std::vector<ra::data::ByteAddre
         const auto nFirstAddress = ConvertFromRealAddress(nFirstRealAddress);
 
         // allocate the new block
-        CapturedMemoryBlock& block = AddBlock(srNew, nFirstAddress, nBlockSize, nMaxAddresses);
+        CapturedMemoryBlock& block = vBlocks.emplace_back(nFirstAddress, nBlockSize, nMaxAddresses);
 
         // capture the subset of data that corresponds to the subset of matches
-        const auto nOffset = nFirstRealAddress - ConvertToRealAddress(nPreviousBlockFirstAddress);
-        memcpy(block.GetBytes(), &vMemory.at(nOffset), nBlockSize);
+        const auto nOffset = nFirstRealAddress - nMemoryRealAddress;
+        memcpy(block.GetBytes(), pMemory + nOffset, nBlockSize);
 
         // capture the matched addresses
-        block.SetMatchingAddresses(vMatches, nFirstIndex, nLastIndex);
+        block.SetMatchingAddresses(vMatches.GetBits(), vMatches.GetFirstAddress(), nFirstMatchingAddress,
+                                   nLastMatchingAddress);
 
-        nFirstIndex = nLastIndex + 1;
-    } while (nFirstIndex < gsl::narrow_cast<gsl::index>(vMatches.size()));
+        nFirstMatchingAddress = nNextMatchingAddress;
+    }
 }
 
 } // namespace search
@@ -6,6 +6,10 @@
 
 #include "services\SearchResults.h"
 
+#include "SearchImpl_vectorized.hh"
+
+#include <intrin.h>
+
 // define this to use the generic filtering code for all search types
 // if defined, specialized templated code will be used for little endian searches
 #undef DISABLE_TEMPLATED_SEARCH
@@ -16,6 +20,104 @@ namespace ra {
 namespace services {
 namespace search {
 
+/// <summary>
+/// Tracks which addresses in a range matched a filter using one bit per address.
+/// </summary>
+class MatchingAddressBitmap
+{
+public:
+    /// <summary>
+    /// Clears the bitmap and resizes it to hold the specified range of addresses.
+    /// </summary>
+    void Reset(ra::data::ByteAddress nFirstAddress, uint32_t nAddressCount)
+    {
+        m_nFirstAddress = nFirstAddress;
+        m_nAddressCount = nAddressCount;
+        m_vBits.assign((gsl::narrow_cast<size_t>(nAddressCount) + 31) / 32, 0U);
+    }
+
+    /// <summary>
+    /// Gets the first address represented by the bitmap.
+    /// </summary>
+    ra::data::ByteAddress GetFirstAddress() const noexcept { return m_nFirstAddress; }
+
+    /// <summary>
+    /// Gets the number of addresses represented by the bitmap.
+    /// </summary>
+    uint32_t GetAddressCount() const noexcept { return m_nAddressCount; }
+
+    /// <summary>
+    /// Marks an address as matching.
+    /// </summary>
+    void Add(ra::data::ByteAddress nAddress) noexcept
+    {
+        const auto nIndex = nAddress - m_nFirstAddress;
+        if (nIndex < m_nAddressCount)
+            GSL_SUPPRESS_BOUNDS4 m_vBits[nIndex >> 5] |= (1U << (nIndex & 31));
+    }
+
+    /// <summary>
+    /// Marks several addresses as matching. Bit N of <paramref name="nMask" /> corresponds to nAddress + N.
+    /// </summary>
+    /// <remarks>
+    /// The offset of nAddress from the first address must be a multiple of the number of bits in the mask.
+    /// </remarks>
+    void AddMask(ra::data::ByteAddress nAddress, uint32_t nMask) noexcept
+    {
+        const auto nIndex = nAddress - m_nFirstAddress;
+        GSL_SUPPRESS_BOUNDS4 m_vBits[nIndex >> 5] |= (nMask << (nIndex & 31));
+    }
+
+    /// <summary>
+    /// Determines if any address has been marked as matching.
+    /// </summary>
+    bool IsEmpty() const noexcept
+    {
+        return std::all_of(m_vBits.begin(), m_vBits.end(), [](uint32_t nBits) noexcept { return nBits == 0; });
+    }
+
+    /// <summary>
+    /// Gets the first matching address at or after <paramref name="nAddress" />.
+    /// </summary>
+    /// <returns>
+    /// The matching address, or the address after the last address in the bitmap if no more addresses match.
+    /// </returns>
+    ra::data::ByteAddress FindNextMatch(ra::data::ByteAddress nAddress) const noexcept
+    {
+        const auto nStopAddress = m_nFirstAddress + m_nAddressCount;
+        const auto nIndex = nAddress - m_nFirstAddress;
+        if (nIndex >= m_nAddressCount)
+            return nStopAddress;
+
+        size_t nWord = nIndex >> 5;
+        GSL_SUPPRESS_BOUNDS4 uint32_t nBits = m_vBits[nWord] & (0xFFFFFFFF << (nIndex & 31));
+        while (nBits == 0)
+        {
+            if (++nWord == m_vBits.size())
+                return nStopAddress;
+
+            GSL_SUPPRESS_BOUNDS4 nBits = m_vBits[nWord];
+        }
+
+        unsigned long nBit = 0;
+        _BitScanForward(&nBit, nBits);
+        return m_nFirstAddress + gsl::narrow_cast<uint32_t>(nWord * 32) + nBit;
+    }
+
+    /// <summary>
+    /// Gets the raw bitmap. Bit N of the returned data corresponds to the address N after the first address.
+    /// </summary>
+    const uint8_t* GetBits() const noexcept
+    {
+        GSL_SUPPRESS_TYPE1 return reinterpret_cast<const uint8_t*>(m_vBits.data());
+    }
+
+private:
+    std::vector<uint32_t> m_vBits;
+    ra::data::ByteAddress m_nFirstAddress = 0U;
+    uint32_t m_nAddressCount = 0U;
+};
+
 class SearchImpl
 {
 public:
@@ -56,8 +158,13 @@ public:
     // Determines if the specified real address exists in the collection of matched addresses.
     virtual bool ContainsAddress(const SearchResults& srResults, ra::data::ByteAddress nAddress) const;
 
-    void AddBlocks(SearchResults& srNew, std::vector<ra::data::ByteAddress>& vMatches, std::vector<uint8_t>& vMemory,
-                   ra::data::ByteAddress nPreviousBlockFirstAddress, uint32_t nPadding) const;
+    // creates blocks for the addresses marked in vMatches. vMemory must contain the memory for the range of addresses
+    // represented by vMatches
+    void AddBlocks(SearchResults& srNew, const MatchingAddressBitmap& vMatches, const std::vector<uint8_t>& vMemory,
+                   uint32_t nPadding) const
+    {
+        AddBlocks(srNew.m_vBlocks, vMatches, vMemory.data(), nPadding);
+    }
 
     // Removes the result associated to the specified real address from the collection of matched addresses.
     virtual bool ExcludeResult(SearchResults& srResults, const SearchResult& pResult) const;
@@ -108,12 +215,12 @@ protected:
     // generic implementation for less used search types
     virtual void ApplyConstantFilter(const uint8_t* pBytes, const uint8_t* pBytesStop, const CapturedMemoryBlock& pPreviousBlock,
                                      ComparisonType nComparison, unsigned nConstantValue,
-                                     std::vector<ra::data::ByteAddress>& vMatches) const;
+                                     MatchingAddressBitmap& vMatches) const;
 
     // generic implementation for less used search types
     virtual void ApplyCompareFilter(const uint8_t* pBytes, const uint8_t* pBytesStop, const CapturedMemoryBlock& pPreviousBlock,
                                     ComparisonType nComparison, unsigned nAdjustment,
-                                    std::vector<ra::data::ByteAddress>& vMatches) const;
+                                    MatchingAddressBitmap& vMatches) const;
 
     template<typename T>
     _NODISCARD static constexpr bool CompareValues(_In_ T nLeft, _In_ T nRight,
@@ -145,7 +252,7 @@ protected:
     template<typename TSize, bool TIsConstantFilter, int TStride, ComparisonType TComparison>
     void ApplyCompareFilterLittleEndian(const uint8_t* pBytes, const uint8_t* pBytesStop,
                                         const CapturedMemoryBlock& pPreviousBlock, unsigned nAdjustment,
-                                        std::vector<ra::data::ByteAddress>& vMatches) const
+                                        MatchingAddressBitmap& vMatches) const
     {
         const auto* pScan = pBytes;
         if (pScan == nullptr)
@@ -153,10 +260,45 @@ protected:
 
         ra::data::ByteAddress nAddress = pPreviousBlock.GetFirstAddress();
         constexpr int TBlockStride = TIsConstantFilter ? 0 : TStride;
-        const auto* pBlockBytes = TIsConstantFilter ? pScan : pPreviousBlock.GetBytes();
+        // the previous bytes aren't compared against a constant, so don't decode them
+        const auto pPreviousBytes = TIsConstantFilter ? CapturedMemoryBlock::BytesView() : pPreviousBlock.GetBytes();
+        const auto* pBlockBytes = TIsConstantFilter ? pScan : pPreviousBytes.Data();
         Expects(pBlockBytes != nullptr);
 
         const auto* pMatchingAddresses = pPreviousBlock.GetMatchingAddressPointer();
+
+#ifdef RA_SEARCH_VECTORIZED
+        if constexpr (TStride == sizeof(TSize))
+        {
+            // the vectorized kernels compare values at their native size. a constant that doesn't fit in the value
+            // or an adjustment that could overflow it has to be compared as a 32-bit value by the scalar code.
+            if (TIsConstantFilter ? (nAdjustment <= std::numeric_limits<TSize>::max()) : (nAdjustment == 0))
+            {
+                std::array<TSize, vectorized::CHUNK_SIZE / sizeof(TSize)> vConstant{};
+                vConstant.fill(gsl::narrow_cast<TSize>(nAdjustment));
+                GSL_SUPPRESS_TYPE1 const auto* pCompareBytes =
+                    TIsConstantFilter ? reinterpret_cast<const uint8_t*>(vConstant.data()) : pBlockBytes;
+
+                switch (vectorized::GetInstructionSet())
+                {
+                    case vectorized::InstructionSet::AVX2:
+                        ApplyCompareFilterVectorized<vectorized::AVX2Kernel, TSize, TIsConstantFilter, TComparison>(
+                            pScan, pBytesStop, pCompareBytes, pMatchingAddresses, nAddress, vMatches);
+                        break;
+                    case vectorized::InstructionSet::SSE2:
+                        ApplyCompareFilterVectorized<vectorized::SSE2Kernel, TSize, TIsConstantFilter, TComparison>(
+                            pScan, pBytesStop, pCompareBytes, pMatchingAddresses, nAddress, vMatches);
+                        break;
+                    default:
+                        break;
+                }
+
+                if (!TIsConstantFilter)
+                    pBlockBytes = pCompareBytes;
+            }
+        }
+#endif
+
         if (!pMatchingAddresses)
         {
             // all addresses in previous block match
@@ -169,7 +311,7 @@ protected:
                         TIsConstantFilter ? nAdjustment : *(reinterpret_cast<const TSize*>(pBlockBytes)) + nAdjustment;
 
                     if (CompareValues(nValue1, nValue2, TComparison))
-                        vMatches.push_back(nAddress);
+                        vMatches.Add(nAddress);
                 }
 
                 ++nAddress;
@@ -202,7 +344,7 @@ protected:
                                                          : *(reinterpret_cast<const TSize*>(pBlockBytes)) + nAdjustment;
 
                         if (CompareValues(nValue1, nValue2, TComparison))
-                            vMatches.push_back(nAddress);
+                            vMatches.Add(nAddress);
                     }
                 }
 
@@ -211,6 +353,44 @@ protected:
         }
     }
 
+#ifdef RA_SEARCH_VECTORIZED
+    /// <summary>
+    /// Compares as many whole chunks of memory as possible using the vectorized kernels.
+    /// </summary>
+    /// <remarks>
+    /// pScan, pBlockBytes, pMatchingAddresses, and nAddress are advanced past the processed chunks. Any remaining
+    /// values are left for the scalar code. As chunks hold a multiple of eight values, pMatchingAddresses will
+    /// always be advanced to the start of a byte.
+    /// </remarks>
+    template<typename TKernel, typename TSize, bool TIsConstantFilter, ComparisonType TComparison>
+    static void ApplyCompareFilterVectorized(const uint8_t*& pScan, const uint8_t* pBytesStop,
+                                             const uint8_t*& pBlockBytes, const uint8_t*& pMatchingAddresses,
+                                             ra::data::ByteAddress& nAddress,
+                                             MatchingAddressBitmap& vMatches)
+    {
+        constexpr auto nLanes = gsl::narrow_cast<uint32_t>(vectorized::CHUNK_SIZE / sizeof(TSize));
+        constexpr auto nBlockStride = TIsConstantFilter ? 0 : vectorized::CHUNK_SIZE;
+
+        while (pBytesStop - pScan >= gsl::narrow_cast<ptrdiff_t>(vectorized::CHUNK_SIZE))
+        {
+            uint32_t nMask = vectorized::CompareChunk<TKernel, TSize, TComparison>(pScan, pBlockBytes);
+            if (pMatchingAddresses)
+            {
+                uint32_t nPreviousMask = 0;
+                memcpy(&nPreviousMask, pMatchingAddresses, nLanes / 8);
+                nMask &= nPreviousMask;
+                pMatchingAddresses += nLanes / 8;
+            }
+
+            vMatches.AddMask(nAddress, nMask);
+
+            nAddress += nLanes;
+            pScan += vectorized::CHUNK_SIZE;
+            pBlockBytes += nBlockStride;
+        }
+    }
+#endif
+
     /// <summary>
     /// Finds items in a block of memory that match a specified filter.
     /// </summary>
@@ -222,11 +402,11 @@ protected:
     /// <param name="pPreviousBlock">The block being compared against</param>
     /// <param name="nComparison">The comparison to perform</param>
     /// <param name="nAdjustment">The adjustment to apply to each value before comparing, or the constant to compare
-    /// against</param> <param name="vMatches">[out] The list of matching addresses</param>
+    /// against</param> <param name="vMatches">[out] The matching addresses</param>
     template<typename TSize, bool TIsConstantFilter, int TStride = 1>
     void ApplyCompareFilterLittleEndian(const uint8_t* pBytes, const uint8_t* pBytesStop,
                                         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison,
-                                        unsigned nAdjustment, std::vector<ra::data::ByteAddress>& vMatches) const
+                                        unsigned nAdjustment, MatchingAddressBitmap& vMatches) const
     {
         switch (nComparison)
         {
@@ -257,7 +437,7 @@ protected:
     template<typename TSize, bool TIsConstantFilter, int TStride = 1>
     void ApplyCompareFilterLittleEndian(const uint8_t* pBytes, const uint8_t* pBytesStop,
                                         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison,
-                                        unsigned nAdjustment, std::vector<ra::data::ByteAddress>& vMatches) const
+                                        unsigned nAdjustment, MatchingAddressBitmap& vMatches) const
     {
         if (TIsConstantFilter)
             SearchImpl::ApplyConstantFilter(pBytes, pBytesStop, pPreviousBlock, nComparison, nAdjustment, vMatches);
@@ -291,7 +471,7 @@ protected:
     {
         const auto nIndex = GetIndexOfBlockForVirtualAddress(srResults, nAddress);
         if (nIndex < srResults.m_vBlocks.size())
-            srResults.m_vBlocks.at(nIndex).ExcludeMatchingAddress(nAddress);
+            srResults.ExcludeMatchingAddress(nIndex, nAddress);
 
         return false;
     }
@@ -316,6 +496,24 @@ protected:
     {
         return srResults.m_vBlocks.emplace_back(nAddress, nSize, nMaxAddresses);
     }
+
+private:
+    // creates blocks for the addresses marked in vMatches. pMemory must point at the memory for the first address
+    // represented by vMatches
+    void AddBlocks(std::vector<CapturedMemoryBlock>& vBlocks, const MatchingAddressBitmap& vMatches,
+                   const uint8_t* pMemory, uint32_t nPadding) const;
+
+    // applies the filter to a single block of the previous results, appending any new blocks to vBlocks.
+    // returns true if every address in the previous block matched and the previous block should be reused as-is.
+    bool ApplyFilterToBlock(std::vector<CapturedMemoryBlock>& vBlocks, const CapturedMemoryBlock& pPreviousBlock,
+                            const uint8_t* pMemory, const SearchResults& srNew, uint32_t nAdjustment,
+                            MatchingAddressBitmap& vMatches) const;
+
+    // reads the memory for a few partitions at a time on the calling thread, then distributes the comparisons for
+    // those partitions across the thread pool.
+    void ApplyFilterParallel(SearchResults& srNew, const SearchResults& srPrevious,
+                             const std::function<void(ra::data::ByteAddress, uint8_t*, size_t)>& pReadMemory,
+                             uint32_t nAdjustment, size_t nTotalBytes) const;
 };
 
 } // namespace search
@@ -25,7 +25,7 @@ protected:
 protected:
     void ApplyConstantFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nConstantValue,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         SearchImpl::ApplyConstantFilter(pBytes, pBytesStop,
             pPreviousBlock, nComparison, nConstantValue, vMatches);
@@ -33,7 +33,7 @@ protected:
 
     void ApplyCompareFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nAdjustment,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         SearchImpl::ApplyCompareFilter(pBytes, pBytesStop,
             pPreviousBlock, nComparison, nAdjustment, vMatches);
@@ -31,7 +31,7 @@ public:
 protected:
     void ApplyConstantFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nConstantValue,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         ApplyCompareFilterLittleEndian<uint32_t, true, 4>(pBytes, pBytesStop,
             pPreviousBlock, nComparison, nConstantValue, vMatches);
@@ -39,7 +39,7 @@ protected:
 
     void ApplyCompareFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nAdjustment,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         ApplyCompareFilterLittleEndian<uint32_t, false, 4>(pBytes, pBytesStop,
             pPreviousBlock, nComparison, nAdjustment, vMatches);
@@ -52,7 +52,7 @@ protected:
         if (nOffset + 3 >= block.GetBytesSize())
             return false;
 
-        result.nValue = BuildValue(block.GetBytes() + nOffset);
+        result.nValue = BuildValue(block.GetBytes().Data() + nOffset);
         result.nAddress *= 4;
 
         return true;
@@ -51,7 +51,7 @@ class FourBitSearchImpl : public SearchImpl
 
     void ApplyConstantFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nConstantValue,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         const auto nBlockAddress = pPreviousBlock.GetFirstAddress();
         const auto* pMatchingAddresses = pPreviousBlock.GetMatchingAddressPointer();
@@ -65,23 +65,24 @@ class FourBitSearchImpl : public SearchImpl
             {
                 const unsigned int nAddress = nBlockAddress + (gsl::narrow_cast<unsigned>(pScan - pBytes) << 1);
                 if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                    vMatches.push_back(nAddress);
+                    vMatches.Add(nAddress);
             }
 
             if (CompareValues(nValue1b, nConstantValue, nComparison))
             {
                 const unsigned int nAddress = (nBlockAddress + (gsl::narrow_cast<unsigned>(pScan - pBytes) << 1)) | 1;
                 if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                    vMatches.push_back(nAddress);
+                    vMatches.Add(nAddress);
             }
         }
     }
 
     void ApplyCompareFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nAdjustment,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
-        const auto* pBlockBytes = pPreviousBlock.GetBytes();
+        const auto pPreviousBytes = pPreviousBlock.GetBytes();
+        const auto* pBlockBytes = pPreviousBytes.Data();
         const auto nBlockAddress = pPreviousBlock.GetFirstAddress();
         const auto* pMatchingAddresses = pPreviousBlock.GetMatchingAddressPointer();
         for (const auto* pScan = pBytes; pScan < pBytesStop; ++pScan)
@@ -97,14 +98,14 @@ class FourBitSearchImpl : public SearchImpl
             {
                 const unsigned int nAddress = nBlockAddress + (gsl::narrow_cast<unsigned>(pScan - pBytes) << 1);
                 if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                    vMatches.push_back(nAddress);
+                    vMatches.Add(nAddress);
             }
 
             if (CompareValues(nValue1b, nValue2b, nComparison))
             {
                 const unsigned int nAddress = nBlockAddress + (gsl::narrow_cast<unsigned>(pScan - pBytes) << 1) | 1;
                 if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                    vMatches.push_back(nAddress);
+                    vMatches.Add(nAddress);
             }
         }
     }
@@ -121,7 +122,7 @@ protected:
         if (nOffset >= block.GetBytesSize())
             return false;
 
-        result.nValue = BuildValue(block.GetBytes() + nOffset);
+        result.nValue = BuildValue(block.GetBytes().Data() + nOffset);
 
         if (result.nSize == ra::data::Memory::Size::NibbleLower)
             result.nValue &= 0x0F;
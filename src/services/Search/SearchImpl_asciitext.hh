@@ -46,10 +46,11 @@ public:
         }
 
         std::vector<unsigned char> vMemory(nLargestBlock);
-        std::vector<ra::data::ByteAddress> vMatches;
+        MatchingAddressBitmap vMatches;
 
         for (auto& block : GetBlocks(srPrevious))
         {
+            vMatches.Reset(block.GetFirstAddress(), block.GetAddressCount());
             pReadMemory(block.GetFirstAddress(), vMemory.data(), block.GetBytesSize());
 
             const auto nStop = block.GetBytesSize() - 1;
@@ -66,7 +67,7 @@ public:
                         {
                             const unsigned int nAddress = block.GetFirstAddress() + i;
                             if (block.HasMatchingAddress(pMatchingAddresses, nAddress))
-                                vMatches.push_back(nAddress);
+                                vMatches.Add(nAddress);
                         }
                     }
                     break;
@@ -75,22 +76,21 @@ public:
                 case SearchFilterType::LastKnownValue:
                     for (unsigned int i = 0; i < nStop; ++i)
                     {
-                        if (CompareMemory(&vMemory.at(i), block.GetBytes() + i, nCompareLength, nFilterComparison))
+                        if (CompareMemory(&vMemory.at(i), block.GetBytes().Data() + i, nCompareLength, nFilterComparison))
                         {
                             const unsigned int nAddress = block.GetFirstAddress() + i;
                             if (block.HasMatchingAddress(pMatchingAddresses, nAddress))
-                                vMatches.push_back(nAddress);
+                                vMatches.Add(nAddress);
                         }
                     }
                     break;
             }
 
-            if (!vMatches.empty())
+            if (!vMatches.IsEmpty())
             {
                 // adjust the block size to account for the length of the string to ensure
                 // the block contains the whole string
-                AddBlocks(srNew, vMatches, vMemory, block.GetFirstAddress(), gsl::narrow_cast<unsigned int>(nCompareLength - 1));
-                vMatches.clear();
+                AddBlocks(srNew, vMatches, vMemory, gsl::narrow_cast<unsigned int>(nCompareLength - 1));
             }
         }
     }
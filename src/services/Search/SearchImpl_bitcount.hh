@@ -57,7 +57,7 @@ private:
         if (nOffset >= block.GetBytesSize() - GetPadding())
             return false;
 
-        result.nValue = *(block.GetBytes() + nOffset);
+        result.nValue = *(block.GetBytes().Data() + nOffset);
         return true;
     }
 
@@ -48,7 +48,7 @@ public:
 protected:
     void ApplyConstantFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nConstantValue,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         pBytes += 4; // we're only looking at the four most significant bytes
 
@@ -69,10 +69,11 @@ protected:
     GSL_SUPPRESS_TYPE1
         void ApplyCompareFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nAdjustment,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         // cannot use base implementation because we need to offset pBytes and pBlockBytes
-        const auto* pBlockBytes = pPreviousBlock.GetBytes() + 4;
+        const auto pPreviousBytes = pPreviousBlock.GetBytes();
+        const auto* pBlockBytes = pPreviousBytes.Data() + 4;
         const auto nBlockAddress = pPreviousBlock.GetFirstAddress();
         constexpr auto nStride = 8;
         const auto* pMatchingAddresses = pPreviousBlock.GetMatchingAddressPointer();
@@ -89,7 +90,7 @@ protected:
                 const ra::data::ByteAddress nAddress = nBlockAddress +
                     ConvertFromRealAddress(gsl::narrow_cast<uint32_t>(pScan - pBytes - 4));
                 if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                    vMatches.push_back(nAddress);
+                    vMatches.Add(nAddress);
             }
         }
     }
@@ -101,7 +102,7 @@ protected:
             return false;
 
         // the actual value being returned is 4-bytes into the 8-byte double
-        result.nValue = BuildValue(block.GetBytes() + nOffset + 4);
+        result.nValue = BuildValue(block.GetBytes().Data() + nOffset + 4);
         result.nAddress = result.nAddress * 8 + 4;
 
         return true;
@@ -100,7 +100,7 @@ protected:
     GSL_SUPPRESS_TYPE1
     void ApplyConstantFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nConstantValue,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         if (nComparison == ComparisonType::Equals || nComparison == ComparisonType::NotEqualTo)
         {
@@ -125,7 +125,7 @@ protected:
                 const ra::data::ByteAddress nAddress = nBlockAddress +
                     ConvertFromRealAddress(gsl::narrow_cast<uint32_t>(pScan - pBytes));
                 if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                    vMatches.push_back(nAddress);
+                    vMatches.Add(nAddress);
             }
         }
     }
@@ -133,7 +133,7 @@ protected:
     GSL_SUPPRESS_TYPE1
     void ApplyCompareFilter(const uint8_t* pBytes, const uint8_t* pBytesStop,
         const CapturedMemoryBlock& pPreviousBlock, ComparisonType nComparison, unsigned nAdjustment,
-        std::vector<ra::data::ByteAddress>& vMatches) const override
+        MatchingAddressBitmap& vMatches) const override
     {
         if (nComparison == ComparisonType::Equals || nComparison == ComparisonType::NotEqualTo)
         {
@@ -143,7 +143,8 @@ protected:
             return;
         }
 
-        const auto* pBlockBytes = pPreviousBlock.GetBytes();
+        const auto pPreviousBytes = pPreviousBlock.GetBytes();
+        const auto* pBlockBytes = pPreviousBytes.Data();
         const auto nBlockAddress = pPreviousBlock.GetFirstAddress();
         const auto nStride = GetStride();
         const auto* pMatchingAddresses = pPreviousBlock.GetMatchingAddressPointer();
@@ -160,7 +161,7 @@ protected:
                 const ra::data::ByteAddress nAddress = nBlockAddress +
                     ConvertFromRealAddress(gsl::narrow_cast<uint32_t>(pScan - pBytes));
                 if (pPreviousBlock.HasMatchingAddress(pMatchingAddresses, nAddress))
-                    vMatches.push_back(nAddress);
+                    vMatches.Add(nAddress);
             }
         }
     }
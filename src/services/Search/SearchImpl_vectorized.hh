@@ -0,0 +1,257 @@
+#ifndef SEARCHIMPL_VECTORIZED_H
+#define SEARCHIMPL_VECTORIZED_H
+#pragma once
+
+#include "data\Types.hh"
+
+#if defined(_M_IX86) || defined(_M_X64)
+ #define RA_SEARCH_VECTORIZED
+ #include <intrin.h>
+#endif
+
+namespace ra {
+namespace services {
+namespace search {
+namespace vectorized {
+
+enum class InstructionSet
+{
+    None,
+    SSE2,
+    AVX2,
+};
+
+/// <summary>
+/// Gets the most capable instruction set supported by the current processor.
+/// </summary>
+InstructionSet GetSupportedInstructionSet() noexcept;
+
+/// <summary>
+/// Gets the instruction set used by the vectorized search kernels.
+/// </summary>
+InstructionSet GetInstructionSet() noexcept;
+
+/// <summary>
+/// Sets the instruction set used by the vectorized search kernels. <see cref="InstructionSet::None" /> forces the
+/// scalar implementation. Requests for unsupported instruction sets are capped at the supported instruction set.
+/// </summary>
+void SetInstructionSet(InstructionSet nInstructionSet) noexcept;
+
+// number of bytes examined by a single kernel invocation. each invocation returns one bit per value.
+_CONSTANT_VAR CHUNK_SIZE = 32U;
+
+#ifdef RA_SEARCH_VECTORIZED
+
+#pragma warning(push)
+#pragma warning(disable : 26481) // pointer arithmetic is required to walk the chunk
+
+// SSE2 doesn't have unsigned comparisons. flipping the sign bit of both operands allows using the signed ones.
+struct SSE2Kernel
+{
+    template<typename TSize>
+    static uint32_t Equal(const uint8_t* pLeft, const uint8_t* pRight) noexcept
+    {
+        GSL_SUPPRESS_TYPE1 const __m128i* pLeftVector = reinterpret_cast<const __m128i*>(pLeft);
+        GSL_SUPPRESS_TYPE1 const __m128i* pRightVector = reinterpret_cast<const __m128i*>(pRight);
+
+        if constexpr (sizeof(TSize) == 1)
+        {
+            const __m128i vLow = _mm_cmpeq_epi8(_mm_loadu_si128(pLeftVector), _mm_loadu_si128(pRightVector));
+            const __m128i vHigh = _mm_cmpeq_epi8(_mm_loadu_si128(pLeftVector + 1), _mm_loadu_si128(pRightVector + 1));
+            return ToMask<TSize>(vLow, vHigh);
+        }
+        else if constexpr (sizeof(TSize) == 2)
+        {
+            const __m128i vLow = _mm_cmpeq_epi16(_mm_loadu_si128(pLeftVector), _mm_loadu_si128(pRightVector));
+            const __m128i vHigh = _mm_cmpeq_epi16(_mm_loadu_si128(pLeftVector + 1), _mm_loadu_si128(pRightVector + 1));
+            return ToMask<TSize>(vLow, vHigh);
+        }
+        else
+        {
+            const __m128i vLow = _mm_cmpeq_epi32(_mm_loadu_si128(pLeftVector), _mm_loadu_si128(pRightVector));
+            const __m128i vHigh = _mm_cmpeq_epi32(_mm_loadu_si128(pLeftVector + 1), _mm_loadu_si128(pRightVector + 1));
+            return ToMask<TSize>(vLow, vHigh);
+        }
+    }
+
+    // compares 32-bit values of pLeft to the 32-bit values of pRight plus nDelta (with wraparound)
+    static uint32_t EqualPlus(const uint8_t* pLeft, const uint8_t* pRight, uint32_t nDelta) noexcept
+    {
+        GSL_SUPPRESS_TYPE1 const __m128i* pLeftVector = reinterpret_cast<const __m128i*>(pLeft);
+        GSL_SUPPRESS_TYPE1 const __m128i* pRightVector = reinterpret_cast<const __m128i*>(pRight);
+
+        const __m128i vDelta = _mm_set1_epi32(static_cast<int>(nDelta));
+        const __m128i vLow = _mm_cmpeq_epi32(_mm_loadu_si128(pLeftVector),
+                                             _mm_add_epi32(_mm_loadu_si128(pRightVector), vDelta));
+        const __m128i vHigh = _mm_cmpeq_epi32(_mm_loadu_si128(pLeftVector + 1),
+                                              _mm_add_epi32(_mm_loadu_si128(pRightVector + 1), vDelta));
+        return ToMask<uint32_t>(vLow, vHigh);
+    }
+
+    template<typename TSize>
+    static uint32_t Greater(const uint8_t* pLeft, const uint8_t* pRight) noexcept
+    {
+        GSL_SUPPRESS_TYPE1 const __m128i* pLeftVector = reinterpret_cast<const __m128i*>(pLeft);
+        GSL_SUPPRESS_TYPE1 const __m128i* pRightVector = reinterpret_cast<const __m128i*>(pRight);
+
+        if constexpr (sizeof(TSize) == 1)
+        {
+            const __m128i vSign = _mm_set1_epi8(static_cast<char>(0x80));
+            const __m128i vLow = _mm_cmpgt_epi8(_mm_xor_si128(_mm_loadu_si128(pLeftVector), vSign),
+                                                _mm_xor_si128(_mm_loadu_si128(pRightVector), vSign));
+            const __m128i vHigh = _mm_cmpgt_epi8(_mm_xor_si128(_mm_loadu_si128(pLeftVector + 1), vSign),
+                                                 _mm_xor_si128(_mm_loadu_si128(pRightVector + 1), vSign));
+            return ToMask<TSize>(vLow, vHigh);
+        }
+        else if constexpr (sizeof(TSize) == 2)
+        {
+            const __m128i vSign = _mm_set1_epi16(static_cast<short>(0x8000));
+            const __m128i vLow = _mm_cmpgt_epi16(_mm_xor_si128(_mm_loadu_si128(pLeftVector), vSign),
+                                                 _mm_xor_si128(_mm_loadu_si128(pRightVector), vSign));
+            const __m128i vHigh = _mm_cmpgt_epi16(_mm_xor_si128(_mm_loadu_si128(pLeftVector + 1), vSign),
+                                                  _mm_xor_si128(_mm_loadu_si128(pRightVector + 1), vSign));
+            return ToMask<TSize>(vLow, vHigh);
+        }
+        else
+        {
+            const __m128i vSign = _mm_set1_epi32(static_cast<int>(0x80000000));
+            const __m128i vLow = _mm_cmpgt_epi32(_mm_xor_si128(_mm_loadu_si128(pLeftVector), vSign),
+                                                 _mm_xor_si128(_mm_loadu_si128(pRightVector), vSign));
+            const __m128i vHigh = _mm_cmpgt_epi32(_mm_xor_si128(_mm_loadu_si128(pLeftVector + 1), vSign),
+                                                  _mm_xor_si128(_mm_loadu_si128(pRightVector + 1), vSign));
+            return ToMask<TSize>(vLow, vHigh);
+        }
+    }
+
+private:
+    // collapses the per-lane comparison results (all bits set or cleared) into one bit per lane
+    template<typename TSize>
+    static uint32_t ToMask(__m128i vLow, __m128i vHigh) noexcept
+    {
+        if constexpr (sizeof(TSize) == 1)
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(vLow)) |
+                   (static_cast<uint32_t>(_mm_movemask_epi8(vHigh)) << 16);
+        }
+        else if constexpr (sizeof(TSize) == 2)
+        {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(vLow, vHigh)));
+        }
+        else
+        {
+            return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(vLow))) |
+                   (static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(vHigh))) << 4);
+        }
+    }
+};
+
+struct AVX2Kernel
+{
+    template<typename TSize>
+    static uint32_t Equal(const uint8_t* pLeft, const uint8_t* pRight) noexcept
+    {
+        GSL_SUPPRESS_TYPE1 const __m256i vLeft = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pLeft));
+        GSL_SUPPRESS_TYPE1 const __m256i vRight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pRight));
+
+        if constexpr (sizeof(TSize) == 1)
+            return ToMask<TSize>(_mm256_cmpeq_epi8(vLeft, vRight));
+        else if constexpr (sizeof(TSize) == 2)
+            return ToMask<TSize>(_mm256_cmpeq_epi16(vLeft, vRight));
+        else
+            return ToMask<TSize>(_mm256_cmpeq_epi32(vLeft, vRight));
+    }
+
+    // compares 32-bit values of pLeft to the 32-bit values of pRight plus nDelta (with wraparound)
+    static uint32_t EqualPlus(const uint8_t* pLeft, const uint8_t* pRight, uint32_t nDelta) noexcept
+    {
+        GSL_SUPPRESS_TYPE1 const __m256i vLeft = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pLeft));
+        GSL_SUPPRESS_TYPE1 const __m256i vRight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pRight));
+
+        const __m256i vDelta = _mm256_set1_epi32(static_cast<int>(nDelta));
+        return ToMask<uint32_t>(_mm256_cmpeq_epi32(vLeft, _mm256_add_epi32(vRight, vDelta)));
+    }
+
+    template<typename TSize>
+    static uint32_t Greater(const uint8_t* pLeft, const uint8_t* pRight) noexcept
+    {
+        GSL_SUPPRESS_TYPE1 const __m256i vLeft = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pLeft));
+        GSL_SUPPRESS_TYPE1 const __m256i vRight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pRight));
+
+        if constexpr (sizeof(TSize) == 1)
+        {
+            const __m256i vSign = _mm256_set1_epi8(static_cast<char>(0x80));
+            return ToMask<TSize>(_mm256_cmpgt_epi8(_mm256_xor_si256(vLeft, vSign), _mm256_xor_si256(vRight, vSign)));
+        }
+        else if constexpr (sizeof(TSize) == 2)
+        {
+            const __m256i vSign = _mm256_set1_epi16(static_cast<short>(0x8000));
+            return ToMask<TSize>(_mm256_cmpgt_epi16(_mm256_xor_si256(vLeft, vSign), _mm256_xor_si256(vRight, vSign)));
+        }
+        else
+        {
+            const __m256i vSign = _mm256_set1_epi32(static_cast<int>(0x80000000));
+            return ToMask<TSize>(_mm256_cmpgt_epi32(_mm256_xor_si256(vLeft, vSign), _mm256_xor_si256(vRight, vSign)));
+        }
+    }
+
+private:
+    // collapses the per-lane comparison results (all bits set or cleared) into one bit per lane
+    template<typename TSize>
+    static uint32_t ToMask(__m256i vResult) noexcept
+    {
+        if constexpr (sizeof(TSize) == 1)
+        {
+            return static_cast<uint32_t>(_mm256_movemask_epi8(vResult));
+        }
+        else if constexpr (sizeof(TSize) == 2)
+        {
+            // packs works within each 128-bit half, so the quadwords have to be put back in order afterwards
+            const __m256i vPacked = _mm256_packs_epi16(vResult, _mm256_setzero_si256());
+            return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_permute4x64_epi64(vPacked, 0xD8))) & 0xFFFF;
+        }
+        else
+        {
+            return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(vResult)));
+        }
+    }
+};
+
+/// <summary>
+/// Compares a chunk of <see cref="CHUNK_SIZE" /> bytes of little endian values.
+/// </summary>
+/// <returns>A bitmask where bit N is set if value N of pLeft compared to value N of pRight matches the comparison.</returns>
+template<typename TKernel, typename TSize, ComparisonType TComparison>
+uint32_t CompareChunk(const uint8_t* pLeft, const uint8_t* pRight) noexcept
+{
+    constexpr auto nLanes = CHUNK_SIZE / sizeof(TSize);
+    constexpr uint32_t nLaneMask = (nLanes == 32) ? 0xFFFFFFFF : ((1U << nLanes) - 1);
+
+    switch (TComparison)
+    {
+        case ComparisonType::Equals:
+            return TKernel::template Equal<TSize>(pLeft, pRight);
+        case ComparisonType::NotEqualTo:
+            return TKernel::template Equal<TSize>(pLeft, pRight) ^ nLaneMask;
+        case ComparisonType::GreaterThan:
+            return TKernel::template Greater<TSize>(pLeft, pRight);
+        case ComparisonType::LessThanOrEqual:
+            return TKernel::template Greater<TSize>(pLeft, pRight) ^ nLaneMask;
+        case ComparisonType::LessThan:
+            return TKernel::template Greater<TSize>(pRight, pLeft);
+        case ComparisonType::GreaterThanOrEqual:
+            return TKernel::template Greater<TSize>(pRight, pLeft) ^ nLaneMask;
+        default:
+            return 0;
+    }
+}
+
+#pragma warning(pop)
+
+#endif // RA_SEARCH_VECTORIZED
+
+} // namespace vectorized
+} // namespace search
+} // namespace services
+} // namespace ra
+
+#endif // SEARCHIMPL_VECTORIZED_H
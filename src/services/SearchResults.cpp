@@ -124,7 +124,8 @@ static size_t CalcSize(const std::vector<ra::data::CapturedMemoryBlock>& vBlocks
     {
         if (pBlock.GetBytesSize() > 8) // IsBytesAllocated
         {
-            const auto* pBytes = pBlock.GetBytes();
+            const auto pBytesView = pBlock.GetBytes();
+            const auto* pBytes = pBytesView.Data();
             if (vAllocatedMemoryBlocks.find(pBytes) == vAllocatedMemoryBlocks.end())
             {
                 vAllocatedMemoryBlocks.insert(pBytes);
@@ -144,6 +145,7 @@ static size_t CalcSize(const std::vector<ra::data::CapturedMemoryBlock>& vBlocks
 
 void SearchResults::Initialize(ra::data::ByteAddress nAddress, size_t nBytes, SearchType nType)
 {
+    ResetMatchingAddressIndex();
     m_nType = nType;
     m_pImpl = GetSearchImpl(nType);
 
@@ -168,12 +170,15 @@ void SearchResults::Initialize(ra::data::ByteAddress nAddress, size_t nBytes, Se
         pBlock.SetAddressCount(nAdjustedAddressCount);
     }
 
+    BuildMatchingAddressIndex();
+
     RA_LOG_INFO("Allocated %zu bytes for initial search", CalcSize(m_vBlocks));
 }
 
 _Use_decl_annotations_
 void SearchResults::Initialize(const std::vector<SearchResult>& vResults, SearchType nType)
 {
+    ResetMatchingAddressIndex();
     m_nType = nType;
     m_pImpl = GetSearchImpl(nType);
 
@@ -202,8 +207,10 @@ void SearchResults::Initialize(const std::vector<SearchResult>& vResults, Search
     std::vector<unsigned char> vMemory;
     vMemory.resize(nMemorySize);
 
-    std::vector<ra::data::ByteAddress> vAddresses;
-    vAddresses.reserve(vResults.size());
+    const auto nFirstVirtualAddress = m_pImpl->ConvertFromRealAddress(nFirstAddress);
+    ra::services::search::MatchingAddressBitmap vAddresses;
+    vAddresses.Reset(nFirstVirtualAddress,
+                     m_pImpl->ConvertFromRealAddress(nLastAddressPlusOne) - nFirstVirtualAddress);
 
     for (const auto& pResult : vResults)
     {
@@ -216,7 +223,7 @@ void SearchResults::Initialize(const std::vector<SearchResult>& vResults, Search
         if (bAligned && m_pImpl->ConvertToRealAddress(nVirtualAddress) != pResult.nAddress)
             continue;
 
-        vAddresses.push_back(nVirtualAddress);
+        vAddresses.Add(nVirtualAddress);
 
         auto nOffset = pResult.nAddress - nFirstAddress;        
         auto nValue = pResult.nValue;
@@ -248,7 +255,9 @@ void SearchResults::Initialize(const std::vector<SearchResult>& vResults, Search
         }
     }
 
-    m_pImpl->AddBlocks(*this, vAddresses, vMemory, nFirstAddress, m_pImpl->GetPadding());
+    m_pImpl->AddBlocks(*this, vAddresses, vMemory, m_pImpl->GetPadding());
+    BuildMatchingAddressIndex();
+
     RA_LOG_INFO("Allocated %zu bytes for initial search", CalcSize(m_vBlocks));
 }
 
@@ -288,12 +297,12 @@ void SearchResults::MergeSearchResults(const SearchResults& srMemory, const Sear
                 const auto nAvailable = pMemBlock.GetBytesSize() - nOffset;
                 if (nAvailable >= nSize)
                 {
-                    memcpy(pWrite, pMemBlock.GetBytes() + nOffset, nSize);
+                    memcpy(pWrite, pMemBlock.GetBytes().Data() + nOffset, nSize);
                     break;
                 }
                 else
                 {
-                    memcpy(pWrite, pMemBlock.GetBytes() + nOffset, nAvailable);
+                    memcpy(pWrite, pMemBlock.GetBytes().Data() + nOffset, nAvailable);
                     nSize -= nAvailable;
                     pWrite += nAvailable;
                     nAddress += nAvailable;
@@ -301,12 +310,16 @@ void SearchResults::MergeSearchResults(const SearchResults& srMemory, const Sear
             }
         }
     }
+
+    BuildMatchingAddressIndex();
 }
 
 _Use_decl_annotations_
 bool SearchResults::Initialize(const SearchResults& srFirst, std::function<void(ra::data::ByteAddress,uint8_t*,size_t)> pReadMemory,
     ComparisonType nCompareType, SearchFilterType nFilterType, const std::wstring& sFilterValue)
 {
+    ResetMatchingAddressIndex();
+
     m_nType = srFirst.m_nType;
     m_pImpl = srFirst.m_pImpl;
     m_nCompareType = nCompareType;
@@ -317,6 +330,7 @@ bool SearchResults::Initialize(const SearchResults& srFirst, std::function<void(
         return false;
 
     m_pImpl->ApplyFilter(*this, srFirst, pReadMemory);
+    BuildMatchingAddressIndex();
 
     RA_LOG_INFO("Allocated %zu bytes for filtered search", CalcSize(m_vBlocks));
 
@@ -351,8 +365,104 @@ bool SearchResults::Initialize(const SearchResults& srMemory, const SearchResult
     return Initialize(srMerge, nCompareType, nFilterType, sFilterValue);
 }
 
+_Use_decl_annotations_
+bool SearchResults::InitializeFromModifiedMemory(const SearchResults& srSource,
+    std::function<bool(ra::data::ByteAddress, uint32_t)> pIsMemoryModified,
+    std::function<bool(SearchResults&, const SearchResults&)> pApplyFilter)
+{
+    ResetMatchingAddressIndex();
+
+    m_nType = srSource.m_nType;
+    m_pImpl = srSource.m_pImpl;
+    m_nCompareType = srSource.m_nCompareType;
+    m_nFilterType = srSource.m_nFilterType;
+    m_nFilterValue = srSource.m_nFilterValue;
+    m_sFilterValue = srSource.m_sFilterValue;
+
+    // srSource was generated by applying the filter to the memory captured in its blocks. if that memory
+    // hasn't been modified, we can determine the result of re-applying the filter without evaluating it.
+    bool bEvaluateUnmodified = false;
+    bool bKeepUnmodified = false;
+    switch (m_nFilterType)
+    {
+        case SearchFilterType::Constant:
+        case SearchFilterType::InitialValue:
+            // comparing the same values to the same constants will produce the same matches
+            bKeepUnmodified = true;
+            break;
+
+        case SearchFilterType::LastKnownValue:
+        case SearchFilterType::LastKnownValuePlus:
+        case SearchFilterType::LastKnownValueMinus:
+            if (m_nFilterValue != 0)
+                bEvaluateUnmodified = true;
+            else if (m_nCompareType == ComparisonType::Equals)
+                bKeepUnmodified = true;
+            else if (m_nCompareType == ComparisonType::GreaterThanOrEqual || m_nCompareType == ComparisonType::LessThanOrEqual)
+                bEvaluateUnmodified = true; // floating point NaNs aren't greater than or equal to themselves
+            // otherwise, nothing can be greater than, less than, or not equal to itself
+            break;
+
+        default:
+            bEvaluateUnmodified = true;
+            break;
+    }
+
+    SearchResults srModified;
+    srModified.m_nType = m_nType;
+    srModified.m_pImpl = m_pImpl;
+    srModified.m_nCompareType = m_nCompareType;
+    srModified.m_nFilterType = m_nFilterType;
+    srModified.m_nFilterValue = m_nFilterValue;
+    srModified.m_sFilterValue = m_sFilterValue;
+
+    std::vector<const ra::data::CapturedMemoryBlock*> vUnmodifiedBlocks;
+    for (const auto& pBlock : srSource.m_vBlocks)
+    {
+        if (bEvaluateUnmodified ||
+            pIsMemoryModified(m_pImpl->ConvertToRealAddress(pBlock.GetFirstAddress()), pBlock.GetBytesSize()))
+        {
+            srModified.m_vBlocks.push_back(pBlock);
+        }
+        else if (bKeepUnmodified)
+        {
+            vUnmodifiedBlocks.push_back(&pBlock);
+        }
+    }
+
+    SearchResults srEvaluated;
+    if (!srModified.m_vBlocks.empty() && !pApplyFilter(srEvaluated, srModified))
+        return false;
+
+    // merge the evaluated blocks and the unmodified blocks back together in address order
+    m_vBlocks.reserve(srEvaluated.m_vBlocks.size() + vUnmodifiedBlocks.size());
+
+    auto pUnmodifiedIter = vUnmodifiedBlocks.begin();
+    for (auto& pBlock : srEvaluated.m_vBlocks)
+    {
+        while (pUnmodifiedIter != vUnmodifiedBlocks.end() &&
+               (*pUnmodifiedIter)->GetFirstAddress() < pBlock.GetFirstAddress())
+        {
+            m_vBlocks.push_back(**pUnmodifiedIter);
+            ++pUnmodifiedIter;
+        }
+
+        m_vBlocks.push_back(std::move(pBlock));
+    }
+
+    for (; pUnmodifiedIter != vUnmodifiedBlocks.end(); ++pUnmodifiedIter)
+        m_vBlocks.push_back(**pUnmodifiedIter);
+
+    BuildMatchingAddressIndex();
+
+    return true;
+}
+
 size_t SearchResults::MatchingAddressCount() const noexcept
 {
+    if (!m_vBlockMatchIndex.empty())
+        return m_vBlockMatchIndex.back();
+
     size_t nCount = 0;
     for (const auto& pBlock : m_vBlocks)
         nCount += pBlock.GetMatchingAddressCount();
@@ -360,6 +470,130 @@ size_t SearchResults::MatchingAddressCount() const noexcept
     return nCount;
 }
 
+static uint32_t CountBits(uint64_t nBits) noexcept
+{
+    nBits = nBits - ((nBits >> 1) & 0x5555555555555555ULL);
+    nBits = (nBits & 0x3333333333333333ULL) + ((nBits >> 2) & 0x3333333333333333ULL);
+    nBits = (nBits + (nBits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return gsl::narrow_cast<uint32_t>((nBits * 0x0101010101010101ULL) >> 56);
+}
+
+// reads the nth 64-bit word of a matching address bitmap, ignoring any bits beyond the last address
+static uint64_t ReadMatchingAddressWord(const uint8_t* pMatchingAddresses, uint32_t nAddressCount, size_t nWord) noexcept
+{
+    const auto nOffset = nWord * 64;
+    const auto nBits = std::min<size_t>(nAddressCount - nOffset, 64);
+
+    uint64_t nValue = 0;
+    for (size_t i = 0; i < (nBits + 7) / 8; ++i)
+        nValue |= gsl::narrow_cast<uint64_t>(pMatchingAddresses[nOffset / 8 + i]) << (i * 8);
+
+    if (nBits < 64)
+        nValue &= (1ULL << nBits) - 1;
+
+    return nValue;
+}
+
+void SearchResults::BuildMatchingAddressIndex()
+{
+    ResetMatchingAddressIndex();
+
+    m_vBlockMatchIndex.reserve(m_vBlocks.size() + 1);
+    m_vBlockWordIndex.reserve(m_vBlocks.size());
+
+    size_t nCount = 0;
+    for (const auto& pBlock : m_vBlocks)
+    {
+        m_vBlockMatchIndex.push_back(nCount);
+        m_vBlockWordIndex.push_back(m_vWordMatchIndex.size());
+        nCount += pBlock.GetMatchingAddressCount();
+
+        const auto* pMatchingAddresses = pBlock.GetMatchingAddressPointer();
+        if (pMatchingAddresses == nullptr) // all addresses match
+            continue;
+
+        const auto nWords = (gsl::narrow_cast<size_t>(pBlock.GetAddressCount()) + 63) / 64;
+        uint32_t nBlockCount = 0;
+        for (size_t nWord = 0; nWord < nWords; ++nWord)
+        {
+            m_vWordMatchIndex.push_back(nBlockCount);
+            nBlockCount += CountBits(ReadMatchingAddressWord(pMatchingAddresses, pBlock.GetAddressCount(), nWord));
+        }
+    }
+
+    m_vBlockMatchIndex.push_back(nCount);
+}
+
+void SearchResults::ResetMatchingAddressIndex() noexcept
+{
+    m_vBlockMatchIndex.clear();
+    m_vBlockWordIndex.clear();
+    m_vWordMatchIndex.clear();
+}
+
+_Use_decl_annotations_
+const ra::data::CapturedMemoryBlock* SearchResults::FindMatchingAddress(gsl::index nIndex, ra::data::ByteAddress& nAddress) const
+{
+    nAddress = 0;
+
+    if (m_vBlockMatchIndex.empty() || nIndex < 0 || gsl::narrow_cast<size_t>(nIndex) >= m_vBlockMatchIndex.back())
+        return nullptr;
+
+    // find the last block that starts at or before the requested match. blocks without matches have the same
+    // starting index as the following block, so they'll be skipped.
+    const auto nMatch = gsl::narrow_cast<size_t>(nIndex);
+    const auto pBlockIter = std::upper_bound(m_vBlockMatchIndex.begin(), m_vBlockMatchIndex.end() - 1, nMatch) - 1;
+    const auto nBlock = gsl::narrow_cast<size_t>(pBlockIter - m_vBlockMatchIndex.begin());
+    const auto& pBlock = m_vBlocks.at(nBlock);
+    auto nRemaining = nMatch - *pBlockIter;
+
+    const auto* pMatchingAddresses = pBlock.GetMatchingAddressPointer();
+    if (pMatchingAddresses == nullptr)
+    {
+        nAddress = pBlock.GetFirstAddress() + gsl::narrow_cast<ra::data::ByteAddress>(nRemaining);
+        return &pBlock;
+    }
+
+    // then the last word of the block that starts at or before the requested match
+    const auto nWords = (gsl::narrow_cast<size_t>(pBlock.GetAddressCount()) + 63) / 64;
+    const auto pFirstWord = m_vWordMatchIndex.begin() + m_vBlockWordIndex.at(nBlock);
+    const auto pWordIter = std::upper_bound(pFirstWord, pFirstWord + nWords, nRemaining) - 1;
+    const auto nWord = gsl::narrow_cast<size_t>(pWordIter - pFirstWord);
+    nRemaining -= *pWordIter;
+
+    // and finally the bit within the word
+    auto nBits = ReadMatchingAddressWord(pMatchingAddresses, pBlock.GetAddressCount(), nWord);
+    uint32_t nBit = 0;
+    while (CountBits(nBits & 0xFF) <= nRemaining)
+    {
+        nRemaining -= CountBits(nBits & 0xFF);
+        nBits >>= 8;
+        nBit += 8;
+    }
+
+    while (!(nBits & 1) || nRemaining-- != 0)
+    {
+        nBits >>= 1;
+        ++nBit;
+    }
+
+    nAddress = pBlock.GetFirstAddress() + gsl::narrow_cast<ra::data::ByteAddress>(nWord * 64 + nBit);
+    return &pBlock;
+}
+
+std::vector<std::pair<ra::data::ByteAddress, uint32_t>> SearchResults::GetCapturedMemoryRanges() const
+{
+    std::vector<std::pair<ra::data::ByteAddress, uint32_t>> vRanges;
+    if (m_pImpl)
+    {
+        vRanges.reserve(m_vBlocks.size());
+        for (const auto& pBlock : m_vBlocks)
+            vRanges.emplace_back(m_pImpl->ConvertToRealAddress(pBlock.GetFirstAddress()), pBlock.GetBytesSize());
+    }
+
+    return vRanges;
+}
+
 bool SearchResults::ExcludeResult(const SearchResult& pResult)
 {
     if (m_nFilterType != SearchFilterType::None && m_pImpl != nullptr)
@@ -368,6 +602,54 @@ bool SearchResults::ExcludeResult(const SearchResult& pResult)
     return false;
 }
 
+void SearchResults::ExcludeMatchingAddress(size_t nBlock, ra::data::ByteAddress nAddress)
+{
+    auto& pBlock = m_vBlocks.at(nBlock);
+    const auto bAllMatching = (pBlock.GetMatchingAddressPointer() == nullptr);
+    const auto nMatchingAddressCount = pBlock.GetMatchingAddressCount();
+
+    pBlock.ExcludeMatchingAddress(nAddress);
+    if (pBlock.GetMatchingAddressCount() == nMatchingAddressCount)
+        return;
+
+    if (bAllMatching || m_vBlockMatchIndex.empty())
+    {
+        // the block didn't have a matching address bitmap, so it doesn't have any words in the index
+        BuildMatchingAddressIndex();
+        return;
+    }
+
+    // one less match in every block after the modified block
+    for (auto nIndex = nBlock + 1; nIndex < m_vBlockMatchIndex.size(); ++nIndex)
+        --m_vBlockMatchIndex.at(nIndex);
+
+    // and one less match in every word of the modified block after the modified word
+    const auto nWords = (gsl::narrow_cast<size_t>(pBlock.GetAddressCount()) + 63) / 64;
+    const auto nFirstWord = m_vBlockWordIndex.at(nBlock);
+    for (auto nWord = (nAddress - pBlock.GetFirstAddress()) / 64 + 1; nWord < nWords; ++nWord)
+        --m_vWordMatchIndex.at(nFirstWord + nWord);
+}
+
+void SearchResults::CompressMemory() noexcept
+{
+    for (auto& block : m_vBlocks)
+        block.CompressBytes();
+}
+
+void SearchResults::DecompressMemory() noexcept
+{
+    for (auto& block : m_vBlocks)
+    {
+        if (block.IsCompressed())
+        {
+            block.DecompressBytes();
+
+            // copies of these results share the compressed memory. let them share the decompressed memory too.
+            block.OptimizeMemory();
+        }
+    }
+}
+
 bool SearchResults::GetMatchingAddress(gsl::index nIndex, _Out_ SearchResult& result) const noexcept
 {
     if (m_pImpl == nullptr)
@@ -405,18 +687,18 @@ bool SearchResults::GetBytes(ra::data::ByteAddress nAddress, unsigned char* pBuf
 
             if (ra::to_unsigned(nRemaining) >= nCount)
             {
-                memcpy(pBuffer, block.GetBytes() + (nAddress - nFirstAddress), nCount);
+                memcpy(pBuffer, block.GetBytes().Data() + (nAddress - nFirstAddress), nCount);
                 return true;
             }
 
-            memcpy(pBuffer, block.GetBytes() + (nAddress - nFirstAddress), nRemaining);
+            memcpy(pBuffer, block.GetBytes().Data() + (nAddress - nFirstAddress), nRemaining);
             nCount -= nRemaining;
             pBuffer += nRemaining;
             nAddress += nRemaining;
         }
     }
 
-    memset(pBuffer, gsl::narrow_cast<int>(nCount), 0);
+    memset(pBuffer, 0, nCount);
     return false;
 }
 
@@ -105,11 +105,28 @@ public:
     bool Initialize(_In_ const SearchResults& srFirst, _In_ std::function<void(ra::data::ByteAddress,uint8_t*,size_t)> pReadMemory,
         _In_ ComparisonType nCompareType, _In_ SearchFilterType nFilterType, _In_ const std::wstring& sFilterValue);
 
+    /// <summary>
+    /// Initializes a result set by re-applying the filter that generated another result set, only evaluating the
+    /// portions of the result set where memory has been modified since it was captured.
+    /// </summary>
+    /// <param name="srSource">The result set to filter.</param>
+    /// <param name="pIsMemoryModified">A function that determines if a range of memory has been modified.</param>
+    /// <param name="pApplyFilter">A function that applies the filter to a subset of srSource.</param>
+    /// <returns><c>true</c> if initialization was successful, <c>false</c> if the filter value was not supported</returns>
+    bool InitializeFromModifiedMemory(_In_ const SearchResults& srSource,
+        _In_ std::function<bool(ra::data::ByteAddress, uint32_t)> pIsMemoryModified,
+        _In_ std::function<bool(SearchResults&, const SearchResults&)> pApplyFilter);
+
     /// <summary>
     /// Gets the number of matching addresses.
     /// </summary>
     size_t MatchingAddressCount() const noexcept;
 
+    /// <summary>
+    /// Gets the start address and size of each range of memory captured by the result set.
+    /// </summary>
+    std::vector<std::pair<ra::data::ByteAddress, uint32_t>> GetCapturedMemoryRanges() const;
+
     /// <summary>
     /// Initializes a result set from a list of address/value pairs
     /// </summary>
@@ -209,10 +226,46 @@ public:
     /// otherwise <c>false</c>.</returns>
     bool ExcludeResult(const SearchResult& pResult);
 
+    /// <summary>
+    /// Compresses the captured memory to reduce the memory footprint of results that aren't being actively used.
+    /// </summary>
+    /// <remarks>
+    /// Reading compressed memory decodes it into a temporary buffer without modifying the results. Call
+    /// <see cref="DecompressMemory" /> before reading the results frequently.
+    /// </remarks>
+    void CompressMemory() noexcept;
+
+    /// <summary>
+    /// Restores captured memory that was compressed by <see cref="CompressMemory" />.
+    /// </summary>
+    void DecompressMemory() noexcept;
+
 private:
     void MergeSearchResults(const SearchResults& srMemory, const SearchResults& srAddresses);
 
+    /// <summary>
+    /// Locates the nth matching address using the matching address index.
+    /// </summary>
+    /// <returns>The block containing the address, <c>nullptr</c> if <paramref name="nIndex" /> is out of range.</returns>
+    const ra::data::CapturedMemoryBlock* FindMatchingAddress(gsl::index nIndex, _Out_ ra::data::ByteAddress& nAddress) const;
+    void BuildMatchingAddressIndex();
+    void ResetMatchingAddressIndex() noexcept;
+
+    /// <summary>
+    /// Removes an address from the matching addresses of the specified block, keeping the index up to date.
+    /// </summary>
+    void ExcludeMatchingAddress(size_t nBlock, ra::data::ByteAddress nAddress);
+
     std::vector<ra::data::CapturedMemoryBlock> m_vBlocks;
+
+    // index for random access into the matching addresses. built whenever the blocks are populated so the
+    // const accessors never have to modify it. m_vBlockMatchIndex holds the number of matches before each block
+    // (plus the total), m_vWordMatchIndex holds the number of matches before each 64-bit word of each block's
+    // matching address bitmap, and m_vBlockWordIndex holds the location of each block's first word in
+    // m_vWordMatchIndex. blocks where every address matches don't have any words.
+    std::vector<size_t> m_vBlockMatchIndex;
+    std::vector<size_t> m_vBlockWordIndex;
+    std::vector<uint32_t> m_vWordMatchIndex;
     SearchType m_nType = SearchType::EightBit;
 
     friend class search::SearchImpl;
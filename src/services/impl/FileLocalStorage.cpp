@@ -110,6 +110,18 @@ std::wstring FileLocalStorage::GetPath(StorageItemType nType, const std::wstring
             sPath.append(L"-history.txt");
             break;
 
+        case StorageItemType::SessionHistory:
+            sPath.append(RA_DIR_BASE);
+            sPath.append(sKey);
+            sPath.append(L"-history.dat");
+            break;
+
+        case StorageItemType::SessionHistoryBackup:
+            sPath.append(RA_DIR_BASE);
+            sPath.append(sKey);
+            sPath.append(L"-history.bak");
+            break;
+
         case StorageItemType::Bookmarks:
             sPath.append(RA_DIR_BOOKMARKS);
             sPath.append(sKey);
@@ -0,0 +1,393 @@
+#include "FileLogger.hh"
+
+#include "util\GSL.hh"
+
+namespace ra {
+namespace services {
+namespace impl {
+
+// the writer thread wakes up this often to write any messages that have been queued. the logging threads
+// don't signal it, so each wake writes the messages logged since the previous one as a single batch.
+_CONSTANT_VAR WRITE_INTERVAL = std::chrono::milliseconds(100);
+
+FileLogger::FileLogger(const ra::services::IFileSystem& pFileSystem)
+{
+    const std::wstring sLogFilePath = pFileSystem.BaseDirectory() + L"RACache\\RALog.txt";
+
+    // if the file is over 1MB, rename it and start a new one
+    const int64_t nLogSize = pFileSystem.GetFileSize(sLogFilePath);
+    if (nLogSize > 1024 * 1024)
+    {
+        const std::wstring sOldLogFilePath = pFileSystem.BaseDirectory() + L"RACache\\RALog-old.txt";
+        pFileSystem.DeleteFile(sOldLogFilePath);
+        pFileSystem.MoveFile(sLogFilePath, sOldLogFilePath);
+    }
+    else if (nLogSize < 0)
+    {
+        const std::wstring sCacheDirectory = pFileSystem.BaseDirectory() + L"RACache";
+        if (!pFileSystem.DirectoryExists(sCacheDirectory))
+            pFileSystem.CreateDirectory(sCacheDirectory);
+    }
+
+    m_pWriter = pFileSystem.AppendTextFile(sLogFilePath);
+    if (m_pWriter != nullptr)
+        m_pWriter->WriteLine();
+}
+
+FileLogger::~FileLogger() noexcept
+{
+    if (m_pWriterThread.joinable())
+    {
+        try
+        {
+            StopWriterThread();
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+void FileLogger::LogMessage(LogLevel level, const std::string& sMessage) const
+{
+    if (m_pWriter == nullptr)
+        return;
+
+    QueueMessage(level, std::string(sMessage), nullptr);
+}
+
+void FileLogger::LogDeferredMessage(LogLevel level, MessageFormatter&& fFormatMessage) const
+{
+    if (m_pWriter == nullptr)
+        return;
+
+    QueueMessage(level, std::string(), std::move(fFormatMessage));
+}
+
+FileLogger::Timestamp FileLogger::GetTimestamp()
+{
+    Timestamp tTimestamp{};
+    if (ServiceLocator::Exists<IClock>())
+    {
+        const auto tNow = ServiceLocator::Get<IClock>().Now();
+        tTimestamp.nMilliseconds = gsl::narrow_cast<unsigned int>(
+            std::chrono::time_point_cast<std::chrono::milliseconds>(tNow).time_since_epoch().count() % 1000);
+        tTimestamp.tTime = std::chrono::system_clock::to_time_t(tNow);
+    }
+    else
+    {
+        tTimestamp.tTime = time(nullptr);
+        tTimestamp.nMilliseconds = 0;
+    }
+
+    return tTimestamp;
+}
+
+void FileLogger::QueueMessage(LogLevel level, std::string&& sMessage, MessageFormatter&& fFormatMessage) const
+{
+    const auto tTimestamp = GetTimestamp();
+
+    // StopWriterThread waits for every thread that saw the writer thread running to finish queueing its message.
+    // both this and the check of m_bWriterThreadRunning have to be sequentially consistent so StopWriterThread
+    // either sees this thread queueing, or this thread sees the writer thread stopped.
+    m_nQueueingThreads.fetch_add(1);
+    if (!m_bWriterThreadRunning.load())
+    {
+        m_nQueueingThreads.fetch_sub(1, std::memory_order_release);
+
+        if (fFormatMessage)
+            sMessage = fFormatMessage();
+
+        WriteMessage(tTimestamp, level, sMessage);
+        return;
+    }
+
+    const bool bIsWriterThread = (std::this_thread::get_id() == m_pWriterThread.get_id());
+    bool bQueued = true;
+    while (!TryPush(level, tTimestamp, sMessage, fFormatMessage))
+    {
+        // the writer thread can't wait for itself to make room. this only happens if something goes wrong
+        // while writing a message, so just discard it.
+        if (bIsWriterThread)
+        {
+            bQueued = false;
+            break;
+        }
+
+        // queue is full. wait for the writer thread to empty it.
+        Flush();
+    }
+
+    m_nQueueingThreads.fetch_sub(1, std::memory_order_release);
+    if (!bQueued)
+        return;
+
+    // errors often precede a crash. make sure they're written before continuing.
+    if (level == LogLevel::Error && !bIsWriterThread)
+        Flush();
+}
+
+bool FileLogger::TryPush(LogLevel level, const Timestamp& tTimestamp, std::string& sMessage,
+                         MessageFormatter& fFormatMessage) const
+{
+    LogEntry* pEntry = nullptr;
+    auto nPosition = m_nEnqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        pEntry = &m_vQueue.at(nPosition & (QUEUE_SIZE - 1));
+
+        // if the sequence matches the position, the entry is available. if it's behind the position, the
+        // writer hasn't processed the entry from the previous pass through the queue yet. if it's ahead of
+        // the position, another thread claimed the entry and we need to try the next one.
+        const auto nSequence = pEntry->nSequence.load(std::memory_order_acquire);
+        const auto nDifference = static_cast<ptrdiff_t>(nSequence - nPosition);
+        if (nDifference == 0)
+        {
+            if (m_nEnqueuePosition.compare_exchange_weak(nPosition, nPosition + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (nDifference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            nPosition = m_nEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    pEntry->nLevel = level;
+    pEntry->tTimestamp = tTimestamp;
+    pEntry->sMessage = std::move(sMessage);
+    pEntry->fFormatMessage = std::move(fFormatMessage);
+
+    // make the entry available to the writer
+    pEntry->nSequence.store(nPosition + 1, std::memory_order_release);
+    return true;
+}
+
+bool FileLogger::TryPop(LogEntry& pEntry) const
+{
+    auto& pQueueEntry = m_vQueue.at(m_nDequeuePosition & (QUEUE_SIZE - 1));
+    if (pQueueEntry.nSequence.load(std::memory_order_acquire) != m_nDequeuePosition + 1)
+        return false;
+
+    pEntry.nLevel = pQueueEntry.nLevel;
+    pEntry.tTimestamp = pQueueEntry.tTimestamp;
+    pEntry.sMessage = std::move(pQueueEntry.sMessage);
+    pEntry.fFormatMessage = std::move(pQueueEntry.fFormatMessage);
+    pQueueEntry.sMessage.clear();
+    pQueueEntry.fFormatMessage = nullptr;
+
+    // make the entry available for the next pass through the queue
+    pQueueEntry.nSequence.store(m_nDequeuePosition + QUEUE_SIZE, std::memory_order_release);
+    ++m_nDequeuePosition;
+    return true;
+}
+
+bool FileLogger::HasPendingMessages() const noexcept
+{
+    return m_nDequeuePosition != m_nEnqueuePosition.load(std::memory_order_acquire);
+}
+
+void FileLogger::WritePendingMessages() const
+{
+    LogEntry pEntry;
+    if (!TryPop(pEntry))
+        return;
+
+    std::scoped_lock<std::mutex> oLock(m_oMutex);
+
+    do
+    {
+        // formatting is deferred until the message is written so the logging thread doesn't have to do it
+        if (pEntry.fFormatMessage)
+        {
+            try
+            {
+                pEntry.sMessage = pEntry.fFormatMessage();
+            }
+            catch (const std::exception& ex)
+            {
+                pEntry.sMessage = std::string("Error formatting message: ") + ex.what();
+            }
+
+            pEntry.fFormatMessage = nullptr;
+        }
+
+        char sBuffer[16];
+        FormatTimestamp(pEntry.tTimestamp, sBuffer, sizeof(sBuffer));
+        WriteMessage(*m_pWriter, sBuffer, pEntry.nLevel, pEntry.sMessage);
+        OnMessageWritten(pEntry.nLevel, pEntry.sMessage);
+    } while (TryPop(pEntry));
+
+    // flush once for the whole batch
+    auto* pFileWriter = dynamic_cast<ra::services::impl::FileTextWriter*>(m_pWriter.get());
+    if (pFileWriter != nullptr)
+        pFileWriter->GetFStream().flush();
+}
+
+void FileLogger::StartWriterThread()
+{
+    if (m_pWriter == nullptr || m_pWriterThread.joinable())
+        return;
+
+    if (m_vQueue.empty())
+    {
+        std::vector<LogEntry> vQueue(QUEUE_SIZE);
+        for (size_t nIndex = 0; nIndex < QUEUE_SIZE; ++nIndex)
+            vQueue.at(nIndex).nSequence.store(nIndex, std::memory_order_relaxed);
+
+        m_vQueue.swap(vQueue);
+    }
+
+    m_nEnqueuePosition.store(m_nDequeuePosition, std::memory_order_relaxed);
+    m_nWrittenPosition = m_nDequeuePosition;
+    m_bStopWriterThread = false;
+
+    m_pWriterThread = std::thread(&FileLogger::WriterThread, this);
+    m_bWriterThreadRunning.store(true, std::memory_order_release);
+}
+
+void FileLogger::StopWriterThread()
+{
+    if (!m_pWriterThread.joinable())
+        return;
+
+    // new messages will be written immediately. see QueueMessage.
+    m_bWriterThreadRunning.store(false);
+
+    {
+        std::scoped_lock<std::mutex> oLock(m_oWriterMutex);
+        m_bStopWriterThread = true;
+    }
+    m_cvWriterWake.notify_one();
+
+    m_pWriterThread.join();
+
+    // threads that saw the writer thread running just before it stopped may still be claiming or filling entries.
+    // keep writing until they're done and the dequeue position has caught up with the enqueue position.
+    for (;;)
+    {
+        WritePendingMessages();
+
+        if (m_nQueueingThreads.load(std::memory_order_acquire) == 0 && !HasPendingMessages())
+            break;
+
+        std::this_thread::yield();
+    }
+
+    {
+        std::scoped_lock<std::mutex> oLock(m_oWriterMutex);
+        m_nWrittenPosition = m_nDequeuePosition;
+    }
+    m_cvWritten.notify_all();
+}
+
+void FileLogger::WriterThread()
+{
+    std::unique_lock<std::mutex> oLock(m_oWriterMutex);
+    for (;;)
+    {
+        m_cvWriterWake.wait_for(oLock, WRITE_INTERVAL, [this]() {
+            return m_bStopWriterThread || (m_nFlushPosition != m_nWrittenPosition && HasPendingMessages());
+        });
+
+        const bool bStop = m_bStopWriterThread;
+
+        oLock.unlock();
+        WritePendingMessages();
+        oLock.lock();
+
+        m_nWrittenPosition = m_nDequeuePosition;
+        m_cvWritten.notify_all();
+
+        if (bStop)
+            break;
+    }
+}
+
+void FileLogger::Flush() const
+{
+    if (!m_bWriterThreadRunning.load(std::memory_order_acquire))
+        return;
+
+    const auto nPosition = m_nEnqueuePosition.load(std::memory_order_acquire);
+
+    std::unique_lock<std::mutex> oLock(m_oWriterMutex);
+    m_nFlushPosition = nPosition;
+    m_cvWriterWake.notify_one();
+
+    m_cvWritten.wait(oLock, [this, nPosition]() {
+        return static_cast<ptrdiff_t>(m_nWrittenPosition - nPosition) >= 0 ||
+               !m_bWriterThreadRunning.load(std::memory_order_acquire);
+    });
+}
+
+void FileLogger::FormatTimestamp(const Timestamp& tTimestamp, char* sBuffer, size_t nBufferSize)
+{
+    std::tm tTimeStruct;
+    localtime_s(&tTimeStruct, &tTimestamp.tTime);
+
+    strftime(sBuffer, nBufferSize, "%H%M%S", &tTimeStruct);
+    sprintf_s(&sBuffer[6], nBufferSize - 6, ".%03u|", tTimestamp.nMilliseconds);
+}
+
+void FileLogger::WriteMessage(const Timestamp& tTimestamp, LogLevel level, const std::string& sMessage) const
+{
+    char sBuffer[16];
+    FormatTimestamp(tTimestamp, sBuffer, sizeof(sBuffer));
+
+    // WinXP hangs if we try to acquire a mutex while the DLL in initializing. Since DllMain writes
+    // a header block to the log file, we have to do that without using a mutex. Luckily, we're not
+    // going to have multiple threads trying to write to the file, so it'll be safe, and we can
+    // use the presence (or lack thereof) of the ThreadPool implementation to determine if we're
+    // being called from DllMain.
+    if (ServiceLocator::Exists<IThreadPool>())
+    {
+        std::scoped_lock<std::mutex> oLock(m_oMutex);
+        WriteMessage(*m_pWriter, sBuffer, level, sMessage);
+    }
+    else
+    {
+        WriteMessage(*m_pWriter, sBuffer, level, sMessage);
+    }
+
+    // if writing to a file, flush immediately
+    auto* pFileWriter = dynamic_cast<ra::services::impl::FileTextWriter*>(m_pWriter.get());
+    if (pFileWriter != nullptr)
+        pFileWriter->GetFStream().flush();
+
+    OnMessageWritten(level, sMessage);
+}
+
+void FileLogger::WriteMessage(ra::services::TextWriter& pWriter, const char* const sTimestamp, LogLevel level,
+                              const std::string& sMessage)
+{
+    pWriter.Write(sTimestamp);
+
+    // mark the level
+    switch (level)
+    {
+        case LogLevel::Info:
+            pWriter.Write("INFO");
+            break;
+        case LogLevel::Warn:
+            pWriter.Write("WARN");
+            break;
+        case LogLevel::Error:
+            pWriter.Write("ERR ");
+            break;
+    }
+    pWriter.Write("| ");
+
+    // write the message
+    pWriter.Write(sMessage);
+
+    // newline
+    pWriter.WriteLine();
+}
+
+} // namespace impl
+} // namespace services
+} // namespace ra
@@ -17,111 +17,105 @@ namespace impl {
 class FileLogger : public ra::services::ILogger
 {
 public:
-    explicit FileLogger(const ra::services::IFileSystem& pFileSystem)
-    {
-        const std::wstring sLogFilePath = pFileSystem.BaseDirectory() + L"RACache\\RALog.txt";
-
-        // if the file is over 1MB, rename it and start a new one
-        const int64_t nLogSize = pFileSystem.GetFileSize(sLogFilePath);
-        if (nLogSize > 1024 * 1024)
-        {
-            const std::wstring sOldLogFilePath = pFileSystem.BaseDirectory() + L"RACache\\RALog-old.txt";
-            pFileSystem.DeleteFile(sOldLogFilePath);
-            pFileSystem.MoveFile(sLogFilePath, sOldLogFilePath);
-        }
-        else if (nLogSize < 0)
-        {
-            const std::wstring sCacheDirectory = pFileSystem.BaseDirectory() + L"RACache";
-            if (!pFileSystem.DirectoryExists(sCacheDirectory))
-                pFileSystem.CreateDirectory(sCacheDirectory);
-        }
-
-        m_pWriter = pFileSystem.AppendTextFile(sLogFilePath);
-        if (m_pWriter != nullptr)
-            m_pWriter->WriteLine();
-    }
-
-    bool IsEnabled([[maybe_unused]] LogLevel level) const noexcept override { return true; }
-
-    void LogMessage(LogLevel level, const std::string& sMessage) const override
-    {
-        if (m_pWriter == nullptr)
-            return;
-
-        // write a timestamp
-        time_t tTime{};
-        unsigned int tMilliseconds{};
-        if (ServiceLocator::Exists<IClock>())
-        {
-            const auto tNow = ServiceLocator::Get<IClock>().Now();
-            tMilliseconds = gsl::narrow_cast<unsigned int>(
-                std::chrono::time_point_cast<std::chrono::milliseconds>(tNow).time_since_epoch().count() % 1000);
-            tTime = std::chrono::system_clock::to_time_t(tNow);
-        }
-        else
-        {
-            tTime = time(nullptr);
-            tMilliseconds = 0;
-        }
-
-        std::tm tTimeStruct;
-        localtime_s(&tTimeStruct, &tTime);
-
-        char sBuffer[16];
-        strftime(sBuffer, sizeof(sBuffer), "%H%M%S", &tTimeStruct);
-        sprintf_s(&sBuffer[6], sizeof(sBuffer) - 6, ".%03u|", tMilliseconds);
-
-        // WinXP hangs if we try to acquire a mutex while the DLL in initializing. Since DllMain writes
-        // a header block to the log file, we have to do that without using a mutex. Luckily, we're not
-        // going to have multiple threads trying to write to the file, so it'll be safe, and we can
-        // use the presence (or lack thereof) of the ThreadPool implementation to determine if we're
-        // being called from DllMain.
-        if (ServiceLocator::Exists<IThreadPool>())
-        {
-            std::scoped_lock<std::mutex> oLock(m_oMutex);
-            LogMessage(*m_pWriter, sBuffer, level, sMessage);
-        }
-        else
-        {
-            LogMessage(*m_pWriter, sBuffer, level, sMessage);
-        }
-
-        // if writing to a file, flush immediately
-        auto* pFileWriter = dynamic_cast<ra::services::impl::FileTextWriter*>(m_pWriter.get());
-        if (pFileWriter != nullptr)
-            pFileWriter->GetFStream().flush();
-    }
+    explicit FileLogger(const ra::services::IFileSystem& pFileSystem);
+    virtual ~FileLogger() noexcept;
+    FileLogger(const FileLogger&) noexcept = delete;
+    FileLogger& operator=(const FileLogger&) noexcept = delete;
+    FileLogger(FileLogger&&) noexcept = delete;
+    FileLogger& operator=(FileLogger&&) noexcept = delete;
+
+    bool IsEnabled(LogLevel level) const noexcept override { return level >= m_nMinimumLevel.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// Sets the least severe level of message that will be logged.
+    /// </summary>
+    void SetMinimumLevel(LogLevel level) noexcept { m_nMinimumLevel.store(level, std::memory_order_relaxed); }
+
+    void LogMessage(LogLevel level, const std::string& sMessage) const override;
+    void LogDeferredMessage(LogLevel level, MessageFormatter&& fFormatMessage) const override;
+
+    /// <summary>
+    /// Starts a thread to format and write messages to the log. Until the thread is started, messages are
+    /// written immediately by the thread logging them.
+    /// </summary>
+    /// <remarks>
+    /// Must not be called while the DLL is being loaded.
+    /// </remarks>
+    void StartWriterThread();
+
+    /// <summary>
+    /// Writes any pending messages and stops the writer thread. Messages logged afterwards are written
+    /// immediately by the thread logging them.
+    /// </summary>
+    /// <remarks>
+    /// Must be called before the DLL is unloaded.
+    /// </remarks>
+    void StopWriterThread();
+
+    /// <summary>
+    /// Waits for the writer thread to write all messages that have been logged.
+    /// </summary>
+    void Flush() const;
+
+protected:
+    /// <summary>
+    /// Called after a message has been written to the log.
+    /// </summary>
+    virtual void OnMessageWritten([[maybe_unused]] LogLevel level, [[maybe_unused]] const std::string& sMessage) const {}
 
 private:
-    static void LogMessage(ra::services::TextWriter& pWriter, const char* const sTimestamp, LogLevel level,
-                           const std::string& sMessage)
+    struct Timestamp
+    {
+        time_t tTime;
+        unsigned int nMilliseconds;
+    };
+
+    static Timestamp GetTimestamp();
+    static void FormatTimestamp(const Timestamp& tTimestamp, char* sBuffer, size_t nBufferSize);
+
+    struct LogEntry
     {
-        pWriter.Write(sTimestamp);
-
-        // mark the level
-        switch (level)
-        {
-            case LogLevel::Info:
-                pWriter.Write("INFO");
-                break;
-            case LogLevel::Warn:
-                pWriter.Write("WARN");
-                break;
-            case LogLevel::Error:
-                pWriter.Write("ERR ");
-                break;
-        }
-        pWriter.Write("| ");
-
-        // write the message
-        pWriter.Write(sMessage);
-
-        // newline
-        pWriter.WriteLine();
-    }
+        // position in the queue that this entry will next be available for. see TryPush.
+        std::atomic<size_t> nSequence{ 0 };
+
+        LogLevel nLevel = LogLevel::Info;
+        Timestamp tTimestamp{};
+        std::string sMessage;
+        MessageFormatter fFormatMessage;
+    };
+
+    void QueueMessage(LogLevel level, std::string&& sMessage, MessageFormatter&& fFormatMessage) const;
+    bool TryPush(LogLevel level, const Timestamp& tTimestamp, std::string& sMessage,
+                 MessageFormatter& fFormatMessage) const;
+    bool TryPop(LogEntry& pEntry) const;
+    bool HasPendingMessages() const noexcept;
+    void WritePendingMessages() const;
+    void WriterThread();
+
+    void WriteMessage(const Timestamp& tTimestamp, LogLevel level, const std::string& sMessage) const;
+    static void WriteMessage(ra::services::TextWriter& pWriter, const char* const sTimestamp, LogLevel level,
+                             const std::string& sMessage);
 
     std::unique_ptr<ra::services::TextWriter> m_pWriter;
     mutable std::mutex m_oMutex;
+    std::atomic<LogLevel> m_nMinimumLevel{ LogLevel::Info };
+
+    // bounded multiple-producer, single-consumer queue. producers only contend on m_nEnqueuePosition.
+    // only the writer thread reads from the queue.
+    static constexpr size_t QUEUE_SIZE = 1024; // must be a power of two
+    mutable std::vector<LogEntry> m_vQueue;
+    mutable std::atomic<size_t> m_nEnqueuePosition{ 0 };
+    mutable size_t m_nDequeuePosition = 0;
+
+    std::thread m_pWriterThread;
+    std::atomic<bool> m_bWriterThreadRunning{ false };
+    mutable std::atomic<int> m_nQueueingThreads{ 0 }; // threads in QueueMessage that saw the writer thread running
+    bool m_bStopWriterThread = false;
+    mutable std::mutex m_oWriterMutex;
+    mutable std::condition_variable m_cvWriterWake;
+    mutable std::condition_variable m_cvWritten;
+    mutable size_t m_nWrittenPosition = 0;
+    mutable size_t m_nFlushPosition = 0;
 };
 
 } // namespace impl
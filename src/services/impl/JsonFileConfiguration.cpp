@@ -128,6 +128,8 @@ bool JsonFileConfiguration::Load(const std::wstring& sFilename)
 
     if (doc.HasMember("Prefer Decimal"))
         SetFeatureEnabled(Feature::PreferDecimal, doc["Prefer Decimal"].GetBool());
+    if (doc.HasMember("Performance Profiler"))
+        SetFeatureEnabled(Feature::PerformanceProfiler, doc["Performance Profiler"].GetBool());
 
     if (doc.HasMember("Num Background Threads"))
         m_nBackgroundThreads = doc["Num Background Threads"].GetUint();
@@ -218,6 +220,7 @@ void JsonFileConfiguration::Save() const
     WritePopupLocation(doc, a, "Challenge Notification Display", GetPopupLocation(ra::ui::viewmodels::Popup::Challenge));
     WritePopupLocation(doc, a, "Informational Notification Display", GetPopupLocation(ra::ui::viewmodels::Popup::Message));
     doc.AddMember("Prefer Decimal", IsFeatureEnabled(Feature::PreferDecimal), a);
+    doc.AddMember("Performance Profiler", IsFeatureEnabled(Feature::PerformanceProfiler), a);
     doc.AddMember("Num Background Threads", m_nBackgroundThreads, a);
 
     if (!m_sRomDirectory.empty())
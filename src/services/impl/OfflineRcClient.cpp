@@ -132,7 +132,7 @@ void OfflineRcClient::CallApi(const std::string& sApi, const ra::services::Http:
     std::function<void(const rc_api_server_response_t&, void*)> fCallback,
     void* pCallbackData) const
 {
-    ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().RunAsync(
+    ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().RunAsync(ra::services::TaskPriority::High,
         [this, httpRequest = pRequest, fCallback, pCallbackData, sApi]()
         {
             ra::services::Http::Response httpResponse = HandleOfflineRequest(httpRequest, sApi);
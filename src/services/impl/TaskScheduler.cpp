@@ -0,0 +1,242 @@
+#include "TaskScheduler.hh"
+
+#include "util\TypeCasts.hh"
+
+namespace ra {
+namespace services {
+namespace impl {
+
+_CONSTANT_VAR HIGH = ra::etoi(TaskPriority::High);
+_CONSTANT_VAR NORMAL = ra::etoi(TaskPriority::Normal);
+_CONSTANT_VAR LOW = ra::etoi(TaskPriority::Low);
+
+TaskScheduler::TaskScheduler(size_t nWorkers)
+    // leave one worker available for higher priority tasks. if there's only one worker, it has to run everything.
+    : m_nMaxLowPriorityTasks(nWorkers > 1 ? nWorkers - 1 : 1)
+{
+    m_vWorkerQueues.reserve(nWorkers);
+    for (size_t i = 0; i < nWorkers; ++i)
+        m_vWorkerQueues.push_back(std::make_unique<WorkerQueue>());
+}
+
+void TaskScheduler::Push(TaskPriority nPriority, Task&& fTask, size_t nWorker)
+{
+    // the count is updated while the queue is locked so it can't be decremented before it's incremented
+    if (nPriority == TaskPriority::Normal && nWorker < m_vWorkerQueues.size())
+    {
+        // a task queued by a worker is probably related to what the worker is doing. keep it on the worker
+        // so it can run while the related data is still cached.
+        auto& pQueue = *m_vWorkerQueues.at(nWorker);
+        std::lock_guard<std::mutex> lock(pQueue.oMutex);
+        pQueue.vTasks.push_back(std::move(fTask));
+        ++pQueue.nCount;
+        ++std::get<NORMAL>(m_vQueuedTaskCounts);
+    }
+    else
+    {
+        const auto nIndex = ra::etoi(nPriority);
+        std::lock_guard<std::mutex> lock(m_oMutex);
+        m_vQueues.at(nIndex).push_back(std::move(fTask));
+        ++m_vQueuedTaskCounts.at(nIndex);
+    }
+}
+
+bool TaskScheduler::TryPopGlobal(TaskPriority nPriority, Task& fTask)
+{
+    const auto nIndex = ra::etoi(nPriority);
+    auto& nCount = m_vQueuedTaskCounts.at(nIndex);
+    if (nCount == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    auto& vQueue = m_vQueues.at(nIndex);
+    if (vQueue.empty())
+        return false;
+
+    fTask = std::move(vQueue.front());
+    vQueue.pop_front();
+    --nCount;
+    return true;
+}
+
+bool TaskScheduler::TryPopLocal(size_t nWorker, Task& fTask)
+{
+    if (nWorker >= m_vWorkerQueues.size())
+        return false;
+
+    // newest first. it's the most likely to still have its data cached.
+    auto& pQueue = *m_vWorkerQueues.at(nWorker);
+    if (pQueue.nCount == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(pQueue.oMutex);
+    if (pQueue.vTasks.empty())
+        return false;
+
+    fTask = std::move(pQueue.vTasks.back());
+    pQueue.vTasks.pop_back();
+    --pQueue.nCount;
+    --std::get<NORMAL>(m_vQueuedTaskCounts);
+    return true;
+}
+
+bool TaskScheduler::TrySteal(size_t nWorker, Task& fTask)
+{
+    const auto nWorkers = m_vWorkerQueues.size();
+    const size_t nFirst = (nWorker < nWorkers) ? nWorker + 1 : 0;
+
+    for (size_t i = 0; i < nWorkers; ++i)
+    {
+        const auto nVictim = (nFirst + i) % nWorkers;
+        if (nVictim == nWorker)
+            continue;
+
+        // oldest first. the victim is working on the newest ones.
+        auto& pQueue = *m_vWorkerQueues.at(nVictim);
+        if (pQueue.nCount == 0)
+            continue;
+
+        std::lock_guard<std::mutex> lock(pQueue.oMutex);
+        if (!pQueue.vTasks.empty())
+        {
+            fTask = std::move(pQueue.vTasks.front());
+            pQueue.vTasks.pop_front();
+            --pQueue.nCount;
+            --std::get<NORMAL>(m_vQueuedTaskCounts);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TaskScheduler::TryPop(size_t nWorker, Task& fTask, TaskPriority& nPriority)
+{
+    if (TryPopGlobal(TaskPriority::High, fTask))
+    {
+        nPriority = TaskPriority::High;
+        return true;
+    }
+
+    if (std::get<NORMAL>(m_vQueuedTaskCounts) > 0)
+    {
+        if (TryPopLocal(nWorker, fTask) || TryPopGlobal(TaskPriority::Normal, fTask) || TrySteal(nWorker, fTask))
+        {
+            nPriority = TaskPriority::Normal;
+            return true;
+        }
+    }
+
+    if (std::get<LOW>(m_vQueuedTaskCounts) > 0)
+    {
+        // reserve a slot before taking the task so multiple workers can't exceed the limit
+        auto nRunning = m_nRunningLowPriorityTasks.load();
+        do
+        {
+            if (nRunning >= m_nMaxLowPriorityTasks)
+                return false;
+        } while (!m_nRunningLowPriorityTasks.compare_exchange_weak(nRunning, nRunning + 1));
+
+        if (TryPopGlobal(TaskPriority::Low, fTask))
+        {
+            nPriority = TaskPriority::Low;
+            return true;
+        }
+
+        --m_nRunningLowPriorityTasks;
+    }
+
+    return false;
+}
+
+void TaskScheduler::Complete(TaskPriority nPriority) noexcept
+{
+    if (nPriority == TaskPriority::Low)
+        --m_nRunningLowPriorityTasks;
+}
+
+bool TaskScheduler::HasAvailableTask() const noexcept
+{
+    if (std::get<HIGH>(m_vQueuedTaskCounts) > 0 || std::get<NORMAL>(m_vQueuedTaskCounts) > 0)
+        return true;
+
+    return (std::get<LOW>(m_vQueuedTaskCounts) > 0 && m_nRunningLowPriorityTasks < m_nMaxLowPriorityTasks);
+}
+
+size_t TaskScheduler::GetQueuedTaskCount() const noexcept
+{
+    return std::get<HIGH>(m_vQueuedTaskCounts) + std::get<NORMAL>(m_vQueuedTaskCounts) +
+           std::get<LOW>(m_vQueuedTaskCounts);
+}
+
+bool TaskScheduler::Schedule(TimePoint tWhen, Task&& fTask)
+{
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    const auto nSequence = m_nNextSequence++;
+    m_vDelayedTasks.push_back({ tWhen, nSequence, std::move(fTask) });
+    std::push_heap(m_vDelayedTasks.begin(), m_vDelayedTasks.end(), IsLater);
+
+    return (m_vDelayedTasks.front().nSequence == nSequence);
+}
+
+size_t TaskScheduler::PromoteDelayedTasks(TimePoint tNow)
+{
+    std::lock_guard<std::mutex> lock(m_oMutex);
+
+    std::vector<Task> vReady;
+    while (!m_vDelayedTasks.empty() && m_vDelayedTasks.front().tWhen <= tNow)
+    {
+        std::pop_heap(m_vDelayedTasks.begin(), m_vDelayedTasks.end(), IsLater);
+        vReady.push_back(std::move(m_vDelayedTasks.back().fTask));
+        m_vDelayedTasks.pop_back();
+    }
+
+    if (!vReady.empty())
+    {
+        // the tasks are already late. put them ahead of anything else of the same priority.
+        auto& vQueue = std::get<NORMAL>(m_vQueues);
+        vQueue.insert(vQueue.begin(), std::make_move_iterator(vReady.begin()), std::make_move_iterator(vReady.end()));
+        std::get<NORMAL>(m_vQueuedTaskCounts) += vReady.size();
+    }
+
+    return vReady.size();
+}
+
+TaskScheduler::TimePoint TaskScheduler::GetNextDelayedTaskTime() const
+{
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    return m_vDelayedTasks.empty() ? TimePoint::max() : m_vDelayedTasks.front().tWhen;
+}
+
+void TaskScheduler::Clear()
+{
+    // tasks are destroyed after the locks are released as destroying their captures may queue more tasks
+    std::vector<Task> vDiscarded;
+    {
+        std::lock_guard<std::mutex> lock(m_oMutex);
+        for (size_t i = 0; i < PRIORITY_COUNT; ++i)
+        {
+            auto& vQueue = m_vQueues.at(i);
+            m_vQueuedTaskCounts.at(i) -= vQueue.size();
+            std::move(vQueue.begin(), vQueue.end(), std::back_inserter(vDiscarded));
+            vQueue.clear();
+        }
+
+        for (auto& pTask : m_vDelayedTasks)
+            vDiscarded.push_back(std::move(pTask.fTask));
+        m_vDelayedTasks.clear();
+    }
+
+    for (auto& pQueue : m_vWorkerQueues)
+    {
+        std::lock_guard<std::mutex> lock(pQueue->oMutex);
+        std::get<NORMAL>(m_vQueuedTaskCounts) -= pQueue->vTasks.size();
+        pQueue->nCount = 0;
+        std::move(pQueue->vTasks.begin(), pQueue->vTasks.end(), std::back_inserter(vDiscarded));
+        pQueue->vTasks.clear();
+    }
+}
+
+} // namespace impl
+} // namespace services
+} // namespace ra
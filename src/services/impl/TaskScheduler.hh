@@ -0,0 +1,146 @@
+#ifndef RA_SERVICES_TASKSCHEDULER_HH
+#define RA_SERVICES_TASKSCHEDULER_HH
+#pragma once
+
+#include "services\IThreadPool.hh"
+
+namespace ra {
+namespace services {
+namespace impl {
+
+/// <summary>
+/// Decides which queued task each worker of a <see cref="ThreadPool" /> should run next.
+/// </summary>
+/// <remarks>
+/// The scheduler doesn't own any threads, so its decisions can be verified without timing dependencies.
+/// All methods are thread-safe.
+/// </remarks>
+class TaskScheduler
+{
+public:
+    using Task = std::function<void()>;
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    /// <summary>
+    /// Identifies a task being queued by a thread that isn't a worker.
+    /// </summary>
+    static constexpr size_t NO_WORKER = static_cast<size_t>(-1);
+
+    explicit TaskScheduler(size_t nWorkers);
+    ~TaskScheduler() noexcept = default;
+    TaskScheduler(const TaskScheduler&) noexcept = delete;
+    TaskScheduler& operator=(const TaskScheduler&) noexcept = delete;
+    TaskScheduler(TaskScheduler&&) noexcept = delete;
+    TaskScheduler& operator=(TaskScheduler&&) noexcept = delete;
+
+    /// <summary>
+    /// Gets the number of workers the scheduler is distributing tasks to.
+    /// </summary>
+    size_t GetWorkerCount() const noexcept { return m_vWorkerQueues.size(); }
+
+    /// <summary>
+    /// Queues a task.
+    /// </summary>
+    /// <param name="nWorker">
+    /// The worker queueing the task, or <see cref="NO_WORKER" />. Normal priority tasks queued by a worker are kept
+    /// in that worker's queue, where they'll be picked up by the worker when it finishes its current task, or by
+    /// an idle worker.
+    /// </param>
+    void Push(TaskPriority nPriority, Task&& fTask, size_t nWorker = NO_WORKER);
+
+    /// <summary>
+    /// Gets the next task for a worker.
+    /// </summary>
+    /// <returns><c>true</c> if a task was returned. <see cref="Complete" /> must be called when the task finishes.</returns>
+    /// <remarks>
+    /// High priority tasks are returned first, followed by tasks from the worker's own queue (newest first),
+    /// normal priority tasks queued by non-workers, and tasks taken from the other workers' queues (oldest first).
+    /// Low priority tasks are only returned if doing so would leave at least one worker available for the other
+    /// priorities.
+    /// </remarks>
+    bool TryPop(size_t nWorker, Task& fTask, TaskPriority& nPriority);
+
+    /// <summary>
+    /// Indicates a task returned by <see cref="TryPop" /> has finished.
+    /// </summary>
+    void Complete(TaskPriority nPriority) noexcept;
+
+    /// <summary>
+    /// Determines whether <see cref="TryPop" /> would return a task.
+    /// </summary>
+    bool HasAvailableTask() const noexcept;
+
+    /// <summary>
+    /// Gets the number of queued tasks, not including delayed tasks.
+    /// </summary>
+    size_t GetQueuedTaskCount() const noexcept;
+
+    /// <summary>
+    /// Queues a task to be made available at a later time.
+    /// </summary>
+    /// <returns><c>true</c> if the task is now the first delayed task to become available.</returns>
+    bool Schedule(TimePoint tWhen, Task&& fTask);
+
+    /// <summary>
+    /// Makes any delayed tasks that are due available ahead of other normal priority tasks.
+    /// </summary>
+    /// <returns>The number of tasks that were made available.</returns>
+    size_t PromoteDelayedTasks(TimePoint tNow);
+
+    /// <summary>
+    /// Gets when the next delayed task is due.
+    /// </summary>
+    /// <returns>When the next delayed task is due, or <c>TimePoint::max()</c> if there are no delayed tasks.</returns>
+    TimePoint GetNextDelayedTaskTime() const;
+
+    /// <summary>
+    /// Discards all queued and delayed tasks.
+    /// </summary>
+    void Clear();
+
+private:
+    static constexpr size_t PRIORITY_COUNT = 3;
+
+    bool TryPopLocal(size_t nWorker, Task& fTask);
+    bool TryPopGlobal(TaskPriority nPriority, Task& fTask);
+    bool TrySteal(size_t nWorker, Task& fTask);
+
+    struct WorkerQueue
+    {
+        std::mutex oMutex;
+        std::deque<Task> vTasks;
+        std::atomic<size_t> nCount{ 0U }; // lets other workers skip an empty queue without locking it
+    };
+    std::vector<std::unique_ptr<WorkerQueue>> m_vWorkerQueues;
+
+    // tasks queued by non-workers, and high and low priority tasks queued by workers
+    mutable std::mutex m_oMutex;
+    std::array<std::deque<Task>, PRIORITY_COUNT> m_vQueues;
+
+    // number of queued tasks for each priority, including those in the worker queues. allows workers to check for
+    // work without taking any locks.
+    std::array<std::atomic<size_t>, PRIORITY_COUNT> m_vQueuedTaskCounts{};
+
+    std::atomic<size_t> m_nRunningLowPriorityTasks{ 0U };
+    size_t m_nMaxLowPriorityTasks;
+
+    struct DelayedTask
+    {
+        TimePoint tWhen;
+        uint64_t nSequence; // tasks scheduled for the same time are made available in the order they were scheduled
+        Task fTask;
+    };
+    static bool IsLater(const DelayedTask& pLeft, const DelayedTask& pRight) noexcept
+    {
+        return (pLeft.tWhen > pRight.tWhen) || (pLeft.tWhen == pRight.tWhen && pLeft.nSequence > pRight.nSequence);
+    }
+
+    std::vector<DelayedTask> m_vDelayedTasks; // min-heap ordered by IsLater
+    uint64_t m_nNextSequence = 0U;
+};
+
+} // namespace impl
+} // namespace services
+} // namespace ra
+
+#endif // !RA_SERVICES_TASKSCHEDULER_HH
@@ -6,6 +6,10 @@ namespace ra {
 namespace services {
 namespace impl {
 
+// identifies the worker running on the current thread so tasks it queues can be kept on that worker
+static thread_local const ThreadPool* s_pWorkerPool = nullptr;
+static thread_local size_t s_nWorkerIndex = 0U;
+
 ThreadPool::~ThreadPool() noexcept
 {
     Shutdown(true);
@@ -15,33 +19,84 @@ void ThreadPool::Initialize(size_t nThreads) noexcept
 {
     assert(m_vThreads.empty());
 
-    // require at least two threads. that way if one thread is reserved for processing timed events, another is still available to execute them.
+    // require at least two threads. that way if one thread is busy with low priority work, another is still
+    // available for everything else.
     if (nThreads < 2)
-        nThreads = 2; 
+        nThreads = 2;
 
     RA_LOG_INFO("Initializing %zu worker threads", nThreads);
 
+    m_pScheduler = std::make_unique<TaskScheduler>(nThreads);
+
     for (size_t i = 0; i < nThreads; ++i)
-        m_vThreads.emplace_back(&ThreadPool::RunThread, this);
+        m_vThreads.emplace_back(&ThreadPool::RunThread, this, i);
+
+    m_pTimerThread = std::thread(&ThreadPool::ProcessDelayedTasks, this);
 }
 
-void ThreadPool::RunThread()
+void ThreadPool::RunAsync(TaskPriority nPriority, std::function<void()>&& f)
 {
-    do
+    if (m_bShutdownInitiated)
+        return;
+
+    assert(m_pScheduler != nullptr);
+
+    const auto nWorker = (s_pWorkerPool == this) ? s_nWorkerIndex : TaskScheduler::NO_WORKER;
+    m_pScheduler->Push(nPriority, std::move(f), nWorker);
+
+    WakeThreads(1);
+}
+
+void ThreadPool::ScheduleAsync(std::chrono::milliseconds nDelay, std::function<void()>&& f)
+{
+    if (m_bShutdownInitiated)
+        return;
+
+    assert(m_pScheduler != nullptr);
+
+    const auto tWhen = ServiceLocator::Get<IClock>().UpTime() + nDelay;
+    if (m_pScheduler->Schedule(tWhen, std::move(f)))
     {
-        // check for work
-        do
+        // sooner than the next scheduled task, wake the timer thread to recalculate the time until the next task.
+        // taking the lock ensures the timer thread is either waiting or hasn't checked the next time yet.
         {
-            std::function<void()> pNext;
-            {
-                std::unique_lock<std::mutex> lock(m_oMutex);
-                if (m_vQueue.empty())
-                    break;
+            std::lock_guard<std::mutex> lock(m_oTimerMutex);
+        }
+        m_cvDelayedWork.notify_one();
+    }
+}
 
-                pNext = std::move(m_vQueue.front());
-                m_vQueue.pop_front();
-            }
+void ThreadPool::WakeThreads(size_t nTasks)
+{
+    // m_nIdleThreads is incremented before an idle thread checks for work, so if it's zero, any thread that's
+    // about to wait will see the new task
+    if (nTasks == 0 || m_nIdleThreads == 0)
+        return;
+
+    // taking the lock ensures an idle thread is either waiting or hasn't checked for work yet
+    {
+        std::lock_guard<std::mutex> lock(m_oMutex);
+    }
+
+    if (nTasks == 1)
+        m_cvWork.notify_one();
+    else
+        m_cvWork.notify_all();
+}
 
+void ThreadPool::RunThread(size_t nWorker)
+{
+    s_pWorkerPool = this;
+    s_nWorkerIndex = nWorker;
+
+    std::function<void()> pNext;
+    TaskPriority nPriority = TaskPriority::Normal;
+
+    while (!m_bShutdownInitiated)
+    {
+        // check for work
+        if (m_pScheduler->TryPop(nWorker, pNext, nPriority))
+        {
             // do work
             try
             {
@@ -52,75 +107,66 @@ void ThreadPool::RunThread()
             {
                 RA_LOG_ERR("Exception on background thread: %s", ex.what());
             }
-        } while (!m_bShutdownInitiated);
 
-        // wait for work
-        if (!m_bShutdownInitiated)
-        {
-            std::unique_lock<std::mutex> lock(m_oMutex);
-            m_cvWork.wait(lock);
+            pNext = nullptr;
+            m_pScheduler->Complete(nPriority);
+
+            // finishing a low priority task may allow another low priority task to start
+            if (nPriority == TaskPriority::Low && m_pScheduler->HasAvailableTask())
+                WakeThreads(1);
+
+            continue;
         }
-    } while (!m_bShutdownInitiated);
+
+        // wait for work
+        std::unique_lock<std::mutex> lock(m_oMutex);
+        ++m_nIdleThreads;
+        m_cvWork.wait(lock, [this]() { return m_bShutdownInitiated || m_pScheduler->HasAvailableTask(); });
+        --m_nIdleThreads;
+    }
+
+    s_pWorkerPool = nullptr;
 }
 
 void ThreadPool::ProcessDelayedTasks()
 {
-    auto& pClock = ServiceLocator::Get<IClock>();
-    constexpr auto tZeroMilliseconds = std::chrono::milliseconds(0);
-
-    // check for work
+    std::unique_lock<std::mutex> lock(m_oTimerMutex);
     while (!m_bShutdownInitiated)
     {
-        // move any work that needs to occur now to the work queue
-        size_t nReadyTasks = 0U;
+        const auto tNext = m_pScheduler->GetNextDelayedTaskTime();
+        if (tNext == TaskScheduler::TimePoint::max())
         {
-            std::unique_lock<std::mutex> lock(m_oMutex);
-
-            const auto tNow = pClock.UpTime();
-            while (!m_vDelayedTasks.empty() && m_vDelayedTasks.front().tWhen <= tNow)
-            {
-                m_vQueue.emplace_front(std::move(m_vDelayedTasks.front().fTask));
-                m_vDelayedTasks.pop_front();
-
-                ++nReadyTasks;
-            }
+            // nothing scheduled. wait for ScheduleAsync.
+            m_cvDelayedWork.wait(lock);
+            continue;
         }
 
-        if (m_bShutdownInitiated)
-            break;
-
-        // wake up other threads to do the work
-        if (nReadyTasks >= m_nThreads - 1) // we're using one thread
+        const auto tNow = ServiceLocator::Get<IClock>().UpTime();
+        if (tNext > tNow)
         {
-            m_cvWork.notify_all();
+            // sleep until it's time to do the next work. use a wait_for instead of a sleep so we can can be woken
+            // early if new work gets added that needs to occur sooner that we were expecting.
+            m_cvDelayedWork.wait_for(lock, tNext - tNow);
+            continue;
         }
-        else
-        {
-            while (nReadyTasks--)
-                m_cvWork.notify_one();
-        }
-
-
-        // sleep until it's time to do the next work. use a wait_for instead of a sleep so we can can be woken
-        // early if new work gets added that needs to occur sooner that we were expecting.
-        {
-            std::unique_lock<std::mutex> lock(m_oMutex);
 
-            // no more delayed tasks, free up the thread for other work
-            if (m_vDelayedTasks.empty())
-                break;
-
-            const auto tNext = m_vDelayedTasks.front().tWhen - pClock.UpTime();
-            if (tNext > tZeroMilliseconds)
-                m_cvDelayedWork.wait_for(lock, tNext);
-        }
+        // move any work that needs to occur now to the work queue and wake up threads to do it
+        WakeThreads(m_pScheduler->PromoteDelayedTasks(tNow));
     }
 }
 
 void ThreadPool::Shutdown(bool bWait) noexcept
 {
     m_bShutdownInitiated = true;
+
+    {
+        std::lock_guard<std::mutex> lock(m_oTimerMutex);
+    }
     m_cvDelayedWork.notify_all();
+
+    {
+        std::lock_guard<std::mutex> lock(m_oMutex);
+    }
     m_cvWork.notify_all();
 
     if (bWait && !m_vThreads.empty())
@@ -130,11 +176,13 @@ void ThreadPool::Shutdown(bool bWait) noexcept
         for (auto& pThread : m_vThreads)
             pThread.join();
 
+        if (m_pTimerThread.joinable())
+            m_pTimerThread.join();
+
         RA_LOG_INFO("Background threads finished");
 
         m_vThreads.clear();
     }
-
 }
 
 } // namespace impl
@@ -5,6 +5,7 @@
 #include "services\IClock.hh"
 #include "services\IThreadPool.hh"
 #include "services\ServiceLocator.hh"
+#include "services\impl\TaskScheduler.hh"
 
 #include "util\GSL.hh"
 
@@ -31,98 +32,34 @@ public:
 
     void RunAsync(std::function<void()>&& f) override
     {
-        if (m_bShutdownInitiated)
-            return;
-
-        assert(!m_vThreads.empty());
-
-        {
-            std::unique_lock<std::mutex> lock(m_oMutex);
-            m_vQueue.push_back(std::move(f));
-        }
-
-        m_cvWork.notify_one();
+        RunAsync(TaskPriority::Normal, std::move(f));
     }
 
-    void ScheduleAsync(std::chrono::milliseconds nDelay, std::function<void()>&& f) override
-    {
-        if (m_bShutdownInitiated)
-            return;
-
-        assert(!m_vThreads.empty());
-
-        const auto tWhen = ServiceLocator::Get<IClock>().UpTime() + nDelay;
-
-        bool bStartScheduler = false;
-        bool bNewPriority    = false;
-        {
-            std::unique_lock<std::mutex> lock(m_oMutex);
-
-            auto iter = m_vDelayedTasks.begin();
-
-            if (m_vDelayedTasks.empty())
-            {
-                // first scheduled task - dedicate one of the background threads to timed events
-                m_vQueue.push_front([this]() { ProcessDelayedTasks(); });
-                bStartScheduler = true;
-            }
-            else if (tWhen < iter->tWhen)
-            {
-                // sooner than the next scheduled task, we'll need to wake the timed events thread to reset the wait
-                // time
-                bNewPriority = true;
-            }
-            else
-            {
-                // after the next scheduled task, find where to insert it
-                do
-                {
-                    ++iter;
-                } while (iter != m_vDelayedTasks.end() && iter->tWhen < tWhen);
-            }
-
-            m_vDelayedTasks.emplace(iter, tWhen, std::move(f));
-        }
-
-        if (bStartScheduler)
-        {
-            // wake one of the background threads to process the timed events
-            m_cvWork.notify_one();
-        }
-
-        if (bNewPriority)
-        {
-            // wake the timed events thread to recalculate the time until the next event
-            m_cvDelayedWork.notify_one();
-        }
-    }
+    void RunAsync(TaskPriority nPriority, std::function<void()>&& f) override;
+
+    void ScheduleAsync(std::chrono::milliseconds nDelay, std::function<void()>&& f) override;
 
     GSL_SUPPRESS_F6 void Shutdown(bool bWait) noexcept override;
 
     bool IsShutdownRequested() const noexcept override { return m_bShutdownInitiated; }
 
 private:
-    void RunThread();
+    void RunThread(size_t nWorker);
     void ProcessDelayedTasks();
+    void WakeThreads(size_t nTasks);
 
+    std::unique_ptr<TaskScheduler> m_pScheduler;
     std::vector<std::thread> m_vThreads;
-    size_t m_nThreads{0U};
-    bool m_bShutdownInitiated{false};
-
-    struct DelayedTask
-    {
-        DelayedTask(std::chrono::steady_clock::time_point tWhen, std::function<void()> fTask) :
-            tWhen(tWhen),
-            fTask(fTask){};
+    std::thread m_pTimerThread;
+    std::atomic<bool> m_bShutdownInitiated{false};
 
-        std::chrono::steady_clock::time_point tWhen;
-        std::function<void()> fTask;
-    };
-    std::deque<DelayedTask> m_vDelayedTasks;
-
-    std::deque<std::function<void()>> m_vQueue;
+    // idle threads wait on m_cvWork. producers only take the lock to wake them if one is waiting.
     std::mutex m_oMutex;
     std::condition_variable m_cvWork;
+    std::atomic<size_t> m_nIdleThreads{0U};
+
+    // the timer thread waits on m_cvDelayedWork until the next delayed task is due
+    std::mutex m_oTimerMutex;
     std::condition_variable m_cvDelayedWork;
 };
 
@@ -16,10 +16,9 @@ public:
     {
     }
 
-    void LogMessage(LogLevel level, const std::string& sMessage) const override
+protected:
+    void OnMessageWritten([[maybe_unused]] LogLevel level, const std::string& sMessage) const override
     {
-        FileLogger::LogMessage(level, sMessage);
-
         OutputDebugStringA(sMessage.c_str());
         OutputDebugStringA("\n");
     }
@@ -90,17 +90,54 @@ static void ReadIntoWriter(const HINTERNET hRequest, ra::services::TextWriter& p
     }
 }
 
-unsigned int WindowsHttpRequester::Request(const Http::Request& pRequest, TextWriter& pContentWriter) const
+WindowsHttpRequester::~WindowsHttpRequester() noexcept
 {
-    DWORD nStatusCode = 0;
+    if (m_hSession != nullptr)
+        WinHttpCloseHandle(m_hSession);
+}
+
+void WindowsHttpRequester::SetUserAgent(const std::string& sUserAgent)
+{
+    std::lock_guard<std::mutex> lock(m_oSessionMutex);
+    m_sUserAgent = ra::util::String::Widen(sUserAgent);
+
+    if (m_hSession != nullptr)
+    {
+        WinHttpSetOption(m_hSession, WINHTTP_OPTION_USER_AGENT, m_sUserAgent.data(),
+                         gsl::narrow_cast<DWORD>(m_sUserAgent.length()));
+    }
+}
 
-    // obtain a session handle.
+void* WindowsHttpRequester::GetSession() const
+{
+    std::lock_guard<std::mutex> lock(m_oSessionMutex);
+    if (m_hSession == nullptr)
+    {
 #pragma warning(push)
 #pragma warning(disable: 26477)
-    GSL_SUPPRESS_ES47 HINTERNET hSession = WinHttpOpen(m_sUserAgent.c_str(), WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-                                                       WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+        GSL_SUPPRESS_ES47 m_hSession = WinHttpOpen(m_sUserAgent.c_str(), WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                                                   WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
 #pragma warning(pop)
 
+#ifdef WINHTTP_PROTOCOL_FLAG_HTTP2
+        if (m_hSession != nullptr)
+        {
+            // HTTP/2 multiplexes requests over a single connection. ignored if the OS doesn't support it.
+            DWORD nProtocols = WINHTTP_PROTOCOL_FLAG_HTTP2;
+            WinHttpSetOption(m_hSession, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &nProtocols, sizeof(nProtocols));
+        }
+#endif
+    }
+
+    return m_hSession;
+}
+
+unsigned int WindowsHttpRequester::Request(const Http::Request& pRequest, TextWriter& pContentWriter) const
+{
+    DWORD nStatusCode = 0;
+
+    // obtain the shared session handle. the session keeps the underlying connections alive between requests.
+    HINTERNET hSession = GetSession();
     if (hSession == nullptr)
     {
         nStatusCode = GetLastError();
@@ -240,7 +277,7 @@ unsigned int WindowsHttpRequester::Request(const Http::Request& pRequest, TextWr
                         hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER, WINHTTP_HEADER_NAME_BY_INDEX,
                         &nStatusCode, &dwSize, WINHTTP_NO_HEADER_INDEX);
 
-                    // read the response
+                    // read the response. the whole response has to be read for the connection to be reused.
                     auto* pStringWriter = dynamic_cast<StringTextWriter*>(&pContentWriter);
                     if (pStringWriter != nullptr)
                     {
@@ -262,8 +299,6 @@ unsigned int WindowsHttpRequester::Request(const Http::Request& pRequest, TextWr
 
             WinHttpCloseHandle(hConnect);
         }
-
-        WinHttpCloseHandle(hSession);
     }
 
     return nStatusCode;
@@ -15,7 +15,14 @@ namespace impl {
 class WindowsHttpRequester : public IHttpRequester
 {
 public:
-    void SetUserAgent(const std::string& sUserAgent) override { m_sUserAgent = ra::util::String::Widen(sUserAgent); }
+    WindowsHttpRequester() noexcept = default;
+    ~WindowsHttpRequester() noexcept;
+    WindowsHttpRequester(const WindowsHttpRequester&) noexcept = delete;
+    WindowsHttpRequester& operator=(const WindowsHttpRequester&) noexcept = delete;
+    WindowsHttpRequester(WindowsHttpRequester&&) noexcept = delete;
+    WindowsHttpRequester& operator=(WindowsHttpRequester&&) noexcept = delete;
+
+    void SetUserAgent(const std::string& sUserAgent) override;
 
     unsigned int Request(const Http::Request& pRequest, TextWriter& pContentWriter) const override;
 
@@ -24,7 +31,14 @@ public:
     std::string GetStatusCodeText(unsigned int nStatusCode) const override;
 
 private:
+    void* GetSession() const;
+
     std::wstring m_sUserAgent;
+
+    // connections made through a single session share the underlying sockets, which allows WinHTTP to keep them
+    // alive between requests.
+    mutable std::mutex m_oSessionMutex;
+    mutable void* m_hSession = nullptr;
 };
 
 } // namespace impl
@@ -6,6 +6,12 @@ namespace ui {
 void ViewModelCollectionBase::OnFrozen() noexcept
 {
     m_vNotifyTargets.Clear();
+    m_vChangedValues.clear();
+}
+
+bool ViewModelCollectionBase::IsBatchingValueChanges(const NotifyTarget& pTarget) const noexcept
+{
+    return IsUpdating() && pTarget.BatchesValueChanges();
 }
 
 void ViewModelCollectionBase::OnModelValueChanged(gsl::index nIndex,
@@ -13,8 +19,17 @@ void ViewModelCollectionBase::OnModelValueChanged(gsl::index nIndex,
 {
     if (m_vNotifyTargets.LockIfNotEmpty())
     {
+        bool bBatched = false;
         for (auto& target : m_vNotifyTargets.Targets())
-            target.OnViewModelBoolValueChanged(nIndex, args);
+        {
+            if (IsBatchingValueChanges(target))
+                bBatched = true;
+            else
+                target.OnViewModelBoolValueChanged(nIndex, args);
+        }
+
+        if (bBatched)
+            m_vChangedValues.push_back({nIndex, &args.Property});
 
         m_vNotifyTargets.Unlock();
     }
@@ -25,8 +40,17 @@ void ViewModelCollectionBase::OnModelValueChanged(gsl::index nIndex,
 {
     if (m_vNotifyTargets.LockIfNotEmpty())
     {
+        bool bBatched = false;
         for (auto& target : m_vNotifyTargets.Targets())
-            target.OnViewModelStringValueChanged(nIndex, args);
+        {
+            if (IsBatchingValueChanges(target))
+                bBatched = true;
+            else
+                target.OnViewModelStringValueChanged(nIndex, args);
+        }
+
+        if (bBatched)
+            m_vChangedValues.push_back({nIndex, &args.Property});
 
         m_vNotifyTargets.Unlock();
     }
@@ -37,8 +61,17 @@ void ViewModelCollectionBase::OnModelValueChanged(gsl::index nIndex,
 {
     if (m_vNotifyTargets.LockIfNotEmpty())
     {
+        bool bBatched = false;
         for (auto& target : m_vNotifyTargets.Targets())
-            target.OnViewModelIntValueChanged(nIndex, args);
+        {
+            if (IsBatchingValueChanges(target))
+                bBatched = true;
+            else
+                target.OnViewModelIntValueChanged(nIndex, args);
+        }
+
+        if (bBatched)
+            m_vChangedValues.push_back({nIndex, &args.Property});
 
         m_vNotifyTargets.Unlock();
     }
@@ -46,6 +79,8 @@ void ViewModelCollectionBase::OnModelValueChanged(gsl::index nIndex,
 
 void ViewModelCollectionBase::OnBeginUpdate()
 {
+    m_vChangedValues.clear();
+
     if (m_vNotifyTargets.LockIfNotEmpty())
     {
         for (auto& target : m_vNotifyTargets.Targets())
@@ -59,6 +94,30 @@ void ViewModelCollectionBase::OnEndUpdate()
 {
     if (m_vNotifyTargets.LockIfNotEmpty())
     {
+        if (!m_vChangedValues.empty())
+        {
+            // a property may have changed several times during the update. only report it once per item.
+            std::vector<ChangedValue> vChangedValues;
+            vChangedValues.swap(m_vChangedValues);
+
+            std::sort(vChangedValues.begin(), vChangedValues.end(), [](const ChangedValue& left, const ChangedValue& right) noexcept {
+                if (left.nIndex != right.nIndex)
+                    return left.nIndex < right.nIndex;
+
+                return left.pProperty->GetKey() < right.pProperty->GetKey();
+            });
+
+            vChangedValues.erase(std::unique(vChangedValues.begin(), vChangedValues.end(), [](const ChangedValue& left, const ChangedValue& right) noexcept {
+                return left.nIndex == right.nIndex && left.pProperty->GetKey() == right.pProperty->GetKey();
+            }), vChangedValues.end());
+
+            for (auto& target : m_vNotifyTargets.Targets())
+            {
+                if (target.BatchesValueChanges())
+                    target.OnViewModelValuesChanged(vChangedValues);
+            }
+        }
+
         for (auto& target : m_vNotifyTargets.Targets())
             target.OnEndViewModelCollectionUpdate();
 
@@ -68,6 +127,27 @@ void ViewModelCollectionBase::OnEndUpdate()
 
 void ViewModelCollectionBase::OnItemsRemoved(const std::vector<gsl::index>& vDeletedIndices)
 {
+    if (!m_vChangedValues.empty())
+    {
+        // changes are recorded using the indices from before the update. discard any changes for the removed
+        // items and shift the remaining changes to account for the removed items.
+        std::vector<gsl::index> vSortedIndices(vDeletedIndices);
+        std::sort(vSortedIndices.begin(), vSortedIndices.end());
+
+        for (auto& pChangedValue : m_vChangedValues)
+        {
+            const auto pIter = std::lower_bound(vSortedIndices.begin(), vSortedIndices.end(), pChangedValue.nIndex);
+            if (pIter != vSortedIndices.end() && *pIter == pChangedValue.nIndex)
+                pChangedValue.nIndex = -1;
+            else
+                pChangedValue.nIndex -= gsl::narrow_cast<gsl::index>(pIter - vSortedIndices.begin());
+        }
+
+        m_vChangedValues.erase(std::remove_if(m_vChangedValues.begin(), m_vChangedValues.end(), [](const ChangedValue& pChangedValue) noexcept {
+            return pChangedValue.nIndex == -1;
+        }), m_vChangedValues.end());
+    }
+
     if (m_vNotifyTargets.LockIfNotEmpty())
     {
         for (auto& target : m_vNotifyTargets.Targets())
@@ -82,6 +162,26 @@ void ViewModelCollectionBase::OnItemsRemoved(const std::vector<gsl::index>& vDel
 
 void ViewModelCollectionBase::OnItemsAdded(const std::vector<gsl::index>& vNewIndices)
 {
+    if (!m_vChangedValues.empty())
+    {
+        // new indices are in ascending order. each item is pushed down by every new item inserted at or before it.
+        std::sort(m_vChangedValues.begin(), m_vChangedValues.end(), [](const ChangedValue& left, const ChangedValue& right) noexcept {
+            return left.nIndex < right.nIndex;
+        });
+
+        gsl::index nInserted = 0;
+        for (auto& pChangedValue : m_vChangedValues)
+        {
+            while (nInserted < ra::to_signed(vNewIndices.size()) &&
+                   vNewIndices.at(nInserted) <= pChangedValue.nIndex + nInserted)
+            {
+                ++nInserted;
+            }
+
+            pChangedValue.nIndex += nInserted;
+        }
+    }
+
     if (m_vNotifyTargets.LockIfNotEmpty())
     {
         for (auto& target : m_vNotifyTargets.Targets())
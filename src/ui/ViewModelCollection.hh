@@ -13,6 +13,15 @@ namespace ui {
 class ViewModelCollectionBase : public ra::data::ModelCollectionBase
 {
 public:
+    /// <summary>
+    /// Identifies a property of an item that changed while the collection was being updated.
+    /// </summary>
+    struct ChangedValue
+    {
+        gsl::index nIndex;
+        const ra::data::ModelPropertyBase* pProperty;
+    };
+
     class NotifyTarget
     {
     public:
@@ -47,6 +56,20 @@ public:
 
         virtual void OnBeginViewModelCollectionUpdate() noexcept(false) {}
         virtual void OnEndViewModelCollectionUpdate() noexcept(false) {}
+
+        /// <summary>
+        /// Determines whether value changes raised while the collection is being updated should be collected
+        /// and delivered to <see cref="OnViewModelValuesChanged" /> when the update ends instead of being
+        /// delivered to the individual OnViewModelXValueChanged methods as they occur.
+        /// </summary>
+        virtual bool BatchesValueChanges() const noexcept { return false; }
+
+        /// <summary>
+        /// Called before <see cref="OnEndViewModelCollectionUpdate" /> with the distinct item properties that
+        /// changed during the update, ordered by item index. Indices have already been adjusted for any items
+        /// that were added or removed during the update.
+        /// </summary>
+        virtual void OnViewModelValuesChanged([[maybe_unused]] const std::vector<ChangedValue>& vChangedValues) noexcept(false) {}
     };
 
     void AddNotifyTarget(NotifyTarget& pTarget) noexcept
@@ -104,7 +127,12 @@ protected:
     void OnItemsChanged(const std::vector<gsl::index>& vChangedIndices) override;
 
 private:
+    bool IsBatchingValueChanges(const NotifyTarget& pTarget) const noexcept;
+
     ra::data::NotifyTargetSet<NotifyTarget> m_vNotifyTargets;
+
+    // values changed while the collection is updating that still need to be delivered to batching targets
+    std::vector<ChangedValue> m_vChangedValues;
 };
 
 template<class T>
@@ -9,7 +9,9 @@
 #include "data/context/GameContext.hh"
 
 #include "services/IConfiguration.hh"
+#include "services/IFileSystem.hh"
 #include "services/ILoginService.hh"
+#include "services/PerformanceCounter.hh"
 #include "services/ServiceLocator.hh"
 
 #include "ui/IDesktop.hh"
@@ -89,6 +91,14 @@ void IntegrationMenuViewModel::AddCommonMenuItems(LookupItemViewModelCollection&
     vmMenu.Add(0, L"-----");
     vmMenu.Add(IDM_RA_FILES_POINTERFINDER, L"Pointer &Finder");
     vmMenu.Add(IDM_RA_FILES_POINTERINSPECTOR, L"Pointer &Inspector");
+
+    // the profiler is a developer tool. only offer it if it was opted into through the configuration file.
+    if (pConfiguration.IsFeatureEnabled(ra::services::Feature::PerformanceProfiler))
+    {
+        const auto& pPerformanceCounter = ra::services::ServiceLocator::Get<ra::services::PerformanceCounter>();
+        vmMenu.Add(0, L"-----");
+        vmMenu.Add(IDM_RA_TOGGLEPROFILER, L"Record Performance &Trace").SetSelected(pPerformanceCounter.IsEnabled());
+    }
 }
 
 void IntegrationMenuViewModel::ActivateMenuItem(int nMenuItemId)
@@ -123,6 +133,10 @@ void IntegrationMenuViewModel::ActivateMenuItem(int nMenuItemId)
             ToggleLeaderboards();
             break;
 
+        case IDM_RA_TOGGLEPROFILER:
+            ToggleProfiler();
+            break;
+
         case IDM_RA_OVERLAYSETTINGS:
             ShowOverlaySettings();
             break;
@@ -273,6 +287,30 @@ void IntegrationMenuViewModel::ToggleLeaderboards()
 
 }
 
+void IntegrationMenuViewModel::ToggleProfiler()
+{
+    auto& pPerformanceCounter = ra::services::ServiceLocator::GetMutable<ra::services::PerformanceCounter>();
+    if (pPerformanceCounter.IsEnabled())
+    {
+        // stopping the recording writes what was captured so it can be examined without closing the emulator
+        pPerformanceCounter.SetEnabled(false);
+
+        const auto& pFileSystem = ra::services::ServiceLocator::Get<ra::services::IFileSystem>();
+        const auto sFilePath = pFileSystem.BaseDirectory() + L"RACache\\Profile.json";
+        if (pPerformanceCounter.ExportChromeTrace(sFilePath))
+            ra::ui::viewmodels::MessageBoxViewModel::ShowInfoMessage(L"Performance trace written to " + sFilePath);
+        else
+            ra::ui::viewmodels::MessageBoxViewModel::ShowWarningMessage(L"Could not write " + sFilePath);
+    }
+    else
+    {
+        pPerformanceCounter.SetEnabled(true);
+    }
+
+    const auto& pEmulatorContext = ra::services::ServiceLocator::Get<ra::data::context::EmulatorContext>();
+    pEmulatorContext.UpdateMenuState(IDM_RA_TOGGLEPROFILER);
+}
+
 void IntegrationMenuViewModel::ShowOverlaySettings()
 {
     ra::ui::viewmodels::OverlaySettingsViewModel vmSettings;
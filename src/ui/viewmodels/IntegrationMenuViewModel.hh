@@ -28,6 +28,7 @@ private:
     static void ToggleHardcoreMode();
     static void ToggleNonHardcoreWarning();
     static void ToggleLeaderboards();
+    static void ToggleProfiler();
     static void ShowOverlaySettings();
     static void ShowAssetList();
     static void ShowAssetEditor();
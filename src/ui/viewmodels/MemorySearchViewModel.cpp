@@ -4,7 +4,6 @@
 
 #include "data\context\EmulatorContext.hh"
 
-#include "services\IClock.hh"
 #include "services\IFileSystem.hh"
 #include "services\IThreadPool.hh"
 #include "services\ServiceLocator.hh"
@@ -470,6 +469,9 @@ void MemorySearchViewModel::ClearResults()
     if (m_bIsContinuousFiltering)
         ToggleContinuousFilter();
 
+    // the continuous filter may have resumed tracking on the memory thread after it was stopped
+    StopTrackingDirtyPages();
+
     {
         std::lock_guard lock(m_oMutex);
 
@@ -504,6 +506,9 @@ void MemorySearchViewModel::BeginNewSearch()
 
 void MemorySearchViewModel::BeginNewSearch(ra::data::ByteAddress nStart, ra::data::ByteAddress nEnd)
 {
+    // the pages tracked for the previous results have nothing to do with the new search
+    StopTrackingDirtyPages();
+
     auto nSearchType = GetSearchType();
     bool bIsAligned = false;
     if (IsAligned())
@@ -562,6 +567,12 @@ void MemorySearchViewModel::AddNewPage(std::unique_ptr<SearchResult>&& pNewPage)
     {
         ++m_nSelectedSearchResult;
     }
+
+    // older pages are only accessed if the user navigates back to them. compress their captured memory
+    // to reduce the footprint of the history. the initial page is left alone as it's used for InitialValue
+    // comparisons.
+    if (m_nSelectedSearchResult > 2)
+        m_vSearchResults.at(m_nSelectedSearchResult - 2)->pResults.CompressMemory();
 }
 
 void MemorySearchViewModel::ApplyFilter()
@@ -581,7 +592,7 @@ void MemorySearchViewModel::DoApplyFilter()
     std::unique_ptr<SearchResult> pResult;
     pResult.reset(new SearchResult());
 
-    if (!ApplyFilter(*pResult, pPreviousResult, GetComparisonType(), GetValueType(), *sValue))
+    if (!ApplyFilter(pResult->pResults, pPreviousResult.pResults, GetComparisonType(), GetValueType(), *sValue))
     {
         ra::ui::viewmodels::MessageBoxViewModel::ShowErrorMessage(L"Invalid filter value");
         return;
@@ -640,18 +651,18 @@ void MemorySearchViewModel::DoApplyFilter()
     DispatchMemoryRead([this]() { ChangePage(m_nSelectedSearchResult); });
 }
 
-bool MemorySearchViewModel::ApplyFilter(SearchResult& pResult, const SearchResult& pPreviousResult,
+bool MemorySearchViewModel::ApplyFilter(ra::services::SearchResults& pResults, const ra::services::SearchResults& pPreviousResults,
     ComparisonType nComparisonType, ra::services::SearchFilterType nValueType, const std::wstring& sValue)
 {
     if (nValueType == ra::services::SearchFilterType::InitialValue)
     {
         SearchResult const& pInitialResult = *m_vSearchResults.front().get();
-        return pResult.pResults.Initialize(pInitialResult.pResults, pPreviousResult.pResults,
+        return pResults.Initialize(pInitialResult.pResults, pPreviousResults,
             nComparisonType, nValueType, sValue);
     }
     else
     {
-        return pResult.pResults.Initialize(pPreviousResult.pResults, nComparisonType, nValueType, sValue);
+        return pResults.Initialize(pPreviousResults, nComparisonType, nValueType, sValue);
     }
 }
 
@@ -662,6 +673,8 @@ void MemorySearchViewModel::ToggleContinuousFilter()
         m_bIsContinuousFiltering = false;
         SetValue(CanFilterProperty, GetResultCount() > 0);
         SetValue(ContinuousFilterLabelProperty, ContinuousFilterLabelProperty.GetDefaultValue());
+
+        StopTrackingDirtyPages();
     }
     else
     {
@@ -670,7 +683,6 @@ void MemorySearchViewModel::ToggleContinuousFilter()
             ApplyFilter();
 
             m_bIsContinuousFiltering = true;
-            m_tLastContinuousFilter = ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime();
 
             SetValue(CanFilterProperty, false);
             SetValue(ContinuousFilterLabelProperty, L"Stop Filtering");
@@ -678,49 +690,49 @@ void MemorySearchViewModel::ToggleContinuousFilter()
     }
 }
 
+void MemorySearchViewModel::StopTrackingDirtyPages()
+{
+    if (m_bTrackingDirtyPages)
+    {
+        m_bTrackingDirtyPages = false;
+        ra::services::ServiceLocator::GetMutable<ra::context::IEmulatorMemoryContext>().StopTrackingDirtyPages();
+    }
+}
+
 void MemorySearchViewModel::ApplyContinuousFilter()
 {
     const SearchResult& pResult = *m_vSearchResults.back().get();
+    auto& pMemoryContext = ra::services::ServiceLocator::GetMutable<ra::context::IEmulatorMemoryContext>();
 
-    // if there are more than 1000 results, don't filter every frame.
-    const auto nResults = pResult.pResults.MatchingAddressCount();
-    if (nResults > 1000)
+    // apply the current filter. once the memory referenced by the results is being monitored, only the
+    // portions of the results where memory has changed since the last frame have to be re-evaluated.
+    std::unique_ptr<SearchResult> pNewResult;
+    pNewResult.reset(new SearchResult());
+    if (m_bTrackingDirtyPages)
     {
-        const auto tNow = ra::services::ServiceLocator::Get<ra::services::IClock>().UpTime();
-
-        auto nElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(tNow - m_tLastContinuousFilterCheck);
-        m_tLastContinuousFilterCheck = tNow;
-
-        auto nElapsedMilliseconds = gsl::narrow_cast<size_t>(nElapsed.count());
-        if (nElapsedMilliseconds >= 200)
-        {
-            // if at least 200ms have passed since the last check, assume the user is
-            // frame-stepping and just allow the continuous filter to be applied.
-        }
-        else
-        {
-            // formula is "number of results / 100" ms between filterings. i.e.:
-            // * for 10000 results, only filter every 100ms
-            // * for 50000 results, only filter every 500ms
-            // * for 100000 results, only filter every second
-            // up to a max of one filter every ten seconds at 1000000 or more results
-            nElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(tNow - m_tLastContinuousFilter);
-            nElapsedMilliseconds = gsl::narrow_cast<size_t>(nElapsed.count());
-            if (nElapsedMilliseconds < 10000 && nElapsedMilliseconds < nResults / 100)
-                return;
-        }
+        pMemoryContext.UpdateDirtyPages();
 
-        m_tLastContinuousFilter = tNow;
+        pNewResult->pResults.InitializeFromModifiedMemory(pResult.pResults,
+            [&pMemoryContext](ra::data::ByteAddress nAddress, uint32_t nBytes) {
+                return pMemoryContext.IsMemoryModified(nAddress, nBytes);
+            },
+            [this](ra::services::SearchResults& pResults, const ra::services::SearchResults& pPreviousResults) {
+                return ApplyFilter(pResults, pPreviousResults, pPreviousResults.GetFilterComparison(),
+                    pPreviousResults.GetFilterType(), pPreviousResults.GetFilterString());
+            });
+    }
+    else
+    {
+        ApplyFilter(pNewResult->pResults, pResult.pResults, pResult.pResults.GetFilterComparison(),
+            pResult.pResults.GetFilterType(), pResult.pResults.GetFilterString());
     }
-
-    // apply the current filter
-    std::unique_ptr<SearchResult> pNewResult;
-    pNewResult.reset(new SearchResult());
-    ApplyFilter(*pNewResult, pResult, pResult.pResults.GetFilterComparison(),
-        pResult.pResults.GetFilterType(), pResult.pResults.GetFilterString());
     pNewResult->sSummary = pResult.sSummary;
     const auto nNewResults = pNewResult->pResults.MatchingAddressCount();
 
+    // only monitor the memory still referenced by the results
+    pMemoryContext.TrackDirtyPages(pNewResult->pResults.GetCapturedMemoryRanges());
+    m_bTrackingDirtyPages = true;
+
     // replace the last item with the new results
     {
         std::lock_guard lock(m_oMutex);
@@ -743,7 +755,27 @@ void MemorySearchViewModel::ChangePage(size_t nNewPage)
     //       by using DispatchMemoryRead().
     {
         std::lock_guard lock(m_oMutex);
+        const auto nOldPage = m_nSelectedSearchResult;
         m_nSelectedSearchResult = nNewPage;
+
+        // the selected page and the page it was filtered from are read every time the results are updated.
+        // restore their memory if it was compressed by AddNewPage, and compress the pages that were being
+        // used. the last two pages and the initial page are never compressed.
+        const auto IsCompressible = [this](size_t nPage) noexcept {
+            return (nPage > 0 && nPage < m_vSearchResults.size() && m_vSearchResults.size() - nPage > 2);
+        };
+
+        for (const auto nPage : { nOldPage, nOldPage - 1 })
+        {
+            if (IsCompressible(nPage) && nPage != nNewPage && nPage + 1 != nNewPage)
+                m_vSearchResults.at(nPage)->pResults.CompressMemory();
+        }
+
+        for (const auto nPage : { nNewPage, nNewPage - 1 })
+        {
+            if (IsCompressible(nPage))
+                m_vSearchResults.at(nPage)->pResults.DecompressMemory();
+        }
     }
     SetValue(SelectedPageProperty, ra::util::String::Printf(L"%u/%u", m_nSelectedSearchResult, m_vSearchResults.size() - 1));
 
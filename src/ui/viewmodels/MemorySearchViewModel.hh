@@ -518,6 +518,7 @@ private:
 
     void BeginNewSearch(ra::data::ByteAddress nStart, ra::data::ByteAddress nEnd);
     void ApplyContinuousFilter();
+    void StopTrackingDirtyPages();
     void UpdateResults();
     void DoApplyFilter();
     void UpdateResult(SearchResultViewModel& pRow, const ra::services::SearchResults& pResults,
@@ -534,8 +535,7 @@ private:
 
     ViewModelCollection<SearchResultViewModel> m_vResults;
     bool m_bIsContinuousFiltering = false;
-    std::chrono::steady_clock::time_point m_tLastContinuousFilter;
-    std::chrono::steady_clock::time_point m_tLastContinuousFilterCheck;
+    bool m_bTrackingDirtyPages = false;
     bool m_bScrolling = false;
     bool m_bSelectingFilter = false;
 
@@ -559,7 +559,7 @@ private:
     std::vector<std::unique_ptr<SearchResult>> m_vSearchResults;
     std::set<unsigned int> m_vSelectedAddresses;
 
-    bool ApplyFilter(SearchResult& pResult, const SearchResult& pPreviousResult,
+    bool ApplyFilter(ra::services::SearchResults& pResults, const ra::services::SearchResults& pPreviousResults,
         ComparisonType nComparisonType, ra::services::SearchFilterType nValueType, const std::wstring& sValue);
 };
 
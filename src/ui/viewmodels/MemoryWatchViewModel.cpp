@@ -228,7 +228,8 @@ uint32_t MemoryWatchViewModel::ReadValue()
     if (m_pValue)
     {
         rc_typed_value_t value;
-        rc_evaluate_value_typed(m_pValue, &value, rc_peek_callback, nullptr);
+        auto* pPeekData = ra::services::AchievementRuntime::GetPeekCallbackData();
+        rc_evaluate_value_typed(m_pValue, &value, rc_peek_callback, pPeekData);
 
         if (IsIndirectAddress())
             UpdateCurrentAddressFromIndirectAddress();
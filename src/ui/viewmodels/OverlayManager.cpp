@@ -5,6 +5,7 @@
 #include "services\IClock.hh"
 #include "services\IConfiguration.hh"
 #include "services\IThreadPool.hh"
+#include "services\PerformanceCounter.hh"
 #include "services\ServiceLocator.hh"
 
 #include "ui\IDesktop.hh"
@@ -129,6 +130,8 @@ void OverlayManager::RequestRender()
 
 void OverlayManager::Render(ra::ui::drawing::ISurface& pSurface, bool bRedrawAll)
 {
+    PERFORMANCE_SCOPE(PerformanceCheckpoint::OverlayRender);
+
     m_bRenderRequestPending = false;
     m_bRedrawAll = bRedrawAll;
 
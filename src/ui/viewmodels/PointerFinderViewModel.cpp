@@ -6,7 +6,10 @@
 #include "data/context/EmulatorContext.hh"
 #include "data/context/GameContext.hh"
 
+#include "context/IConsoleContext.hh"
+
 #include "services/IFileSystem.hh"
+#include "services/PointerScanner.hh"
 #include "services/ServiceLocator.hh"
 
 #include "ui/viewmodels/FileDialogViewModel.hh"
@@ -19,6 +22,8 @@ namespace viewmodels {
 
 const StringModelProperty PointerFinderViewModel::ResultCountTextProperty("PointerFinderViewModel", "ResultCountText", L"0");
 const IntModelProperty PointerFinderViewModel::SearchTypeProperty("PointerFinderViewModel", "SearchType", ra::etoi(ra::services::SearchType::ThirtyTwoBitAligned));
+const IntModelProperty PointerFinderViewModel::MaxOffsetProperty("PointerFinderViewModel", "MaxOffset", 0x1000);
+const IntModelProperty PointerFinderViewModel::PointerDepthProperty("PointerFinderViewModel", "PointerDepth", 1);
 
 const StringModelProperty PointerFinderViewModel::StateViewModel::AddressProperty("StateViewModel", "Address", L"");
 const StringModelProperty PointerFinderViewModel::StateViewModel::CaptureButtonTextProperty("StateViewModel", "CaptureButtonText", L"Capture");
@@ -126,6 +131,14 @@ PointerFinderViewModel::PointerFinderViewModel()
     m_vSearchTypes.Add(ra::etoi(ra::services::SearchType::SixteenBitBigEndianAligned), L"16-bit BE (aligned)");
     m_vSearchTypes.Add(ra::etoi(ra::services::SearchType::ThirtyTwoBitBigEndianAligned), L"32-bit BE (aligned)");
 
+    m_vMaxOffsets.Add(0, L"Any offset");
+    m_vMaxOffsets.Add(0x100, L"+/- 0x100");
+    m_vMaxOffsets.Add(0x1000, L"+/- 0x1000");
+    m_vMaxOffsets.Add(0x10000, L"+/- 0x10000");
+
+    m_vPointerDepths.Add(1, L"Direct");
+    m_vPointerDepths.Add(2, L"Pointer to pointer");
+
     for (auto& pState : m_vStates)
         pState.SetOwner(this);
 }
@@ -161,123 +174,87 @@ static std::wstring FormatValue(const ra::services::SearchResults& srResults, ra
     return sValue;
 }
 
-void PointerFinderViewModel::Find()
+static std::wstring FormatOffset(uint32_t nOffset)
 {
-    bool bPerformedSearch = false;
+    // negative offsets are stored as two's complement. display them with a sign instead of as large values.
+    if (ra::to_signed(nOffset) < 0)
+        return ra::util::String::Printf(L"-0x%02X", 0U - nOffset);
+
+    return ra::util::String::Printf(L"+0x%02X", nOffset);
+}
 
+void PointerFinderViewModel::Find()
+{
     // TODO: capture/restore selected address
 
+    std::vector<ra::services::PointerScanner::State> vStates;
+    std::vector<gsl::index> vStateIndices;
+    bool bUniqueAddresses = false;
+    for (gsl::index nIndex = 0; nIndex < gsl::narrow_cast<gsl::index>(m_vStates.size()); nIndex++)
+    {
+        const auto& pState = m_vStates.at(nIndex);
+        if (pState.CanCapture())
+            continue;
+
+        const auto nAddress = pState.Viewer().GetAddress();
+        if (!vStates.empty() && vStates.front().nTargetAddress != nAddress)
+            bUniqueAddresses = true;
+
+        vStates.push_back({ pState.CapturedMemory(), nAddress });
+        vStateIndices.push_back(nIndex);
+    }
+
     m_vResults.BeginUpdate();
     m_vResults.Clear();
 
-    const auto& pMemoryContext = ra::services::ServiceLocator::Get<ra::context::IEmulatorMemoryContext>();
-    for (size_t i = 0; i < m_vStates.size(); i++)
+    if (bUniqueAddresses)
     {
-        const auto& pStateI = m_vStates.at(i);
-        if (pStateI.CanCapture())
-            continue;
+        ra::services::PointerScanner pScanner;
+        pScanner.SetSearchType(GetSearchType());
+        pScanner.SetMaxOffset(GetMaxOffset());
+        pScanner.SetMaxDepth(GetPointerDepth());
 
-        for (size_t j = i + 1; j < m_vStates.size(); j++)
+        // pointers on some systems hold real addresses. allow offsets relative to the start of each region.
+        if (ra::services::ServiceLocator::Exists<ra::context::IConsoleContext>())
         {
-            const auto& pStateJ = m_vStates.at(j);
-            if (pStateJ.CanCapture())
-                continue;
-
-            const auto nAddressI = pStateI.Viewer().GetAddress();
-            const auto nAddressJ = pStateJ.Viewer().GetAddress();
-            if (nAddressI == nAddressJ)
-                continue;
-
-            // flag all items as having not been seen - anything that's still not seen after merging will be discarded
-            for (auto& pResult : m_vResults)
-                pResult.m_bMatched = false;
-
-            // compare the two memory states
-            ra::services::SearchResults pResults;
-            auto pReadMemory = [srSecond = pStateJ.CapturedMemory()](ra::data::ByteAddress nAddress, uint8_t* pBuffer, size_t nBufferSize) noexcept {
-                srSecond->GetBytes(nAddress, pBuffer, nBufferSize);
-            };
-            if (nAddressI > nAddressJ)
-                pResults.Initialize(*pStateI.CapturedMemory(), pReadMemory, ComparisonType::Equals, ra::services::SearchFilterType::LastKnownValueMinus, std::to_wstring(nAddressI - nAddressJ));
-            else
-                pResults.Initialize(*pStateI.CapturedMemory(), pReadMemory, ComparisonType::Equals, ra::services::SearchFilterType::LastKnownValuePlus, std::to_wstring(nAddressJ - nAddressI));
+            const auto& pConsoleContext = ra::services::ServiceLocator::Get<ra::context::IConsoleContext>();
+            for (const auto& pRegion : pConsoleContext.MemoryRegions())
+                pScanner.AddPointerBias(pRegion.GetStartAddress() - pRegion.GetRealStartAddress());
+        }
 
-            // merge the new potential items into the list
-            gsl::index nResultIndex = 0;
-            for (gsl::index nIndex = 0; nIndex < gsl::narrow_cast<gsl::index>(pResults.MatchingAddressCount()); nIndex++)
-            {
-                ra::services::SearchResult pResult;
-                if (pResults.GetMatchingAddress(nIndex, pResult))
-                {
-                    PotentialPointerViewModel* pPointer = nullptr;
-                    while (nResultIndex < gsl::narrow_cast<gsl::index>(m_vResults.Count()))
-                    {
-                        PotentialPointerViewModel* pItem = m_vResults.GetItemAt(nResultIndex);
-                        if (pItem->m_nAddress > pResult.nAddress)
-                            break;
-
-                        if (pItem->m_nAddress == pResult.nAddress)
-                        {
-                            pPointer = pItem;
-                            nResultIndex++;
-                            break;
-                        }
-
-                        nResultIndex++;
-                    }
-
-                    if (pPointer == nullptr)
-                    {
-                        if (bPerformedSearch) // new address not in set, ignore
-                            continue;
-
-                        pPointer = &m_vResults.Add();
-                        pPointer->m_nAddress = pResult.nAddress;
-                        pPointer->SetPointerAddress(pMemoryContext.FormatAddress(pResult.nAddress));
-                        const auto nOffset = (nAddressJ - pResult.nValue);
-                        pPointer->SetOffset(ra::util::String::Printf(L"+0x%02X", nOffset));
-
-                        pPointer->SetPointerValue(i, FormatValue(*pStateI.CapturedMemory(), pResult.nAddress));
-                    }
-                    else if (pPointer->GetPointerValue(i).empty())
-                    {
-                        pPointer->SetPointerValue(i, FormatValue(*pStateI.CapturedMemory(), pResult.nAddress));
-                    }
-
-                    pPointer->SetPointerValue(j, FormatValue(*pStateJ.CapturedMemory(), pResult.nAddress));
-                    pPointer->m_bMatched = true;
-                }
-            }
+        const auto vPointers = pScanner.Find(vStates);
+        const auto& pMemoryContext = ra::services::ServiceLocator::Get<ra::context::IEmulatorMemoryContext>();
+        for (const auto& pResult : vPointers)
+        {
+            auto& pPointer = m_vResults.Add();
+            pPointer.m_nAddress = pResult.nAddress;
+            pPointer.SetPointerAddress(pMemoryContext.FormatAddress(pResult.nAddress));
 
-            // remove any items that didn't also match the most recent search
-            if (bPerformedSearch)
-            {
-                for (gsl::index nIndex = m_vResults.Count() - 1; nIndex >= 0; nIndex--)
-                {
-                    if (!m_vResults.GetItemAt(nIndex)->m_bMatched)
-                        m_vResults.RemoveAt(nIndex);
-                }
-            }
+            if (pResult.vOffsets.size() == 1)
+                pPointer.SetOffset(FormatOffset(pResult.vOffsets.front()));
+            else
+                pPointer.SetOffset(FormatOffset(pResult.vOffsets.at(0)) + L" " + FormatOffset(pResult.vOffsets.at(1)));
 
-            bPerformedSearch = true;
+            for (size_t nState = 0; nState < vStates.size(); nState++)
+                pPointer.SetPointerValue(vStateIndices.at(nState), FormatValue(*vStates.at(nState).pMemory, pResult.nAddress));
         }
-    }
 
-    if (m_vResults.Count() == 0 && bPerformedSearch)
-    {
-        auto* pPointer = &m_vResults.Add();
-        pPointer->SetPointerAddress(L"No pointers found.");
-        SetValue(ResultCountTextProperty, L"0");
+        if (vPointers.empty())
+        {
+            auto& pPointer = m_vResults.Add();
+            pPointer.SetPointerAddress(L"No pointers found.");
+        }
+
+        SetValue(ResultCountTextProperty, std::to_wstring(vPointers.size()));
     }
     else
     {
-        SetValue(ResultCountTextProperty, std::to_wstring(m_vResults.Count()));
+        SetValue(ResultCountTextProperty, L"0");
     }
 
     m_vResults.EndUpdate();
 
-
-    if (!bPerformedSearch)
+    if (!bUniqueAddresses)
         ra::ui::viewmodels::MessageBoxViewModel::ShowMessage(L"Cannot find.", L"At least two unique addresses must be captured before potential pointers can be located.");
 }
 
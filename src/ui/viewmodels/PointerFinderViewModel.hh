@@ -46,6 +46,52 @@ public:
         return m_vSearchTypes;
     }
 
+    /// <summary>
+    /// The <see cref="ModelProperty" /> for the maximum distance between where a pointer points and the captured address.
+    /// </summary>
+    static const IntModelProperty MaxOffsetProperty;
+
+    /// <summary>
+    /// Gets the maximum distance between where a pointer points and the captured address. 0 allows any distance.
+    /// </summary>
+    uint32_t GetMaxOffset() const { return gsl::narrow_cast<uint32_t>(GetValue(MaxOffsetProperty)); }
+
+    /// <summary>
+    /// Sets the maximum distance between where a pointer points and the captured address. 0 allows any distance.
+    /// </summary>
+    void SetMaxOffset(uint32_t value) { SetValue(MaxOffsetProperty, gsl::narrow_cast<int>(value)); }
+
+    /// <summary>
+    /// Gets the list of selectable maximum offsets.
+    /// </summary>
+    const LookupItemViewModelCollection& MaxOffsets() const noexcept
+    {
+        return m_vMaxOffsets;
+    }
+
+    /// <summary>
+    /// The <see cref="ModelProperty" /> for the maximum number of pointers to follow to reach the captured address.
+    /// </summary>
+    static const IntModelProperty PointerDepthProperty;
+
+    /// <summary>
+    /// Gets the maximum number of pointers to follow to reach the captured address.
+    /// </summary>
+    uint32_t GetPointerDepth() const { return gsl::narrow_cast<uint32_t>(GetValue(PointerDepthProperty)); }
+
+    /// <summary>
+    /// Sets the maximum number of pointers to follow to reach the captured address.
+    /// </summary>
+    void SetPointerDepth(uint32_t value) { SetValue(PointerDepthProperty, gsl::narrow_cast<int>(value)); }
+
+    /// <summary>
+    /// Gets the list of selectable pointer depths.
+    /// </summary>
+    const LookupItemViewModelCollection& PointerDepths() const noexcept
+    {
+        return m_vPointerDepths;
+    }
+
     void DoFrame();
 
     void Find();
@@ -267,7 +313,6 @@ public:
     private:
         friend class PointerFinderViewModel;
         ra::data::ByteAddress m_nAddress = 0;
-        bool m_bMatched = false;
     };
 
     ra::ui::ViewModelCollection<PotentialPointerViewModel>& PotentialPointers() noexcept
@@ -288,6 +333,8 @@ private:
 
     ra::ui::ViewModelCollection<PotentialPointerViewModel> m_vResults;
     LookupItemViewModelCollection m_vSearchTypes;
+    LookupItemViewModelCollection m_vMaxOffsets;
+    LookupItemViewModelCollection m_vPointerDepths;
 };
 
 } // namespace viewmodels
@@ -1579,7 +1579,10 @@ void TriggerViewModel::UpdateMemrefs()
 
         auto* memrefs = rc_trigger_get_memrefs(m_pTrigger);
         if (memrefs)
-            rc_update_memref_values(memrefs, rc_peek_callback, nullptr);
+        {
+            auto* pPeekData = ra::services::AchievementRuntime::GetPeekCallbackData();
+            rc_update_memref_values(memrefs, rc_peek_callback, pPeekData);
+        }
     }
 }
 
@@ -95,6 +95,8 @@ public:
 PointerFinderDialog::PointerFinderDialog(PointerFinderViewModel& vmPointerFinder)
     : DialogBase(vmPointerFinder),
       m_bindSearchType(vmPointerFinder),
+      m_bindMaxOffset(vmPointerFinder),
+      m_bindPointerDepth(vmPointerFinder),
       m_bindResults(vmPointerFinder),
       m_bindViewer1(vmPointerFinder.States().at(0)),
       m_bindViewer2(vmPointerFinder.States().at(1)),
@@ -107,6 +109,10 @@ PointerFinderDialog::PointerFinderDialog(PointerFinderViewModel& vmPointerFinder
     m_bindWindow.BindLabel(IDC_RA_RESULT_COUNT, PointerFinderViewModel::ResultCountTextProperty);
     m_bindSearchType.BindItems(vmPointerFinder.SearchTypes());
     m_bindSearchType.BindSelectedItem(PointerFinderViewModel::SearchTypeProperty);
+    m_bindMaxOffset.BindItems(vmPointerFinder.MaxOffsets());
+    m_bindMaxOffset.BindSelectedItem(PointerFinderViewModel::MaxOffsetProperty);
+    m_bindPointerDepth.BindItems(vmPointerFinder.PointerDepths());
+    m_bindPointerDepth.BindSelectedItem(PointerFinderViewModel::PointerDepthProperty);
 
     auto pAddressColumn = std::make_unique<PointerAddressGridColumnBinding>(
         PointerFinderViewModel::PotentialPointerViewModel::PointerAddressProperty);
@@ -197,6 +203,8 @@ PointerFinderDialog::PointerFinderDialog(PointerFinderViewModel& vmPointerFinder
 BOOL PointerFinderDialog::OnInitDialog()
 {
     m_bindSearchType.SetControl(*this, IDC_RA_SEARCHTYPE);
+    m_bindMaxOffset.SetControl(*this, IDC_RA_MAX_OFFSET);
+    m_bindPointerDepth.SetControl(*this, IDC_RA_POINTER_DEPTH);
     m_bindResults.SetControl(*this, IDC_RA_RESULTS);
 
     m_bindViewer1.OnInitDialog(*this, IDC_RA_MEMVIEWER_1);
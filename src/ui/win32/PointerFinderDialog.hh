@@ -86,6 +86,8 @@ private:
     };
 
     bindings::ComboBoxBinding m_bindSearchType;
+    bindings::ComboBoxBinding m_bindMaxOffset;
+    bindings::ComboBoxBinding m_bindPointerDepth;
     bindings::GridBinding m_bindResults;
     PointerFinderStateBinding m_bindViewer1;
     PointerFinderStateBinding m_bindViewer2;
@@ -357,21 +357,9 @@ void GridBinding::OnViewModelIntValueChanged(gsl::index nIndex, const IntModelPr
         return;
     }
 
-    auto& pPropertyMapping = GetPropertyColumnMapping(args.Property.GetKey());
-    if (pPropertyMapping.nDependentColumns == 0xFFFFFFFF)
-    {
-        pPropertyMapping.nDependentColumns = 0;
-
-        for (size_t nColumnIndex = 0; nColumnIndex < m_vColumns.size(); ++nColumnIndex)
-        {
-            const auto& pColumn = *m_vColumns.at(nColumnIndex);
-            if (pColumn.DependsOn(args.Property))
-                pPropertyMapping.nDependentColumns |= 1 << nColumnIndex;
-        }
-    }
-
-    if (pPropertyMapping.nDependentColumns)
-        UpdateDependentColumns(nIndex, pPropertyMapping.nDependentColumns);
+    const auto nDependentColumns = GetDependentColumns(args.Property);
+    if (nDependentColumns)
+        UpdateDependentColumns(nIndex, nDependentColumns);
 
     if (!m_vmItems->IsUpdating())
         OnEndViewModelCollectionUpdate();
@@ -391,42 +379,101 @@ void GridBinding::OnViewModelBoolValueChanged(gsl::index nIndex, const BoolModel
         });
     }
 
-    auto& pPropertyMapping = GetPropertyColumnMapping(args.Property.GetKey());
+    const auto nDependentColumns = GetDependentColumns(args.Property);
+    if (nDependentColumns)
+        UpdateDependentColumns(nIndex, nDependentColumns);
+}
 
-    if (pPropertyMapping.nDependentColumns == 0xFFFFFFFF)
+void GridBinding::OnViewModelStringValueChanged(gsl::index nIndex, const StringModelProperty::ChangeArgs& args)
+{
+    const auto nDependentColumns = GetDependentColumns(args.Property);
+    if (nDependentColumns)
+        UpdateDependentColumns(nIndex, nDependentColumns);
+}
+
+void GridBinding::OnViewModelValuesChanged(const std::vector<ViewModelCollectionBase::ChangedValue>& vChangedValues)
+{
+    struct DirtyRow
     {
-        pPropertyMapping.nDependentColumns = 0;
+        gsl::index nIndex;
+        uint32_t nDependentColumns;
+    };
+    std::vector<DirtyRow> vDirtyRows;
+    std::vector<std::pair<gsl::index, bool>> vSelectionChanges;
+    gsl::index nFirstRecoloredRow = -1, nLastRecoloredRow = -1;
 
-        for (size_t nColumnIndex = 0; nColumnIndex < m_vColumns.size(); ++nColumnIndex)
+    // changes are ordered by index, so all of the changes for a row are adjacent. merge them into a
+    // single mask per row so each affected cell is only updated once.
+    for (const auto& pChangedValue : vChangedValues)
+    {
+        const auto& pProperty = *pChangedValue.pProperty;
+        const auto nIndex = pChangedValue.nIndex;
+
+        // when virtualizing, only the visible items have view models. ignore any that aren't mapped to an item.
+        const auto nRealIndex = GetRealItemIndex(nIndex);
+        if (nRealIndex == -1)
+            continue;
+
+        if (m_pRowColorProperty && *m_pRowColorProperty == pProperty)
         {
-            const auto& pColumn = *m_vColumns.at(nColumnIndex);
-            if (pColumn.DependsOn(args.Property))
-                pPropertyMapping.nDependentColumns |= 1 << nColumnIndex;
+            if (m_nAdjustingScrollOffset == 0)
+            {
+                if (nFirstRecoloredRow == -1 || nRealIndex < nFirstRecoloredRow)
+                    nFirstRecoloredRow = nRealIndex;
+                if (nRealIndex > nLastRecoloredRow)
+                    nLastRecoloredRow = nRealIndex;
+            }
+            continue;
         }
+
+        if (m_pIsSelectedProperty && *m_pIsSelectedProperty == pProperty)
+            vSelectionChanges.emplace_back(nRealIndex, m_vmItems->GetItemValue(nIndex, *m_pIsSelectedProperty));
+
+        const auto nDependentColumns = GetDependentColumns(pProperty);
+        if (nDependentColumns == 0)
+            continue;
+
+        if (!vDirtyRows.empty() && vDirtyRows.back().nIndex == nIndex)
+            vDirtyRows.back().nDependentColumns |= nDependentColumns;
+        else
+            vDirtyRows.push_back({nIndex, nDependentColumns});
+
+        // if the sort column is affected, it's no longer sorted
+        if (m_nSortIndex >= 0 && (nDependentColumns & (1 << m_nSortIndex)))
+            m_nSortIndex = -1;
     }
 
-    if (pPropertyMapping.nDependentColumns)
-        UpdateDependentColumns(nIndex, pPropertyMapping.nDependentColumns);
-}
+    if (nLastRecoloredRow != -1)
+        m_bForceRepaintItems = true;
 
-void GridBinding::OnViewModelStringValueChanged(gsl::index nIndex, const StringModelProperty::ChangeArgs& args)
-{
-    auto& pPropertyMapping = GetPropertyColumnMapping(args.Property.GetKey());
+    if (vDirtyRows.empty() && vSelectionChanges.empty() && nLastRecoloredRow == -1)
+        return;
 
-    if (pPropertyMapping.nDependentColumns == 0xFFFFFFFF)
-    {
-        pPropertyMapping.nDependentColumns = 0;
+    InvokeOnUIThread([this, vDirtyRows = std::move(vDirtyRows), vSelectionChanges = std::move(vSelectionChanges),
+                      nFirstRecoloredRow, nLastRecoloredRow]() {
+        for (const auto& pSelectionChange : vSelectionChanges)
+        {
+            ListView_SetItemState(m_hWnd, gsl::narrow_cast<int>(pSelectionChange.first),
+                                  pSelectionChange.second ? LVIS_SELECTED : 0, LVIS_SELECTED);
+        }
 
-        for (size_t nColumnIndex = 0; nColumnIndex < m_vColumns.size(); ++nColumnIndex)
+        for (const auto& pDirtyRow : vDirtyRows)
         {
-            const auto& pColumn = *m_vColumns.at(nColumnIndex);
-            if (pColumn.DependsOn(args.Property))
-                pPropertyMapping.nDependentColumns |= 1 << nColumnIndex;
+            auto nMask = pDirtyRow.nDependentColumns;
+            gsl::index nColumnIndex = 0;
+            do
+            {
+                if (nMask & 1)
+                    UpdateCell(pDirtyRow.nIndex, nColumnIndex);
+
+                ++nColumnIndex;
+                nMask >>= 1;
+            } while (nMask);
         }
-    }
 
-    if (pPropertyMapping.nDependentColumns)
-        UpdateDependentColumns(nIndex, pPropertyMapping.nDependentColumns);
+        if (nLastRecoloredRow != -1)
+            ListView_RedrawItems(m_hWnd, nFirstRecoloredRow, nLastRecoloredRow);
+    });
 }
 
 int GridBinding::ComparePropertyColumnMappings(const GridBinding::PropertyColumnMapping& left, int nKey) noexcept
@@ -444,6 +491,32 @@ GridBinding::PropertyColumnMapping& GridBinding::GetPropertyColumnMapping(int nP
     return GetPropertyColumnMapping(nPropertyKey);
 }
 
+uint32_t GridBinding::GetDependentColumns(const ra::data::ModelPropertyBase& pProperty)
+{
+    auto& pPropertyMapping = GetPropertyColumnMapping(pProperty.GetKey());
+    if (pPropertyMapping.nDependentColumns == 0xFFFFFFFF)
+    {
+        pPropertyMapping.nDependentColumns = 0;
+
+        const auto* pBoolProperty = dynamic_cast<const BoolModelProperty*>(&pProperty);
+        const auto* pIntProperty = dynamic_cast<const IntModelProperty*>(&pProperty);
+        const auto* pStringProperty = dynamic_cast<const StringModelProperty*>(&pProperty);
+
+        for (size_t nColumnIndex = 0; nColumnIndex < m_vColumns.size(); ++nColumnIndex)
+        {
+            const auto& pColumn = *m_vColumns.at(nColumnIndex);
+            if ((pBoolProperty && pColumn.DependsOn(*pBoolProperty)) ||
+                (pIntProperty && pColumn.DependsOn(*pIntProperty)) ||
+                (pStringProperty && pColumn.DependsOn(*pStringProperty)))
+            {
+                pPropertyMapping.nDependentColumns |= 1 << nColumnIndex;
+            }
+        }
+    }
+
+    return pPropertyMapping.nDependentColumns;
+}
+
 void GridBinding::UpdateDependentColumns(gsl::index nIndex, uint32_t nDependentColumns)
 {
     // if the sort column is affected, it's no longer sorted
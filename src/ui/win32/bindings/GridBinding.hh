@@ -108,6 +108,8 @@ protected:
     void OnViewModelChanged(gsl::index nIndex) override;
     void OnBeginViewModelCollectionUpdate() noexcept override;
     void OnEndViewModelCollectionUpdate() override;
+    bool BatchesValueChanges() const noexcept override { return true; }
+    void OnViewModelValuesChanged(const std::vector<ViewModelCollectionBase::ChangedValue>& vChangedValues) override;
 
     typedef struct PropertyColumnMapping
     {
@@ -117,6 +119,7 @@ protected:
     std::vector<PropertyColumnMapping> m_vPropertyColumns;
     static int ComparePropertyColumnMappings(const GridBinding::PropertyColumnMapping& left, int nKey) noexcept;
     PropertyColumnMapping& GetPropertyColumnMapping(int nPropertyKey);
+    uint32_t GetDependentColumns(const ra::data::ModelPropertyBase& pProperty);
     void UpdateDependentColumns(gsl::index nIndex, uint32_t nDependentColumns);
 
     std::vector<std::unique_ptr<GridColumnBinding>> m_vColumns;
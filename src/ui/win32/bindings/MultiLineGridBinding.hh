@@ -38,6 +38,9 @@ protected:
     void OnViewModelAdded(gsl::index nIndex) override;
     void OnViewModelRemoved(gsl::index nIndex) override;
 
+    // line breaks have to be recalculated as each string changes
+    bool BatchesValueChanges() const noexcept override { return false; }
+
 private:
     gsl::index GetIndexForLine(gsl::index nLine) const;
     void UpdateLineBreaks(gsl::index nIndex, gsl::index nColumn, const ra::ui::win32::bindings::GridColumnBinding* pColumn, size_t nChars);
@@ -0,0 +1,72 @@
+#ifndef RA_BENCHMARK_BENCHMARKCOMPAT_HH
+#define RA_BENCHMARK_BENCHMARKCOMPAT_HH
+#pragma once
+
+// Forced into every file by CMakeLists.txt in place of src/pch.h, which the Visual Studio project uses. Provides the
+// subset of pch.h that the search code relies on without pulling in Windows, rapidjson, or the unit test framework.
+
+#ifdef _MSC_VER
+ #include <sal.h>
+#else
+ // SAL annotations are only understood by the Microsoft compiler
+ #define _In_
+ #define _In_opt_
+ #define _In_z_
+ #define _Inout_
+ #define _Out_
+ #define _Out_opt_
+ #define _Use_decl_annotations_
+ #define _Success_(expr)
+ #define _Printf_format_string_
+ #define _Acquires_lock_(lock)
+ #define _Releases_lock_(lock)
+ #define _Requires_lock_held_(lock)
+ #define _Guarded_by_(lock)
+ #define _NODISCARD [[nodiscard]]
+ #define _FALLTHROUGH [[fallthrough]]
+ #define __fallthrough [[fallthrough]]
+
+ // Microsoft-specific CRT and compiler extensions used by the product code
+ #define swprintf_s swprintf
+ #define __FUNC__ __PRETTY_FUNCTION__
+
+ #include <ctime>
+ inline int localtime_s(std::tm* pTime, const std::time_t* pSeconds) noexcept
+ {
+     return localtime_r(pSeconds, pTime) ? 0 : 1;
+ }
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <cwchar>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#define GSL_THROW_ON_CONTRACT_VIOLATION
+#include <gsl/gsl>
+
+#include "util/Compat.hh"
+
+#endif // !RA_BENCHMARK_BENCHMARKCOMPAT_HH
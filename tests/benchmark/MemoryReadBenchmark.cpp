@@ -0,0 +1,156 @@
+#include "MemoryReadBenchmark.hh"
+
+#include <cstdio>
+#include <random>
+
+namespace ra {
+namespace benchmark {
+
+_CONSTANT_VAR MAX_BANKS = 3U;
+_CONSTANT_VAR MEMREF_COUNT = 4096U;
+_CONSTANT_VAR PEEKS_PER_ITERATION = 4U * 1024 * 1024;
+
+struct MemoryBank
+{
+    size_t nSize;
+    bool bDirect; // the emulator exposes the host memory for the bank
+};
+
+struct MemoryLayout
+{
+    const char* sName;
+    std::vector<MemoryBank> vBanks;
+};
+
+struct MemRef
+{
+    ra::data::ByteAddress nAddress;
+    uint32_t nBytes;
+};
+
+static std::array<std::vector<uint8_t>, MAX_BANKS> s_vBankMemory;
+
+template<size_t nBank>
+static uint8_t ReadBank(uint32_t nAddress)
+{
+    return s_vBankMemory.at(nBank).at(nAddress);
+}
+
+template<size_t nBank>
+static void WriteBank(uint32_t nAddress, uint8_t nValue)
+{
+    s_vBankMemory.at(nBank).at(nAddress) = nValue;
+}
+
+static constexpr std::array<ra::context::impl::EmulatorMemoryContext::MemoryReadFunction*, MAX_BANKS> s_vReaders = {
+    ReadBank<0>, ReadBank<1>, ReadBank<2>
+};
+
+static constexpr std::array<ra::context::impl::EmulatorMemoryContext::MemoryWriteFunction*, MAX_BANKS> s_vWriters = {
+    WriteBank<0>, WriteBank<1>, WriteBank<2>
+};
+
+static void LoadLayout(ra::context::impl::EmulatorMemoryContext& pMemoryContext, const MemoryLayout& pLayout,
+                       std::mt19937& pRandom)
+{
+    pMemoryContext.ClearMemoryBlocks();
+
+    gsl::index nIndex = 0;
+    for (const auto& pBank : pLayout.vBanks)
+    {
+        auto& vMemory = s_vBankMemory.at(nIndex);
+        vMemory.resize(pBank.nSize);
+        for (auto& nByte : vMemory)
+            nByte = gsl::narrow_cast<uint8_t>(pRandom());
+
+        pMemoryContext.AddMemoryBlock(nIndex, pBank.nSize, s_vReaders.at(nIndex), s_vWriters.at(nIndex));
+        if (pBank.bDirect)
+            pMemoryContext.AddMemoryBlockPointer(nIndex, vMemory.data());
+
+        ++nIndex;
+    }
+}
+
+static std::vector<MemRef> GenerateMemRefs(size_t nTotalMemorySize, std::mt19937& pRandom)
+{
+    // most memrefs in a typical set are 8-bit. the rest are split between 16-bit and 32-bit.
+    std::vector<MemRef> vMemRefs;
+    vMemRefs.reserve(MEMREF_COUNT);
+    for (size_t i = 0; i < MEMREF_COUNT; ++i)
+    {
+        const auto nSelector = pRandom() % 4;
+        const uint32_t nBytes = (nSelector < 2) ? 1 : (nSelector == 2) ? 2 : 4;
+        const auto nAddress = gsl::narrow_cast<ra::data::ByteAddress>(pRandom() % (nTotalMemorySize - 3));
+        vMemRefs.push_back({ nAddress, nBytes });
+    }
+
+    return vMemRefs;
+}
+
+static double TimePeeks(ra::context::impl::EmulatorMemoryContext& pMemoryContext, const std::vector<MemRef>& vMemRefs,
+                        unsigned int nIterations, bool bCacheReads, uint32_t& nChecksum)
+{
+    // each pass over the memrefs simulates a frame
+    const auto nFrames = PEEKS_PER_ITERATION / vMemRefs.size();
+
+    double dBestTime = 0.0;
+    for (unsigned int nIteration = 0; nIteration < nIterations; ++nIteration)
+    {
+        const auto tStart = std::chrono::steady_clock::now();
+        for (size_t nFrame = 0; nFrame < nFrames; ++nFrame)
+        {
+            if (bCacheReads)
+                pMemoryContext.BeginCachingReads();
+
+            // rc_peek_callback (which isn't part of the benchmark) forwards to PeekMemory when it's given the context
+            for (const auto& pMemRef : vMemRefs)
+                nChecksum += pMemoryContext.PeekMemory(pMemRef.nAddress, pMemRef.nBytes);
+
+            if (bCacheReads)
+                pMemoryContext.EndCachingReads();
+        }
+
+        const auto dTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+        if (nIteration == 0 || dTime < dBestTime)
+            dBestTime = dTime;
+    }
+
+    return (dBestTime > 0.0) ? gsl::narrow_cast<double>(nFrames * vMemRefs.size()) / dBestTime : 0.0;
+}
+
+void RunMemoryReadBenchmarks(ra::context::impl::EmulatorMemoryContext& pMemoryContext, unsigned int nIterations,
+                             unsigned int nSeed)
+{
+    const std::vector<MemoryLayout> vLayouts = {
+        { "PS1 (RAM, scratchpad)", { { 0x200000, true }, { 0x400, true } } },
+        { "N64 (RDRAM)", { { 0x800000, true } } },
+        { "GBA (IWRAM, EWRAM, SRAM)", { { 0x8000, true }, { 0x40000, true }, { 0x10000, false } } },
+        { "SNES (WRAM, cartridge RAM)", { { 0x20000, false }, { 0x80000, false } } },
+    };
+
+    std::mt19937 pRandom(nSeed);
+    uint32_t nChecksum = 0;
+
+    printf("%u memrefs\n\n", MEMREF_COUNT);
+    printf("%-28s %6s %14s %14s\n", "layout", "banks", "peeks/s", "cached peeks/s");
+
+    for (const auto& pLayout : vLayouts)
+    {
+        LoadLayout(pMemoryContext, pLayout, pRandom);
+        const auto vMemRefs = GenerateMemRefs(pMemoryContext.TotalMemorySize(), pRandom);
+
+        const auto dPeeksPerSecond = TimePeeks(pMemoryContext, vMemRefs, nIterations, false, nChecksum);
+        const auto dCachedPeeksPerSecond = TimePeeks(pMemoryContext, vMemRefs, nIterations, true, nChecksum);
+
+        printf("%-28s %6zu %14.0f %14.0f\n", pLayout.sName, pLayout.vBanks.size(), dPeeksPerSecond,
+               dCachedPeeksPerSecond);
+    }
+
+    // prevents the reads from being optimized away
+    printf("\nchecksum: %08x\n", nChecksum);
+
+    pMemoryContext.ClearMemoryBlocks();
+}
+
+} // namespace benchmark
+} // namespace ra
@@ -0,0 +1,20 @@
+#ifndef RA_BENCHMARK_MEMORYREADBENCHMARK_HH
+#define RA_BENCHMARK_MEMORYREADBENCHMARK_HH
+#pragma once
+
+#include "context\impl\EmulatorMemoryContext.hh"
+
+namespace ra {
+namespace benchmark {
+
+/// <summary>
+/// Measures how many memory reads per second can be made through the path rcheevos uses to read memrefs
+/// for several common memory layouts.
+/// </summary>
+void RunMemoryReadBenchmarks(ra::context::impl::EmulatorMemoryContext& pMemoryContext, unsigned int nIterations,
+                             unsigned int nSeed);
+
+} // namespace benchmark
+} // namespace ra
+
+#endif // !RA_BENCHMARK_MEMORYREADBENCHMARK_HH
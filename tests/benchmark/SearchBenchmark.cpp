@@ -0,0 +1,466 @@
+// Measures the throughput of SearchResults against a memory dump or synthesized memory. Runs without any of the
+// UI or emulator integration so it can be used to compare builds before release.
+//
+// usage: RA_Integration.Benchmark [options]
+//   --mode <name>       "search" to benchmark memory searches, "peek" to benchmark the memory reads made while
+//                       processing achievements, "pool" to benchmark the background thread pool (default: search).
+//                       only --iterations and --seed apply to peek. only --iterations and --threads apply to pool.
+//   --dump <file>       raw memory dump to search (default: synthesize memory)
+//   --size <bytes>      size of synthesized memory (default: 2MB)
+//   --entropy <0-100>   percentage of synthesized bytes that are random. the rest are small values, which is
+//                       typical of emulated RAM. (default: 25)
+//   --changes <0-100>   percentage of bytes modified between capturing and filtering (default: 1)
+//   --seed <n>          random seed for synthesized memory and changes (default: 1)
+//   --iterations <n>    number of times each filter is timed. the fastest is reported. (default: 3)
+//   --threads <n>       number of background threads available to the search (default: hardware threads)
+//   --type <name>       only benchmark the named search type (can be repeated)
+
+#include "services\SearchResults.h"
+#include "services\ServiceLocator.hh"
+#include "services\impl\Clock.hh"
+#include "services\impl\ThreadPool.hh"
+
+#include "context\impl\EmulatorMemoryContext.hh"
+
+#include "MemoryReadBenchmark.hh"
+#include "ThreadPoolBenchmark.hh"
+
+#include "util\TypeCasts.hh"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <random>
+
+namespace ra {
+namespace services {
+
+bool ServiceLocator::IsInitialized() noexcept { return true; }
+bool ServiceLocator::IsShuttingDown() noexcept { return false; }
+
+} // namespace services
+} // namespace ra
+
+namespace ra {
+namespace benchmark {
+
+static std::vector<uint8_t> s_vMemory;
+
+static uint8_t ReadMemory(uint32_t nAddress) { return s_vMemory.at(nAddress); }
+static void WriteMemory(uint32_t nAddress, uint8_t nValue) { s_vMemory.at(nAddress) = nValue; }
+
+class BenchmarkMemoryContext : public ra::context::impl::EmulatorMemoryContext
+{
+public:
+    // there's no debugger detector in the benchmark
+    bool IsMemoryInsecure() const noexcept override { return false; }
+};
+
+struct Options
+{
+    std::string sMode = "search";
+    std::string sDumpFile;
+    size_t nSize = 2 * 1024 * 1024;
+    unsigned int nEntropy = 25;
+    unsigned int nChanges = 1;
+    unsigned int nSeed = 1;
+    unsigned int nIterations = 3;
+    size_t nThreads = std::thread::hardware_concurrency();
+    std::vector<std::string> vTypes;
+};
+
+static const char* GetSearchTypeName(ra::services::SearchType nType) noexcept
+{
+    switch (nType)
+    {
+        case ra::services::SearchType::FourBit: return "FourBit";
+        case ra::services::SearchType::EightBit: return "EightBit";
+        case ra::services::SearchType::SixteenBit: return "SixteenBit";
+        case ra::services::SearchType::TwentyFourBit: return "TwentyFourBit";
+        case ra::services::SearchType::ThirtyTwoBit: return "ThirtyTwoBit";
+        case ra::services::SearchType::SixteenBitAligned: return "SixteenBitAligned";
+        case ra::services::SearchType::ThirtyTwoBitAligned: return "ThirtyTwoBitAligned";
+        case ra::services::SearchType::SixteenBitBigEndian: return "SixteenBitBigEndian";
+        case ra::services::SearchType::ThirtyTwoBitBigEndian: return "ThirtyTwoBitBigEndian";
+        case ra::services::SearchType::SixteenBitBigEndianAligned: return "SixteenBitBigEndianAligned";
+        case ra::services::SearchType::ThirtyTwoBitBigEndianAligned: return "ThirtyTwoBitBigEndianAligned";
+        case ra::services::SearchType::Float: return "Float";
+        case ra::services::SearchType::FloatAligned: return "FloatAligned";
+        case ra::services::SearchType::FloatBigEndian: return "FloatBigEndian";
+        case ra::services::SearchType::FloatBigEndianAligned: return "FloatBigEndianAligned";
+        case ra::services::SearchType::MBF32: return "MBF32";
+        case ra::services::SearchType::MBF32LE: return "MBF32LE";
+        case ra::services::SearchType::Double32: return "Double32";
+        case ra::services::SearchType::Double32Aligned: return "Double32Aligned";
+        case ra::services::SearchType::Double32BigEndian: return "Double32BigEndian";
+        case ra::services::SearchType::Double32BigEndianAligned: return "Double32BigEndianAligned";
+        case ra::services::SearchType::AsciiText: return "AsciiText";
+        case ra::services::SearchType::BitCount: return "BitCount";
+        default: return "None";
+    }
+}
+
+static const char* GetComparisonName(ComparisonType nComparison) noexcept
+{
+    switch (nComparison)
+    {
+        case ComparisonType::Equals: return "==";
+        case ComparisonType::LessThan: return "<";
+        case ComparisonType::LessThanOrEqual: return "<=";
+        case ComparisonType::GreaterThan: return ">";
+        case ComparisonType::GreaterThanOrEqual: return ">=";
+        case ComparisonType::NotEqualTo: return "!=";
+        default: return "?";
+    }
+}
+
+static const char* GetFilterTypeName(ra::services::SearchFilterType nFilterType) noexcept
+{
+    switch (nFilterType)
+    {
+        case ra::services::SearchFilterType::Constant: return "Constant";
+        case ra::services::SearchFilterType::LastKnownValue: return "LastKnownValue";
+        case ra::services::SearchFilterType::LastKnownValuePlus: return "LastKnownValuePlus";
+        case ra::services::SearchFilterType::LastKnownValueMinus: return "LastKnownValueMinus";
+        case ra::services::SearchFilterType::InitialValue: return "InitialValue";
+        default: return "None";
+    }
+}
+
+static size_t GetMemoryUsage() noexcept
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pCounters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pCounters, sizeof(pCounters)))
+        return pCounters.WorkingSetSize;
+
+    return 0;
+#else
+    // the second field of statm is the number of resident pages
+    size_t nResidentPages = 0;
+    FILE* pFile = fopen("/proc/self/statm", "r");
+    if (pFile == nullptr)
+        return 0;
+
+    if (fscanf(pFile, "%*zu %zu", &nResidentPages) != 1)
+        nResidentPages = 0;
+    fclose(pFile);
+
+    return nResidentPages * gsl::narrow_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+/// <summary>
+/// Polls the memory usage of the process on a background thread so the peak can be reported for each combination.
+/// The operating system only tracks the peak for the lifetime of the process.
+/// </summary>
+class PeakMemorySampler
+{
+public:
+    PeakMemorySampler() { m_pThread = std::thread([this]() { Run(); }); }
+
+    ~PeakMemorySampler() noexcept
+    {
+        m_bStop = true;
+        m_pThread.join();
+    }
+
+    PeakMemorySampler(const PeakMemorySampler&) noexcept = delete;
+    PeakMemorySampler& operator=(const PeakMemorySampler&) noexcept = delete;
+    PeakMemorySampler(PeakMemorySampler&&) noexcept = delete;
+    PeakMemorySampler& operator=(PeakMemorySampler&&) noexcept = delete;
+
+    /// <summary>
+    /// Starts tracking a new peak from the current memory usage.
+    /// </summary>
+    void Reset() noexcept { m_nPeak = GetMemoryUsage(); }
+
+    /// <summary>
+    /// Gets the highest memory usage observed since the last call to <see cref="Reset" />.
+    /// </summary>
+    size_t GetPeak() noexcept
+    {
+        Sample();
+        return m_nPeak;
+    }
+
+private:
+    void Run() noexcept
+    {
+        while (!m_bStop)
+        {
+            Sample();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void Sample() noexcept
+    {
+        const auto nUsage = GetMemoryUsage();
+        auto nPeak = m_nPeak.load();
+        while (nUsage > nPeak && !m_nPeak.compare_exchange_weak(nPeak, nUsage))
+            continue;
+    }
+
+    std::atomic<size_t> m_nPeak{ 0 };
+    std::atomic_bool m_bStop{ false };
+    std::thread m_pThread;
+};
+
+static double ElapsedMilliseconds(std::chrono::steady_clock::time_point tStart) noexcept
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+static bool ParseOptions(int argc, char* argv[], Options& pOptions)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string sArg = argv[i];
+        if (i + 1 == argc)
+        {
+            fprintf(stderr, "missing value for %s\n", sArg.c_str());
+            return false;
+        }
+
+        const std::string sValue = argv[++i];
+        if (sArg == "--mode")
+            pOptions.sMode = sValue;
+        else if (sArg == "--dump")
+            pOptions.sDumpFile = sValue;
+        else if (sArg == "--size")
+            pOptions.nSize = std::stoul(sValue);
+        else if (sArg == "--entropy")
+            pOptions.nEntropy = gsl::narrow_cast<unsigned int>(std::min(std::stoul(sValue), 100UL));
+        else if (sArg == "--changes")
+            pOptions.nChanges = gsl::narrow_cast<unsigned int>(std::min(std::stoul(sValue), 100UL));
+        else if (sArg == "--seed")
+            pOptions.nSeed = gsl::narrow_cast<unsigned int>(std::stoul(sValue));
+        else if (sArg == "--iterations")
+            pOptions.nIterations = gsl::narrow_cast<unsigned int>(std::max(std::stoul(sValue), 1UL));
+        else if (sArg == "--threads")
+            pOptions.nThreads = std::stoul(sValue);
+        else if (sArg == "--type")
+            pOptions.vTypes.push_back(sValue);
+        else
+        {
+            fprintf(stderr, "unknown option: %s\n", sArg.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool LoadMemory(const Options& pOptions, std::mt19937& pRandom)
+{
+    if (!pOptions.sDumpFile.empty())
+    {
+        std::ifstream pFile(pOptions.sDumpFile, std::ios::binary);
+        if (!pFile)
+        {
+            fprintf(stderr, "could not open %s\n", pOptions.sDumpFile.c_str());
+            return false;
+        }
+
+        s_vMemory.assign(std::istreambuf_iterator<char>(pFile), std::istreambuf_iterator<char>());
+        return !s_vMemory.empty();
+    }
+
+    s_vMemory.resize(pOptions.nSize);
+    for (auto& nByte : s_vMemory)
+    {
+        if (pRandom() % 100 < pOptions.nEntropy)
+            nByte = gsl::narrow_cast<uint8_t>(pRandom());
+        else
+            nByte = gsl::narrow_cast<uint8_t>(pRandom() & 0x03);
+    }
+
+    return !s_vMemory.empty();
+}
+
+static void ModifyMemory(const Options& pOptions, std::mt19937& pRandom)
+{
+    const auto nChanges = s_vMemory.size() * pOptions.nChanges / 100;
+    for (size_t i = 0; i < nChanges; ++i)
+        s_vMemory.at(pRandom() % s_vMemory.size()) += gsl::narrow_cast<uint8_t>(1 + (pRandom() & 0x01));
+}
+
+static void RunBenchmarks(const Options& pOptions, std::mt19937& pRandom)
+{
+    constexpr std::array<ComparisonType, 6> vComparisons = {
+        ComparisonType::Equals, ComparisonType::LessThan, ComparisonType::LessThanOrEqual,
+        ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual, ComparisonType::NotEqualTo,
+    };
+    constexpr std::array<ra::services::SearchFilterType, 5> vFilterTypes = {
+        ra::services::SearchFilterType::Constant, ra::services::SearchFilterType::LastKnownValue,
+        ra::services::SearchFilterType::LastKnownValuePlus, ra::services::SearchFilterType::LastKnownValueMinus,
+        ra::services::SearchFilterType::InitialValue,
+    };
+
+    const auto vOriginalMemory = s_vMemory;
+    std::vector<uint8_t> vModifiedMemory;
+
+    printf("%zu bytes, %zu threads\n\n", s_vMemory.size(), pOptions.nThreads);
+    printf("%-28s %-2s %-19s %10s %10s %10s %12s %8s\n", "type", "op", "filter", "matches", "init ms", "filter ms",
+           "addresses/s", "peak MB");
+
+    double dTotalFilterTime = 0.0;
+    double dTotalAddresses = 0.0;
+    size_t nOverallPeakMemory = 0;
+    PeakMemorySampler pMemorySampler;
+
+    for (auto nType = ra::etoi(ra::services::SearchType::FourBit); nType <= ra::etoi(ra::services::SearchType::BitCount);
+         ++nType)
+    {
+        const auto nSearchType = ra::itoe<ra::services::SearchType>(nType);
+        const std::string sTypeName = GetSearchTypeName(nSearchType);
+        if (!pOptions.vTypes.empty() &&
+            std::find(pOptions.vTypes.begin(), pOptions.vTypes.end(), sTypeName) == pOptions.vTypes.end())
+        {
+            continue;
+        }
+
+        // every combination filters the same memory. copy over the existing buffer, the memory context
+        // is pointing at it.
+        std::copy(vOriginalMemory.begin(), vOriginalMemory.end(), s_vMemory.begin());
+
+        pMemorySampler.Reset();
+        const auto tInitializeStart = std::chrono::steady_clock::now();
+        ra::services::SearchResults pInitialResults;
+        pInitialResults.Initialize(0, s_vMemory.size(), nSearchType);
+        const auto dInitializeTime = ElapsedMilliseconds(tInitializeStart);
+        const auto nInitializePeakMemory = pMemorySampler.GetPeak();
+
+        if (vModifiedMemory.empty())
+        {
+            ModifyMemory(pOptions, pRandom);
+            vModifiedMemory = s_vMemory;
+        }
+        else
+        {
+            std::copy(vModifiedMemory.begin(), vModifiedMemory.end(), s_vMemory.begin());
+        }
+
+        for (const auto nComparison : vComparisons)
+        {
+            for (const auto nFilterType : vFilterTypes)
+            {
+                std::wstring sFilterValue;
+                if (nFilterType == ra::services::SearchFilterType::Constant)
+                    sFilterValue = (nSearchType == ra::services::SearchType::AsciiText) ? L"ab" : L"1";
+                else if (nFilterType == ra::services::SearchFilterType::LastKnownValuePlus ||
+                         nFilterType == ra::services::SearchFilterType::LastKnownValueMinus)
+                    sFilterValue = L"1";
+
+                double dBestTime = 0.0;
+                size_t nMatches = 0;
+                bool bSupported = true;
+                pMemorySampler.Reset();
+                for (unsigned int nIteration = 0; nIteration < pOptions.nIterations; ++nIteration)
+                {
+                    ra::services::SearchResults pResults;
+                    const auto tFilterStart = std::chrono::steady_clock::now();
+                    bSupported = pResults.Initialize(pInitialResults, nComparison, nFilterType, sFilterValue);
+                    const auto dFilterTime = ElapsedMilliseconds(tFilterStart);
+                    if (!bSupported)
+                        break;
+
+                    if (nIteration == 0 || dFilterTime < dBestTime)
+                        dBestTime = dFilterTime;
+
+                    nMatches = pResults.MatchingAddressCount();
+                }
+
+                printf("%-28s %-2s %-19s ", sTypeName.c_str(), GetComparisonName(nComparison),
+                       GetFilterTypeName(nFilterType));
+                if (!bSupported)
+                {
+                    printf("%10s\n", "n/a");
+                    continue;
+                }
+
+                const auto nAddresses = pInitialResults.MatchingAddressCount();
+                const auto dAddressesPerSecond = (dBestTime > 0.0) ? nAddresses * 1000.0 / dBestTime : 0.0;
+
+                // the initial results are part of the working set of every filter made against them
+                const auto nPeakMemory = std::max(pMemorySampler.GetPeak(), nInitializePeakMemory);
+                nOverallPeakMemory = std::max(nOverallPeakMemory, nPeakMemory);
+
+                printf("%10zu %10.3f %10.3f %12.0f %8.1f\n", nMatches, dInitializeTime, dBestTime, dAddressesPerSecond,
+                       nPeakMemory / (1024.0 * 1024.0));
+
+                dTotalFilterTime += dBestTime;
+                dTotalAddresses += gsl::narrow_cast<double>(nAddresses);
+            }
+        }
+    }
+
+    printf("\ntotal filter time: %.3f ms\n", dTotalFilterTime);
+    if (dTotalFilterTime > 0.0)
+        printf("overall: %.0f addresses/s\n", dTotalAddresses * 1000.0 / dTotalFilterTime);
+    printf("peak memory: %.1f MB\n", nOverallPeakMemory / (1024.0 * 1024.0));
+}
+
+} // namespace benchmark
+} // namespace ra
+
+int main(int argc, char* argv[])
+{
+    ra::benchmark::Options pOptions;
+    if (!ra::benchmark::ParseOptions(argc, argv, pOptions))
+        return 1;
+
+    ra::services::ServiceLocator::Provide<ra::services::IClock>(std::make_unique<ra::services::impl::Clock>());
+
+    if (pOptions.nThreads > 0)
+    {
+        auto pThreadPool = std::make_unique<ra::services::impl::ThreadPool>();
+        pThreadPool->Initialize(pOptions.nThreads);
+        ra::services::ServiceLocator::Provide<ra::services::IThreadPool>(std::move(pThreadPool));
+    }
+
+    auto pMemoryContext = std::make_unique<ra::benchmark::BenchmarkMemoryContext>();
+    ra::services::ServiceLocator::Provide<ra::context::IEmulatorMemoryContext>(std::move(pMemoryContext));
+
+    // the memory has to be loaded before the size of the memory block is known
+    auto& pContext = ra::services::ServiceLocator::GetMutable<ra::context::IEmulatorMemoryContext>();
+    auto* pEmulatorMemoryContext = dynamic_cast<ra::context::impl::EmulatorMemoryContext*>(&pContext);
+    Expects(pEmulatorMemoryContext != nullptr);
+
+    if (pOptions.sMode == "peek")
+    {
+        ra::benchmark::RunMemoryReadBenchmarks(*pEmulatorMemoryContext, pOptions.nIterations, pOptions.nSeed);
+    }
+    else if (pOptions.sMode == "pool")
+    {
+        ra::benchmark::RunThreadPoolBenchmarks(pOptions.nThreads, pOptions.nIterations);
+    }
+    else if (pOptions.sMode == "search")
+    {
+        std::mt19937 pRandom(pOptions.nSeed);
+        if (!ra::benchmark::LoadMemory(pOptions, pRandom))
+            return 1;
+
+        pEmulatorMemoryContext->AddMemoryBlock(0, ra::benchmark::s_vMemory.size(), ra::benchmark::ReadMemory,
+                                               ra::benchmark::WriteMemory);
+        pEmulatorMemoryContext->AddMemoryBlockPointer(0, ra::benchmark::s_vMemory.data());
+
+        ra::benchmark::RunBenchmarks(pOptions, pRandom);
+    }
+    else
+    {
+        fprintf(stderr, "unknown mode: %s\n", pOptions.sMode.c_str());
+        return 1;
+    }
+
+    if (ra::services::ServiceLocator::Exists<ra::services::IThreadPool>())
+        ra::services::ServiceLocator::GetMutable<ra::services::IThreadPool>().Shutdown(true);
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "ThreadPoolBenchmark.hh"
+
+#include "services\impl\ThreadPool.hh"
+
+#include <cstdio>
+
+namespace ra {
+namespace benchmark {
+
+_CONSTANT_VAR THROUGHPUT_TASKS = 200000U;
+_CONSTANT_VAR PRODUCER_THREADS = 4U; // must divide THROUGHPUT_TASKS
+_CONSTANT_VAR FAN_OUT_PARENTS = 1000U;
+_CONSTANT_VAR FAN_OUT_CHILDREN = 200U;
+
+// simulates a burst of image downloads, like opening the achievement list for a large set
+_CONSTANT_VAR BURST_TASKS = 500U;
+_CONSTANT_VAR BURST_TASK_DURATION = std::chrono::milliseconds(2);
+_CONSTANT_VAR PROBE_TASKS = 50U;
+_CONSTANT_VAR PROBE_INTERVAL = std::chrono::milliseconds(2);
+
+using ra::services::TaskPriority;
+using ra::services::impl::ThreadPool;
+
+// lets the benchmark wait for a known number of tasks to finish
+class Countdown
+{
+public:
+    explicit Countdown(size_t nCount) noexcept : m_nRemaining(nCount) {}
+
+    void Signal()
+    {
+        // decrement and notify while holding the lock. otherwise the waiter could see the count reach zero
+        // between its check and its wait, or destroy the countdown before it's notified.
+        std::lock_guard<std::mutex> lock(m_oMutex);
+        if (--m_nRemaining == 0)
+            m_cvDone.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(m_oMutex);
+        m_cvDone.wait(lock, [this]() noexcept { return m_nRemaining == 0; });
+    }
+
+private:
+    size_t m_nRemaining;
+    std::mutex m_oMutex;
+    std::condition_variable m_cvDone;
+};
+
+static double ElapsedMilliseconds(std::chrono::steady_clock::time_point tStart) noexcept
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+static double TimeThroughput(size_t nThreads, unsigned int nIterations, size_t nTasks,
+                             const std::function<void(ThreadPool&, Countdown&)>& fQueueTasks)
+{
+    double dBestTime = 0.0;
+    for (unsigned int nIteration = 0; nIteration < nIterations; ++nIteration)
+    {
+        ThreadPool pThreadPool;
+        pThreadPool.Initialize(nThreads);
+        Countdown pCountdown(nTasks);
+
+        const auto tStart = std::chrono::steady_clock::now();
+        fQueueTasks(pThreadPool, pCountdown);
+        pCountdown.Wait();
+        const auto dTime = ElapsedMilliseconds(tStart);
+
+        pThreadPool.Shutdown(true);
+
+        if (nIteration == 0 || dTime < dBestTime)
+            dBestTime = dTime;
+    }
+
+    return (dBestTime > 0.0) ? gsl::narrow_cast<double>(nTasks) * 1000.0 / dBestTime : 0.0;
+}
+
+static void QueueFromOneThread(ThreadPool& pThreadPool, Countdown& pCountdown)
+{
+    for (unsigned int i = 0; i < THROUGHPUT_TASKS; ++i)
+        pThreadPool.RunAsync([&pCountdown]() { pCountdown.Signal(); });
+}
+
+static void QueueFromManyThreads(ThreadPool& pThreadPool, Countdown& pCountdown)
+{
+    std::vector<std::thread> vProducers;
+    for (unsigned int nProducer = 0; nProducer < PRODUCER_THREADS; ++nProducer)
+    {
+        vProducers.emplace_back([&pThreadPool, &pCountdown]() {
+            for (unsigned int i = 0; i < THROUGHPUT_TASKS / PRODUCER_THREADS; ++i)
+                pThreadPool.RunAsync([&pCountdown]() { pCountdown.Signal(); });
+        });
+    }
+
+    for (auto& pProducer : vProducers)
+        pProducer.join();
+}
+
+static void QueueFromWorkers(ThreadPool& pThreadPool, Countdown& pCountdown)
+{
+    // like a search, where each partition is processed by a task that queues more tasks
+    for (unsigned int nParent = 0; nParent < FAN_OUT_PARENTS; ++nParent)
+    {
+        pThreadPool.RunAsync([&pThreadPool, &pCountdown]() {
+            for (unsigned int nChild = 0; nChild < FAN_OUT_CHILDREN; ++nChild)
+                pThreadPool.RunAsync([&pCountdown]() { pCountdown.Signal(); });
+        });
+    }
+}
+
+struct LatencyResult
+{
+    double dMedian;
+    double dP99;
+    double dMax;
+};
+
+static LatencyResult MeasureLatency(size_t nThreads, unsigned int nIterations, TaskPriority nBurstPriority,
+                                    TaskPriority nProbePriority)
+{
+    std::vector<double> vLatencies;
+    vLatencies.reserve(gsl::narrow_cast<size_t>(nIterations) * PROBE_TASKS);
+
+    for (unsigned int nIteration = 0; nIteration < nIterations; ++nIteration)
+    {
+        ThreadPool pThreadPool;
+        pThreadPool.Initialize(nThreads);
+        Countdown pCountdown(BURST_TASKS + PROBE_TASKS);
+
+        for (unsigned int i = 0; i < BURST_TASKS; ++i)
+        {
+            pThreadPool.RunAsync(nBurstPriority, [&pCountdown]() {
+                std::this_thread::sleep_for(BURST_TASK_DURATION);
+                pCountdown.Signal();
+            });
+        }
+
+        // each probe records how long it waited to start
+        std::vector<double> vProbeLatencies(PROBE_TASKS);
+        for (auto& dLatency : vProbeLatencies)
+        {
+            const auto tQueued = std::chrono::steady_clock::now();
+            pThreadPool.RunAsync(nProbePriority, [&pCountdown, &dLatency, tQueued]() {
+                dLatency = ElapsedMilliseconds(tQueued);
+                pCountdown.Signal();
+            });
+
+            std::this_thread::sleep_for(PROBE_INTERVAL);
+        }
+
+        pCountdown.Wait();
+        pThreadPool.Shutdown(true);
+
+        vLatencies.insert(vLatencies.end(), vProbeLatencies.begin(), vProbeLatencies.end());
+    }
+
+    std::sort(vLatencies.begin(), vLatencies.end());
+
+    LatencyResult pResult{};
+    pResult.dMedian = vLatencies.at(vLatencies.size() / 2);
+    pResult.dP99 = vLatencies.at(vLatencies.size() * 99 / 100);
+    pResult.dMax = vLatencies.back();
+    return pResult;
+}
+
+void RunThreadPoolBenchmarks(size_t nThreads, unsigned int nIterations)
+{
+    if (nThreads == 0)
+        nThreads = std::thread::hardware_concurrency();
+
+    printf("%zu worker threads\n\n", nThreads);
+    printf("%-40s %14s\n", "throughput", "tasks/s");
+    printf("%-40s %14.0f\n", "queued by one thread",
+           TimeThroughput(nThreads, nIterations, THROUGHPUT_TASKS, QueueFromOneThread));
+    printf("%-40s %14.0f\n", "queued by several threads",
+           TimeThroughput(nThreads, nIterations, THROUGHPUT_TASKS, QueueFromManyThreads));
+    printf("%-40s %14.0f\n", "queued by workers",
+           TimeThroughput(nThreads, nIterations, FAN_OUT_PARENTS * FAN_OUT_CHILDREN, QueueFromWorkers));
+
+    printf("\n%u tasks of %lldms queued at once, then a task queued every %lldms\n", BURST_TASKS,
+           gsl::narrow_cast<long long>(BURST_TASK_DURATION.count()),
+           gsl::narrow_cast<long long>(PROBE_INTERVAL.count()));
+    printf("%-40s %10s %10s %10s\n", "wait to start (ms)", "median", "p99", "max");
+
+    struct LatencyScenario
+    {
+        const char* sName;
+        TaskPriority nBurstPriority;
+        TaskPriority nProbePriority;
+    };
+    const std::array<LatencyScenario, 3> vScenarios = { {
+        { "normal burst, normal task", TaskPriority::Normal, TaskPriority::Normal },
+        { "low burst, normal task", TaskPriority::Low, TaskPriority::Normal },
+        { "low burst, high task", TaskPriority::Low, TaskPriority::High },
+    } };
+
+    for (const auto& pScenario : vScenarios)
+    {
+        const auto pResult = MeasureLatency(nThreads, nIterations, pScenario.nBurstPriority, pScenario.nProbePriority);
+        printf("%-40s %10.3f %10.3f %10.3f\n", pScenario.sName, pResult.dMedian, pResult.dP99, pResult.dMax);
+    }
+}
+
+} // namespace benchmark
+} // namespace ra
@@ -0,0 +1,17 @@
+#ifndef RA_BENCHMARK_THREADPOOLBENCHMARK_HH
+#define RA_BENCHMARK_THREADPOOLBENCHMARK_HH
+#pragma once
+
+namespace ra {
+namespace benchmark {
+
+/// <summary>
+/// Measures how many tasks per second the thread pool can run, and how long latency-sensitive tasks wait while
+/// the pool is busy with a burst of slow tasks (like a set's worth of badge downloads).
+/// </summary>
+void RunThreadPoolBenchmarks(size_t nThreads, unsigned int nIterations);
+
+} // namespace benchmark
+} // namespace ra
+
+#endif // !RA_BENCHMARK_THREADPOOLBENCHMARK_HH
@@ -0,0 +1,13 @@
+#ifndef RA_DEFS_H
+#define RA_DEFS_H
+#pragma once
+
+// Replaces src/RA_Defs.h in the CMake build of the benchmark. The real header pulls in Windows and rapidjson for
+// the UI, but the search code only needs the memory definitions.
+
+#include "util/Strings.hh"
+
+#include "data/Types.hh"
+#include "data/Memory.hh"
+
+#endif // !RA_DEFS_H
@@ -0,0 +1,17 @@
+#ifndef RA_BENCHMARK_COMPAT_INTRIN_H
+#define RA_BENCHMARK_COMPAT_INTRIN_H
+#pragma once
+
+// Stands in for the Microsoft intrinsics header when the benchmark is built with another compiler. Only the
+// intrinsics used by the code the benchmark compiles are provided.
+
+inline unsigned char _BitScanForward(unsigned long* pIndex, unsigned long nMask) noexcept
+{
+    if (nMask == 0)
+        return 0;
+
+    *pIndex = static_cast<unsigned long>(__builtin_ctzl(nMask));
+    return 1;
+}
+
+#endif // !RA_BENCHMARK_COMPAT_INTRIN_H
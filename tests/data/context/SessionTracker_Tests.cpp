@@ -2,6 +2,8 @@
 
 #include "data\context\SessionTracker.hh"
 
+#include "RA_md5factory.h"
+
 #include "tests\RA_UnitTestHelpers.h"
 #include "tests\data\DataAsserts.hh"
 
@@ -45,24 +47,121 @@ public:
 
         bool HasStoredData() const
         {
-            return mockStorage.HasStoredData(StorageItemType::SessionStats, m_sUsernameWide);
+            return mockStorage.HasStoredData(StorageItemType::SessionHistory, m_sUsernameWide);
         }
 
         const std::string& GetStoredData() const
         {
-            return mockStorage.GetStoredData(StorageItemType::SessionStats, m_sUsernameWide);
+            return mockStorage.GetStoredData(StorageItemType::SessionHistory, m_sUsernameWide);
         }
 
         void MockStoredData(const std::string& sContents)
+        {
+            mockStorage.MockStoredData(StorageItemType::SessionHistory, m_sUsernameWide, sContents);
+        }
+
+        // returns the valid records in the history file as "<gameid>:<sessionstart>:<sessionlength>" lines
+        std::string GetStoredSessions() const
+        {
+            return DecodeSessions(GetStoredData());
+        }
+
+        bool HasLegacyData() const
+        {
+            return mockStorage.HasStoredData(StorageItemType::SessionStats, m_sUsernameWide);
+        }
+
+        void MockLegacyData(const std::string& sContents)
         {
             mockStorage.MockStoredData(StorageItemType::SessionStats, m_sUsernameWide, sContents);
         }
 
+        bool HasBackupData() const
+        {
+            return mockStorage.HasStoredData(StorageItemType::SessionHistoryBackup, m_sUsernameWide);
+        }
+
+        void MockBackupData(const std::string& sContents)
+        {
+            mockStorage.MockStoredData(StorageItemType::SessionHistoryBackup, m_sUsernameWide, sContents);
+        }
+
     private:
         std::string m_sUsername;
         std::wstring m_sUsernameWide;
     };
 
+    static void AppendUInt32(std::string& sBuffer, uint32_t nValue)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            sBuffer.push_back(gsl::narrow_cast<char>(nValue & 0xFF));
+            nValue >>= 8;
+        }
+    }
+
+    static uint32_t ReadUInt32(const std::string& sBuffer, size_t nOffset)
+    {
+        uint32_t nValue = 0;
+        for (int i = 3; i >= 0; --i)
+            nValue = (nValue << 8) | static_cast<uint8_t>(sBuffer.at(nOffset + i));
+
+        return nValue;
+    }
+
+    static uint32_t Checksum(const std::string& sBuffer, size_t nOffset, size_t nBytes)
+    {
+        uint32_t nChecksum = 0x811C9DC5;
+        for (size_t i = 0; i < nBytes; ++i)
+        {
+            nChecksum ^= static_cast<uint8_t>(sBuffer.at(nOffset + i));
+            nChecksum *= 0x01000193;
+        }
+
+        return nChecksum;
+    }
+
+    static std::string EncodeHeader(uint32_t nRecords)
+    {
+        std::string sHeader("RASH");
+        AppendUInt32(sHeader, 1U);
+        AppendUInt32(sHeader, nRecords);
+        AppendUInt32(sHeader, Checksum(sHeader, 0, 12));
+        return sHeader;
+    }
+
+    static std::string EncodeRecord(unsigned int nGameId, uint32_t nSessionStart, uint32_t nSessionLength)
+    {
+        std::string sRecord;
+        AppendUInt32(sRecord, nGameId);
+        AppendUInt32(sRecord, nSessionLength);
+        AppendUInt32(sRecord, nSessionStart);
+        AppendUInt32(sRecord, 0U);
+        AppendUInt32(sRecord, 0U);
+        AppendUInt32(sRecord, Checksum(sRecord, 0, 20));
+        return sRecord;
+    }
+
+    static std::string DecodeSessions(const std::string& sData)
+    {
+        Assert::IsTrue(sData.length() >= 16);
+        Assert::AreEqual(std::string("RASH"), sData.substr(0, 4));
+        Assert::AreEqual(1U, ReadUInt32(sData, 4));
+        Assert::AreEqual(Checksum(sData, 0, 12), ReadUInt32(sData, 12));
+
+        std::string sSessions;
+        for (size_t nOffset = 16; nOffset + 24 <= sData.length(); nOffset += 24)
+        {
+            if (ReadUInt32(sData, nOffset + 20) != Checksum(sData, nOffset, 20))
+                continue;
+
+            sSessions.append(ra::util::String::Printf("%u:%u:%u\n", ReadUInt32(sData, nOffset),
+                ReadUInt32(sData, nOffset + 8), ReadUInt32(sData, nOffset + 4)));
+        }
+
+        return sSessions;
+    }
+
     TEST_METHOD(TestEmptyFile)
     {
         SessionTrackerHarness tracker;
@@ -90,7 +189,8 @@ public:
         tracker.mockThreadPool.ExecuteNextTask(); // execute async server call
         Assert::AreEqual({ 1U }, tracker.mockThreadPool.PendingTasks());
         Assert::IsTrue(tracker.HasStoredData());
-        Assert::AreEqual(std::string("1234:1534889323:150:5d\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534889323:150\n"), tracker.GetStoredSessions());
+        Assert::AreEqual({ 16U + 24U }, tracker.GetStoredData().length());
 
         // after two more minutes, the callback will be called again, and the file updated
         tracker.mockClock.AdvanceTime(std::chrono::seconds(120));
@@ -98,17 +198,19 @@ public:
         tracker.mockThreadPool.ExecuteNextTask(); // execute async server call
         Assert::AreEqual({ 1U }, tracker.mockThreadPool.PendingTasks());
         Assert::IsTrue(tracker.HasStoredData());
-        Assert::AreEqual(std::string("1234:1534889323:270:f9\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534889323:270\n"), tracker.GetStoredSessions());
+        Assert::AreEqual({ 16U + 24U }, tracker.GetStoredData().length());
     }
 
     TEST_METHOD(TestNonEmptyFile)
     {
-        std::string sInitialValue("1234:1534000000:1732:f5\n");
+        const std::string sInitialValue = EncodeHeader(1) + EncodeRecord(1234U, 1534000000U, 1732U);
         SessionTrackerHarness tracker;
         tracker.MockStoredData(sInitialValue);
 
         tracker.Initialize("User");
         Assert::IsTrue(tracker.HasStoredData());
+        Assert::AreEqual(1732U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
 
         // BeginSession should begin the session, but not write to the file
         tracker.mockGameContext.SetGameId(1234U);
@@ -125,12 +227,13 @@ public:
         // after two minutes, the callback will be called again, and a new entry added to the file
         tracker.mockClock.AdvanceTime(std::chrono::seconds(120));
         tracker.mockThreadPool.AdvanceTime(std::chrono::seconds(120));
-        Assert::AreEqual(std::string("1234:1534000000:1732:f5\n1234:1534889323:150:5d\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534000000:1732\n1234:1534889323:150\n"), tracker.GetStoredSessions());
 
         // after two more minutes, the callback will be called again, and the new entry updated
         tracker.mockClock.AdvanceTime(std::chrono::seconds(120));
         tracker.mockThreadPool.AdvanceTime(std::chrono::seconds(120));
-        Assert::AreEqual(std::string("1234:1534000000:1732:f5\n1234:1534889323:270:f9\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534000000:1732\n1234:1534889323:270\n"), tracker.GetStoredSessions());
+        Assert::AreEqual({ 16U + 24U * 2 }, tracker.GetStoredData().length());
 
         // total playtime should include current session and previous session
         Assert::AreEqual(1732U + 270U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
@@ -138,13 +241,15 @@ public:
         // ending session should count any time in the since the last callback
         tracker.mockClock.AdvanceTime(std::chrono::seconds(23));
         tracker.EndSession();
-        Assert::AreEqual(std::string("1234:1534000000:1732:f5\n1234:1534889323:293:c9\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534000000:1732\n1234:1534889323:293\n"), tracker.GetStoredSessions());
         Assert::AreEqual(1732U + 293U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
     }
 
     TEST_METHOD(TestNonEmptyFileBadChecksum)
     {
-        std::string sInitialValue("1234:1534000000:1732:00\n");
+        std::string sInitialValue = EncodeHeader(2) + EncodeRecord(1234U, 1534000000U, 1732U) +
+                                    EncodeRecord(1234U, 1534100000U, 963U);
+        sInitialValue.at(16 + 5) ^= 0x40; // corrupt the duration of the first record
         SessionTrackerHarness tracker;
         tracker.MockStoredData(sInitialValue);
         tracker.mockGameContext.SetGameId(1234U);
@@ -152,14 +257,34 @@ public:
         tracker.Initialize("User");
         tracker.BeginSession(1234U);
         tracker.mockClock.AdvanceTime(std::chrono::seconds(180));
-        Assert::AreEqual(180U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
+        Assert::AreEqual(963U + 180U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
+    }
+
+    TEST_METHOD(TestNonEmptyFilePartialRecord)
+    {
+        // the last record was only partially written
+        const std::string sInitialValue = EncodeHeader(0) + EncodeRecord(1234U, 1534000000U, 1732U) +
+                                          EncodeRecord(9999U, 1534100000U, 963U).substr(0, 10);
+        SessionTrackerHarness tracker;
+        tracker.MockStoredData(sInitialValue);
+        tracker.mockGameContext.SetGameId(1234U);
+
+        tracker.Initialize("User");
+        Assert::AreEqual(0U, static_cast<unsigned int>(tracker.GetTotalPlaytime(9999U).count()));
+
+        // the partial record should be overwritten by the next session
+        tracker.BeginSession(1234U);
+        tracker.mockClock.AdvanceTime(std::chrono::seconds(180));
+        tracker.EndSession();
+        Assert::AreEqual(std::string("1234:1534000000:1732\n1234:1534889323:180\n"), tracker.GetStoredSessions());
+        Assert::AreEqual({ 16U + 24U * 2 }, tracker.GetStoredData().length());
     }
 
     TEST_METHOD(TestNonEmptyFileMultipleGames)
     {
-        std::string sInitialValue("1234:1534000000:1732:f5\n"
-            "9999:1534100000:963:4e\n"
-            "1234:1534200000:591:0b\n");
+        const std::string sInitialValue = EncodeHeader(3) + EncodeRecord(1234U, 1534000000U, 1732U) +
+                                          EncodeRecord(9999U, 1534100000U, 963U) +
+                                          EncodeRecord(1234U, 1534200000U, 591U);
         SessionTrackerHarness tracker;
         tracker.MockStoredData(sInitialValue);
         tracker.mockGameContext.SetGameId(1234U);
@@ -169,11 +294,16 @@ public:
         tracker.mockClock.AdvanceTime(std::chrono::seconds(180));
         Assert::AreEqual(1732U + 591U + 180U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
         Assert::AreEqual(963U, static_cast<unsigned int>(tracker.GetTotalPlaytime(9999U).count()));
+
+        // most recently played first
+        Assert::AreEqual({ 2U }, tracker.SessionData().size());
+        Assert::AreEqual(1234U, tracker.SessionData().at(0).GameId);
+        Assert::AreEqual(9999U, tracker.SessionData().at(1).GameId);
     }
 
     TEST_METHOD(TestMultipleSessions)
     {
-        std::string sInitialValue("1234:1534000000:1732:f5\n");
+        const std::string sInitialValue = EncodeHeader(1) + EncodeRecord(1234U, 1534000000U, 1732U);
         SessionTrackerHarness tracker;
         tracker.MockStoredData(sInitialValue);
 
@@ -191,12 +321,12 @@ public:
         // after two minutes, the callback will be called again, and a new entry added to the file
         tracker.mockClock.AdvanceTime(std::chrono::seconds(120));
         tracker.mockThreadPool.AdvanceTime(std::chrono::seconds(120));
-        Assert::AreEqual(std::string("1234:1534000000:1732:f5\n1234:1534889323:150:5d\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534000000:1732\n1234:1534889323:150\n"), tracker.GetStoredSessions());
 
         // end session should include time since last callback
         tracker.mockClock.AdvanceTime(std::chrono::seconds(23));
         tracker.EndSession();
-        Assert::AreEqual(std::string("1234:1534000000:1732:f5\n1234:1534889323:173:bb\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534000000:1732\n1234:1534889323:173\n"), tracker.GetStoredSessions());
 
         // start new session
         tracker.BeginSession(9999U);
@@ -208,12 +338,160 @@ public:
         // after two minutes, the callback will be called again, and a new entry added to the file
         tracker.mockClock.AdvanceTime(std::chrono::seconds(120));
         tracker.mockThreadPool.AdvanceTime(std::chrono::seconds(120));
-        Assert::AreEqual(std::string("1234:1534000000:1732:f5\n1234:1534889323:173:bb\n9999:1534889496:150:d0\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534000000:1732\n1234:1534889323:173\n9999:1534889496:150\n"), tracker.GetStoredSessions());
 
         // end session should include time since last callback
         tracker.mockClock.AdvanceTime(std::chrono::seconds(19));
         tracker.EndSession();
-        Assert::AreEqual(std::string("1234:1534000000:1732:f5\n1234:1534889323:173:bb\n9999:1534889496:169:14\n"), tracker.GetStoredData());
+        Assert::AreEqual(std::string("1234:1534000000:1732\n1234:1534889323:173\n9999:1534889496:169\n"), tracker.GetStoredSessions());
+        Assert::AreEqual({ 16U + 24U * 3 }, tracker.GetStoredData().length());
+    }
+
+    TEST_METHOD(TestConvertLegacyFile)
+    {
+        SessionTrackerHarness tracker;
+        tracker.MockLegacyData("1234:1534000000:1732:f5\n"
+            "9999:1534100000:963:4e\n"
+            "1234:1534200000:591:0b\n"
+            "5555:1534300000:100:00\n"); // bad checksum
+        tracker.mockGameContext.SetGameId(1234U);
+
+        tracker.Initialize("User");
+
+        // one record per game, legacy file removed
+        Assert::IsFalse(tracker.HasLegacyData());
+        Assert::IsFalse(tracker.HasBackupData());
+        Assert::AreEqual(std::string("1234:1534200000:2323\n9999:1534100000:963\n"), tracker.GetStoredSessions());
+        Assert::AreEqual(2323U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
+        Assert::AreEqual(963U, static_cast<unsigned int>(tracker.GetTotalPlaytime(9999U).count()));
+        Assert::AreEqual(0U, static_cast<unsigned int>(tracker.GetTotalPlaytime(5555U).count()));
+
+        // new sessions are appended to the converted file
+        tracker.BeginSession(1234U);
+        tracker.mockClock.AdvanceTime(std::chrono::seconds(180));
+        tracker.EndSession();
+        Assert::AreEqual(std::string("1234:1534200000:2323\n9999:1534100000:963\n1234:1534889323:180\n"), tracker.GetStoredSessions());
+    }
+
+    TEST_METHOD(TestCompaction)
+    {
+        // history has more than 256 more records than games
+        std::string sInitialValue = EncodeHeader(0);
+        for (unsigned int i = 0; i < 300; ++i)
+            sInitialValue += EncodeRecord(1000U + (i % 3), 1534000000U + i * 1000, 60U);
+
+        SessionTrackerHarness tracker;
+        tracker.MockStoredData(sInitialValue);
+
+        tracker.Initialize("User");
+        Assert::IsFalse(tracker.HasBackupData());
+        Assert::AreEqual(std::string("1000:1534297000:6000\n1001:1534298000:6000\n1002:1534299000:6000\n"), tracker.GetStoredSessions());
+        Assert::AreEqual(3U, ReadUInt32(tracker.GetStoredData(), 8));
+        Assert::AreEqual(6000U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1001U).count()));
+    }
+
+    TEST_METHOD(TestCompactionBelowThreshold)
+    {
+        std::string sInitialValue = EncodeHeader(0);
+        for (unsigned int i = 0; i < 200; ++i)
+            sInitialValue += EncodeRecord(1000U + (i % 3), 1534000000U + i * 1000, 60U);
+
+        SessionTrackerHarness tracker;
+        tracker.MockStoredData(sInitialValue);
+
+        tracker.Initialize("User");
+        Assert::AreEqual(sInitialValue, tracker.GetStoredData());
+    }
+
+    TEST_METHOD(TestInterruptedCompaction)
+    {
+        // backup was written, but the history file was not
+        const std::string sBackup = EncodeHeader(2) + EncodeRecord(1234U, 1534200000U, 2323U) +
+                                    EncodeRecord(9999U, 1534100000U, 963U);
+        SessionTrackerHarness tracker;
+        tracker.MockBackupData(sBackup);
+        tracker.MockStoredData(EncodeHeader(2) + EncodeRecord(1234U, 1534200000U, 2323U).substr(0, 12));
+
+        tracker.Initialize("User");
+        Assert::IsFalse(tracker.HasBackupData());
+        Assert::AreEqual(sBackup, tracker.GetStoredData());
+        Assert::AreEqual(2323U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
+        Assert::AreEqual(963U, static_cast<unsigned int>(tracker.GetTotalPlaytime(9999U).count()));
+    }
+
+    TEST_METHOD(TestInterruptedCompactionIncompleteBackup)
+    {
+        // backup was only partially written, so the history file was not touched
+        const std::string sInitialValue = EncodeHeader(0) + EncodeRecord(1234U, 1534000000U, 1732U) +
+                                          EncodeRecord(9999U, 1534100000U, 963U) +
+                                          EncodeRecord(1234U, 1534200000U, 591U);
+        SessionTrackerHarness tracker;
+        tracker.MockBackupData(EncodeHeader(2) + EncodeRecord(1234U, 1534200000U, 2323U));
+        tracker.MockStoredData(sInitialValue);
+
+        tracker.Initialize("User");
+        Assert::IsFalse(tracker.HasBackupData());
+        Assert::AreEqual(sInitialValue, tracker.GetStoredData());
+        Assert::AreEqual(2323U, static_cast<unsigned int>(tracker.GetTotalPlaytime(1234U).count()));
+        Assert::AreEqual(963U, static_cast<unsigned int>(tracker.GetTotalPlaytime(9999U).count()));
+    }
+
+    TEST_METHOD(TestLoadManySessions)
+    {
+        constexpr unsigned int nSessions = 100000;
+        constexpr unsigned int nGames = 2500;
+
+        std::string sInitialValue = EncodeHeader(0);
+        sInitialValue.reserve(16 + nSessions * 24);
+        for (unsigned int i = 0; i < nSessions; ++i)
+            sInitialValue += EncodeRecord(i % nGames + 1, 1500000000U + i * 60, i % 100);
+
+        SessionTrackerHarness tracker;
+        tracker.MockStoredData(sInitialValue);
+        tracker.Initialize("User");
+
+        // each game was played 40 times for (game-1)%100 seconds
+        Assert::AreEqual({ nGames }, tracker.SessionData().size());
+        for (unsigned int nGameId = 1; nGameId <= nGames; ++nGameId)
+        {
+            const auto nExpected = ((nGameId - 1) % 100) * 40;
+            Assert::AreEqual(nExpected, static_cast<unsigned int>(tracker.GetTotalPlaytime(nGameId).count()));
+        }
+
+        // most recently played first
+        Assert::AreEqual(nGames, tracker.SessionData().front().GameId);
+        Assert::AreEqual(1U, tracker.SessionData().back().GameId);
+
+        // compacted to one record per game
+        Assert::AreEqual({ 16U + nGames * 24U }, tracker.GetStoredData().length());
+    }
+
+    TEST_METHOD(TestConvertManyLegacySessions)
+    {
+        constexpr unsigned int nSessions = 100000;
+        constexpr unsigned int nGames = 2500;
+
+        std::string sInitialValue;
+        for (unsigned int i = 0; i < nSessions; ++i)
+        {
+            auto sLine = ra::util::String::Printf("%u:%u:%u:", i % nGames + 1, 1500000000U + i * 60, 60U);
+            const auto sMD5 = RAGenerateMD5(sLine);
+            sLine.push_back(sMD5.front());
+            sLine.push_back(sMD5.back());
+            sInitialValue.append(sLine);
+            sInitialValue.push_back('\n');
+        }
+
+        SessionTrackerHarness tracker;
+        tracker.MockLegacyData(sInitialValue);
+        tracker.Initialize("User");
+
+        Assert::IsFalse(tracker.HasLegacyData());
+        Assert::AreEqual({ nGames }, tracker.SessionData().size());
+        for (unsigned int nGameId = 1; nGameId <= nGames; ++nGameId)
+            Assert::AreEqual(60U * 40U, static_cast<unsigned int>(tracker.GetTotalPlaytime(nGameId).count()));
+
+        Assert::AreEqual({ 16U + nGames * 24U }, tracker.GetStoredData().length());
     }
 };
 
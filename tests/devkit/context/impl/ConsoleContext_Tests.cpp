@@ -193,6 +193,18 @@ public:
         Assert::AreEqual({ 0xFFFFFFFF }, context.ByteAddressFromRealAddress(0xB0001234U));
         Assert::AreEqual({ 0xFFFFFFFF }, context.ByteAddressFromRealAddress(0x00001234U));
     }
+
+    TEST_METHOD(TestRealAddressFromByteAddressGameboyAdvance)
+    {
+        ConsoleContext context(ConsoleID::GBA);
+
+        Assert::AreEqual({ 0x03000000 }, context.RealAddressFromByteAddress(0x00000000U));
+        Assert::AreEqual({ 0x03007FFF }, context.RealAddressFromByteAddress(0x00007FFFU));
+        Assert::AreEqual({ 0x02000000 }, context.RealAddressFromByteAddress(0x00008000U));
+        Assert::AreEqual({ 0x02001234 }, context.RealAddressFromByteAddress(0x00009234U));
+        Assert::AreEqual({ 0x0E000000 }, context.RealAddressFromByteAddress(0x00048000U));
+        Assert::AreEqual({ 0xFFFFFFFF }, context.RealAddressFromByteAddress(0x00058000U));
+    }
 };
 
 } // namespace tests
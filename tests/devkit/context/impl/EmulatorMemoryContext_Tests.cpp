@@ -60,6 +60,20 @@ private:
         return nBytes;
     }
 
+    static int nBlockReads;
+    static uint32_t ReadMemoryBlockCounted(uint32_t nAddress, uint8_t* pBuffer, uint32_t nBytes) noexcept
+    {
+        ++nBlockReads;
+        return ReadMemoryBlock0(nAddress, pBuffer, nBytes);
+    }
+
+    static int nByteReads;
+    static uint8_t ReadMemoryCounted(uint32_t nAddress) noexcept
+    {
+        ++nByteReads;
+        return ReadMemory0(nAddress);
+    }
+
     static uint32_t ReadMemoryBlockNull(uint32_t, uint8_t*, uint32_t) noexcept
     {
         return 0;
@@ -76,6 +90,19 @@ private:
             memory.at(i) = gsl::narrow_cast<uint8_t>(i);
     }
 
+    static std::array<uint8_t, EmulatorMemoryContext::DIRTY_PAGE_SIZE * 3> pageMemory;
+
+    static uint8_t ReadPageMemory(uint32_t nAddress) noexcept { return pageMemory.at(nAddress); }
+    static void WritePageMemory(uint32_t nAddress, uint8_t nValue) noexcept { pageMemory.at(nAddress) = nValue; }
+
+    static void InitializePageMemory(EmulatorMemoryContextHarness& emulator)
+    {
+        for (size_t i = 0; i < pageMemory.size(); ++i)
+            pageMemory.at(i) = gsl::narrow_cast<uint8_t>(i);
+
+        emulator.AddMemoryBlock(0, pageMemory.size(), &ReadPageMemory, &WritePageMemory);
+    }
+
 public:
     TEST_METHOD(TestIsValidAddress)
     {
@@ -278,6 +305,244 @@ public:
         Assert::AreEqual(gsl::at(buffer, 1), memory.at(1));
     }
 
+    TEST_METHOD(TestReadMemoryPointer)
+    {
+        for (size_t i = 0; i < memory.size(); i++)
+            memory.at(i) = gsl::narrow_cast<uint8_t>(i);
+
+        memory.at(4) = 0xA8;
+        memory.at(5) = 0x00;
+        memory.at(6) = 0x37;
+        memory.at(7) = 0x2E;
+
+        memory.at(14) = 0x57;
+
+        EmulatorMemoryContextHarness emulator;
+        emulator.AddMemoryBlock(0, 20, &ReadMemory1, &WriteMemory0); // purposefully use ReadMemory1 to detect using byte reader
+        emulator.AddMemoryBlockReader(0, &ReadMemoryBlock1); // purposefully use ReadMemoryBlock1 to detect using block reader
+        emulator.AddMemoryBlockPointer(0, memory.data());
+
+        // all reads should use the pointer ($4 => $4)
+        Assert::AreEqual(0, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::Bit0)));
+        Assert::AreEqual(1, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::Bit3)));
+        Assert::AreEqual(3, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::BitCount)));
+        Assert::AreEqual(8, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::NibbleLower)));
+        Assert::AreEqual(10, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::NibbleUpper)));
+        Assert::AreEqual(0xA8, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::EightBit)));
+        Assert::AreEqual(0xA8, static_cast<int>(emulator.ReadMemoryByte(4U)));
+        Assert::AreEqual(0x2E37, static_cast<int>(emulator.ReadMemory(6U, ra::data::Memory::Size::SixteenBit)));
+        Assert::AreEqual(0x2E3700A8, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::ThirtyTwoBit)));
+        Assert::AreEqual(0xA800372EU, emulator.ReadMemory(4U, ra::data::Memory::Size::ThirtyTwoBitBigEndian));
+
+        // reading past the end of the block should not read past the end of the host memory
+        uint8_t buffer[24];
+        emulator.ReadMemory(0U, buffer, sizeof(buffer));
+        for (size_t i = 0; i < 20; i++)
+            Assert::AreEqual(gsl::at(buffer, i), memory.at(i));
+        for (size_t i = 20; i < sizeof(buffer); i++)
+            Assert::AreEqual(gsl::at(buffer, i), (uint8_t)0);
+
+        std::vector<ra::data::CapturedMemoryBlock> vBlocks;
+        emulator.CaptureMemory(vBlocks, 2, 16, 0);
+        Assert::AreEqual({ 1 }, vBlocks.size());
+        Assert::AreEqual(16U, vBlocks.at(0).GetBytesSize());
+        const auto* pBytes = vBlocks.at(0).GetBytes();
+        Expects(pBytes != nullptr);
+        for (size_t i = 0; i < 16; i++)
+            Assert::AreEqual(memory.at(i + 2), pBytes[i]);
+
+        // writes should still use the write function
+        emulator.WriteMemoryByte(4U, 0x12);
+        Assert::AreEqual({ 0x12 }, memory.at(4));
+        Assert::AreEqual(0x12, static_cast<int>(emulator.ReadMemoryByte(4U)));
+    }
+
+    TEST_METHOD(TestReadMemoryPages)
+    {
+        for (size_t i = 0; i < pageMemory.size(); ++i)
+            pageMemory.at(i) = gsl::narrow_cast<uint8_t>(i * 7);
+
+        // second block doesn't end on a page boundary, so one page is split between the second and third blocks.
+        // third block is not directly accessible.
+        EmulatorMemoryContextHarness emulator;
+        emulator.AddMemoryBlock(0, 0x1000, &ReadPageMemory, &WritePageMemory);
+        emulator.AddMemoryBlockPointer(0, pageMemory.data());
+        emulator.AddMemoryBlock(1, 0x600, [](uint32_t nAddress) noexcept { return pageMemory.at(nAddress + 0x1000); },
+                                [](uint32_t nAddress, uint8_t nValue) noexcept { pageMemory.at(nAddress + 0x1000) = nValue; });
+        emulator.AddMemoryBlockPointer(1, pageMemory.data() + 0x1000);
+        emulator.AddMemoryBlock(2, 0x200, [](uint32_t nAddress) noexcept { return pageMemory.at(nAddress + 0x1600); },
+                                [](uint32_t nAddress, uint8_t nValue) noexcept { pageMemory.at(nAddress + 0x1600) = nValue; });
+        Assert::AreEqual({ 0x1800U }, emulator.TotalMemorySize());
+
+        for (ra::data::ByteAddress nAddress = 0; nAddress < 0x1800; ++nAddress)
+            Assert::AreEqual(pageMemory.at(nAddress), emulator.ReadMemoryByte(nAddress));
+
+        Assert::AreEqual(0, static_cast<int>(emulator.ReadMemoryByte(0x1800U)));
+        Assert::IsTrue(emulator.IsValidAddress(0x17FFU));
+        Assert::IsFalse(emulator.IsValidAddress(0x1800U));
+
+        // reads across page boundaries and block boundaries
+        for (const ra::data::ByteAddress nAddress : { 0x03FEU, 0x0FFEU, 0x13FEU, 0x15FEU, 0x17FCU })
+        {
+            const uint32_t nExpected = pageMemory.at(nAddress) | (pageMemory.at(nAddress + 1) << 8) |
+                                       (pageMemory.at(nAddress + 2) << 16) | (pageMemory.at(nAddress + 3) << 24);
+            Assert::AreEqual(nExpected, emulator.ReadMemory(nAddress, ra::data::Memory::Size::ThirtyTwoBit));
+        }
+
+        // read extending past the end of memory
+        Assert::AreEqual(static_cast<uint32_t>(pageMemory.at(0x17FF)), emulator.ReadMemory(0x17FFU, ra::data::Memory::Size::SixteenBit));
+
+        // writes should go to the correct block
+        emulator.WriteMemory(0x15FFU, ra::data::Memory::Size::SixteenBit, 0x1234U);
+        Assert::AreEqual({ 0x34 }, pageMemory.at(0x15FF));
+        Assert::AreEqual({ 0x12 }, pageMemory.at(0x1600));
+        Assert::AreEqual(0x1234U, emulator.ReadMemory(0x15FFU, ra::data::Memory::Size::SixteenBit));
+
+        // blocks are no longer accessible after they're cleared
+        emulator.ClearMemoryBlocks();
+        Assert::AreEqual(0, static_cast<int>(emulator.ReadMemoryByte(0x0004U)));
+        Assert::IsFalse(emulator.IsValidAddress(0x0004U));
+    }
+
+    TEST_METHOD(TestPeekMemory)
+    {
+        for (size_t i = 0; i < pageMemory.size(); ++i)
+            pageMemory.at(i) = gsl::narrow_cast<uint8_t>(i * 7);
+
+        // same layout as TestReadMemoryPages. the last page and a half are not directly accessible.
+        EmulatorMemoryContextHarness emulator;
+        emulator.AddMemoryBlock(0, 0x1000, &ReadPageMemory, &WritePageMemory);
+        emulator.AddMemoryBlockPointer(0, pageMemory.data());
+        emulator.AddMemoryBlock(1, 0x600, [](uint32_t nAddress) noexcept { return pageMemory.at(nAddress + 0x1000); },
+                                [](uint32_t nAddress, uint8_t nValue) noexcept { pageMemory.at(nAddress + 0x1000) = nValue; });
+        emulator.AddMemoryBlockPointer(1, pageMemory.data() + 0x1000);
+        emulator.AddMemoryBlock(2, 0x200, [](uint32_t nAddress) noexcept { return pageMemory.at(nAddress + 0x1600); },
+                                [](uint32_t nAddress, uint8_t nValue) noexcept { pageMemory.at(nAddress + 0x1600) = nValue; });
+
+        for (ra::data::ByteAddress nAddress = 0; nAddress < 0x1804; ++nAddress)
+        {
+            Assert::AreEqual(static_cast<uint32_t>(emulator.ReadMemoryByte(nAddress)), emulator.PeekMemory(nAddress, 1));
+            Assert::AreEqual(emulator.ReadMemory(nAddress, ra::data::Memory::Size::SixteenBit), emulator.PeekMemory(nAddress, 2));
+            Assert::AreEqual(emulator.ReadMemory(nAddress, ra::data::Memory::Size::ThirtyTwoBit), emulator.PeekMemory(nAddress, 4));
+        }
+
+        // unsupported sizes
+        Assert::AreEqual(0U, emulator.PeekMemory(0x0004U, 3));
+        Assert::AreEqual(0U, emulator.PeekMemory(0x1700U, 3));
+
+        // buffered reads return the number of bytes read, even when they run off the end of memory
+        for (ra::data::ByteAddress nAddress = 0; nAddress < 0x1804; nAddress += 3)
+        {
+            std::array<uint8_t, 8> pExpected{}, pActual{};
+            const auto nExpected = emulator.ReadMemory(nAddress, pExpected.data(), pExpected.size());
+            Assert::AreEqual(nExpected, emulator.PeekMemory(nAddress, pActual.data(), gsl::narrow_cast<uint32_t>(pActual.size())));
+            Assert::IsTrue(pExpected == pActual);
+        }
+    }
+
+    TEST_METHOD(TestCachingReads)
+    {
+        InitializeMemory();
+        nBlockReads = 0;
+
+        EmulatorMemoryContextHarness emulator;
+        emulator.AddMemoryBlock(0, 64, &ReadMemory0, &WriteMemory0);
+        emulator.AddMemoryBlockReader(0, &ReadMemoryBlockCounted);
+
+        // not caching, each read goes to the emulator
+        Assert::AreEqual(0x0504, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::SixteenBit)));
+        Assert::AreEqual(0x0504, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::SixteenBit)));
+        Assert::AreEqual(2, nBlockReads);
+
+        // caching, first read populates the cache
+        emulator.BeginCachingReads();
+        nBlockReads = 0;
+        Assert::AreEqual(0x0504, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::SixteenBit)));
+        Assert::AreEqual(1, nBlockReads);
+        Assert::AreEqual(0x0C0B0A09U, emulator.ReadMemory(9U, ra::data::Memory::Size::ThirtyTwoBit));
+        Assert::AreEqual(0x30, static_cast<int>(emulator.ReadMemoryByte(0x30U)));
+        uint8_t buffer[16];
+        Assert::AreEqual(16U, emulator.ReadMemory(0x20U, buffer, sizeof(buffer)));
+        Assert::AreEqual(1, nBlockReads);
+
+        // memory modified outside of the context is not seen
+        memory.at(4) = 0x44;
+        Assert::AreEqual(0x0504, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::SixteenBit)));
+
+        // memory written through the context discards the cached memory
+        emulator.WriteMemoryByte(5U, 0x55);
+        Assert::AreEqual(0x5544, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::SixteenBit)));
+        Assert::AreEqual(2, nBlockReads);
+
+        // reads past the end of memory are not cached
+        Assert::AreEqual(0U, emulator.ReadMemory(0x40U, buffer, 4));
+        Assert::AreEqual(2U, emulator.ReadMemory(0x3EU, buffer, 4));
+        Assert::AreEqual(0x3E, static_cast<int>(gsl::at(buffer, 0)));
+        Assert::AreEqual(0x00, static_cast<int>(gsl::at(buffer, 2)));
+
+        // no longer caching, memory modified outside of the context is seen
+        emulator.EndCachingReads();
+        memory.at(4) = 0x04;
+        nBlockReads = 0;
+        Assert::AreEqual(0x5504, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::SixteenBit)));
+        Assert::AreEqual(1, nBlockReads);
+    }
+
+    TEST_METHOD(TestCachingReadsByteReader)
+    {
+        InitializeMemory();
+        nByteReads = 0;
+
+        EmulatorMemoryContextHarness emulator;
+        emulator.AddMemoryBlock(0, 64, &ReadMemoryCounted, &WriteMemory0);
+        emulator.BeginCachingReads();
+
+        // without a block reader, only the requested bytes are read into the cache
+        Assert::AreEqual(0x04, static_cast<int>(emulator.ReadMemoryByte(4U)));
+        Assert::AreEqual(1, nByteReads);
+        Assert::AreEqual(0x0504, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::SixteenBit)));
+        Assert::AreEqual(2, nByteReads);
+        Assert::AreEqual(0x06050403U, emulator.ReadMemory(3U, ra::data::Memory::Size::ThirtyTwoBit));
+        Assert::AreEqual(4, nByteReads);
+        Assert::AreEqual(0x30, static_cast<int>(emulator.ReadMemoryByte(0x30U)));
+        Assert::AreEqual(5, nByteReads);
+
+        // previously read bytes come from the cache
+        memory.at(4) = 0x44;
+        Assert::AreEqual(0x06050403U, emulator.ReadMemory(3U, ra::data::Memory::Size::ThirtyTwoBit));
+        Assert::AreEqual(5, nByteReads);
+
+        // writing discards the page, repeated writes and reads shouldn't duplicate it
+        for (int i = 0; i < 3; ++i)
+        {
+            emulator.WriteMemoryByte(5U, 0x55);
+            Assert::AreEqual(0x5544, static_cast<int>(emulator.ReadMemory(4U, ra::data::Memory::Size::SixteenBit)));
+        }
+        Assert::AreEqual(11, nByteReads);
+        Assert::AreEqual(0x30, static_cast<int>(emulator.ReadMemoryByte(0x30U)));
+        Assert::AreEqual(12, nByteReads);
+    }
+
+    TEST_METHOD(TestCachingReadsInvalidMemoryBlock)
+    {
+        InitializeMemory();
+
+        EmulatorMemoryContextHarness emulator;
+        emulator.AddMemoryBlock(0, 10, &ReadMemory0, &WriteMemory0);
+        emulator.AddMemoryBlock(1, 10, nullptr, nullptr);
+        emulator.AddMemoryBlock(2, 44, &ReadMemory2, &WriteMemory2);
+        emulator.BeginCachingReads();
+
+        // page containing invalid memory should be read directly so the number of valid bytes is accurate
+        uint8_t buffer[8];
+        Assert::AreEqual(4U, emulator.ReadMemory(6U, buffer, sizeof(buffer)));
+        Assert::AreEqual(0x06, static_cast<int>(gsl::at(buffer, 0)));
+        Assert::AreEqual(0x00, static_cast<int>(gsl::at(buffer, 4)));
+        Assert::AreEqual(0x09, static_cast<int>(emulator.ReadMemoryByte(9U)));
+        Assert::AreEqual(0x00, static_cast<int>(emulator.ReadMemoryByte(12U)));
+        Assert::AreEqual(0x15, static_cast<int>(emulator.ReadMemoryByte(21U)));
+    }
+
     TEST_METHOD(TestReadMemoryBuffer)
     {
         InitializeMemory();
@@ -702,6 +967,32 @@ public:
             Assert::AreEqual(memory.at(i + 20), pBytes[i]);
     }
 
+    TEST_METHOD(TestCaptureMemoryPadding)
+    {
+        EmulatorMemoryContextHarness emulator;
+
+        InitializeMemory();
+        emulator.AddMemoryBlock(0, 20, &ReadMemory0, &WriteMemory0);
+        emulator.AddMemoryBlock(1, 10, &ReadMemory2, &WriteMemory2);
+
+        std::vector<ra::data::CapturedMemoryBlock> vBlocks;
+        emulator.CaptureMemory(vBlocks, 1, 29, 3);
+        Assert::AreEqual({ 2 }, vBlocks.size());
+
+        // first block should include the first three bytes of the second block
+        Assert::AreEqual(22U, vBlocks.at(0).GetBytesSize());
+        const auto* pBytes = vBlocks.at(0).GetBytes();
+        Expects(pBytes != nullptr);
+        for (size_t i = 0; i < 22; i++)
+            Assert::AreEqual(memory.at(i + 1), pBytes[i]);
+
+        Assert::AreEqual(10U, vBlocks.at(1).GetBytesSize());
+        pBytes = vBlocks.at(1).GetBytes();
+        Expects(pBytes != nullptr);
+        for (size_t i = 0; i < 10; i++)
+            Assert::AreEqual(memory.at(i + 20), pBytes[i]);
+    }
+
     TEST_METHOD(TestCaptureMemorySecondBlockOnly)
     {
         EmulatorMemoryContextHarness emulator;
@@ -793,9 +1084,188 @@ public:
         for (size_t i = 0; i < 10; i++)
             Assert::AreEqual(memory.at(i + 20), pBytes[i]);
     }
+
+    TEST_METHOD(TestCaptureMemoryShared)
+    {
+        EmulatorMemoryContextHarness emulator;
+
+        InitializeMemory();
+        emulator.AddMemoryBlock(0, 20, &ReadMemory0, &WriteMemory0);
+        emulator.AddMemoryBlock(1, 10, &ReadMemory2, &WriteMemory2);
+
+        std::vector<ra::data::CapturedMemoryBlock> vBlocks1;
+        emulator.CaptureMemory(vBlocks1, 0, 30, 0);
+        Assert::AreEqual({ 2 }, vBlocks1.size());
+
+        // identical captures should share memory
+        std::vector<ra::data::CapturedMemoryBlock> vBlocks2;
+        emulator.CaptureMemory(vBlocks2, 0, 30, 0);
+        Assert::AreEqual({ 2 }, vBlocks2.size());
+        Assert::IsTrue(std::as_const(vBlocks1.at(0)).GetBytes().Data() == std::as_const(vBlocks2.at(0)).GetBytes().Data());
+        Assert::IsTrue(std::as_const(vBlocks1.at(1)).GetBytes().Data() == std::as_const(vBlocks2.at(1)).GetBytes().Data());
+
+        // modified memory should not be shared
+        emulator.WriteMemoryByte(4U, 0x12);
+        std::vector<ra::data::CapturedMemoryBlock> vBlocks3;
+        emulator.CaptureMemory(vBlocks3, 0, 30, 0);
+        Assert::AreEqual({ 2 }, vBlocks3.size());
+        Assert::IsFalse(std::as_const(vBlocks1.at(0)).GetBytes().Data() == std::as_const(vBlocks3.at(0)).GetBytes().Data());
+        Assert::IsTrue(std::as_const(vBlocks1.at(1)).GetBytes().Data() == std::as_const(vBlocks3.at(1)).GetBytes().Data());
+        Assert::AreEqual({ 0x12 }, std::as_const(vBlocks3.at(0)).GetBytes().Data()[4]);
+        Assert::AreEqual({ 4 }, std::as_const(vBlocks1.at(0)).GetBytes().Data()[4]);
+
+        // modifying shared memory should not affect the other captures
+        auto* pBytes = vBlocks2.at(1).GetBytes();
+        Expects(pBytes != nullptr);
+        pBytes[0] = 0x34;
+        Assert::IsFalse(std::as_const(vBlocks1.at(1)).GetBytes().Data() == std::as_const(vBlocks2.at(1)).GetBytes().Data());
+        Assert::AreEqual({ 20 }, std::as_const(vBlocks1.at(1)).GetBytes().Data()[0]);
+        Assert::AreEqual({ 20 }, std::as_const(vBlocks3.at(1)).GetBytes().Data()[0]);
+        Assert::AreEqual({ 0x34 }, std::as_const(vBlocks2.at(1)).GetBytes().Data()[0]);
+    }
+
+    TEST_METHOD(TestCaptureMemorySharedHostMemory)
+    {
+        // large enough to be split into two blocks
+        static std::vector<uint8_t> vMemory(256 * 1024 + 16);
+        for (size_t i = 0; i < vMemory.size(); ++i)
+            vMemory.at(i) = gsl::narrow_cast<uint8_t>(i * 7);
+
+        EmulatorMemoryContextHarness emulator;
+        emulator.AddMemoryBlock(0, vMemory.size(), [](uint32_t nAddress) noexcept { return vMemory.at(nAddress); },
+                                [](uint32_t nAddress, uint8_t nValue) noexcept { vMemory.at(nAddress) = nValue; });
+        emulator.AddMemoryBlockPointer(0, vMemory.data());
+
+        std::vector<ra::data::CapturedMemoryBlock> vBlocks1;
+        emulator.CaptureMemory(vBlocks1, 0, gsl::narrow_cast<uint32_t>(vMemory.size()), 3);
+        Assert::AreEqual({ 2 }, vBlocks1.size());
+
+        // first block should include the first three bytes of the second block
+        Assert::AreEqual(256U * 1024 + 3, vBlocks1.at(0).GetBytesSize());
+        Assert::AreEqual(0, memcmp(vMemory.data(), std::as_const(vBlocks1.at(0)).GetBytes().Data(), 256 * 1024 + 3));
+        Assert::AreEqual(16U, vBlocks1.at(1).GetBytesSize());
+        Assert::AreEqual(0, memcmp(vMemory.data() + 256 * 1024, std::as_const(vBlocks1.at(1)).GetBytes().Data(), 16));
+
+        // identical captures should share memory
+        std::vector<ra::data::CapturedMemoryBlock> vBlocks2;
+        emulator.CaptureMemory(vBlocks2, 0, gsl::narrow_cast<uint32_t>(vMemory.size()), 3);
+        Assert::AreEqual({ 2 }, vBlocks2.size());
+        Assert::IsTrue(std::as_const(vBlocks1.at(0)).GetBytes().Data() == std::as_const(vBlocks2.at(0)).GetBytes().Data());
+        Assert::IsTrue(std::as_const(vBlocks1.at(1)).GetBytes().Data() == std::as_const(vBlocks2.at(1)).GetBytes().Data());
+
+        // modified memory should not be shared
+        vMemory.at(256 * 1024 + 1) = 0x12;
+        std::vector<ra::data::CapturedMemoryBlock> vBlocks3;
+        emulator.CaptureMemory(vBlocks3, 0, gsl::narrow_cast<uint32_t>(vMemory.size()), 3);
+        Assert::AreEqual({ 2 }, vBlocks3.size());
+        Assert::IsFalse(std::as_const(vBlocks1.at(0)).GetBytes().Data() == std::as_const(vBlocks3.at(0)).GetBytes().Data());
+        Assert::IsFalse(std::as_const(vBlocks1.at(1)).GetBytes().Data() == std::as_const(vBlocks3.at(1)).GetBytes().Data());
+        Assert::AreEqual({ 0x12 }, std::as_const(vBlocks3.at(0)).GetBytes().Data()[256 * 1024 + 1]);
+        Assert::AreEqual({ 0x12 }, std::as_const(vBlocks3.at(1)).GetBytes().Data()[1]);
+    }
+
+    TEST_METHOD(TestDirtyPages)
+    {
+        EmulatorMemoryContextHarness emulator;
+        InitializePageMemory(emulator);
+        constexpr auto PAGE_SIZE = EmulatorMemoryContext::DIRTY_PAGE_SIZE;
+
+        // memory that isn't being monitored is always considered modified
+        Assert::IsTrue(emulator.IsMemoryModified(0x10, 4));
+
+        emulator.TrackDirtyPages({ { 0x10, 4 }, { PAGE_SIZE * 2 + 0x10, 4 } });
+
+        // newly monitored pages are considered modified until the next update
+        Assert::IsTrue(emulator.IsMemoryModified(0x10, 4));
+        Assert::IsTrue(emulator.IsMemoryModified(PAGE_SIZE * 2 + 0x10, 4));
+
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(0x10, 4));
+        Assert::IsFalse(emulator.IsMemoryModified(PAGE_SIZE - 4, 4));
+        Assert::IsTrue(emulator.IsMemoryModified(PAGE_SIZE - 4, 8)); // second page isn't monitored
+        Assert::IsTrue(emulator.IsMemoryModified(PAGE_SIZE + 0x10, 4));
+        Assert::IsFalse(emulator.IsMemoryModified(PAGE_SIZE * 2 + 0x10, 4));
+        Assert::IsFalse(emulator.IsMemoryModified(PAGE_SIZE * 2 + 0x10, 0));
+
+        // modifications are tracked per page
+        pageMemory.at(PAGE_SIZE * 2 + 0x100) = 0xFF;
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(0x10, 4));
+        Assert::IsTrue(emulator.IsMemoryModified(PAGE_SIZE * 2 + 0x10, 4));
+
+        // modifications are relative to the previous update
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(0x10, 4));
+        Assert::IsFalse(emulator.IsMemoryModified(PAGE_SIZE * 2 + 0x10, 4));
+
+        // writing the same value is not a modification
+        pageMemory.at(0x20) = 0x20;
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(0x10, 4));
+    }
+
+    TEST_METHOD(TestTrackDirtyPagesRetainsState)
+    {
+        EmulatorMemoryContextHarness emulator;
+        InitializePageMemory(emulator);
+        constexpr auto PAGE_SIZE = EmulatorMemoryContext::DIRTY_PAGE_SIZE;
+
+        // range spans the first two pages
+        emulator.TrackDirtyPages({ { PAGE_SIZE - 2, 4 } });
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(PAGE_SIZE - 2, 4));
+
+        pageMemory.at(PAGE_SIZE + 8) = 0xFF;
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(0, 4));
+        Assert::IsTrue(emulator.IsMemoryModified(PAGE_SIZE, 4));
+
+        // stop monitoring the first page, start monitoring the third page
+        emulator.TrackDirtyPages({ { PAGE_SIZE, 4 }, { PAGE_SIZE * 2, PAGE_SIZE } });
+        Assert::IsTrue(emulator.IsMemoryModified(0, 4));
+        Assert::IsTrue(emulator.IsMemoryModified(PAGE_SIZE, 4));
+        Assert::IsTrue(emulator.IsMemoryModified(PAGE_SIZE * 2, 4));
+
+        // second page should still be compared against the memory from the last update
+        pageMemory.at(PAGE_SIZE + 8) = 0x08;
+        emulator.UpdateDirtyPages();
+        Assert::IsTrue(emulator.IsMemoryModified(0, 4));
+        Assert::IsTrue(emulator.IsMemoryModified(PAGE_SIZE, 4));
+        Assert::IsFalse(emulator.IsMemoryModified(PAGE_SIZE * 2, 4));
+
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(PAGE_SIZE, PAGE_SIZE * 2));
+    }
+
+    TEST_METHOD(TestStopTrackingDirtyPages)
+    {
+        EmulatorMemoryContextHarness emulator;
+        InitializePageMemory(emulator);
+
+        emulator.TrackDirtyPages({ { 0x10, 4 } });
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(0x10, 4));
+
+        emulator.StopTrackingDirtyPages();
+        Assert::IsTrue(emulator.IsMemoryModified(0x10, 4));
+
+        emulator.UpdateDirtyPages();
+        Assert::IsTrue(emulator.IsMemoryModified(0x10, 4));
+
+        // changing the memory layout also stops monitoring
+        emulator.TrackDirtyPages({ { 0x10, 4 } });
+        emulator.UpdateDirtyPages();
+        Assert::IsFalse(emulator.IsMemoryModified(0x10, 4));
+
+        emulator.ClearMemoryBlocks();
+        Assert::IsTrue(emulator.IsMemoryModified(0x10, 4));
+    }
 };
 
 std::array<uint8_t, 64> EmulatorMemoryContext_Tests::memory;
+int EmulatorMemoryContext_Tests::nBlockReads = 0;
+int EmulatorMemoryContext_Tests::nByteReads = 0;
+std::array<uint8_t, EmulatorMemoryContext::DIRTY_PAGE_SIZE * 3> EmulatorMemoryContext_Tests::pageMemory;
 
 } // namespace tests
 } // namespace impl
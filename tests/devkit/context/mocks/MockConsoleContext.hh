@@ -24,11 +24,19 @@ public:
         m_sName = sName;
     }
 
-    void SetId(ConsoleID nId) noexcept { m_nId = nId; }
+    void SetId(ConsoleID nId)
+    {
+        m_nId = nId;
+        UpdateAddressTranslation();
+    }
 
     void SetName(std::wstring&& sName) noexcept { m_sName = std::move(sName); }
 
-    void ResetMemoryRegions() noexcept { m_vRegions.clear(); }
+    void ResetMemoryRegions()
+    {
+        m_vRegions.clear();
+        UpdateAddressTranslation();
+    }
 
     void AddMemoryRegion(ra::data::ByteAddress nStartAddress, ra::data::ByteAddress nEndAddress, 
         ra::data::MemoryRegion::Type nAddressType, const std::wstring& sDescription = L"")
@@ -42,6 +50,8 @@ public:
         auto& pRegion = m_vRegions.emplace_back(nStartAddress, nEndAddress, sDescription);
         pRegion.SetRealStartAddress(nRealAddress);
         pRegion.SetType(nAddressType);
+
+        UpdateAddressTranslation();
     }
 
 private:
@@ -0,0 +1,403 @@
+#include "data/CapturedMemoryBlock.hh"
+
+#include "testutil/CppUnitTest.hh"
+
+#include <thread>
+
+namespace ra {
+namespace data {
+namespace tests {
+
+TEST_CLASS(CapturedMemoryBlock_Tests)
+{
+private:
+    static constexpr uint32_t BLOCK_SIZE = 256;
+    static constexpr int THREAD_COUNT = 8;
+
+    // every block with the same seed has the same contents. the second half is filled so it can be compressed.
+    static void FillBlock(CapturedMemoryBlock& pBlock, uint8_t nSeed)
+    {
+        auto* pBytes = pBlock.GetBytes();
+        for (uint32_t i = 0; i < pBlock.GetBytesSize(); ++i)
+            pBytes[i] = (i < pBlock.GetBytesSize() / 2) ? gsl::narrow_cast<uint8_t>(nSeed + i) : nSeed;
+    }
+
+    static bool IsBlockFilled(const CapturedMemoryBlock& pBlock, uint8_t nSeed)
+    {
+        const auto pBytesView = pBlock.GetBytes();
+        const auto* pBytes = pBytesView.Data();
+        for (uint32_t i = 0; i < pBlock.GetBytesSize(); ++i)
+        {
+            const auto nExpected = (i < pBlock.GetBytesSize() / 2) ? gsl::narrow_cast<uint8_t>(nSeed + i) : nSeed;
+            if (pBytes[i] != nExpected)
+                return false;
+        }
+
+        return true;
+    }
+
+    static const uint8_t* GetSharedBytes(const CapturedMemoryBlock& pBlock) noexcept { return pBlock.GetBytes().Data(); }
+
+    // runs fWork on several threads at once and returns the number of threads that reported a failure
+    static int RunOnThreads(std::function<bool(int)> fWork)
+    {
+        std::atomic<int> nFailures{ 0 };
+        std::atomic<int> nWaiting{ THREAD_COUNT };
+        std::vector<std::thread> vThreads;
+        for (int nThread = 0; nThread < THREAD_COUNT; ++nThread)
+        {
+            vThreads.emplace_back([&fWork, &nFailures, &nWaiting, nThread]() {
+                // maximize contention by not starting until every thread is ready
+                --nWaiting;
+                while (nWaiting > 0)
+                    std::this_thread::yield();
+
+                if (!fWork(nThread))
+                    ++nFailures;
+            });
+        }
+
+        for (auto& pThread : vThreads)
+            pThread.join();
+
+        return nFailures;
+    }
+
+public:
+    TEST_METHOD(TestCopySharesBytes)
+    {
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock, 0x40);
+
+        const CapturedMemoryBlock pCopy(pBlock);
+        Assert::IsTrue(GetSharedBytes(pBlock) == GetSharedBytes(pCopy));
+        Assert::IsTrue(IsBlockFilled(pCopy, 0x40));
+    }
+
+    TEST_METHOD(TestModifyCopy)
+    {
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock, 0x40);
+
+        CapturedMemoryBlock pCopy(pBlock);
+        FillBlock(pCopy, 0x60);
+        Assert::IsFalse(GetSharedBytes(pBlock) == GetSharedBytes(pCopy));
+        Assert::IsTrue(IsBlockFilled(pBlock, 0x40));
+        Assert::IsTrue(IsBlockFilled(pCopy, 0x60));
+
+        // no longer shared, so doesn't have to be copied again
+        const auto* pBytes = GetSharedBytes(pCopy);
+        Assert::IsTrue(pBytes == pCopy.GetBytes());
+    }
+
+    TEST_METHOD(TestModifyOriginal)
+    {
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock, 0x40);
+
+        const CapturedMemoryBlock pCopy(pBlock);
+        FillBlock(pBlock, 0x60);
+        Assert::IsTrue(IsBlockFilled(pBlock, 0x60));
+        Assert::IsTrue(IsBlockFilled(pCopy, 0x40));
+    }
+
+    TEST_METHOD(TestOptimizeMemory)
+    {
+        CapturedMemoryBlock pBlock1(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock1, 0x40);
+        CapturedMemoryBlock pBlock2(0x2000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock2, 0x40);
+        Assert::IsFalse(GetSharedBytes(pBlock1) == GetSharedBytes(pBlock2));
+
+        pBlock1.OptimizeMemory();
+        pBlock2.OptimizeMemory();
+        Assert::IsTrue(GetSharedBytes(pBlock1) == GetSharedBytes(pBlock2));
+
+        FillBlock(pBlock2, 0x60);
+        Assert::IsTrue(IsBlockFilled(pBlock1, 0x40));
+        Assert::IsTrue(IsBlockFilled(pBlock2, 0x60));
+    }
+
+    TEST_METHOD(TestOptimizeMemoryCopy)
+    {
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock, 0x40);
+        CapturedMemoryBlock pCopy(pBlock);
+
+        // optimizing a copy shouldn't stop it from sharing memory with the original
+        pCopy.OptimizeMemory();
+        pBlock.OptimizeMemory();
+        Assert::IsTrue(GetSharedBytes(pBlock) == GetSharedBytes(pCopy));
+    }
+
+    TEST_METHOD(TestCompressCopy)
+    {
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock, 0x40);
+
+        CapturedMemoryBlock pCopy(pBlock);
+        pCopy.CompressBytes();
+        Assert::IsTrue(pCopy.IsCompressed());
+        Assert::IsFalse(pBlock.IsCompressed());
+
+        Assert::IsTrue(IsBlockFilled(pCopy, 0x40));
+        Assert::IsTrue(IsBlockFilled(pBlock, 0x40));
+
+        // reading through the const accessor shouldn't undo the compression
+        Assert::IsTrue(pCopy.IsCompressed());
+    }
+
+    TEST_METHOD(TestReadCompressedBlocks)
+    {
+        CapturedMemoryBlock pBlock1(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock1, 0x40);
+        pBlock1.CompressBytes();
+        CapturedMemoryBlock pBlock2(0x2000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock2, 0x60);
+        pBlock2.CompressBytes();
+
+        // alternate between blocks to make sure each read decodes the correct block
+        Assert::IsTrue(IsBlockFilled(pBlock1, 0x40));
+        Assert::IsTrue(IsBlockFilled(pBlock2, 0x60));
+        Assert::IsTrue(IsBlockFilled(pBlock1, 0x40));
+        Assert::IsTrue(pBlock1.IsCompressed());
+        Assert::IsTrue(pBlock2.IsCompressed());
+    }
+
+    TEST_METHOD(TestReadCompressedBlocksAtOnce)
+    {
+        CapturedMemoryBlock pBlock1(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock1, 0x40);
+        pBlock1.CompressBytes();
+        CapturedMemoryBlock pBlock2(0x2000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock2, 0x60);
+        pBlock2.CompressBytes();
+
+        // decoding the second block must not overwrite the bytes still being viewed from the first
+        const auto pBytes1 = std::as_const(pBlock1).GetBytes();
+        const auto pBytes2 = std::as_const(pBlock2).GetBytes();
+        Assert::IsFalse(pBytes1.Data() == pBytes2.Data());
+        Assert::AreEqual({ 0x40 }, pBytes1.Data()[0]);
+        Assert::AreEqual({ 0x60 }, pBytes2.Data()[0]);
+        Assert::AreEqual({ 0x40 }, pBytes1.Data()[BLOCK_SIZE - 1]);
+        Assert::AreEqual({ 0x60 }, pBytes2.Data()[BLOCK_SIZE - 1]);
+
+        // the decoded bytes are still valid after the block is read again
+        Assert::IsTrue(IsBlockFilled(pBlock1, 0x40));
+        Assert::AreEqual({ 0x60 }, pBytes2.Data()[0]);
+    }
+
+    TEST_METHOD(TestDecompressCopies)
+    {
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock, 0x40);
+        pBlock.CompressBytes();
+        CapturedMemoryBlock pCopy(pBlock);
+
+        pBlock.DecompressBytes();
+        Assert::IsFalse(pBlock.IsCompressed());
+        Assert::IsTrue(pCopy.IsCompressed());
+        pBlock.OptimizeMemory();
+
+        // the copy should find the bytes decompressed by the original
+        pCopy.DecompressBytes();
+        pCopy.OptimizeMemory();
+        Assert::IsTrue(GetSharedBytes(pBlock) == GetSharedBytes(pCopy));
+        Assert::IsTrue(IsBlockFilled(pCopy, 0x40));
+    }
+
+    TEST_METHOD(TestConcurrentReadCompressed)
+    {
+        std::vector<CapturedMemoryBlock> vBlocks;
+        vBlocks.reserve(16);
+        for (uint8_t i = 0; i < 16; ++i)
+        {
+            auto& pBlock = vBlocks.emplace_back(0x1000 * i, BLOCK_SIZE, BLOCK_SIZE);
+            FillBlock(pBlock, i);
+            pBlock.CompressBytes();
+        }
+
+        // every thread reads every block, so they're all decoding the same compressed memory at once
+        const auto& vConstBlocks = vBlocks;
+        const int nFailures = RunOnThreads([&vConstBlocks](int nThread) {
+            for (int nIteration = 0; nIteration < 2000; ++nIteration)
+            {
+                const auto nIndex = gsl::narrow_cast<uint8_t>((nIteration + nThread) % vConstBlocks.size());
+                if (!IsBlockFilled(vConstBlocks.at(nIndex), nIndex))
+                    return false;
+            }
+
+            return true;
+        });
+
+        Assert::AreEqual(0, nFailures);
+
+        for (uint8_t i = 0; i < 16; ++i)
+            Assert::IsTrue(vBlocks.at(i).IsCompressed());
+    }
+
+    TEST_METHOD(TestCopyMatchingAddresses)
+    {
+        // more addresses than can be stored without allocating, but few enough matches that the count
+        // alone would indicate they don't need to be allocated
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+        {
+            if (i % 64 != 0)
+                pBlock.ExcludeMatchingAddress(0x1000 + i);
+        }
+        Assert::AreEqual(4U, pBlock.GetMatchingAddressCount());
+
+        CapturedMemoryBlock pCopy(pBlock);
+        Assert::AreEqual(4U, pCopy.GetMatchingAddressCount());
+        Assert::IsTrue(pCopy.ContainsMatchingAddress(0x1040));
+        Assert::IsFalse(pCopy.ContainsMatchingAddress(0x1041));
+        Assert::AreEqual({ 0x10C0 }, pCopy.GetMatchingAddress(3));
+
+        // the copy has its own matching addresses
+        pCopy.ExcludeMatchingAddress(0x1040);
+        Assert::IsFalse(pCopy.ContainsMatchingAddress(0x1040));
+        Assert::IsTrue(pBlock.ContainsMatchingAddress(0x1040));
+        Assert::AreEqual(4U, pBlock.GetMatchingAddressCount());
+    }
+
+    TEST_METHOD(TestMoveMatchingAddresses)
+    {
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+        {
+            if (i % 64 != 0)
+                pBlock.ExcludeMatchingAddress(0x1000 + i);
+        }
+
+        const CapturedMemoryBlock pMoved(std::move(pBlock));
+        Assert::AreEqual(4U, pMoved.GetMatchingAddressCount());
+        Assert::IsTrue(pMoved.ContainsMatchingAddress(0x1080));
+        Assert::IsFalse(pMoved.ContainsMatchingAddress(0x1081));
+        Assert::AreEqual({ 0x1040 }, pMoved.GetMatchingAddress(1));
+    }
+
+    TEST_METHOD(TestConcurrentCopyAndDestroy)
+    {
+        // the originals are only read by the threads, so may be used by all of them at once
+        std::vector<CapturedMemoryBlock> vBlocks;
+        vBlocks.reserve(16);
+        for (uint8_t i = 0; i < 16; ++i)
+        {
+            auto& pBlock = vBlocks.emplace_back(0x1000 * i, BLOCK_SIZE, BLOCK_SIZE);
+            FillBlock(pBlock, i);
+            if (i & 1)
+                pBlock.OptimizeMemory();
+        }
+
+        const int nFailures = RunOnThreads([&vBlocks](int nThread) {
+            for (int nIteration = 0; nIteration < 2000; ++nIteration)
+            {
+                const auto nIndex = gsl::narrow_cast<uint8_t>((nIteration + nThread) % vBlocks.size());
+                std::vector<CapturedMemoryBlock> vCopies;
+                vCopies.reserve(2);
+                vCopies.emplace_back(vBlocks.at(nIndex));
+                vCopies.emplace_back(vCopies.back());
+
+                switch (nIteration % 4)
+                {
+                    case 0:
+                        vCopies.front().OptimizeMemory();
+                        break;
+                    case 1:
+                        vCopies.front().CompressBytes();
+                        break;
+                    case 2:
+                        FillBlock(vCopies.front(), gsl::narrow_cast<uint8_t>(nIndex + 0x80));
+                        if (!IsBlockFilled(vCopies.front(), gsl::narrow_cast<uint8_t>(nIndex + 0x80)))
+                            return false;
+                        break;
+                }
+
+                if (!IsBlockFilled(vCopies.back(), nIndex) || !IsBlockFilled(vBlocks.at(nIndex), nIndex))
+                    return false;
+            }
+
+            return true;
+        });
+
+        Assert::AreEqual(0, nFailures);
+
+        for (uint8_t i = 0; i < 16; ++i)
+            Assert::IsTrue(IsBlockFilled(vBlocks.at(i), i));
+    }
+
+    TEST_METHOD(TestConcurrentOptimizeMemory)
+    {
+        // every thread captures the same contents, so they compete to find and release the same shared memory
+        const int nFailures = RunOnThreads([](int nThread) {
+            for (int nIteration = 0; nIteration < 500; ++nIteration)
+            {
+                std::vector<CapturedMemoryBlock> vBlocks;
+                vBlocks.reserve(8);
+                for (uint8_t i = 0; i < 8; ++i)
+                {
+                    auto& pBlock = vBlocks.emplace_back(0x1000 * i, BLOCK_SIZE, BLOCK_SIZE);
+                    FillBlock(pBlock, i);
+                    pBlock.OptimizeMemory();
+                }
+
+                // modifying a shared block must not affect the other threads
+                FillBlock(vBlocks.at(nThread % 8), 0xFF);
+
+                for (uint8_t i = 0; i < 8; ++i)
+                {
+                    const uint8_t nSeed = (i == nThread % 8) ? 0xFF : i;
+                    if (!IsBlockFilled(vBlocks.at(i), nSeed))
+                        return false;
+                }
+            }
+
+            return true;
+        });
+
+        Assert::AreEqual(0, nFailures);
+    }
+
+    TEST_METHOD(TestConcurrentRelease)
+    {
+        CapturedMemoryBlock pBlock(0x1000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock, 0x40);
+        pBlock.OptimizeMemory();
+
+        // every copy shares the same memory. each thread releases its copies while the others do the same.
+        std::vector<std::vector<CapturedMemoryBlock>> vCopies(THREAD_COUNT);
+        for (auto& vThreadCopies : vCopies)
+        {
+            vThreadCopies.reserve(1000);
+            for (int i = 0; i < 1000; ++i)
+                vThreadCopies.emplace_back(pBlock);
+        }
+
+        const int nFailures = RunOnThreads([&vCopies](int nThread) {
+            auto& vThreadCopies = vCopies.at(nThread);
+            while (!vThreadCopies.empty())
+            {
+                if (!IsBlockFilled(vThreadCopies.back(), 0x40))
+                    return false;
+
+                vThreadCopies.pop_back();
+            }
+
+            return true;
+        });
+
+        Assert::AreEqual(0, nFailures);
+        Assert::IsTrue(IsBlockFilled(pBlock, 0x40));
+
+        // the memory is still registered, so an identical block should find it
+        CapturedMemoryBlock pBlock2(0x2000, BLOCK_SIZE, BLOCK_SIZE);
+        FillBlock(pBlock2, 0x40);
+        pBlock2.OptimizeMemory();
+        Assert::IsTrue(GetSharedBytes(pBlock) == GetSharedBytes(pBlock2));
+    }
+};
+
+} // namespace tests
+} // namespace data
+} // namespace ra
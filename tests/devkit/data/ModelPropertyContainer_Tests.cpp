@@ -141,6 +141,31 @@ public:
         Assert::AreEqual(0, container.GetInt());
         Assert::AreEqual(false, container.GetBool());
     }
+
+    TEST_METHOD(TestManyProperties)
+    {
+        ModelPropertyContainerHarness container;
+        container.SetString(L"Test");
+
+        // properties created after the container has values have keys outside of the allocated storage
+        std::vector<std::unique_ptr<IntModelProperty>> vProperties;
+        for (int i = 0; i < 100; ++i)
+            vProperties.push_back(std::make_unique<IntModelProperty>("ModelPropertyContainerHarness", "Many", 0));
+
+        for (int i = 0; i < 100; ++i)
+            container.SetValue(*vProperties.at(i), i + 1);
+
+        for (int i = 0; i < 100; ++i)
+            Assert::AreEqual(i + 1, container.GetValue(*vProperties.at(i)));
+
+        for (int i = 0; i < 100; i += 2)
+            container.SetValue(*vProperties.at(i), 0);
+
+        for (int i = 0; i < 100; ++i)
+            Assert::AreEqual((i % 2) ? i + 1 : 0, container.GetValue(*vProperties.at(i)));
+
+        Assert::AreEqual(std::wstring(L"Test"), container.GetString());
+    }
 };
 
 } // namespace tests
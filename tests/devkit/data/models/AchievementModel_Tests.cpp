@@ -243,6 +243,38 @@ public:
         Assert::IsTrue(g_bEventSeen);
     }
 
+    TEST_METHOD(TestDoFrameSyncsStateFromRuntime)
+    {
+        AchievementModelHarness achievement;
+        achievement.mockGameContext.SetGameId(22);
+        achievement.SetID(53U);
+        achievement.SetTrigger("0xH1234=1_T:0xH2345=2");
+        achievement.CreateServerCheckpoint();
+        achievement.CreateLocalCheckpoint();
+
+        auto* achievement_info = achievement.mockRcClient.MockAchievement(achievement.GetID());
+        Expects(achievement_info != nullptr);
+        achievement.SetLocalAchievementInfo(*achievement_info);
+
+        achievement.SetState(AssetState::Active);
+        auto* pTrigger = achievement.GetMutableRuntimeTrigger();
+        Expects(pTrigger != nullptr);
+
+        pTrigger->state = RC_TRIGGER_STATE_PRIMED;
+        achievement.DoFrame();
+        Assert::AreEqual(AssetState::Primed, achievement.GetState());
+
+        achievement.DoFrame();
+        Assert::AreEqual(AssetState::Primed, achievement.GetState());
+
+        // model changed without the runtime state changing since the last frame. should still resync.
+        achievement.SetState(AssetState::Active);
+        Assert::AreEqual({RC_TRIGGER_STATE_ACTIVE}, pTrigger->state);
+        pTrigger->state = RC_TRIGGER_STATE_PRIMED;
+        achievement.DoFrame();
+        Assert::AreEqual(AssetState::Primed, achievement.GetState());
+    }
+
     TEST_METHOD(TestDeleteHidesIndicator)
     {
         AchievementModelHarness achievement;
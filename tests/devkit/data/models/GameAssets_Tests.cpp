@@ -810,6 +810,103 @@ public:
             GameAssets::FirstLocalId);
         Assert::AreEqual(sExpected, gameAssets.GetUserFile());
     }
+
+    TEST_METHOD(TestFindAssetAfterIdChange)
+    {
+        GameAssetsHarness gameAssets;
+        gameAssets.AddThreeAchievements();
+
+        auto* pAsset = gameAssets.FindAchievement({ 2U });
+        Assert::IsNotNull(pAsset);
+        Ensures(pAsset != nullptr);
+
+        pAsset->SetID(7U);
+        Assert::IsNull(gameAssets.FindAchievement({ 2U }));
+        Assert::IsTrue(pAsset == gameAssets.FindAchievement({ 7U }));
+
+        // same ID, different type
+        Assert::IsNull(gameAssets.FindLeaderboard({ 7U }));
+    }
+
+    TEST_METHOD(TestFindAssetWhileUpdating)
+    {
+        GameAssetsHarness gameAssets;
+        gameAssets.AddThreeAchievements();
+
+        gameAssets.BeginUpdate();
+        auto& pAchievement = gameAssets.AddAchievement(AssetCategory::Core, 5, L"Ach4", L"Desc4", L"44444", "4=4");
+        Assert::IsTrue(&pAchievement == gameAssets.FindAchievement({ 4U }));
+
+        gameAssets.RemoveAt(0);
+        Assert::IsNull(gameAssets.FindAchievement({ 1U }));
+        gameAssets.EndUpdate();
+
+        Assert::IsTrue(&pAchievement == gameAssets.FindAchievement({ 4U }));
+        Assert::IsNull(gameAssets.FindAchievement({ 1U }));
+        Assert::IsNotNull(gameAssets.FindAchievement({ 3U }));
+    }
+
+    TEST_METHOD(TestFindAssetAfterIdChangeWhileMoved)
+    {
+        GameAssetsHarness gameAssets;
+        gameAssets.AddThreeAchievements();
+
+        auto* pAsset = gameAssets.FindAchievement({ 2U });
+        Expects(pAsset != nullptr);
+
+        // removing the first item moves the others, so the ID change isn't reported until the update completes
+        gameAssets.BeginUpdate();
+        gameAssets.RemoveAt(0);
+        pAsset->SetID(7U);
+        gameAssets.EndUpdate();
+
+        Assert::IsNull(gameAssets.FindAchievement({ 2U }));
+        Assert::IsTrue(pAsset == gameAssets.FindAchievement({ 7U }));
+
+        // the old ID must not still refer to the removed asset
+        gameAssets.RemoveAt(0);
+        Assert::IsNull(gameAssets.FindAchievement({ 2U }));
+        Assert::IsNull(gameAssets.FindAchievement({ 7U }));
+        Assert::IsNotNull(gameAssets.FindAchievement({ 3U }));
+    }
+
+    TEST_METHOD(TestFindAssetAfterIdChangeWhileMovedAndRemoved)
+    {
+        GameAssetsHarness gameAssets;
+        gameAssets.AddThreeAchievements();
+
+        auto* pAsset = gameAssets.FindAchievement({ 2U });
+        Expects(pAsset != nullptr);
+
+        gameAssets.BeginUpdate();
+        gameAssets.RemoveAt(0);
+        pAsset->SetID(7U);
+        gameAssets.RemoveAt(0);
+        gameAssets.EndUpdate();
+
+        Assert::IsNull(gameAssets.FindAchievement({ 2U }));
+        Assert::IsNull(gameAssets.FindAchievement({ 7U }));
+        Assert::IsNotNull(gameAssets.FindAchievement({ 3U }));
+    }
+
+    TEST_METHOD(TestGetPauseOnResetAchievements)
+    {
+        GameAssetsHarness gameAssets;
+        gameAssets.AddThreeAchievements();
+        Assert::IsFalse(gameAssets.HasPauseOnXAssets());
+        Assert::AreEqual({ 0U }, gameAssets.GetPauseOnResetAchievements().size());
+
+        auto* pAsset = gameAssets.FindAchievement({ 2U });
+        Expects(pAsset != nullptr);
+        pAsset->SetPauseOnReset(true);
+        Assert::IsTrue(gameAssets.HasPauseOnXAssets());
+        Assert::AreEqual({ 1U }, gameAssets.GetPauseOnResetAchievements().size());
+        Assert::IsTrue(pAsset == gameAssets.GetPauseOnResetAchievements().at(0));
+
+        gameAssets.RemoveAt(1);
+        Assert::IsFalse(gameAssets.HasPauseOnXAssets());
+        Assert::AreEqual({ 0U }, gameAssets.GetPauseOnResetAchievements().size());
+    }
 };
 
 } // namespace tests
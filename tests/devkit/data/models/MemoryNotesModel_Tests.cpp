@@ -6,6 +6,7 @@
 #include "tests/devkit/context/mocks/MockEmulatorMemoryContext.hh"
 #include "tests/devkit/context/mocks/MockRcClient.hh"
 #include "tests/devkit/context/mocks/MockUserContext.hh"
+#include "tests/devkit/services/mocks/MockThreadPool.hh"
 #include "tests/devkit/testutil/AssetAsserts.hh"
 #include "tests/devkit/testutil/MemoryAsserts.hh"
 
@@ -48,6 +49,11 @@ private:
                 []() {});
         }
 
+        void SetMemoryNoteMovedFunction(MemoryNoteMovedFunction fMemoryNoteMoved)
+        {
+            m_fMemoryNoteMoved = fMemoryNoteMoved;
+        }
+
         void MonitorNoteChanges()
         {
             m_fMemoryNoteChanged = [this](ra::data::ByteAddress nAddress, const std::wstring& sNewNote) {
@@ -61,6 +67,8 @@ private:
         }
 
         using MemoryNotesModel::AddMemoryNote;
+        using MemoryNotesModel::AddServerMemoryNotes;
+        using MemoryNotesModel::ServerMemoryNote;
 
         void AssertNoNote(ra::data::ByteAddress nAddress)
         {
@@ -212,17 +220,16 @@ public:
         }));
 
         notes.InitializeNotes(1U);
-        Assert::AreEqual({3U}, notes.mNewNotes.size());
 
-        notes.AssertNote(1234U, L"Note1");
-        Assert::AreEqual(std::wstring(L"Note1"), notes.mNewNotes[1234U]);
+        // notes loaded from the server are reported by the completion callback, not individually
+        Assert::AreEqual({0U}, notes.mNewNotes.size());
+        Assert::AreEqual({3U}, notes.NoteCount());
 
+        notes.AssertNote(1234U, L"Note1");
         notes.AssertNote(2345U, L"Note2");
-        Assert::AreEqual(std::wstring(L"Note2"), notes.mNewNotes[2345U]);
 
         // newlines should be normalized when loaded into the note.
         notes.AssertNote(3456U, L"Note3\r\nSubNote3");
-        Assert::AreEqual(std::wstring(L"Note3\r\nSubNote3"), notes.mNewNotes[3456U]);
 
         const auto* pNote4 = notes.FindNote(4567U);
         Assert::IsNull(pNote4);
@@ -233,6 +240,50 @@ public:
         Assert::AreEqual({0U}, notes.mNewNotes.size());
     }
 
+    TEST_METHOD(TestAddServerMemoryNotesParallel)
+    {
+        MemoryNotesModelHarness notes;
+        notes.MonitorNoteChanges();
+        ra::services::mocks::MockThreadPool mockThreadPool;
+        mockThreadPool.SetSynchronous(true);
+
+        // enough notes to be split across the thread pool, returned in descending address order
+        std::vector<std::string> vNoteText;
+        for (int i = 0; i < 4000; ++i)
+            vNoteText.push_back(ra::util::String::Printf("Note%d", i));
+
+        std::vector<MemoryNotesModelHarness::ServerMemoryNote> vNotes;
+        for (int i = 0; i < 4000; ++i)
+            vNotes.push_back({ gsl::narrow_cast<ra::data::ByteAddress>(0x10000 - i * 4), "Author", vNoteText.at(i).c_str() });
+        vNotes.push_back({ 12, "Author", "Bomb Timer Pointer (24-bit)\n+03 - Bombs Defused\n+04 - Bomb Timer" });
+        vNotes.push_back({ 0x10000, "Author2", "Replaced" });
+
+        notes.AddServerMemoryNotes(vNotes);
+
+        Assert::AreEqual({0U}, notes.mNewNotes.size());
+        Assert::AreEqual({4001U}, notes.NoteCount());
+        Assert::AreEqual({12U}, notes.FirstNoteAddress());
+        notes.AssertNote(0x10000U - 4, L"Note1");
+        notes.AssertNote(0x10000U - 3999 * 4, L"Note3999");
+
+        // if the server returns multiple notes for an address, the last one wins
+        notes.AssertNote(0x10000U, L"Replaced");
+        const auto* pNote = notes.FindMemoryNoteModel(0x10000U);
+        Assert::IsNotNull(pNote);
+        Ensures(pNote != nullptr);
+        Assert::AreEqual(std::string("Author2"), pNote->GetAuthor());
+
+        // pointer notes should be indexed
+        std::array<unsigned char, 32> memory{};
+        notes.mockEmulatorMemoryContext.MockMemory(memory);
+        memory.at(12) = 0x04;
+        notes.DoFrame();
+
+        notes.AssertNote(4+3U, L"Bombs Defused", Memory::Size::Unknown, 1);
+        notes.AssertNote(4+4U, L"Bomb Timer", Memory::Size::Unknown, 1);
+        Assert::AreEqual({12U}, notes.GetIndirectSource(4+4U));
+    }
+
     TEST_METHOD(TestFindNoteSized)
     {
         MemoryNotesModelHarness notes;
@@ -1001,6 +1052,33 @@ public:
         Assert::AreEqual({0U}, notes.mNewNotes.size());
     }
 
+    TEST_METHOD(TestDoFrameMovedNoteIndexedBeforeCallback)
+    {
+        MemoryNotesModelHarness notes;
+
+        std::array<unsigned char, 32> memory{};
+        notes.mockEmulatorMemoryContext.MockMemory(memory);
+        memory.at(0) = 16;
+
+        notes.AddMemoryNote(0x0000, "Author",
+            L"Pointer (8-bit)\n"
+            L"+2 = Medium (16-bit)");
+        notes.DoFrame();
+
+        // handlers look up the note at the new address. it should already be found there.
+        std::map<ra::data::ByteAddress, std::wstring> mFoundNotes;
+        notes.SetMemoryNoteMovedFunction([&notes, &mFoundNotes](ra::data::ByteAddress, ra::data::ByteAddress nNewAddress, const std::wstring&) {
+            const auto* pNote = notes.FindNote(nNewAddress);
+            mFoundNotes[nNewAddress] = (pNote != nullptr) ? *pNote : L"";
+        });
+
+        memory.at(0) = 8;
+        notes.DoFrame();
+
+        Assert::AreEqual({ 1U }, mFoundNotes.size());
+        Assert::AreEqual(std::wstring(L"Medium (16-bit)"), mFoundNotes[0x0A]);
+    }
+
     TEST_METHOD(TestDoFrameRealAddressConversion)
     {
         MemoryNotesModelHarness notes;
@@ -1242,6 +1320,95 @@ public:
         Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x08));
     }
 
+    TEST_METHOD(TestGetIndirectSourceMultiplePointers)
+    {
+        MemoryNotesModelHarness notes;
+
+        std::array<unsigned char, 64> memory{};
+        notes.mockEmulatorMemoryContext.MockMemory(memory);
+        memory.at(0) = 16;
+        memory.at(1) = 32;
+
+        notes.AddMemoryNote(0x0000, "Author", L"Pointer (8-bit)\n+1 = First (8-bit)\n+2 = Second (16-bit)");
+        notes.AddMemoryNote(0x0001, "Author", L"Pointer (8-bit)\n+1 = Third (8-bit)\n+4 = Fourth (32-bit)");
+        notes.DoFrame();
+
+        Assert::AreEqual(0x0U, notes.GetIndirectSource(0x11));
+        Assert::AreEqual(0x0U, notes.GetIndirectSource(0x12));
+        Assert::AreEqual(0x1U, notes.GetIndirectSource(0x21));
+        Assert::AreEqual(0x1U, notes.GetIndirectSource(0x24));
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x25));
+        Assert::AreEqual({0x24U}, notes.FindNoteStart(0x27));
+        Assert::AreEqual({0x21U}, notes.GetNextNoteAddress(0x12, true));
+        Assert::AreEqual({0x12U}, notes.GetPreviousNoteAddress(0x21, true));
+
+        // when the pointers overlap, the note from the first pointer is used
+        memory.at(1) = 16;
+        notes.DoFrame();
+
+        notes.AssertNote(0x11U, L"First (8-bit)");
+        Assert::AreEqual(0x0U, notes.GetIndirectSource(0x11));
+        Assert::AreEqual(0x1U, notes.GetIndirectSource(0x14));
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x21));
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x24));
+        Assert::AreEqual({0x12U}, notes.GetNextNoteAddress(0x11, true));
+        Assert::AreEqual({0x14U}, notes.GetNextNoteAddress(0x12, true));
+
+        // pointer replaced with a non-pointer note
+        notes.AddMemoryNote(0x0000, "Author", L"Not a pointer");
+        notes.AssertNote(0x11U, L"Third (8-bit)");
+        Assert::AreEqual(0x1U, notes.GetIndirectSource(0x11));
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x12));
+        Assert::AreEqual({0x14U}, notes.GetNextNoteAddress(0x11, true));
+
+        // pointer note removed
+        notes.SetNote(0x0001, L"");
+        notes.AssertNoNote(0x11U);
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x14));
+        Assert::AreEqual(0xFFFFFFFF, notes.GetNextNoteAddress(0x11, true));
+    }
+
+    TEST_METHOD(TestGetIndirectSourceLargeField)
+    {
+        MemoryNotesModelHarness notes;
+
+        std::array<unsigned char, 64> memory{};
+        notes.mockEmulatorMemoryContext.MockMemory(memory);
+        memory.at(0) = 0x10;
+        memory.at(1) = 0x30;
+
+        notes.AddMemoryNote(0x0000, "Author", L"Pointer (8-bit)\n+1 = Table (1024 bytes)\n+0x420 = Flag (8-bit)");
+        notes.AddMemoryNote(0x0001, "Author", L"Pointer (8-bit)\n+0x100 = Other (8-bit)");
+        notes.DoFrame();
+
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x10));
+        Assert::AreEqual(0x0U, notes.GetIndirectSource(0x11));
+        Assert::AreEqual({0x11U}, notes.FindNoteStart(0x300));
+        Assert::AreEqual({0x11U}, notes.FindNoteStart(0x410));
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x411));
+        Assert::AreEqual(0x0U, notes.GetIndirectSource(0x430));
+        Assert::AreEqual(0x1U, notes.GetIndirectSource(0x130));
+
+        // pointer moves
+        memory.at(0) = 0x20;
+        notes.DoFrame();
+
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x11));
+        Assert::AreEqual(0x0U, notes.GetIndirectSource(0x21));
+        Assert::AreEqual({0x21U}, notes.FindNoteStart(0x420));
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x430));
+        Assert::AreEqual(0x0U, notes.GetIndirectSource(0x440));
+        Assert::AreEqual(0x1U, notes.GetIndirectSource(0x130));
+        Assert::AreEqual({0x21U}, notes.FindNoteStart(0x131));
+        Assert::AreEqual({0x440U}, notes.GetNextNoteAddress(0x421, true));
+
+        // pointer note removed
+        notes.SetNote(0x0000, L"");
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x21));
+        Assert::AreEqual(0xFFFFFFFF, notes.GetIndirectSource(0x440));
+        Assert::AreEqual(0x1U, notes.GetIndirectSource(0x130));
+    }
+
     TEST_METHOD(TestGetIndirectSourceOverflow)
     {
         MemoryNotesModelHarness notes;
@@ -0,0 +1,93 @@
+#include "services\ParallelPartitions.hh"
+
+#include "services\mocks\MockThreadPool.hh"
+
+#include "testutil\CppUnitTest.hh"
+
+#include <stdexcept>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(ParallelPartitions_Tests)
+{
+public:
+    TEST_METHOD(TestNoThreadPool)
+    {
+        std::vector<size_t> vProcessed;
+        ProcessPartitions(5, [&vProcessed](size_t nPartition) { vProcessed.push_back(nPartition); });
+
+        // without a thread pool, the partitions are processed in order on the calling thread
+        Assert::AreEqual({ 5U }, vProcessed.size());
+        for (size_t i = 0; i < vProcessed.size(); ++i)
+            Assert::AreEqual(i, vProcessed.at(i));
+    }
+
+    TEST_METHOD(TestNoPartitions)
+    {
+        ra::services::mocks::MockThreadPool mockThreadPool;
+
+        int nCalls = 0;
+        ProcessPartitions(0, [&nCalls](size_t) noexcept { ++nCalls; });
+
+        Assert::AreEqual(0, nCalls);
+        Assert::AreEqual({ 0U }, mockThreadPool.PendingTasks());
+    }
+
+    TEST_METHOD(TestThreadPoolBusy)
+    {
+        ra::services::mocks::MockThreadPool mockThreadPool;
+
+        // the queued helpers never start, so the calling thread has to process every partition
+        std::vector<int> vProcessed(8);
+        ProcessPartitions(vProcessed.size(), [&vProcessed](size_t nPartition) { ++vProcessed.at(nPartition); });
+
+        for (const auto nCount : vProcessed)
+            Assert::AreEqual(1, nCount);
+
+        // helpers that start after everything has been processed shouldn't do anything
+        while (mockThreadPool.PendingTasks() > 0)
+            mockThreadPool.ExecuteNextTask();
+
+        for (const auto nCount : vProcessed)
+            Assert::AreEqual(1, nCount);
+    }
+
+    TEST_METHOD(TestThreadPoolSynchronous)
+    {
+        ra::services::mocks::MockThreadPool mockThreadPool;
+        mockThreadPool.SetSynchronous(true);
+
+        std::vector<int> vProcessed(8);
+        ProcessPartitions(vProcessed.size(), [&vProcessed](size_t nPartition) { ++vProcessed.at(nPartition); });
+
+        for (const auto nCount : vProcessed)
+            Assert::AreEqual(1, nCount);
+    }
+
+    TEST_METHOD(TestException)
+    {
+        ra::services::mocks::MockThreadPool mockThreadPool;
+
+        std::vector<int> vProcessed(8);
+        Assert::ExpectException<std::runtime_error>([&vProcessed]() {
+            ProcessPartitions(vProcessed.size(), [&vProcessed](size_t nPartition) {
+                ++vProcessed.at(nPartition);
+                if (nPartition == 2)
+                    throw std::runtime_error("failed");
+            });
+        });
+
+        // the exception should not be raised until the partition that threw it is complete
+        Assert::AreEqual(1, vProcessed.at(0));
+        Assert::AreEqual(1, vProcessed.at(1));
+        Assert::AreEqual(1, vProcessed.at(2));
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
@@ -19,6 +19,8 @@ public:
     {
     }
 
+    using IThreadPool::RunAsync;
+
     void RunAsync(std::function<void()>&& f) override
     {
         if (m_bSynchronous)
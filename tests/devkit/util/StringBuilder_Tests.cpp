@@ -103,6 +103,7 @@ public:
 
         Assert::AreEqual(std::string("This is a test."), ra::util::String::Printf("This is a %s.", "test"));
         Assert::AreEqual(std::string("1, 2, 3, 4"), ra::util::String::Printf("%d, %u, %zu, %li", 1, 2U, (size_t)3U, 4L));
+        Assert::AreEqual(std::string("-5, 6"), ra::util::String::Printf("%lld, %llu", -5LL, 6ULL));
         Assert::AreEqual(std::string("53.45%"), ra::util::String::Printf("%.2f%%", 53.45f));
         Assert::AreEqual(std::string("Nothing to replace"), ra::util::String::Printf("Nothing to replace"));
         Assert::AreEqual(std::string(), ra::util::String::Printf(""));
@@ -134,6 +135,7 @@ public:
 
         Assert::AreEqual(std::wstring(L"This is a test."), ra::util::String::Printf(L"This is a %s.", "test"));
         Assert::AreEqual(std::wstring(L"1, 2, 3, 4"), ra::util::String::Printf(L"%d, %u, %zu, %li", 1, 2U, (size_t)3U, 4L));
+        Assert::AreEqual(std::wstring(L"-5, 6"), ra::util::String::Printf(L"%lld, %llu", -5LL, 6ULL));
         Assert::AreEqual(std::wstring(L"53.45%"), ra::util::String::Printf(L"%.2f%%", 53.45f));
         Assert::AreEqual(std::wstring(L"Nothing to replace"), ra::util::String::Printf(L"Nothing to replace"));
         Assert::AreEqual(std::wstring(), ra::util::String::Printf(L""));
@@ -117,6 +117,9 @@ public:
         Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::Badge, L"12345"), std::wstring(L".\\RACache\\Badge\\12345.png"));
         Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::UserPic, L"12345"), std::wstring(L".\\RACache\\UserPic\\12345.png"));
         Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::Bookmarks, L"12345"), std::wstring(L".\\RACache\\Bookmarks\\12345-Bookmarks.json"));
+        Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::SessionStats, L"User"), std::wstring(L".\\RACache\\User-history.txt"));
+        Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::SessionHistory, L"User"), std::wstring(L".\\RACache\\User-history.dat"));
+        Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::SessionHistoryBackup, L"User"), std::wstring(L".\\RACache\\User-history.bak"));
         Assert::AreEqual(storage.GetPath(ra::services::StorageItemType::HashMapping, L"0123456789abcdef0123456789abcdef"), std::wstring(L".\\RACache\\Data\\0123456789abcdef0123456789abcdef.txt"));
     }
 
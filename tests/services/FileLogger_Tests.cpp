@@ -1,13 +1,17 @@
 #include "services\impl\FileLogger.hh"
 
+#include "util\Log.hh"
+
 #include "tests\devkit\services\mocks\MockClock.hh"
 #include "tests\devkit\services\mocks\MockFileSystem.hh"
+#include "tests\devkit\services\mocks\MockThreadPool.hh"
 #include "tests\RA_UnitTestHelpers.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 using ra::services::mocks::MockClock;
 using ra::services::mocks::MockFileSystem;
+using ra::services::mocks::MockThreadPool;
 
 namespace ra {
 namespace services {
@@ -77,6 +81,237 @@ public:
         Assert::AreEqual(static_cast<int>(mockFileSystem.GetFileSize(mockLogFileName)), 37);
         Assert::AreEqual(static_cast<int>(mockFileSystem.GetFileSize(mockOldLogFileName)), 1100000);
     }
+
+    TEST_METHOD(TestMinimumLevel)
+    {
+        MockFileSystem mockFileSystem;
+        FileLogger logger(mockFileSystem);
+        Assert::IsTrue(logger.IsEnabled(LogLevel::Info));
+        Assert::IsTrue(logger.IsEnabled(LogLevel::Warn));
+        Assert::IsTrue(logger.IsEnabled(LogLevel::Error));
+
+        logger.SetMinimumLevel(LogLevel::Warn);
+        Assert::IsFalse(logger.IsEnabled(LogLevel::Info));
+        Assert::IsTrue(logger.IsEnabled(LogLevel::Warn));
+        Assert::IsTrue(logger.IsEnabled(LogLevel::Error));
+
+        logger.SetMinimumLevel(LogLevel::Error);
+        Assert::IsFalse(logger.IsEnabled(LogLevel::Info));
+        Assert::IsFalse(logger.IsEnabled(LogLevel::Warn));
+        Assert::IsTrue(logger.IsEnabled(LogLevel::Error));
+    }
+
+    TEST_METHOD(TestLogDeferredMessage)
+    {
+        MockClock mockClock;
+        MockFileSystem mockFileSystem;
+        FileLogger logger(mockFileSystem);
+
+        // without the writer thread, the message is formatted immediately
+        std::string sMessage("This is a message.");
+        logger.LogDeferredMessage(LogLevel::Info, ra::util::DeferLogMessage("%s %d", sMessage.c_str(), 1));
+        sMessage.assign("This message was changed.");
+
+        Assert::AreEqual(std::string("\n"
+            "220843.000|INFO| This is a message. 1\n"), mockFileSystem.GetFileContents(mockLogFileName));
+    }
+
+    TEST_METHOD(TestWriterThread)
+    {
+        MockClock mockClock;
+        MockFileSystem mockFileSystem;
+        FileLogger logger(mockFileSystem);
+        logger.StartWriterThread();
+
+        logger.LogMessage(LogLevel::Info, "This is a message.");
+        logger.LogMessage(LogLevel::Warn, "This is another message.");
+        mockClock.AdvanceTime(std::chrono::milliseconds(375));
+        logger.LogMessage(LogLevel::Info, "This is the third message.");
+        logger.Flush();
+
+        // timestamps are captured when the message is logged, not when it's written
+        Assert::AreEqual(std::string("\n"
+            "220843.000|INFO| This is a message.\n"
+            "220843.000|WARN| This is another message.\n"
+            "220843.375|INFO| This is the third message.\n"), mockFileSystem.GetFileContents(mockLogFileName));
+    }
+
+    TEST_METHOD(TestWriterThreadDeferredMessage)
+    {
+        MockClock mockClock;
+        MockFileSystem mockFileSystem;
+        FileLogger logger(mockFileSystem);
+        logger.StartWriterThread();
+
+        std::thread::id nFormatThreadId;
+        logger.LogDeferredMessage(LogLevel::Info, [&nFormatThreadId]() {
+            nFormatThreadId = std::this_thread::get_id();
+            return std::string("This is a message.");
+        });
+
+        // captured arguments must outlive the strings they were captured from
+        {
+            std::string sArgument("This is another message.");
+            logger.LogDeferredMessage(LogLevel::Warn, ra::util::DeferLogMessage("%s (%d)", sArgument.c_str(), 2));
+            sArgument.assign("This message was changed.");
+        }
+
+        logger.Flush();
+
+        Assert::IsTrue(nFormatThreadId != std::thread::id());
+        Assert::IsTrue(nFormatThreadId != std::this_thread::get_id());
+        Assert::AreEqual(std::string("\n"
+            "220843.000|INFO| This is a message.\n"
+            "220843.000|WARN| This is another message. (2)\n"), mockFileSystem.GetFileContents(mockLogFileName));
+    }
+
+    TEST_METHOD(TestWriterThreadError)
+    {
+        MockClock mockClock;
+        MockFileSystem mockFileSystem;
+        FileLogger logger(mockFileSystem);
+        logger.StartWriterThread();
+
+        // errors (and anything logged before them) are written before LogMessage returns
+        logger.LogMessage(LogLevel::Info, "This is a message.");
+        logger.LogMessage(LogLevel::Error, "This is an error.");
+
+        Assert::AreEqual(std::string("\n"
+            "220843.000|INFO| This is a message.\n"
+            "220843.000|ERR | This is an error.\n"), mockFileSystem.GetFileContents(mockLogFileName));
+    }
+
+    TEST_METHOD(TestWriterThreadQueueFull)
+    {
+        MockClock mockClock;
+        MockFileSystem mockFileSystem;
+        FileLogger logger(mockFileSystem);
+        logger.StartWriterThread();
+
+        // more messages than the queue can hold
+        std::string sExpected("\n");
+        for (int i = 0; i < 3000; ++i)
+        {
+            logger.LogMessage(LogLevel::Info, std::to_string(i));
+            sExpected.append("220843.000|INFO| ");
+            sExpected.append(std::to_string(i));
+            sExpected.push_back('\n');
+        }
+
+        logger.Flush();
+        Assert::AreEqual(sExpected, mockFileSystem.GetFileContents(mockLogFileName));
+    }
+
+    TEST_METHOD(TestWriterThreadMultipleThreads)
+    {
+        MockClock mockClock;
+        MockFileSystem mockFileSystem;
+        FileLogger logger(mockFileSystem);
+        logger.StartWriterThread();
+
+        constexpr int nThreads = 4;
+        constexpr int nMessagesPerThread = 500;
+        std::vector<std::thread> vThreads;
+        for (int i = 0; i < nThreads; ++i)
+        {
+            vThreads.emplace_back([&logger, i]() {
+                for (int j = 0; j < nMessagesPerThread; ++j)
+                    logger.LogDeferredMessage(LogLevel::Info, ra::util::DeferLogMessage("%d:%d", i, j));
+            });
+        }
+
+        for (auto& pThread : vThreads)
+            pThread.join();
+
+        logger.Flush();
+
+        // messages from each thread should be written in the order they were logged by that thread
+        const auto sContents = mockFileSystem.GetFileContents(mockLogFileName);
+        std::array<int, nThreads> vNextMessage{};
+        size_t nIndex = 1; // skip blank line
+        while (nIndex < sContents.length())
+        {
+            const auto nEnd = sContents.find('\n', nIndex);
+            Assert::AreNotEqual(std::string::npos, nEnd);
+
+            const auto sLine = sContents.substr(nIndex + 17, nEnd - nIndex - 17);
+            const auto nColon = sLine.find(':');
+            const auto nThread = std::stoi(sLine.substr(0, nColon));
+            const auto nMessage = std::stoi(sLine.substr(nColon + 1));
+            Assert::AreEqual(vNextMessage.at(nThread), nMessage);
+            ++vNextMessage.at(nThread);
+
+            nIndex = nEnd + 1;
+        }
+
+        for (const auto nCount : vNextMessage)
+            Assert::AreEqual(nMessagesPerThread, nCount);
+    }
+
+    TEST_METHOD(TestStopWriterThread)
+    {
+        MockClock mockClock;
+        MockFileSystem mockFileSystem;
+        FileLogger logger(mockFileSystem);
+        logger.StartWriterThread();
+
+        logger.LogMessage(LogLevel::Info, "This is a message.");
+        logger.StopWriterThread();
+
+        // pending messages are written when the thread is stopped
+        Assert::AreEqual(std::string("\n"
+            "220843.000|INFO| This is a message.\n"), mockFileSystem.GetFileContents(mockLogFileName));
+
+        // messages are written immediately after the thread is stopped
+        logger.LogMessage(LogLevel::Warn, "This is another message.");
+        Assert::AreEqual(std::string("\n"
+            "220843.000|INFO| This is a message.\n"
+            "220843.000|WARN| This is another message.\n"), mockFileSystem.GetFileContents(mockLogFileName));
+
+        // and the thread can be restarted
+        logger.StartWriterThread();
+        logger.LogMessage(LogLevel::Info, "This is the third message.");
+        logger.Flush();
+        Assert::AreEqual(std::string("\n"
+            "220843.000|INFO| This is a message.\n"
+            "220843.000|WARN| This is another message.\n"
+            "220843.000|INFO| This is the third message.\n"), mockFileSystem.GetFileContents(mockLogFileName));
+    }
+
+    TEST_METHOD(TestStopWriterThreadWhileLogging)
+    {
+        MockClock mockClock;
+        MockFileSystem mockFileSystem;
+        MockThreadPool mockThreadPool; // serializes the messages written directly after the thread is stopped
+        FileLogger logger(mockFileSystem);
+        logger.StartWriterThread();
+
+        constexpr int nThreads = 4;
+        constexpr int nMessagesPerThread = 500;
+        std::atomic<int> nStarted{ 0 };
+        std::vector<std::thread> vThreads;
+        for (int i = 0; i < nThreads; ++i)
+        {
+            vThreads.emplace_back([&logger, &nStarted, i]() {
+                ++nStarted;
+                for (int j = 0; j < nMessagesPerThread; ++j)
+                    logger.LogMessage(LogLevel::Info, ra::util::String::Printf("%d:%d", i, j));
+            });
+        }
+
+        while (nStarted < nThreads)
+            std::this_thread::yield();
+
+        logger.StopWriterThread();
+
+        for (auto& pThread : vThreads)
+            pThread.join();
+
+        // messages queued just before the thread stopped should not be lost
+        const auto sContents = mockFileSystem.GetFileContents(mockLogFileName);
+        const auto nLines = std::count(sContents.begin(), sContents.end(), '\n');
+        Assert::AreEqual(nThreads * nMessagesPerThread + 1, gsl::narrow_cast<int>(nLines));
+    }
 };
 
 } // namespace tests
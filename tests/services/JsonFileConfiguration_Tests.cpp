@@ -176,6 +176,11 @@ public:
         TestFeature(ra::services::Feature::PreferDecimal, "Prefer Decimal", false);
     }
 
+    TEST_METHOD(TestPerformanceProfiler)
+    {
+        TestFeature(ra::services::Feature::PerformanceProfiler, "Performance Profiler", false);
+    }
+
     void TestPopupLocation(ra::ui::viewmodels::Popup nPopup, const std::string& sJsonKey, ra::ui::viewmodels::PopupLocation nDefault)
     {
         MockFileSystem fileSystem;
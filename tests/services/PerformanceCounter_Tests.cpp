@@ -0,0 +1,228 @@
+#include "services\PerformanceCounter.hh"
+
+#include "services\impl\StringTextWriter.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+#include "tests\devkit\services\mocks\MockClock.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(PerformanceCounter_Tests)
+{
+private:
+    class PerformanceCounterHarness : public PerformanceCounter
+    {
+    public:
+        PerformanceCounterHarness() noexcept : m_Override(this) {}
+
+        ra::services::mocks::MockClock mockClock;
+
+        void RunFrame(std::chrono::milliseconds nRuntime, std::chrono::milliseconds nOverlay)
+        {
+            Tally(PerformanceCheckpoint::RuntimeProcess);
+            mockClock.AdvanceTime(nRuntime);
+            Tally(PerformanceCheckpoint::OverlayManagerAdvanceFrame);
+            mockClock.AdvanceTime(nOverlay);
+            Stop();
+        }
+
+    private:
+        ra::services::ServiceLocator::ServiceOverride<ra::services::PerformanceCounter> m_Override;
+    };
+
+    static void AssertStatistics(const PerformanceCounter::Statistics& pStatistics,
+                                 size_t nSamples, int nP50, int nP99, int nMax)
+    {
+        Assert::AreEqual(nSamples, pStatistics.nSamples);
+        Assert::AreEqual(nP50, pStatistics.nP50);
+        Assert::AreEqual(nP99, pStatistics.nP99);
+        Assert::AreEqual(nMax, pStatistics.nMax);
+    }
+
+public:
+    TEST_METHOD(TestInitialState)
+    {
+        PerformanceCounterHarness counter;
+        Assert::IsFalse(counter.IsEnabled());
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::Frame), 0U, 0, 0, 0);
+    }
+
+    TEST_METHOD(TestDisabled)
+    {
+        PerformanceCounterHarness counter;
+        counter.RunFrame(std::chrono::milliseconds(2), std::chrono::milliseconds(1));
+
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::RuntimeProcess), 0U, 0, 0, 0);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::Frame), 0U, 0, 0, 0);
+    }
+
+    TEST_METHOD(TestTally)
+    {
+        PerformanceCounterHarness counter;
+        counter.SetEnabled(true);
+        counter.RunFrame(std::chrono::milliseconds(2), std::chrono::milliseconds(1));
+
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::RuntimeProcess), 1U, 2000, 2000, 2000);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::OverlayManagerAdvanceFrame), 1U, 1000, 1000, 1000);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::Frame), 1U, 3000, 3000, 3000);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::AssetListDoFrame), 0U, 0, 0, 0);
+    }
+
+    TEST_METHOD(TestPercentiles)
+    {
+        PerformanceCounterHarness counter;
+        counter.SetEnabled(true);
+        for (int i = 100; i > 0; --i)
+            counter.RunFrame(std::chrono::milliseconds(i), std::chrono::milliseconds(0));
+
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::RuntimeProcess), 100U, 50000, 99000, 100000);
+    }
+
+    TEST_METHOD(TestEnableMidFrame)
+    {
+        PerformanceCounterHarness counter;
+        counter.Tally(PerformanceCheckpoint::RuntimeProcess);
+        counter.SetEnabled(true);
+        counter.mockClock.AdvanceTime(std::chrono::milliseconds(2));
+        counter.Tally(PerformanceCheckpoint::OverlayManagerAdvanceFrame);
+        counter.mockClock.AdvanceTime(std::chrono::milliseconds(1));
+        counter.Stop();
+
+        // frame starts at the first checkpoint tallied after the profiler was enabled
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::RuntimeProcess), 0U, 0, 0, 0);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::OverlayManagerAdvanceFrame), 1U, 1000, 1000, 1000);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::Frame), 1U, 1000, 1000, 1000);
+    }
+
+    TEST_METHOD(TestDisableMidFrame)
+    {
+        PerformanceCounterHarness counter;
+        counter.SetEnabled(true);
+        counter.RunFrame(std::chrono::milliseconds(2), std::chrono::milliseconds(1));
+
+        counter.Tally(PerformanceCheckpoint::RuntimeProcess);
+        counter.mockClock.AdvanceTime(std::chrono::milliseconds(4));
+        counter.SetEnabled(false);
+        counter.Stop();
+
+        // previously recorded timings are still available
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::RuntimeProcess), 1U, 2000, 2000, 2000);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::Frame), 1U, 3000, 3000, 3000);
+    }
+
+    TEST_METHOD(TestScope)
+    {
+        PerformanceCounterHarness counter;
+        counter.SetEnabled(true);
+
+        counter.Tally(PerformanceCheckpoint::RuntimeProcess);
+        counter.mockClock.AdvanceTime(std::chrono::milliseconds(1));
+        {
+            PerformanceScope pOuterScope(PerformanceCheckpoint::RuntimeDoFrame);
+            counter.mockClock.AdvanceTime(std::chrono::milliseconds(2));
+            {
+                PerformanceScope pInnerScope(PerformanceCheckpoint::RuntimeEvents);
+                counter.mockClock.AdvanceTime(std::chrono::milliseconds(3));
+            }
+            {
+                PerformanceScope pInnerScope(PerformanceCheckpoint::RuntimeEvents);
+                counter.mockClock.AdvanceTime(std::chrono::milliseconds(1));
+            }
+        }
+        counter.Stop();
+
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::RuntimeProcess), 1U, 7000, 7000, 7000);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::RuntimeDoFrame), 1U, 6000, 6000, 6000);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::RuntimeEvents), 2U, 1000, 3000, 3000);
+    }
+
+    TEST_METHOD(TestScopeDisabled)
+    {
+        PerformanceCounterHarness counter;
+        {
+            PerformanceScope pScope(PerformanceCheckpoint::OverlayRender);
+            counter.mockClock.AdvanceTime(std::chrono::milliseconds(2));
+            counter.SetEnabled(true);
+        }
+
+        // scope started before the profiler was enabled should not be recorded
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::OverlayRender), 0U, 0, 0, 0);
+    }
+
+    TEST_METHOD(TestBufferWraps)
+    {
+        PerformanceCounterHarness counter;
+        counter.SetEnabled(true);
+
+        const auto tStart = counter.mockClock.UpTime();
+        for (size_t i = 0; i < PerformanceCounter::EVENT_BUFFER_SIZE; ++i)
+            counter.Record(PerformanceCheckpoint::OverlayRender, tStart, tStart + std::chrono::milliseconds(1));
+        for (size_t i = 0; i < 10; ++i)
+            counter.Record(PerformanceCheckpoint::FrameEvents, tStart, tStart + std::chrono::milliseconds(2));
+
+        // oldest events should have been overwritten
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::OverlayRender),
+                         PerformanceCounter::EVENT_BUFFER_SIZE - 10, 1000, 1000, 1000);
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::FrameEvents), 10U, 2000, 2000, 2000);
+    }
+
+    TEST_METHOD(TestRecordFromMultipleThreads)
+    {
+        PerformanceCounterHarness counter;
+        counter.SetEnabled(true);
+
+        const auto tStart = counter.mockClock.UpTime();
+        std::vector<std::thread> vThreads;
+        for (int i = 1; i <= 4; ++i)
+        {
+            vThreads.emplace_back([&counter, tStart, i]() {
+                for (int j = 0; j < 1000; ++j)
+                    counter.Record(PerformanceCheckpoint::OverlayRender, tStart, tStart + std::chrono::milliseconds(i));
+            });
+        }
+
+        for (auto& pThread : vThreads)
+            pThread.join();
+
+        AssertStatistics(counter.GetStatistics(PerformanceCheckpoint::OverlayRender), 4000U, 2000, 4000, 4000);
+    }
+
+    TEST_METHOD(TestExportChromeTrace)
+    {
+        PerformanceCounterHarness counter;
+        counter.SetEnabled(true);
+        counter.mockClock.AdvanceTime(std::chrono::milliseconds(5));
+        counter.RunFrame(std::chrono::milliseconds(2), std::chrono::milliseconds(1));
+
+        ra::services::impl::StringTextWriter pWriter;
+        counter.ExportChromeTrace(pWriter);
+
+        const auto& sTrace = pWriter.GetString();
+        AssertContains(sTrace, "{\"traceEvents\":[");
+        AssertContains(sTrace, "\"name\":\"Runtime\",\"ph\":\"X\"");
+        AssertContains(sTrace, "\"ts\":5000,\"dur\":2000,\"args\":{\"frame\":0}}");
+        AssertContains(sTrace, "\"name\":\"Overlay\",\"ph\":\"X\"");
+        AssertContains(sTrace, "\"ts\":7000,\"dur\":1000,\"args\":{\"frame\":0}}");
+        AssertContains(sTrace, "\"name\":\"Frame\",\"ph\":\"X\"");
+        AssertContains(sTrace, "\"ts\":5000,\"dur\":3000,\"args\":{\"frame\":0}}");
+        AssertContains(sTrace, "],\"displayTimeUnit\":\"ms\"}");
+    }
+
+    TEST_METHOD(TestExportChromeTraceEmpty)
+    {
+        PerformanceCounterHarness counter;
+
+        ra::services::impl::StringTextWriter pWriter;
+        counter.ExportChromeTrace(pWriter);
+
+        Assert::AreEqual(std::string("{\"traceEvents\":[\n\n],\"displayTimeUnit\":\"ms\"}\n"), pWriter.GetString());
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
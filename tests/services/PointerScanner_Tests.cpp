@@ -0,0 +1,325 @@
+#include "services\PointerScanner.hh"
+#include "services\search\SearchImpl_vectorized.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+#include "tests\devkit\context\mocks\MockEmulatorMemoryContext.hh"
+#include "tests\devkit\services\mocks\MockThreadPool.hh"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace tests {
+
+TEST_CLASS(PointerScanner_Tests)
+{
+private:
+    static void AssertResult(const PointerScanner::Result& pResult, ra::data::ByteAddress nAddress,
+                             const std::vector<uint32_t>& vOffsets, const std::vector<uint32_t>& vValues)
+    {
+        Assert::AreEqual(nAddress, pResult.nAddress);
+        Assert::AreEqual(vOffsets.size(), pResult.vOffsets.size());
+        for (size_t i = 0; i < vOffsets.size(); ++i)
+            Assert::AreEqual(vOffsets.at(i), pResult.vOffsets.at(i));
+        Assert::AreEqual(vValues.size(), pResult.vValues.size());
+        for (size_t i = 0; i < vValues.size(); ++i)
+            Assert::AreEqual(vValues.at(i), pResult.vValues.at(i));
+    }
+
+public:
+    TEST_METHOD(TestFindNoStates)
+    {
+        PointerScanner pScanner;
+        Assert::AreEqual({ 0U }, pScanner.Find({}).size());
+    }
+
+    TEST_METHOD(TestFindDirect)
+    {
+        std::array<uint8_t, 0x100> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        memory.at(0x08) = 0x1C;
+        memory.at(0x70) = 0x1C;
+        memory.at(0x9C) = 0x20;
+        SearchResults pState1;
+        pState1.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        memory.at(0x08) = 0x34;
+        memory.at(0x70) = 0x34;
+        memory.at(0x9C) = 0x38;
+        SearchResults pState2;
+        pState2.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        PointerScanner pScanner;
+        const auto vResults = pScanner.Find({ { &pState1, 0x20U }, { &pState2, 0x38U } });
+
+        Assert::AreEqual({ 3U }, vResults.size());
+        AssertResult(vResults.at(0), 0x08U, { 0x04U }, { 0x1CU, 0x34U });
+        AssertResult(vResults.at(1), 0x70U, { 0x04U }, { 0x1CU, 0x34U });
+        AssertResult(vResults.at(2), 0x9CU, { 0x00U }, { 0x20U, 0x38U });
+    }
+
+    TEST_METHOD(TestFindNegativeOffset)
+    {
+        std::array<uint8_t, 0x100> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        memory.at(0x08) = 0x1C;
+        SearchResults pState1;
+        pState1.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        memory.at(0x08) = 0x34;
+        SearchResults pState2;
+        pState2.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        PointerScanner pScanner;
+        pScanner.SetMaxOffset(0x10);
+        const auto vResults = pScanner.Find({ { &pState1, 0x18U }, { &pState2, 0x30U } });
+
+        Assert::AreEqual({ 1U }, vResults.size());
+        AssertResult(vResults.at(0), 0x08U, { 0xFFFFFFFCU }, { 0x1CU, 0x34U });
+    }
+
+    TEST_METHOD(TestFindAllStatesMustMatch)
+    {
+        std::array<uint8_t, 0x100> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        memory.at(0x08) = 0x1C;
+        memory.at(0x10) = 0x1C;
+        SearchResults pState1;
+        pState1.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        memory.at(0x08) = 0x34;
+        memory.at(0x10) = 0x34;
+        SearchResults pState2;
+        pState2.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        // 0x10 doesn't point at the target in the third state
+        memory.at(0x08) = 0x5C;
+        memory.at(0x10) = 0x60;
+        SearchResults pState3;
+        pState3.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        PointerScanner pScanner;
+        const auto vResults = pScanner.Find({ { &pState1, 0x20U }, { &pState2, 0x38U }, { &pState3, 0x60U } });
+
+        Assert::AreEqual({ 1U }, vResults.size());
+        AssertResult(vResults.at(0), 0x08U, { 0x04U }, { 0x1CU, 0x34U, 0x5CU });
+    }
+
+    TEST_METHOD(TestFindMaxOffset)
+    {
+        std::array<uint8_t, 0x400> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        memory.at(0x08) = 0x10; // +0x30
+        memory.at(0x0C) = 0x3C; // +0x04
+        memory.at(0x10) = 0x40; // -0x200
+        memory.at(0x11) = 0x02;
+        memory.at(0x14) = 0x40; // 0x80000000 bias
+        memory.at(0x17) = 0x80;
+        SearchResults pState1;
+        pState1.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        memory.at(0x08) = 0x30;
+        memory.at(0x0C) = 0x5C;
+        memory.at(0x10) = 0x60;
+        memory.at(0x14) = 0x60;
+        SearchResults pState2;
+        pState2.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        const std::vector<PointerScanner::State> vStates{ { &pState1, 0x40U }, { &pState2, 0x60U } };
+
+        PointerScanner pScanner;
+        Assert::AreEqual({ 4U }, pScanner.Find(vStates).size());
+
+        pScanner.SetMaxOffset(0x100);
+        auto vResults = pScanner.Find(vStates);
+        Assert::AreEqual({ 2U }, vResults.size());
+        AssertResult(vResults.at(0), 0x08U, { 0x30U }, { 0x10U, 0x30U });
+        AssertResult(vResults.at(1), 0x0CU, { 0x04U }, { 0x3CU, 0x5CU });
+
+        pScanner.SetMaxOffset(0x10);
+        vResults = pScanner.Find(vStates);
+        Assert::AreEqual({ 1U }, vResults.size());
+        AssertResult(vResults.at(0), 0x0CU, { 0x04U }, { 0x3CU, 0x5CU });
+
+        // real addresses start at 0x80000000. offset is measured relative to the bias
+        pScanner.AddPointerBias(0x80000000U);
+        vResults = pScanner.Find(vStates);
+        Assert::AreEqual({ 2U }, vResults.size());
+        AssertResult(vResults.at(0), 0x0CU, { 0x04U }, { 0x3CU, 0x5CU });
+        AssertResult(vResults.at(1), 0x14U, { 0x80000000U }, { 0x80000040U, 0x80000060U });
+    }
+
+    TEST_METHOD(TestFindSixteenBitBigEndian)
+    {
+        std::array<uint8_t, 0x100> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        memory.at(0x07) = 0x12;
+        memory.at(0x08) = 0x1C;
+        SearchResults pState1;
+        pState1.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::SixteenBitBigEndian);
+
+        memory.at(0x07) = 0x12;
+        memory.at(0x08) = 0x34;
+        SearchResults pState2;
+        pState2.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::SixteenBitBigEndian);
+
+        PointerScanner pScanner;
+        pScanner.SetSearchType(SearchType::SixteenBitBigEndian);
+        const auto vResults = pScanner.Find({ { &pState1, 0x1220U }, { &pState2, 0x1238U } });
+
+        Assert::AreEqual({ 1U }, vResults.size());
+        AssertResult(vResults.at(0), 0x07U, { 0x04U }, { 0x121CU, 0x1234U });
+    }
+
+    TEST_METHOD(TestFindThirtyTwoBitUnaligned)
+    {
+        std::array<uint8_t, 0x100> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        memory.at(0x09) = 0x1C;
+        SearchResults pState1;
+        pState1.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBit);
+
+        memory.at(0x09) = 0x34;
+        SearchResults pState2;
+        pState2.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBit);
+
+        PointerScanner pScanner;
+        pScanner.SetSearchType(SearchType::ThirtyTwoBitAligned);
+        Assert::AreEqual({ 0U }, pScanner.Find({ { &pState1, 0x20U }, { &pState2, 0x38U } }).size());
+
+        pScanner.SetSearchType(SearchType::ThirtyTwoBit);
+        const auto vResults = pScanner.Find({ { &pState1, 0x20U }, { &pState2, 0x38U } });
+        Assert::AreEqual({ 1U }, vResults.size());
+        AssertResult(vResults.at(0), 0x09U, { 0x04U }, { 0x1CU, 0x34U });
+    }
+
+    TEST_METHOD(TestFindChain)
+    {
+        std::array<uint8_t, 0x100> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        // 0x10 => 0x40, 0x40+0x08 => 0x80, 0x80+0x04 => 0x84
+        memory.at(0x10) = 0x40;
+        memory.at(0x48) = 0x80;
+        SearchResults pState1;
+        pState1.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        // 0x10 => 0x60, 0x60+0x08 => 0xA0, 0xA0+0x04 => 0xA4
+        memory.at(0x10) = 0x60;
+        memory.at(0x68) = 0xA0;
+        SearchResults pState2;
+        pState2.Initialize(0U, gsl::narrow_cast<uint32_t>(memory.size()), SearchType::ThirtyTwoBitAligned);
+
+        const std::vector<PointerScanner::State> vStates{ { &pState1, 0x84U }, { &pState2, 0xA4U } };
+
+        PointerScanner pScanner;
+        pScanner.SetMaxOffset(0x10);
+        Assert::AreEqual({ 0U }, pScanner.Find(vStates).size());
+
+        pScanner.SetMaxDepth(2);
+        auto vResults = pScanner.Find(vStates);
+        Assert::AreEqual({ 1U }, vResults.size());
+        AssertResult(vResults.at(0), 0x10U, { 0x08U, 0x04U }, { 0x40U, 0x60U });
+
+        // 0x10 is also a direct pointer with offset 0x44. it should be listed before the chain
+        pScanner.SetMaxOffset(0x100);
+        vResults = pScanner.Find(vStates);
+        Assert::AreEqual({ 2U }, vResults.size());
+        AssertResult(vResults.at(0), 0x10U, { 0x44U }, { 0x40U, 0x60U });
+        AssertResult(vResults.at(1), 0x10U, { 0x08U, 0x04U }, { 0x40U, 0x60U });
+    }
+
+private:
+    static std::vector<PointerScanner::Result> FindInLargeMemory(SearchType nSearchType, uint32_t nMaxDepth)
+    {
+        // memory size is not a multiple of the chunk size, so the scalar code has to finish the last partition
+        constexpr uint32_t nMemorySize = 512U * 1024U + 27U;
+        auto memory = std::make_unique<unsigned char[]>(nMemorySize);
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory.get(), nMemorySize);
+
+        std::array<SearchResults, 3> vCaptures;
+        std::vector<PointerScanner::State> vStates;
+        for (uint32_t nState = 0; nState < vCaptures.size(); ++nState)
+        {
+            // small values make for lots of addresses pointing near the target
+            for (uint32_t i = 0; i < nMemorySize; ++i)
+                GSL_SUPPRESS_BOUNDS4 memory[i] = ((i % 4) == 0) ? gsl::narrow_cast<unsigned char>((i * 7 + nState * (i % 3)) % 251) : 0;
+
+            vCaptures.at(nState).Initialize(0U, nMemorySize, nSearchType);
+            vStates.push_back({ &vCaptures.at(nState), 0x80U + nState * 2 });
+        }
+
+        PointerScanner pScanner;
+        pScanner.SetSearchType(nSearchType);
+        pScanner.SetMaxOffset(0x100);
+        pScanner.SetMaxDepth(nMaxDepth);
+        return pScanner.Find(vStates);
+    }
+
+    static void AssertResultsEqual(const std::vector<PointerScanner::Result>& vExpected,
+                                   const std::vector<PointerScanner::Result>& vResults)
+    {
+        Assert::AreEqual(vExpected.size(), vResults.size());
+        for (size_t i = 0; i < vExpected.size(); ++i)
+            AssertResult(vResults.at(i), vExpected.at(i).nAddress, vExpected.at(i).vOffsets, vExpected.at(i).vValues);
+    }
+
+    static void AssertParallelMatchesSerial(SearchType nSearchType, uint32_t nMaxDepth)
+    {
+        // without a thread pool, the scan is serial
+        const auto vExpected = FindInLargeMemory(nSearchType, nMaxDepth);
+        Assert::IsFalse(vExpected.empty());
+
+        for (const bool bSynchronous : {true, false})
+        {
+            ra::services::mocks::MockThreadPool mockThreadPool;
+            mockThreadPool.SetSynchronous(bSynchronous);
+
+            AssertResultsEqual(vExpected, FindInLargeMemory(nSearchType, nMaxDepth));
+
+            // helpers that start after the scan completed should find nothing to do
+            while (mockThreadPool.PendingTasks() > 0)
+                mockThreadPool.ExecuteNextTask();
+        }
+
+        using ra::services::search::vectorized::InstructionSet;
+        const auto nInstructionSet = ra::services::search::vectorized::GetInstructionSet();
+        ra::services::search::vectorized::SetInstructionSet(InstructionSet::None);
+        AssertResultsEqual(vExpected, FindInLargeMemory(nSearchType, nMaxDepth));
+        ra::services::search::vectorized::SetInstructionSet(nInstructionSet);
+    }
+
+public:
+    TEST_METHOD(TestParallelThirtyTwoBitAligned)
+    {
+        AssertParallelMatchesSerial(SearchType::ThirtyTwoBitAligned, 1);
+    }
+
+    TEST_METHOD(TestParallelSixteenBit)
+    {
+        AssertParallelMatchesSerial(SearchType::SixteenBit, 1);
+    }
+
+    TEST_METHOD(TestParallelChain)
+    {
+        AssertParallelMatchesSerial(SearchType::ThirtyTwoBitAligned, 2);
+    }
+};
+
+} // namespace tests
+} // namespace services
+} // namespace ra
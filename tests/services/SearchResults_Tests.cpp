@@ -1,7 +1,9 @@
 #include "services\SearchResults.h"
+#include "services\search\SearchImpl_vectorized.hh"
 
 #include "tests\RA_UnitTestHelpers.h"
 #include "tests\devkit\context\mocks\MockEmulatorMemoryContext.hh"
+#include "tests\devkit\services\mocks\MockThreadPool.hh"
 #include "tests\devkit\testutil\MemoryAsserts.hh"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -1571,6 +1573,112 @@ public:
         Assert::AreEqual(0xAB55U, result.nValue);
     }
 
+    TEST_METHOD(TestGetMatchingAddressLargeSparse)
+    {
+        auto memory = std::make_unique<unsigned char[]>(BIG_BLOCK_SIZE);
+        for (unsigned int i = 0; i < BIG_BLOCK_SIZE; ++i)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = (i % 256);
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory.get(), BIG_BLOCK_SIZE);
+
+        SearchResults results;
+        results.Initialize(0U, BIG_BLOCK_SIZE, ra::services::SearchType::EightBit);
+
+        // modify an irregular pattern of addresses spanning multiple blocks. leave a gap of unmodified
+        // memory so one of the blocks doesn't have any matches.
+        std::vector<ra::data::ByteAddress> vExpected;
+        for (unsigned int i = 0; i < BIG_BLOCK_SIZE; i += (i % 7) + 1)
+        {
+            if (i >= MAX_BLOCK_SIZE && i < MAX_BLOCK_SIZE * 2)
+                continue;
+
+            GSL_SUPPRESS_BOUNDS4 memory[i] ^= 0xFF;
+            vExpected.push_back(i);
+        }
+
+        SearchResults results1;
+        results1.Initialize(results, ComparisonType::NotEqualTo, ra::services::SearchFilterType::LastKnownValue, L"");
+        Assert::AreEqual(vExpected.size(), results1.MatchingAddressCount());
+
+        SearchResult result;
+        for (gsl::index nIndex = 0; nIndex < gsl::narrow_cast<gsl::index>(vExpected.size()); ++nIndex)
+        {
+            Assert::IsTrue(results1.GetMatchingAddress(nIndex, result));
+            Assert::AreEqual(vExpected.at(nIndex), result.nAddress);
+        }
+
+        // random access
+        Assert::IsTrue(results1.GetMatchingAddress(vExpected.size() / 2, result));
+        Assert::AreEqual(vExpected.at(vExpected.size() / 2), result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(1, result));
+        Assert::AreEqual(vExpected.at(1), result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(vExpected.size() - 1, result));
+        Assert::AreEqual(vExpected.back(), result.nAddress);
+
+        Assert::IsFalse(results1.GetMatchingAddress(vExpected.size(), result));
+        Assert::IsFalse(results1.GetMatchingAddress(-1, result));
+    }
+
+    TEST_METHOD(TestGetMatchingAddressAfterExclude)
+    {
+        auto memory = std::make_unique<unsigned char[]>(BIG_BLOCK_SIZE);
+        for (unsigned int i = 0; i < BIG_BLOCK_SIZE; ++i)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = (i % 256);
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory.get(), BIG_BLOCK_SIZE);
+
+        SearchResults results;
+        results.Initialize(0U, BIG_BLOCK_SIZE, ra::services::SearchType::EightBit);
+
+        SearchResults results1;
+        results1.Initialize(results, ComparisonType::Equals, ra::services::SearchFilterType::LastKnownValue, L"");
+        Assert::AreEqual({ BIG_BLOCK_SIZE }, results1.MatchingAddressCount());
+
+        SearchResult result;
+        Assert::IsTrue(results1.GetMatchingAddress(MAX_BLOCK_SIZE + 100, result));
+        Assert::AreEqual(MAX_BLOCK_SIZE + 100, result.nAddress);
+
+        // excluding an address should shift all of the following matches
+        const SearchResult excludeResult{ 100U, 0U, ra::data::Memory::Size::EightBit };
+        results1.ExcludeResult(excludeResult);
+        Assert::AreEqual({ BIG_BLOCK_SIZE - 1 }, results1.MatchingAddressCount());
+
+        Assert::IsTrue(results1.GetMatchingAddress(99, result));
+        Assert::AreEqual(99U, result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(100, result));
+        Assert::AreEqual(101U, result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(MAX_BLOCK_SIZE + 100, result));
+        Assert::AreEqual(MAX_BLOCK_SIZE + 101, result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(BIG_BLOCK_SIZE - 2, result));
+        Assert::AreEqual(BIG_BLOCK_SIZE - 1, result.nAddress);
+        Assert::IsFalse(results1.GetMatchingAddress(BIG_BLOCK_SIZE - 1, result));
+
+        // excluding an already excluded address should not change anything
+        results1.ExcludeResult(excludeResult);
+        Assert::AreEqual({ BIG_BLOCK_SIZE - 1 }, results1.MatchingAddressCount());
+        Assert::IsTrue(results1.GetMatchingAddress(100, result));
+        Assert::AreEqual(101U, result.nAddress);
+
+        // excluding a second address from the same block should update the existing index
+        const SearchResult excludeResult2{ 50U, 0U, ra::data::Memory::Size::EightBit };
+        results1.ExcludeResult(excludeResult2);
+        Assert::AreEqual({ BIG_BLOCK_SIZE - 2 }, results1.MatchingAddressCount());
+
+        Assert::IsTrue(results1.GetMatchingAddress(49, result));
+        Assert::AreEqual(49U, result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(50, result));
+        Assert::AreEqual(51U, result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(98, result));
+        Assert::AreEqual(99U, result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(99, result));
+        Assert::AreEqual(101U, result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(MAX_BLOCK_SIZE + 100, result));
+        Assert::AreEqual(MAX_BLOCK_SIZE + 102, result.nAddress);
+        Assert::IsTrue(results1.GetMatchingAddress(BIG_BLOCK_SIZE - 3, result));
+        Assert::AreEqual(BIG_BLOCK_SIZE - 1, result.nAddress);
+        Assert::IsFalse(results1.GetMatchingAddress(BIG_BLOCK_SIZE - 2, result));
+    }
+
     TEST_METHOD(TestInitializeFromMemoryEightBitLargeMemory)
     {
         auto memory = std::make_unique<unsigned char[]>(BIG_BLOCK_SIZE);
@@ -2901,6 +3009,41 @@ public:
         Assert::AreEqual(0xdeadbeefU, result.nValue);
     }
 
+    TEST_METHOD(TestInitializeFromListSixteenBitAlignedNonZeroFirstAddress)
+    {
+        std::array<unsigned char, 128> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        std::vector<SearchResult> vResults;
+        vResults.push_back({16, 0x1234, ra::data::Memory::Size::Unknown});
+        vResults.push_back({18, 0x5678, ra::data::Memory::Size::Unknown});
+        vResults.push_back({120, 0xbeef, ra::data::Memory::Size::Unknown});
+
+        SearchResults results;
+        results.Initialize(vResults, ra::services::SearchType::SixteenBitAligned);
+
+        Assert::AreEqual({3U}, results.MatchingAddressCount());
+
+        Assert::IsTrue(results.ContainsAddress(16U));
+        Assert::IsTrue(results.ContainsAddress(18U));
+        Assert::IsFalse(results.ContainsAddress(20U));
+        Assert::IsTrue(results.ContainsAddress(120U));
+
+        SearchResult result;
+        Assert::IsTrue(results.GetMatchingAddress(0U, result));
+        Assert::AreEqual(16U, result.nAddress);
+        Assert::AreEqual(0x1234U, result.nValue);
+
+        Assert::IsTrue(results.GetMatchingAddress(1U, result));
+        Assert::AreEqual(18U, result.nAddress);
+        Assert::AreEqual(0x5678U, result.nValue);
+
+        Assert::IsTrue(results.GetMatchingAddress(2U, result));
+        Assert::AreEqual(120U, result.nAddress);
+        Assert::AreEqual(0xbeefU, result.nValue);
+    }
+
     TEST_METHOD(TestInitializeFromListThirtyTwoBitBigEndian)
     {
         std::array<unsigned char, 16> memory{};
@@ -2940,6 +3083,382 @@ public:
         Assert::AreEqual(0xdeadbeefU, result.nValue);
     }
 
+private:
+    static std::vector<SearchResult> FilterVectorized(std::array<unsigned char, 1027>& memory, SearchType nSearchType,
+                                                      ComparisonType nCompareType, SearchFilterType nFilterType,
+                                                      const std::wstring& sFilterValue)
+    {
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        for (unsigned int i = 0; i < memory.size(); ++i)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>((i * 7) % 5);
+        mockMemoryContext.MockMemory(memory);
+
+        SearchResults results1;
+        results1.Initialize(0U, memory.size(), nSearchType);
+
+        // modify some of the memory so the first filter only keeps some of the addresses in each chunk
+        for (unsigned int i = 0; i < memory.size(); i += 3)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>((i * 11) % 6);
+
+        SearchResults results2;
+        results2.Initialize(results1, nCompareType, nFilterType, sFilterValue);
+
+        // second filter has to merge with the partial matches of the first filter
+        for (unsigned int i = 1; i < memory.size(); i += 5)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>((i * 13) % 4);
+
+        SearchResults results3;
+        results3.Initialize(results2, nCompareType, nFilterType, sFilterValue);
+
+        std::vector<SearchResult> vResults;
+        SearchResult result;
+        for (gsl::index i = 0; results3.GetMatchingAddress(i, result); ++i)
+            vResults.push_back(result);
+
+        return vResults;
+    }
+
+    static void AssertVectorizedMatchesScalar(SearchType nSearchType, ComparisonType nCompareType,
+                                              SearchFilterType nFilterType, const std::wstring& sFilterValue)
+    {
+        using ra::services::search::vectorized::InstructionSet;
+
+        // memory size is not a multiple of the chunk size, so the scalar code has to finish each block
+        std::array<unsigned char, 1027> memory{};
+        const auto nInstructionSet = ra::services::search::vectorized::GetInstructionSet();
+
+        ra::services::search::vectorized::SetInstructionSet(InstructionSet::None);
+        const auto vExpected = FilterVectorized(memory, nSearchType, nCompareType, nFilterType, sFilterValue);
+
+        for (auto nTest = InstructionSet::SSE2; nTest <= ra::services::search::vectorized::GetSupportedInstructionSet();
+             nTest = ra::itoe<InstructionSet>(ra::etoi(nTest) + 1))
+        {
+            ra::services::search::vectorized::SetInstructionSet(nTest);
+            const auto vResults = FilterVectorized(memory, nSearchType, nCompareType, nFilterType, sFilterValue);
+
+            Assert::AreEqual(vExpected.size(), vResults.size());
+            for (size_t i = 0; i < vExpected.size(); ++i)
+            {
+                Assert::AreEqual(vExpected.at(i).nAddress, vResults.at(i).nAddress);
+                Assert::AreEqual(vExpected.at(i).nValue, vResults.at(i).nValue);
+            }
+        }
+
+        ra::services::search::vectorized::SetInstructionSet(nInstructionSet);
+    }
+
+    static void AssertVectorizedMatchesScalar(SearchType nSearchType)
+    {
+        for (const auto nCompareType : {ComparisonType::Equals, ComparisonType::NotEqualTo, ComparisonType::LessThan,
+                                        ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan,
+                                        ComparisonType::GreaterThanOrEqual})
+        {
+            AssertVectorizedMatchesScalar(nSearchType, nCompareType, SearchFilterType::Constant, L"2");
+            AssertVectorizedMatchesScalar(nSearchType, nCompareType, SearchFilterType::LastKnownValue, L"");
+            AssertVectorizedMatchesScalar(nSearchType, nCompareType, SearchFilterType::LastKnownValuePlus, L"1");
+        }
+    }
+
+public:
+    TEST_METHOD(TestVectorizedEightBit)
+    {
+        AssertVectorizedMatchesScalar(ra::services::SearchType::EightBit);
+    }
+
+    TEST_METHOD(TestVectorizedSixteenBitAligned)
+    {
+        AssertVectorizedMatchesScalar(ra::services::SearchType::SixteenBitAligned);
+    }
+
+    TEST_METHOD(TestVectorizedThirtyTwoBitAligned)
+    {
+        AssertVectorizedMatchesScalar(ra::services::SearchType::ThirtyTwoBitAligned);
+    }
+
+    TEST_METHOD(TestVectorizedSixteenBitUnaligned)
+    {
+        // unaligned sizes use the scalar implementation, but should not be affected by the instruction set
+        AssertVectorizedMatchesScalar(ra::services::SearchType::SixteenBit);
+    }
+
+private:
+    static std::vector<SearchResult> FilterLargeMemory(SearchType nSearchType, ComparisonType nCompareType,
+                                                       SearchFilterType nFilterType, const std::wstring& sFilterValue)
+    {
+        auto memory = std::make_unique<unsigned char[]>(BIG_BLOCK_SIZE);
+        for (unsigned int i = 0; i < BIG_BLOCK_SIZE; ++i)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>(i % 5);
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory.get(), BIG_BLOCK_SIZE);
+
+        SearchResults results1;
+        results1.Initialize(0U, BIG_BLOCK_SIZE, nSearchType);
+
+        // leave the last block unchanged so it can be reused
+        for (unsigned int i = 0; i < MAX_BLOCK_SIZE * 2; i += 7)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>((i * 11) % 6);
+
+        SearchResults results2;
+        results2.Initialize(results1, nCompareType, nFilterType, sFilterValue);
+
+        // second filter operates on the many small blocks generated by the first filter
+        for (unsigned int i = 1; i < BIG_BLOCK_SIZE; i += 13)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>((i * 3) % 4);
+
+        SearchResults results3;
+        results3.Initialize(results2, nCompareType, SearchFilterType::LastKnownValue, L"");
+
+        std::vector<SearchResult> vResults;
+        SearchResult result;
+        for (gsl::index i = 0; results3.GetMatchingAddress(i, result); ++i)
+            vResults.push_back(result);
+
+        return vResults;
+    }
+
+    static void AssertParallelMatchesSerial(SearchType nSearchType, ComparisonType nCompareType,
+                                            SearchFilterType nFilterType, const std::wstring& sFilterValue)
+    {
+        // without a thread pool, the filter is applied serially
+        const auto vExpected = FilterLargeMemory(nSearchType, nCompareType, nFilterType, sFilterValue);
+
+        for (const bool bSynchronous : {true, false})
+        {
+            ra::services::mocks::MockThreadPool mockThreadPool;
+            mockThreadPool.SetSynchronous(bSynchronous);
+
+            const auto vResults = FilterLargeMemory(nSearchType, nCompareType, nFilterType, sFilterValue);
+
+            Assert::AreEqual(vExpected.size(), vResults.size());
+            for (size_t i = 0; i < vExpected.size(); ++i)
+            {
+                Assert::AreEqual(vExpected.at(i).nAddress, vResults.at(i).nAddress);
+                Assert::AreEqual(vExpected.at(i).nValue, vResults.at(i).nValue);
+            }
+
+            // helpers that start after the filter completed should find nothing to do
+            while (mockThreadPool.PendingTasks() > 0)
+                mockThreadPool.ExecuteNextTask();
+        }
+    }
+
+    static void AssertParallelMatchesSerial(SearchType nSearchType)
+    {
+        for (const auto nCompareType : {ComparisonType::Equals, ComparisonType::NotEqualTo, ComparisonType::LessThan,
+                                        ComparisonType::GreaterThanOrEqual})
+        {
+            AssertParallelMatchesSerial(nSearchType, nCompareType, SearchFilterType::Constant, L"2");
+            AssertParallelMatchesSerial(nSearchType, nCompareType, SearchFilterType::LastKnownValue, L"");
+            AssertParallelMatchesSerial(nSearchType, nCompareType, SearchFilterType::LastKnownValuePlus, L"1");
+        }
+    }
+
+public:
+    TEST_METHOD(TestParallelEightBit)
+    {
+        AssertParallelMatchesSerial(ra::services::SearchType::EightBit);
+    }
+
+    TEST_METHOD(TestParallelFourBit)
+    {
+        AssertParallelMatchesSerial(ra::services::SearchType::FourBit);
+    }
+
+    TEST_METHOD(TestParallelSixteenBitBigEndian)
+    {
+        AssertParallelMatchesSerial(ra::services::SearchType::SixteenBitBigEndian);
+    }
+
+    TEST_METHOD(TestParallelThirtyTwoBitAligned)
+    {
+        AssertParallelMatchesSerial(ra::services::SearchType::ThirtyTwoBitAligned);
+    }
+
+    TEST_METHOD(TestCompressMemory)
+    {
+        auto memory = std::make_unique<unsigned char[]>(BIG_BLOCK_SIZE);
+        for (unsigned int i = 0; i < BIG_BLOCK_SIZE; ++i)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>((i / 100) % 7);
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory.get(), BIG_BLOCK_SIZE);
+
+        SearchResults results;
+        results.Initialize(0U, BIG_BLOCK_SIZE, ra::services::SearchType::SixteenBit);
+        const SearchResults resultsUncompressed = results;
+        results.CompressMemory();
+
+        SearchResult result;
+        for (unsigned int nAddress = 0; nAddress < BIG_BLOCK_SIZE - 1; nAddress += 997)
+        {
+            Assert::IsTrue(results.GetMatchingAddress(nAddress, result));
+            Assert::AreEqual(nAddress, result.nAddress);
+            GSL_SUPPRESS_BOUNDS4 Assert::AreEqual(static_cast<unsigned int>(memory[nAddress] | (memory[nAddress + 1] << 8)), result.nValue);
+        }
+
+        for (unsigned int i = 0; i < BIG_BLOCK_SIZE; i += 31)
+            GSL_SUPPRESS_BOUNDS4 memory[i]++;
+
+        SearchResults results1;
+        results1.Initialize(resultsUncompressed, ComparisonType::NotEqualTo, ra::services::SearchFilterType::LastKnownValue, L"");
+
+        SearchResults results2;
+        results2.Initialize(results, ComparisonType::NotEqualTo, ra::services::SearchFilterType::LastKnownValue, L"");
+
+        // compressed blocks are decoded by each thread the filter is distributed across
+        ra::services::mocks::MockThreadPool mockThreadPool;
+        SearchResults results3;
+        results3.Initialize(results, ComparisonType::NotEqualTo, ra::services::SearchFilterType::LastKnownValue, L"");
+
+        Assert::AreEqual(results1.MatchingAddressCount(), results2.MatchingAddressCount());
+        Assert::AreEqual(results1.MatchingAddressCount(), results3.MatchingAddressCount());
+
+        SearchResult result2, result3;
+        for (gsl::index i = 0; results1.GetMatchingAddress(i, result); ++i)
+        {
+            Assert::IsTrue(results2.GetMatchingAddress(i, result2));
+            Assert::IsTrue(results3.GetMatchingAddress(i, result3));
+            Assert::AreEqual(result.nAddress, result2.nAddress);
+            Assert::AreEqual(result.nValue, result2.nValue);
+            Assert::AreEqual(result.nAddress, result3.nAddress);
+            Assert::AreEqual(result.nValue, result3.nValue);
+        }
+
+        // decompressing should not change the values
+        results.DecompressMemory();
+        for (unsigned int nAddress = 0; nAddress < BIG_BLOCK_SIZE - 1; nAddress += 997)
+        {
+            Assert::IsTrue(results.GetMatchingAddress(nAddress, result));
+            Assert::AreEqual(nAddress, result.nAddress);
+            Assert::IsTrue(resultsUncompressed.GetMatchingAddress(nAddress, result2));
+            Assert::AreEqual(result2.nValue, result.nValue);
+        }
+    }
+
+    TEST_METHOD(TestCompressMemoryIncompressible)
+    {
+        auto memory = std::make_unique<unsigned char[]>(MAX_BLOCK_SIZE);
+        for (unsigned int i = 0; i < MAX_BLOCK_SIZE; ++i)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>(i * 7);
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory.get(), MAX_BLOCK_SIZE);
+
+        SearchResults results;
+        results.Initialize(0U, MAX_BLOCK_SIZE, ra::services::SearchType::EightBit);
+        results.CompressMemory();
+
+        SearchResult result;
+        for (unsigned int nAddress = 0; nAddress < MAX_BLOCK_SIZE; nAddress += 991)
+        {
+            Assert::IsTrue(results.GetMatchingAddress(nAddress, result));
+            Assert::AreEqual(nAddress, result.nAddress);
+            GSL_SUPPRESS_BOUNDS4 Assert::AreEqual(static_cast<unsigned int>(memory[nAddress]), result.nValue);
+        }
+    }
+
+private:
+    static void AssertModifiedMemoryMatchesFullFilter(SearchType nSearchType, ComparisonType nCompareType,
+        SearchFilterType nFilterType, const std::wstring& sFilterValue, bool bEvaluatesUnmodified)
+    {
+        auto memory = std::make_unique<unsigned char[]>(BIG_BLOCK_SIZE);
+        for (unsigned int i = 0; i < BIG_BLOCK_SIZE; ++i)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>((i % 8) ? 0 : (i % 5));
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory.get(), BIG_BLOCK_SIZE);
+
+        SearchResults results1;
+        results1.Initialize(0U, BIG_BLOCK_SIZE, nSearchType);
+
+        for (unsigned int i = 0; i < BIG_BLOCK_SIZE; i += 7)
+            GSL_SUPPRESS_BOUNDS4 memory[i] = gsl::narrow_cast<unsigned char>((i * 11) % 6);
+
+        SearchResults results2;
+        results2.Initialize(results1, nCompareType, nFilterType, sFilterValue);
+        Assert::IsTrue(results2.MatchingAddressCount() > 0);
+
+        // only modify a few scattered addresses
+        std::set<ra::data::ByteAddress> vModifiedAddresses;
+        for (unsigned int i = 3; i < BIG_BLOCK_SIZE; i += 4099)
+        {
+            GSL_SUPPRESS_BOUNDS4 memory[i] ^= 0x01;
+            vModifiedAddresses.insert(i);
+        }
+
+        SearchResults results3;
+        results3.Initialize(results2, nCompareType, nFilterType, sFilterValue);
+
+        size_t nEvaluated = 0;
+        SearchResults results4;
+        Assert::IsTrue(results4.InitializeFromModifiedMemory(results2,
+            [&vModifiedAddresses](ra::data::ByteAddress nAddress, uint32_t nBytes) {
+                const auto pIter = vModifiedAddresses.lower_bound(nAddress);
+                return (pIter != vModifiedAddresses.end() && *pIter < nAddress + nBytes);
+            },
+            [&nEvaluated](SearchResults& srNew, const SearchResults& srModified) {
+                nEvaluated += srModified.MatchingAddressCount();
+                return srNew.Initialize(srModified, srModified.GetFilterComparison(),
+                    srModified.GetFilterType(), srModified.GetFilterString());
+            }));
+
+        if (bEvaluatesUnmodified)
+            Assert::AreEqual(results2.MatchingAddressCount(), nEvaluated);
+        else
+            Assert::IsTrue(nEvaluated < results2.MatchingAddressCount());
+
+        Assert::AreEqual(results3.GetFilterComparison(), results4.GetFilterComparison());
+        Assert::AreEqual(results3.GetFilterType(), results4.GetFilterType());
+        Assert::AreEqual(results3.GetFilterValue(), results4.GetFilterValue());
+        Assert::AreEqual(results3.MatchingAddressCount(), results4.MatchingAddressCount());
+
+        SearchResult result3, result4;
+        for (gsl::index i = 0; results3.GetMatchingAddress(i, result3); ++i)
+        {
+            Assert::IsTrue(results4.GetMatchingAddress(i, result4));
+            Assert::AreEqual(result3.nAddress, result4.nAddress);
+            Assert::AreEqual(result3.nValue, result4.nValue);
+        }
+    }
+
+    static void AssertModifiedMemoryMatchesFullFilter(SearchType nSearchType)
+    {
+        AssertModifiedMemoryMatchesFullFilter(nSearchType, ComparisonType::Equals, SearchFilterType::Constant, L"2", false);
+        AssertModifiedMemoryMatchesFullFilter(nSearchType, ComparisonType::LessThan, SearchFilterType::Constant, L"2", false);
+        AssertModifiedMemoryMatchesFullFilter(nSearchType, ComparisonType::Equals, SearchFilterType::LastKnownValue, L"", false);
+        AssertModifiedMemoryMatchesFullFilter(nSearchType, ComparisonType::NotEqualTo, SearchFilterType::LastKnownValue, L"", false);
+        AssertModifiedMemoryMatchesFullFilter(nSearchType, ComparisonType::GreaterThan, SearchFilterType::LastKnownValue, L"", false);
+        AssertModifiedMemoryMatchesFullFilter(nSearchType, ComparisonType::GreaterThanOrEqual, SearchFilterType::LastKnownValue, L"", true);
+        AssertModifiedMemoryMatchesFullFilter(nSearchType, ComparisonType::Equals, SearchFilterType::LastKnownValuePlus, L"1", true);
+    }
+
+public:
+    TEST_METHOD(TestInitializeFromModifiedMemoryEightBit)
+    {
+        AssertModifiedMemoryMatchesFullFilter(ra::services::SearchType::EightBit);
+    }
+
+    TEST_METHOD(TestInitializeFromModifiedMemoryFourBit)
+    {
+        AssertModifiedMemoryMatchesFullFilter(ra::services::SearchType::FourBit);
+    }
+
+    TEST_METHOD(TestInitializeFromModifiedMemoryThirtyTwoBitAligned)
+    {
+        AssertModifiedMemoryMatchesFullFilter(ra::services::SearchType::ThirtyTwoBitAligned);
+    }
+
+    TEST_METHOD(TestGetCapturedMemoryRanges)
+    {
+        std::array<unsigned char, 32> memory{};
+        ra::context::mocks::MockEmulatorMemoryContext mockMemoryContext;
+        mockMemoryContext.MockMemory(memory);
+
+        SearchResults results;
+        results.Initialize(4U, 20U, ra::services::SearchType::SixteenBit);
+
+        const auto vRanges = results.GetCapturedMemoryRanges();
+        Assert::AreEqual({ 1U }, vRanges.size());
+        Assert::AreEqual(4U, vRanges.at(0).first);
+        Assert::AreEqual(20U, vRanges.at(0).second);
+    }
 };
 
 } // namespace tests
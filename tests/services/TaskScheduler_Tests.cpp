@@ -0,0 +1,362 @@
+#include "services\impl\TaskScheduler.hh"
+
+#include "util\TypeCasts.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace impl {
+namespace tests {
+
+TEST_CLASS(TaskScheduler_Tests)
+{
+private:
+    class TaskSchedulerHarness : public TaskScheduler
+    {
+    public:
+        explicit TaskSchedulerHarness(size_t nWorkers) : TaskScheduler(nWorkers) {}
+
+        void Push(TaskPriority nPriority, const std::string& sName, size_t nWorker = NO_WORKER)
+        {
+            TaskScheduler::Push(nPriority, [this, sName]() { vExecuted.push_back(sName); }, nWorker);
+        }
+
+        void Schedule(TimePoint tWhen, const std::string& sName, bool bExpectedFirst)
+        {
+            Assert::AreEqual(bExpectedFirst,
+                TaskScheduler::Schedule(tWhen, [this, sName]() { vExecuted.push_back(sName); }));
+        }
+
+        // runs the next task for the worker and returns its name, or an empty string if there wasn't one
+        std::string RunNext(size_t nWorker, TaskPriority nExpectedPriority, bool bComplete = true)
+        {
+            Task fTask;
+            TaskPriority nPriority = TaskPriority::Normal;
+            if (!TryPop(nWorker, fTask, nPriority))
+                return "";
+
+            Assert::AreEqual(ra::etoi(nExpectedPriority), ra::etoi(nPriority));
+
+            vExecuted.clear();
+            fTask();
+            if (bComplete)
+                Complete(nPriority);
+
+            Assert::AreEqual({ 1U }, vExecuted.size());
+            return vExecuted.front();
+        }
+
+        void AssertNoTask(size_t nWorker)
+        {
+            Assert::IsFalse(HasAvailableTask());
+
+            Task fTask;
+            TaskPriority nPriority = TaskPriority::Normal;
+            Assert::IsFalse(TryPop(nWorker, fTask, nPriority));
+        }
+
+        std::vector<std::string> vExecuted;
+    };
+
+    static TaskScheduler::TimePoint At(int nMilliseconds)
+    {
+        return TaskScheduler::TimePoint() + std::chrono::milliseconds(nMilliseconds);
+    }
+
+public:
+    TEST_METHOD(TestEmpty)
+    {
+        TaskSchedulerHarness scheduler(2);
+        Assert::AreEqual({ 2U }, scheduler.GetWorkerCount());
+        Assert::AreEqual({ 0U }, scheduler.GetQueuedTaskCount());
+        Assert::IsTrue(scheduler.GetNextDelayedTaskTime() == TaskScheduler::TimePoint::max());
+        scheduler.AssertNoTask(0);
+        scheduler.AssertNoTask(TaskScheduler::NO_WORKER);
+    }
+
+    TEST_METHOD(TestPriorityOrder)
+    {
+        TaskSchedulerHarness scheduler(2);
+        scheduler.Push(TaskPriority::Low, "low1");
+        scheduler.Push(TaskPriority::Normal, "normal1");
+        scheduler.Push(TaskPriority::High, "high1");
+        scheduler.Push(TaskPriority::Low, "low2");
+        scheduler.Push(TaskPriority::Normal, "normal2");
+        scheduler.Push(TaskPriority::High, "high2");
+        Assert::AreEqual({ 6U }, scheduler.GetQueuedTaskCount());
+        Assert::IsTrue(scheduler.HasAvailableTask());
+
+        Assert::AreEqual(std::string("high1"), scheduler.RunNext(0, TaskPriority::High));
+        Assert::AreEqual(std::string("high2"), scheduler.RunNext(1, TaskPriority::High));
+        Assert::AreEqual(std::string("normal1"), scheduler.RunNext(0, TaskPriority::Normal));
+        Assert::AreEqual(std::string("normal2"), scheduler.RunNext(1, TaskPriority::Normal));
+        Assert::AreEqual(std::string("low1"), scheduler.RunNext(0, TaskPriority::Low));
+        Assert::AreEqual(std::string("low2"), scheduler.RunNext(1, TaskPriority::Low));
+        Assert::AreEqual({ 0U }, scheduler.GetQueuedTaskCount());
+        scheduler.AssertNoTask(0);
+    }
+
+    TEST_METHOD(TestWorkerQueueNewestFirst)
+    {
+        TaskSchedulerHarness scheduler(2);
+        scheduler.Push(TaskPriority::Normal, "external");
+        scheduler.Push(TaskPriority::Normal, "local1", 0);
+        scheduler.Push(TaskPriority::Normal, "local2", 0);
+        Assert::AreEqual({ 3U }, scheduler.GetQueuedTaskCount());
+
+        // a worker runs its own tasks (newest first) before tasks queued by non-workers
+        Assert::AreEqual(std::string("local2"), scheduler.RunNext(0, TaskPriority::Normal));
+        Assert::AreEqual(std::string("local1"), scheduler.RunNext(0, TaskPriority::Normal));
+        Assert::AreEqual(std::string("external"), scheduler.RunNext(0, TaskPriority::Normal));
+        scheduler.AssertNoTask(0);
+    }
+
+    TEST_METHOD(TestWorkerQueueStealOldestFirst)
+    {
+        TaskSchedulerHarness scheduler(3);
+        scheduler.Push(TaskPriority::Normal, "local1", 0);
+        scheduler.Push(TaskPriority::Normal, "local2", 0);
+        scheduler.Push(TaskPriority::Normal, "local3", 0);
+
+        // idle workers take the oldest tasks from the busy worker
+        Assert::AreEqual(std::string("local1"), scheduler.RunNext(1, TaskPriority::Normal));
+        Assert::AreEqual(std::string("local2"), scheduler.RunNext(2, TaskPriority::Normal));
+        Assert::AreEqual(std::string("local3"), scheduler.RunNext(TaskScheduler::NO_WORKER, TaskPriority::Normal));
+        scheduler.AssertNoTask(0);
+    }
+
+    TEST_METHOD(TestWorkerQueueExternalBeforeSteal)
+    {
+        TaskSchedulerHarness scheduler(2);
+        scheduler.Push(TaskPriority::Normal, "local", 0);
+        scheduler.Push(TaskPriority::Normal, "external");
+
+        Assert::AreEqual(std::string("external"), scheduler.RunNext(1, TaskPriority::Normal));
+        Assert::AreEqual(std::string("local"), scheduler.RunNext(1, TaskPriority::Normal));
+    }
+
+    TEST_METHOD(TestWorkerQueueStealVictimOrder)
+    {
+        TaskSchedulerHarness scheduler(4);
+        scheduler.Push(TaskPriority::Normal, "worker0", 0);
+        scheduler.Push(TaskPriority::Normal, "worker1", 1);
+        scheduler.Push(TaskPriority::Normal, "worker3", 3);
+
+        // workers look for tasks to steal starting with the next worker
+        Assert::AreEqual(std::string("worker3"), scheduler.RunNext(2, TaskPriority::Normal));
+        Assert::AreEqual(std::string("worker0"), scheduler.RunNext(2, TaskPriority::Normal));
+        Assert::AreEqual(std::string("worker1"), scheduler.RunNext(2, TaskPriority::Normal));
+    }
+
+    TEST_METHOD(TestWorkerHighAndLowPriorityShared)
+    {
+        TaskSchedulerHarness scheduler(2);
+        scheduler.Push(TaskPriority::Normal, "local", 0);
+        scheduler.Push(TaskPriority::High, "high", 0);
+        scheduler.Push(TaskPriority::Low, "low", 0);
+
+        // high and low priority tasks are not kept on the worker that queued them
+        Assert::AreEqual(std::string("high"), scheduler.RunNext(1, TaskPriority::High));
+        Assert::AreEqual(std::string("local"), scheduler.RunNext(1, TaskPriority::Normal));
+        Assert::AreEqual(std::string("low"), scheduler.RunNext(1, TaskPriority::Low));
+    }
+
+    TEST_METHOD(TestHighPriorityBeforeWorkerQueue)
+    {
+        TaskSchedulerHarness scheduler(2);
+        scheduler.Push(TaskPriority::Normal, "local", 0);
+        scheduler.Push(TaskPriority::High, "high");
+
+        Assert::AreEqual(std::string("high"), scheduler.RunNext(0, TaskPriority::High));
+        Assert::AreEqual(std::string("local"), scheduler.RunNext(0, TaskPriority::Normal));
+    }
+
+    TEST_METHOD(TestLowPriorityLimit)
+    {
+        TaskSchedulerHarness scheduler(3);
+        scheduler.Push(TaskPriority::Low, "low1");
+        scheduler.Push(TaskPriority::Low, "low2");
+        scheduler.Push(TaskPriority::Low, "low3");
+
+        // only two of the three workers can run low priority tasks at the same time
+        Assert::AreEqual(std::string("low1"), scheduler.RunNext(0, TaskPriority::Low, false));
+        Assert::AreEqual(std::string("low2"), scheduler.RunNext(1, TaskPriority::Low, false));
+        scheduler.AssertNoTask(2);
+        Assert::AreEqual({ 1U }, scheduler.GetQueuedTaskCount());
+
+        // the remaining worker is available for other tasks
+        scheduler.Push(TaskPriority::High, "high");
+        Assert::IsTrue(scheduler.HasAvailableTask());
+        Assert::AreEqual(std::string("high"), scheduler.RunNext(2, TaskPriority::High));
+        scheduler.Push(TaskPriority::Normal, "normal");
+        Assert::AreEqual(std::string("normal"), scheduler.RunNext(2, TaskPriority::Normal));
+        scheduler.AssertNoTask(2);
+
+        // when a low priority task completes, another can start
+        scheduler.Complete(TaskPriority::Low);
+        Assert::IsTrue(scheduler.HasAvailableTask());
+        Assert::AreEqual(std::string("low3"), scheduler.RunNext(2, TaskPriority::Low, false));
+        scheduler.AssertNoTask(0);
+    }
+
+    TEST_METHOD(TestLowPriorityLimitSingleWorker)
+    {
+        TaskSchedulerHarness scheduler(1);
+        scheduler.Push(TaskPriority::Low, "low1");
+        scheduler.Push(TaskPriority::Low, "low2");
+
+        // with only one worker, low priority tasks still have to run
+        Assert::AreEqual(std::string("low1"), scheduler.RunNext(0, TaskPriority::Low, false));
+        scheduler.AssertNoTask(0);
+        scheduler.Complete(TaskPriority::Low);
+        Assert::AreEqual(std::string("low2"), scheduler.RunNext(0, TaskPriority::Low));
+    }
+
+    TEST_METHOD(TestDelayedTaskOrder)
+    {
+        TaskSchedulerHarness scheduler(2);
+        scheduler.Schedule(At(30), "at30", true);
+        scheduler.Schedule(At(10), "at10a", true);
+        scheduler.Schedule(At(20), "at20", false);
+        scheduler.Schedule(At(10), "at10b", false);
+        scheduler.Schedule(At(40), "at40", false);
+        Assert::IsTrue(scheduler.GetNextDelayedTaskTime() == At(10));
+        Assert::AreEqual({ 0U }, scheduler.GetQueuedTaskCount());
+        scheduler.AssertNoTask(0);
+
+        Assert::AreEqual({ 0U }, scheduler.PromoteDelayedTasks(At(9)));
+        scheduler.AssertNoTask(0);
+
+        // tasks scheduled for the same time are made available in the order they were scheduled
+        Assert::AreEqual({ 2U }, scheduler.PromoteDelayedTasks(At(15)));
+        Assert::IsTrue(scheduler.GetNextDelayedTaskTime() == At(20));
+        Assert::AreEqual(std::string("at10a"), scheduler.RunNext(0, TaskPriority::Normal));
+        Assert::AreEqual(std::string("at10b"), scheduler.RunNext(0, TaskPriority::Normal));
+        scheduler.AssertNoTask(0);
+
+        Assert::AreEqual({ 2U }, scheduler.PromoteDelayedTasks(At(30)));
+        Assert::IsTrue(scheduler.GetNextDelayedTaskTime() == At(40));
+        Assert::AreEqual(std::string("at20"), scheduler.RunNext(0, TaskPriority::Normal));
+        Assert::AreEqual(std::string("at30"), scheduler.RunNext(0, TaskPriority::Normal));
+
+        Assert::AreEqual({ 1U }, scheduler.PromoteDelayedTasks(At(100)));
+        Assert::IsTrue(scheduler.GetNextDelayedTaskTime() == TaskScheduler::TimePoint::max());
+        Assert::AreEqual(std::string("at40"), scheduler.RunNext(0, TaskPriority::Normal));
+        scheduler.AssertNoTask(0);
+    }
+
+    TEST_METHOD(TestDelayedTaskManyOutOfOrder)
+    {
+        TaskSchedulerHarness scheduler(2);
+
+        // schedule in a scrambled order. 37 is coprime with 1000, so each time is used once.
+        for (int i = 0; i < 1000; ++i)
+        {
+            const int nTime = (i * 37) % 1000;
+            scheduler.Schedule(At(nTime), std::to_string(nTime), nTime == 0);
+        }
+
+        Assert::AreEqual({ 1000U }, scheduler.PromoteDelayedTasks(At(1000)));
+        for (int i = 0; i < 1000; ++i)
+            Assert::AreEqual(std::to_string(i), scheduler.RunNext(1, TaskPriority::Normal));
+
+        scheduler.AssertNoTask(1);
+    }
+
+    TEST_METHOD(TestDelayedTaskBeforeQueuedTasks)
+    {
+        TaskSchedulerHarness scheduler(2);
+        scheduler.Push(TaskPriority::Normal, "normal");
+        scheduler.Push(TaskPriority::High, "high");
+        scheduler.Schedule(At(10), "delayed1", true);
+        scheduler.Schedule(At(20), "delayed2", false);
+
+        // delayed tasks run ahead of other normal priority tasks, but not ahead of high priority tasks
+        Assert::AreEqual({ 2U }, scheduler.PromoteDelayedTasks(At(20)));
+        Assert::AreEqual({ 4U }, scheduler.GetQueuedTaskCount());
+        Assert::AreEqual(std::string("high"), scheduler.RunNext(0, TaskPriority::High));
+        Assert::AreEqual(std::string("delayed1"), scheduler.RunNext(0, TaskPriority::Normal));
+        Assert::AreEqual(std::string("delayed2"), scheduler.RunNext(0, TaskPriority::Normal));
+        Assert::AreEqual(std::string("normal"), scheduler.RunNext(0, TaskPriority::Normal));
+    }
+
+    TEST_METHOD(TestClear)
+    {
+        TaskSchedulerHarness scheduler(2);
+        scheduler.Push(TaskPriority::High, "high");
+        scheduler.Push(TaskPriority::Normal, "normal");
+        scheduler.Push(TaskPriority::Normal, "local", 1);
+        scheduler.Push(TaskPriority::Low, "low");
+        scheduler.Schedule(At(10), "delayed", true);
+        Assert::AreEqual({ 4U }, scheduler.GetQueuedTaskCount());
+
+        scheduler.Clear();
+        Assert::AreEqual({ 0U }, scheduler.GetQueuedTaskCount());
+        Assert::IsTrue(scheduler.GetNextDelayedTaskTime() == TaskScheduler::TimePoint::max());
+        Assert::AreEqual({ 0U }, scheduler.PromoteDelayedTasks(At(100)));
+        scheduler.AssertNoTask(0);
+        scheduler.AssertNoTask(1);
+    }
+
+    TEST_METHOD(TestConcurrentPushAndPop)
+    {
+        TaskScheduler scheduler(4);
+        std::atomic<int> nExecuted{ 0 };
+        std::atomic<int> nRunningLow{ 0 };
+        std::atomic<int> nMaxRunningLow{ 0 };
+
+        // every worker queues its own tasks while taking tasks from the others
+        std::vector<std::thread> vThreads;
+        for (size_t nWorker = 0; nWorker < 4; ++nWorker)
+        {
+            vThreads.emplace_back([&, nWorker]() {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    const auto nPriority = ra::itoe<TaskPriority>(i % 3);
+                    scheduler.Push(nPriority, [&nExecuted, &nRunningLow, &nMaxRunningLow, nPriority]() {
+                        if (nPriority == TaskPriority::Low)
+                        {
+                            const int nRunning = ++nRunningLow;
+                            int nMax = nMaxRunningLow;
+                            while (nRunning > nMax && !nMaxRunningLow.compare_exchange_weak(nMax, nRunning))
+                                continue;
+                            --nRunningLow;
+                        }
+                        ++nExecuted;
+                    }, nWorker);
+
+                    TaskScheduler::Task fTask;
+                    TaskPriority nPopped = TaskPriority::Normal;
+                    if (scheduler.TryPop(nWorker, fTask, nPopped))
+                    {
+                        fTask();
+                        scheduler.Complete(nPopped);
+                    }
+                }
+            });
+        }
+
+        for (auto& pThread : vThreads)
+            pThread.join();
+
+        TaskScheduler::Task fTask;
+        TaskPriority nPopped = TaskPriority::Normal;
+        while (scheduler.TryPop(0, fTask, nPopped))
+        {
+            fTask();
+            scheduler.Complete(nPopped);
+        }
+
+        Assert::AreEqual(4000, nExecuted.load());
+        Assert::AreEqual({ 0U }, scheduler.GetQueuedTaskCount());
+        Assert::IsTrue(nMaxRunningLow.load() <= 3);
+    }
+};
+
+} // namespace tests
+} // namespace impl
+} // namespace services
+} // namespace ra
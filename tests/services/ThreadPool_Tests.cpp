@@ -0,0 +1,167 @@
+#include "services\impl\ThreadPool.hh"
+
+#include "services\impl\Clock.hh"
+
+#include "tests\RA_UnitTestHelpers.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ra {
+namespace services {
+namespace impl {
+namespace tests {
+
+TEST_CLASS(ThreadPool_Tests)
+{
+private:
+    // waits up to five seconds for a condition to be met by the background threads
+    static bool WaitFor(std::function<bool()> fCondition)
+    {
+        const auto tTimeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!fCondition())
+        {
+            if (std::chrono::steady_clock::now() > tTimeout)
+                return false;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return true;
+    }
+
+    class Gate
+    {
+    public:
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_oMutex);
+            m_cvOpen.wait(lock, [this]() noexcept { return m_bOpen; });
+        }
+
+        void Open()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_oMutex);
+                m_bOpen = true;
+            }
+            m_cvOpen.notify_all();
+        }
+
+    private:
+        std::mutex m_oMutex;
+        std::condition_variable m_cvOpen;
+        bool m_bOpen = false;
+    };
+
+public:
+    TEST_METHOD(TestRunAsync)
+    {
+        ThreadPool pool;
+        pool.Initialize(4);
+
+        std::atomic<int> nExecuted{ 0 };
+        for (int i = 0; i < 1000; ++i)
+            pool.RunAsync([&nExecuted]() { ++nExecuted; });
+
+        Assert::IsTrue(WaitFor([&nExecuted]() { return nExecuted == 1000; }));
+        pool.Shutdown(true);
+    }
+
+    TEST_METHOD(TestRunAsyncFromWorker)
+    {
+        ThreadPool pool;
+        pool.Initialize(4);
+
+        std::atomic<int> nExecuted{ 0 };
+        for (int i = 0; i < 10; ++i)
+        {
+            pool.RunAsync([&pool, &nExecuted]() {
+                for (int j = 0; j < 100; ++j)
+                    pool.RunAsync([&nExecuted]() { ++nExecuted; });
+            });
+        }
+
+        Assert::IsTrue(WaitFor([&nExecuted]() { return nExecuted == 1000; }));
+        pool.Shutdown(true);
+    }
+
+    TEST_METHOD(TestHighPriorityNotBlockedByLowPriority)
+    {
+        ThreadPool pool;
+        pool.Initialize(2);
+
+        // occupy as many threads with low priority tasks as possible
+        Gate gate;
+        std::atomic<int> nLowExecuted{ 0 };
+        for (int i = 0; i < 10; ++i)
+        {
+            pool.RunAsync(TaskPriority::Low, [&gate, &nLowExecuted]() {
+                gate.Wait();
+                ++nLowExecuted;
+            });
+        }
+
+        std::atomic<bool> bHighExecuted{ false };
+        pool.RunAsync(TaskPriority::High, [&bHighExecuted]() { bHighExecuted = true; });
+        Assert::IsTrue(WaitFor([&bHighExecuted]() { return bHighExecuted.load(); }));
+
+        std::atomic<bool> bNormalExecuted{ false };
+        pool.RunAsync([&bNormalExecuted]() { bNormalExecuted = true; });
+        Assert::IsTrue(WaitFor([&bNormalExecuted]() { return bNormalExecuted.load(); }));
+
+        Assert::AreEqual(0, nLowExecuted.load());
+        gate.Open();
+        Assert::IsTrue(WaitFor([&nLowExecuted]() { return nLowExecuted == 10; }));
+        pool.Shutdown(true);
+    }
+
+    TEST_METHOD(TestScheduleAsync)
+    {
+        Clock clock;
+        ServiceLocator::ServiceOverride<IClock> pClockOverride(&clock);
+
+        ThreadPool pool;
+        pool.Initialize(2);
+
+        std::mutex oMutex;
+        std::vector<int> vExecuted;
+        pool.ScheduleAsync(std::chrono::milliseconds(60), [&oMutex, &vExecuted]() {
+            std::lock_guard<std::mutex> lock(oMutex);
+            vExecuted.push_back(60);
+        });
+        pool.ScheduleAsync(std::chrono::milliseconds(10), [&oMutex, &vExecuted]() {
+            std::lock_guard<std::mutex> lock(oMutex);
+            vExecuted.push_back(10);
+        });
+
+        Assert::IsTrue(WaitFor([&oMutex, &vExecuted]() {
+            std::lock_guard<std::mutex> lock(oMutex);
+            return vExecuted.size() == 2;
+        }));
+
+        pool.Shutdown(true);
+        Assert::AreEqual(10, vExecuted.at(0));
+        Assert::AreEqual(60, vExecuted.at(1));
+    }
+
+    TEST_METHOD(TestShutdown)
+    {
+        ThreadPool pool;
+        pool.Initialize(2);
+        Assert::IsFalse(pool.IsShutdownRequested());
+
+        pool.Shutdown(true);
+        Assert::IsTrue(pool.IsShutdownRequested());
+
+        // tasks queued after shutdown are ignored
+        bool bExecuted = false;
+        pool.RunAsync([&bExecuted]() { bExecuted = true; });
+        pool.RunAsync(TaskPriority::High, [&bExecuted]() { bExecuted = true; });
+        Assert::IsFalse(bExecuted);
+    }
+};
+
+} // namespace tests
+} // namespace impl
+} // namespace services
+} // namespace ra
@@ -166,6 +166,41 @@ TEST_CLASS(ViewModelCollection_Tests)
         std::map<gsl::index, std::string> m_nChanges;
     };
 
+    class BatchingNotifyTargetHarness : public NotifyTargetHarness
+    {
+    public:
+        bool BatchesValueChanges() const noexcept override { return true; }
+
+        void OnViewModelValuesChanged(const std::vector<ViewModelCollectionBase::ChangedValue>& vChangedValues) override
+        {
+            ++m_nBatches;
+            m_vChangedValues = vChangedValues;
+        }
+
+        void AssertBatch(const std::vector<std::pair<gsl::index, const ra::data::ModelPropertyBase*>>& vExpected)
+        {
+            Assert::AreEqual(1, m_nBatches);
+            Assert::AreEqual(vExpected.size(), m_vChangedValues.size());
+            for (size_t i = 0; i < vExpected.size(); ++i)
+            {
+                Assert::AreEqual(vExpected.at(i).first, m_vChangedValues.at(i).nIndex);
+                Assert::AreEqual(vExpected.at(i).second->GetPropertyName(), m_vChangedValues.at(i).pProperty->GetPropertyName());
+            }
+
+            m_nBatches = 0;
+            m_vChangedValues.clear();
+        }
+
+        void AssertNoBatch()
+        {
+            Assert::AreEqual(0, m_nBatches);
+        }
+
+    private:
+        int m_nBatches = 0;
+        std::vector<ViewModelCollectionBase::ChangedValue> m_vChangedValues;
+    };
+
 public:
     TEST_METHOD(TestAddWithoutSubscription)
     {
@@ -697,6 +732,76 @@ public:
         Assert::AreEqual((void*)&pItem5, (void*)vmCollection.GetItemAt(5));
     }
 
+    TEST_METHOD(TestBatchedValueChanges)
+    {
+        ViewModelCollection<TestViewModel> vmCollection;
+        auto& pItem1 = vmCollection.Add(1, L"Test1");
+        auto& pItem2 = vmCollection.Add(2, L"Test2");
+        vmCollection.Add(3, L"Test3");
+
+        NotifyTargetHarness oNotify;
+        vmCollection.AddNotifyTarget(oNotify);
+        BatchingNotifyTargetHarness oBatchNotify;
+        vmCollection.AddNotifyTarget(oBatchNotify);
+
+        // when not updating, changes are delivered immediately
+        pItem1.SetInt(4);
+        oNotify.AssertIntChanged(TestViewModel::IntProperty, 0, 1, 4);
+        oBatchNotify.AssertIntChanged(TestViewModel::IntProperty, 0, 1, 4);
+        oBatchNotify.AssertNoBatch();
+
+        vmCollection.BeginUpdate();
+
+        pItem2.SetInt(5);
+        oNotify.AssertIntChanged(TestViewModel::IntProperty, 1, 2, 5);
+        oBatchNotify.AssertNotChanged();
+
+        pItem2.SetInt(6);
+        pItem2.SetBool(true);
+        pItem1.SetString(L"Test1a");
+        oNotify.AssertStringChanged(TestViewModel::StringProperty, 0, L"Test1", L"Test1a");
+        oBatchNotify.AssertNotChanged();
+        oBatchNotify.AssertNoBatch();
+
+        vmCollection.EndUpdate();
+
+        // each changed property is only reported once per item, ordered by item
+        oBatchNotify.AssertBatch({
+            {0, &TestViewModel::StringProperty},
+            {1, &TestViewModel::IntProperty},
+            {1, &TestViewModel::BoolProperty},
+        });
+    }
+
+    TEST_METHOD(TestBatchedValueChangesWithAddRemove)
+    {
+        ViewModelCollection<TestViewModel> vmCollection;
+        auto& pItem1 = vmCollection.Add(1, L"Test1");
+        vmCollection.Add(2, L"Test2");
+        auto& pItem3 = vmCollection.Add(3, L"Test3");
+        auto& pItem4 = vmCollection.Add(4, L"Test4");
+
+        BatchingNotifyTargetHarness oBatchNotify;
+        vmCollection.AddNotifyTarget(oBatchNotify);
+
+        vmCollection.BeginUpdate();
+        pItem1.SetInt(5);
+        pItem3.SetInt(6);
+        pItem4.SetString(L"Test4a");
+        vmCollection.RemoveAt(0);
+        vmCollection.Add(7, L"Test7");
+        vmCollection.MoveItem(3, 0);
+        vmCollection.EndUpdate();
+
+        // change to removed item is discarded. changes to other items are reported at their new indices.
+        Assert::AreEqual((void*)&pItem3, (void*)vmCollection.GetItemAt(2));
+        Assert::AreEqual((void*)&pItem4, (void*)vmCollection.GetItemAt(3));
+        oBatchNotify.AssertBatch({
+            {2, &TestViewModel::IntProperty},
+            {3, &TestViewModel::StringProperty},
+        });
+    }
+
     TEST_METHOD(TestShiftItemsUp)
     {
         ViewModelCollection<TestViewModel> vmCollection;
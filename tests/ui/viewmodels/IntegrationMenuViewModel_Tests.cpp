@@ -15,12 +15,16 @@
 #include "ui\viewmodels\RichPresenceMonitorViewModel.hh"
 #include "ui\viewmodels\UnknownGameViewModel.hh"
 
+#include "services\PerformanceCounter.hh"
+
 #include "tests\data\DataAsserts.hh"
 #include "tests\ui\UIAsserts.hh"
 #include "tests\devkit\context\mocks\MockConsoleContext.hh"
 #include "tests\devkit\context\mocks\MockEmulatorMemoryContext.hh"
 #include "tests\devkit\context\mocks\MockRcClient.hh"
 #include "tests\devkit\context\mocks\MockUserContext.hh"
+#include "tests\devkit\services\mocks\MockClock.hh"
+#include "tests\devkit\services\mocks\MockFileSystem.hh"
 #include "tests\devkit\services\mocks\MockLocalStorage.hh"
 #include "tests\devkit\services\mocks\MockThreadPool.hh"
 #include "tests\mocks\MockAchievementRuntime.hh"
@@ -94,6 +98,13 @@ private:
             AssertMenuItem(nIndex, 0, L"-----");
         }
 
+        void AssertMenuItemSelected(gsl::index nIndex, bool bSelected)
+        {
+            const auto* vmItem = m_vmItems.GetItemAt(nIndex);
+            Expects(vmItem != nullptr);
+            Assert::AreEqual(bSelected, vmItem->IsSelected());
+        }
+
         template<typename T>
         void AssertShowWindow(int nMenuItemId, bool bHardcore, const std::string& sWarningMessage, DialogResult nConfirmResult)
         {
@@ -223,6 +234,24 @@ public:
         menu.AssertMenuItem(17, IDM_RA_GETROMCHECKSUM, L"View Game H&ash");
     }
 
+    TEST_METHOD(TestBuildMenuProfiler)
+    {
+        IntegrationMenuViewModelHarness menu;
+        ra::services::mocks::MockClock mockClock;
+        ra::services::PerformanceCounter counter;
+        ra::services::ServiceLocator::ServiceOverride<ra::services::PerformanceCounter> counterOverride(&counter);
+        menu.mockConfiguration.SetFeatureEnabled(ra::services::Feature::PerformanceProfiler, true);
+        counter.SetEnabled(true);
+
+        menu.BuildMenu();
+
+        menu.AssertMenuSize(20);
+        menu.AssertMenuItem(17, IDM_RA_FILES_POINTERINSPECTOR, L"Pointer &Inspector");
+        menu.AssertMenuSeparator(18);
+        menu.AssertMenuItem(19, IDM_RA_TOGGLEPROFILER, L"Record Performance &Trace");
+        menu.AssertMenuItemSelected(19, true);
+    }
+
     TEST_METHOD(TestLoginHardcoreValidClient)
     {
         IntegrationMenuViewModelHarness menu;
@@ -447,6 +476,52 @@ public:
         Assert::IsTrue(bMenuRebuilt);
     }
 
+    TEST_METHOD(TestToggleProfilerEnabled)
+    {
+        IntegrationMenuViewModelHarness menu;
+        ra::services::mocks::MockClock mockClock;
+        ra::services::mocks::MockFileSystem mockFileSystem;
+        ra::services::PerformanceCounter counter;
+        ra::services::ServiceLocator::ServiceOverride<ra::services::PerformanceCounter> counterOverride(&counter);
+        bool bMenuRebuilt = false;
+        menu.mockEmulatorContext.SetRebuildMenuFunction([&bMenuRebuilt]() { bMenuRebuilt = true;  });
+
+        menu.ActivateMenuItem(IDM_RA_TOGGLEPROFILER);
+
+        Assert::IsTrue(counter.IsEnabled());
+        Assert::IsFalse(menu.mockDesktop.WasDialogShown());
+        Assert::AreEqual(std::string(), mockFileSystem.GetFileContents(L".\\RACache\\Profile.json"));
+        Assert::IsTrue(bMenuRebuilt);
+    }
+
+    TEST_METHOD(TestToggleProfilerDisabled)
+    {
+        IntegrationMenuViewModelHarness menu;
+        ra::services::mocks::MockClock mockClock;
+        ra::services::mocks::MockFileSystem mockFileSystem;
+        ra::services::PerformanceCounter counter;
+        ra::services::ServiceLocator::ServiceOverride<ra::services::PerformanceCounter> counterOverride(&counter);
+        counter.SetEnabled(true);
+        bool bMenuRebuilt = false;
+        menu.mockEmulatorContext.SetRebuildMenuFunction([&bMenuRebuilt]() { bMenuRebuilt = true;  });
+
+        bool bDialogShown = false;
+        menu.mockDesktop.ExpectWindow<ra::ui::viewmodels::MessageBoxViewModel>([&bDialogShown](ra::ui::viewmodels::MessageBoxViewModel& vmMessageBox)
+        {
+            Assert::AreEqual(std::wstring(L"Performance trace written to .\\RACache\\Profile.json"), vmMessageBox.GetMessage());
+            bDialogShown = true;
+            return DialogResult::OK;
+        });
+
+        menu.ActivateMenuItem(IDM_RA_TOGGLEPROFILER);
+
+        Assert::IsFalse(counter.IsEnabled());
+        Assert::IsTrue(bDialogShown);
+        Assert::AreEqual(std::string("{\"traceEvents\":[\n\n],\"displayTimeUnit\":\"ms\"}\n"),
+                         mockFileSystem.GetFileContents(L".\\RACache\\Profile.json"));
+        Assert::IsTrue(bMenuRebuilt);
+    }
+
     TEST_METHOD(TestShowOverlaySettingsOk)
     {
         IntegrationMenuViewModelHarness menu;
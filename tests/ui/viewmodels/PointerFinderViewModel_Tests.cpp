@@ -345,7 +345,7 @@ public:
 
         Assert::IsFalse(vmPointerFinder.mockDesktop.WasDialogShown());
         Assert::AreEqual({ 1U }, vmPointerFinder.PotentialPointers().Count());
-        vmPointerFinder.AssertRow(0, L"0x0008", L"+0xFFFFFFFC", L"001c", L"0034", L"", L""); // 1c-04=>18, 34-04=>30
+        vmPointerFinder.AssertRow(0, L"0x0008", L"-0x04", L"001c", L"0034", L"", L""); // 1c-04=>18, 34-04=>30
         Assert::AreEqual(std::wstring(L"1"), vmPointerFinder.GetResultCountText());
     }
 
@@ -449,6 +449,71 @@ public:
         Assert::AreEqual(std::wstring(L"0"), vmPointerFinder.GetResultCountText());
     }
 
+    TEST_METHOD(TestFindMaxOffset)
+    {
+        PointerFinderViewModelHarness vmPointerFinder;
+        vmPointerFinder.mockGameContext.SetGameId(1U);
+        vmPointerFinder.SetSearchType(ra::services::SearchType::SixteenBitAligned);
+        vmPointerFinder.SetMaxOffset(0x10);
+
+        std::array<unsigned char, 256> pMemory{};
+        pMemory.at(0x08) = 0x1c;
+        vmPointerFinder.mockEmulatorMemoryContext.MockMemory(pMemory);
+
+        vmPointerFinder.States().at(0).SetAddress(L"0x20");
+        vmPointerFinder.States().at(0).ToggleCapture();
+
+        pMemory.at(0x08) = 0x34;
+        pMemory.at(0x0a) = 0x18;
+
+        vmPointerFinder.States().at(1).SetAddress(L"0x38");
+        vmPointerFinder.States().at(1).ToggleCapture();
+        vmPointerFinder.Find();
+
+        // 0x0a is a pointer with an offset of 0x20, which is outside the window
+        Assert::IsFalse(vmPointerFinder.mockDesktop.WasDialogShown());
+        Assert::AreEqual({ 1U }, vmPointerFinder.PotentialPointers().Count());
+        vmPointerFinder.AssertRow(0, L"0x0008", L"+0x04", L"001c", L"0034", L"", L""); // 1c+04=>20, 34+04=>38
+        Assert::AreEqual(std::wstring(L"1"), vmPointerFinder.GetResultCountText());
+
+        vmPointerFinder.SetMaxOffset(0);
+        vmPointerFinder.Find();
+
+        Assert::AreEqual({ 2U }, vmPointerFinder.PotentialPointers().Count());
+        vmPointerFinder.AssertRow(0, L"0x0008", L"+0x04", L"001c", L"0034", L"", L"");
+        vmPointerFinder.AssertRow(1, L"0x000a", L"+0x20", L"0000", L"0018", L"", L""); // 00+20=>20, 18+20=>38
+        Assert::AreEqual(std::wstring(L"2"), vmPointerFinder.GetResultCountText());
+    }
+
+    TEST_METHOD(TestFindPointerToPointer)
+    {
+        PointerFinderViewModelHarness vmPointerFinder;
+        vmPointerFinder.mockGameContext.SetGameId(1U);
+        vmPointerFinder.SetSearchType(ra::services::SearchType::SixteenBitAligned);
+        vmPointerFinder.SetMaxOffset(0x10);
+        vmPointerFinder.SetPointerDepth(2);
+
+        std::array<unsigned char, 256> pMemory{};
+        pMemory.at(0x10) = 0x40;
+        pMemory.at(0x48) = 0x80;
+        vmPointerFinder.mockEmulatorMemoryContext.MockMemory(pMemory);
+
+        vmPointerFinder.States().at(0).SetAddress(L"0x84");
+        vmPointerFinder.States().at(0).ToggleCapture();
+
+        pMemory.at(0x10) = 0x60;
+        pMemory.at(0x68) = 0xa0;
+
+        vmPointerFinder.States().at(1).SetAddress(L"0xa4");
+        vmPointerFinder.States().at(1).ToggleCapture();
+        vmPointerFinder.Find();
+
+        Assert::IsFalse(vmPointerFinder.mockDesktop.WasDialogShown());
+        Assert::AreEqual({ 1U }, vmPointerFinder.PotentialPointers().Count());
+        vmPointerFinder.AssertRow(0, L"0x0010", L"+0x08 +0x04", L"0040", L"0060", L"", L""); // 40+08=>48=>80+04=>84, 60+08=>68=>a0+04=>a4
+        Assert::AreEqual(std::wstring(L"1"), vmPointerFinder.GetResultCountText());
+    }
+
     TEST_METHOD(TestBookmarkSelected)
     {
         PointerFinderViewModelHarness vmPointerFinder;